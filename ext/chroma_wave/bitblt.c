@@ -0,0 +1,244 @@
+#include "bitblt.h"
+
+/*
+ * Raster operations on packed framebuffers: rectangle fills and
+ * rectangle copies between framebuffers of the same pixel format,
+ * combined with the destination by a ROP.
+ *
+ * Rows are treated as bit strings (most significant bit first, as in
+ * set_pixel), so every pixel format shares one kernel and
+ * a copy may start and land at any pixel, i.e. any bit offset. Each
+ * destination row span is written as a masked head byte, a body of
+ * 64-bit words and a masked tail byte; when source and destination
+ * bit offsets differ, the body loads each source word shifted into
+ * place from its two neighbouring bytes.
+ *
+ * ROPs work on raw palette indices:
+ *
+ *   copy  d = s      and  d = d & s      or  d = d | s
+ *   xor   d = d ^ s  not  d = ~s
+ */
+
+static ID id_copy, id_and, id_or, id_xor, id_not;
+
+static int
+rop_from_symbol(VALUE sym)
+{
+    ID id = SYMBOL_P(sym) ? SYM2ID(sym) : 0;
+    if (id == id_copy) return ROP_COPY;
+    if (id == id_and)  return ROP_AND;
+    if (id == id_or)   return ROP_OR;
+    if (id == id_xor)  return ROP_XOR;
+    if (id == id_not)  return ROP_NOT;
+    rb_raise(rb_eArgError, "unknown rop: %+"PRIsVALUE, sym);
+    UNREACHABLE_RETURN(ROP_COPY);
+}
+
+static inline uint64_t
+rop_apply(int rop, uint64_t d, uint64_t s)
+{
+    switch (rop) {
+    case ROP_AND: return d & s;
+    case ROP_OR:  return d | s;
+    case ROP_XOR: return d ^ s;
+    case ROP_NOT: return ~s;
+    default:      return s;
+    }
+}
+
+static inline uint64_t
+load_be64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    for (int k = 0; k < 8; k++) v = (v << 8) | p[k];
+    return v;
+}
+
+static inline void
+store_be64(uint8_t *p, uint64_t v)
+{
+    for (int k = 7; k >= 0; k--, v >>= 8) p[k] = (uint8_t)v;
+}
+
+int
+cw_fb_bits_per_pixel(const framebuffer_t *fb)
+{
+    switch (fb->pixel_format) {
+    case PIXEL_FORMAT_MONO:  return 1;
+    case PIXEL_FORMAT_GRAY4:
+    case PIXEL_FORMAT_COLOR4_2BPP: return 2;
+    default:                 return 4;
+    }
+}
+
+/* The 8 source bits lining up with a destination byte, starting at
+ * source bit sp (which is negative only for a head byte whose leading
+ * bits are masked off). Never reads past src[len - 1]. */
+static inline uint8_t
+source_byte(const uint8_t *src, long len, long sp)
+{
+    if (sp < 0) return (uint8_t)(src[0] >> -sp);
+
+    long idx = sp >> 3;
+    int  sh  = (int)(sp & 7);
+    unsigned v = (unsigned)src[idx] << sh;
+    if (sh && idx + 1 < len) v |= src[idx + 1] >> (8 - sh);
+    return (uint8_t)v;
+}
+
+void
+cw_rop_row(uint8_t *dst, long dbit, const uint8_t *src, long len, long sbit,
+           uint8_t fill, long nbits, int rop)
+{
+    long first = dbit >> 3;
+    long last  = (dbit + nbits - 1) >> 3;
+    long off   = sbit - dbit;
+    uint64_t fill64 = fill * 0x0101010101010101ULL;
+
+    for (long i = first; i <= last;) {
+        uint8_t mask = 0xFF;
+        if (i == first) mask &= (uint8_t)(0xFF >> (dbit & 7));
+        if (i == last)  mask &= (uint8_t)(0xFF << (7 - ((dbit + nbits - 1) & 7)));
+
+        /* Body: whole words strictly before the tail byte */
+        if (mask == 0xFF && i + 8 <= last) {
+            long sp  = i * 8 + off;
+            long idx = sp >> 3;
+            int  sh  = (int)(sp & 7);
+            if (src == NULL || (sp >= 0 && idx + 8 + (sh != 0) <= len)) {
+                uint64_t s;
+                if (src == NULL) {
+                    s = fill64;
+                } else if (sh == 0) {
+                    s = load_be64(src + idx);
+                } else {
+                    s = (load_be64(src + idx) << sh) | (src[idx + 8] >> (8 - sh));
+                }
+                store_be64(dst + i, rop_apply(rop, load_be64(dst + i), s));
+                i += 8;
+                continue;
+            }
+        }
+
+        uint8_t s = src ? source_byte(src, len, i * 8 + off) : fill;
+        uint8_t d = dst[i];
+        dst[i] = (uint8_t)((d & ~mask) | ((uint8_t)rop_apply(rop, d, s) & mask));
+        i++;
+    }
+}
+
+/* Clips a w x h rectangle at (x, y) to 0 <= x < width, 0 <= y < height,
+ * moving the paired source origin (sx, sy) along with it. Returns 0 if
+ * nothing is left. */
+static int
+clip_rect(long *x, long *y, long *w, long *h, long *sx, long *sy, long width, long height)
+{
+    if (*x < 0) { *w += *x; *sx -= *x; *x = 0; }
+    if (*y < 0) { *h += *y; *sy -= *y; *y = 0; }
+    if (*x + *w > width)  *w = width - *x;
+    if (*y + *h > height) *h = height - *y;
+    return *w > 0 && *h > 0;
+}
+
+/* ---- _fill_rect(x, y, w, h, color, rop) ---- */
+static VALUE
+fb_fill_rect(VALUE self, VALUE rb_x, VALUE rb_y, VALUE rb_w, VALUE rb_h,
+             VALUE rb_color, VALUE rb_rop)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+
+    int  rop = rop_from_symbol(rb_rop);
+    long x = NUM2LONG(rb_x), y = NUM2LONG(rb_y);
+    long w = NUM2LONG(rb_w), h = NUM2LONG(rb_h);
+    long unused_x = 0, unused_y = 0;
+    uint8_t c = (uint8_t)(NUM2INT(rb_color) & 0xFF);
+    uint8_t fill;
+
+    switch (fb->pixel_format) {
+    case PIXEL_FORMAT_MONO:
+        fill = c == 0 ? 0x00 : 0xFF;
+        break;
+    case PIXEL_FORMAT_GRAY4:
+    case PIXEL_FORMAT_COLOR4_2BPP:
+        c &= 0x03;
+        fill = (uint8_t)((c << 6) | (c << 4) | (c << 2) | c);
+        break;
+    default:
+        c &= 0x0F;
+        fill = (uint8_t)((c << 4) | c);
+        break;
+    }
+
+    if (!clip_rect(&x, &y, &w, &h, &unused_x, &unused_y, fb->width, fb->height))
+        return self;
+
+    cw_fb_touch(fb);
+    int bpp = cw_fb_bits_per_pixel(fb);
+    for (long row = y; row < y + h; row++) {
+        cw_rop_row(fb->buffer + (size_t)row * fb->width_byte, x * bpp,
+                   NULL, 0, 0, fill, w * bpp, rop);
+    }
+    return self;
+}
+
+/* ---- _copy_rect(src, sx, sy, w, h, dx, dy, rop) ---- */
+static VALUE
+fb_copy_rect(VALUE self, VALUE rb_src, VALUE rb_sx, VALUE rb_sy, VALUE rb_w, VALUE rb_h,
+             VALUE rb_dx, VALUE rb_dy, VALUE rb_rop)
+{
+    framebuffer_t *dst, *src;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, dst);
+    if (!rb_typeddata_is_kind_of(rb_src, &framebuffer_type)) {
+        rb_raise(rb_eTypeError, "expected a Framebuffer, got %"PRIsVALUE, rb_obj_class(rb_src));
+    }
+    TypedData_Get_Struct(rb_src, framebuffer_t, &framebuffer_type, src);
+    if (src->pixel_format != dst->pixel_format) {
+        rb_raise(rb_eArgError, "source pixel format does not match the destination");
+    }
+
+    int  rop = rop_from_symbol(rb_rop);
+    long sx = NUM2LONG(rb_sx), sy = NUM2LONG(rb_sy);
+    long w  = NUM2LONG(rb_w),  h  = NUM2LONG(rb_h);
+    long dx = NUM2LONG(rb_dx), dy = NUM2LONG(rb_dy);
+
+    /* Clip the source rectangle, then the destination, shifting the other side */
+    if (!clip_rect(&sx, &sy, &w, &h, &dx, &dy, src->width, src->height)) return self;
+    if (!clip_rect(&dx, &dy, &w, &h, &sx, &sy, dst->width, dst->height)) return self;
+
+    const uint8_t *rows = src->buffer + (size_t)sy * src->width_byte;
+    VALUE tmp = 0;
+    if (src == dst) {
+        /* Overlapping self-copy: work from a snapshot of the source rows */
+        size_t size = (size_t)h * src->width_byte;
+        uint8_t *copy = ALLOCV(tmp, size);
+        memcpy(copy, rows, size);
+        rows = copy;
+    }
+
+    cw_fb_touch(dst);
+    int bpp = cw_fb_bits_per_pixel(dst);
+    for (long k = 0; k < h; k++) {
+        cw_rop_row(dst->buffer + (size_t)(dy + k) * dst->width_byte, dx * bpp,
+                   rows + (size_t)k * src->width_byte, src->width_byte, sx * bpp,
+                   0, w * bpp, rop);
+    }
+
+    if (tmp) ALLOCV_END(tmp);
+    RB_GC_GUARD(rb_src);
+    return self;
+}
+
+/* ---- Init_bitblt() ---- */
+void
+Init_bitblt(void)
+{
+    id_copy = rb_intern("copy");
+    id_and  = rb_intern("and");
+    id_or   = rb_intern("or");
+    id_xor  = rb_intern("xor");
+    id_not  = rb_intern("not");
+
+    rb_define_private_method(rb_cFramebuffer, "_fill_rect", fb_fill_rect, 6);
+    rb_define_private_method(rb_cFramebuffer, "_copy_rect", fb_copy_rect, 8);
+}
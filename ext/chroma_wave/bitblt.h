@@ -0,0 +1,22 @@
+#ifndef CHROMA_WAVE_BITBLT_H
+#define CHROMA_WAVE_BITBLT_H
+
+#include "framebuffer.h"
+
+/* Raster operations on raw palette indices (see bitblt.c) */
+enum { ROP_COPY, ROP_AND, ROP_OR, ROP_XOR, ROP_NOT };
+
+/* Bits per pixel of a framebuffer's packed rows: 1, 2 or 4 */
+int cw_fb_bits_per_pixel(const framebuffer_t *fb);
+
+/*
+ * Combines nbits source bits starting at bit sbit of src (a row of len
+ * bytes) into dst starting at bit dbit, most significant bit first.
+ * With src == NULL the source is the byte pattern fill repeated, which
+ * is pixel-aligned at any offset. Only the nbits destination bits are
+ * written.
+ */
+void cw_rop_row(uint8_t *dst, long dbit, const uint8_t *src, long len, long sbit,
+                uint8_t fill, long nbits, int rop);
+
+#endif /* CHROMA_WAVE_BITBLT_H */
@@ -0,0 +1,80 @@
+#include "chroma_wave.h"
+#include "ruby/encoding.h"
+
+#ifdef HAVE_SYS_MMAN_H
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+VALUE rb_cBitmapFont;
+
+#ifdef HAVE_SYS_MMAN_H
+
+/*
+ * _map_file(path) → String
+ *
+ * Maps a file read-only and returns a frozen ASCII-8BIT String whose
+ * bytes point directly at the mapping (no copy). Substrings taken with
+ * byteslice share the mapping as well.
+ *
+ * The mapping is never unmapped: Ruby cannot tell when the last shared
+ * substring dies, so the pages stay mapped for the rest of the process.
+ * Callers are expected to map each file once and cache the result.
+ * The file must not be truncated while mapped (reads would SIGBUS).
+ */
+static VALUE
+bf_map_file(VALUE klass, VALUE rb_path)
+{
+    (void)klass;
+
+    FilePathValue(rb_path);
+    const char *path = StringValueCStr(rb_path);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) rb_sys_fail_str(rb_path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        rb_sys_fail_str(rb_path);
+    }
+
+    if (st.st_size == 0) {
+        close(fd);
+        VALUE empty = rb_str_new(NULL, 0);
+        rb_enc_associate(empty, rb_ascii8bit_encoding());
+        OBJ_FREEZE(empty);
+        return empty;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (map == MAP_FAILED) {
+        errno = saved;
+        rb_sys_fail_str(rb_path);
+    }
+
+    VALUE str = rb_str_new_static((const char *)map, (long)st.st_size);
+    rb_enc_associate(str, rb_ascii8bit_encoding());
+    OBJ_FREEZE(str);
+    return str;
+}
+
+#endif /* HAVE_SYS_MMAN_H */
+
+/* ---- Init_bitmap_font() ---- */
+void
+Init_bitmap_font(void)
+{
+    rb_cBitmapFont = rb_define_class_under(rb_mChromaWave, "BitmapFont", rb_cObject);
+
+#ifdef HAVE_SYS_MMAN_H
+    rb_define_private_method(rb_singleton_class(rb_cBitmapFont), "_map_file", bf_map_file, 1);
+#endif
+}
@@ -0,0 +1,428 @@
+#include "blend.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  if defined(__SSE2__)
+#    include <emmintrin.h>
+#    define CW_BLEND_SSE2 1
+#  endif
+#  if defined(__GNUC__) && (defined(__clang__) || __GNUC__ >= 5)
+#    include <immintrin.h>
+#    define CW_BLEND_AVX2 1
+#  endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define CW_BLEND_NEON 1
+#endif
+
+cw_blend_rgba_row_fn cw_blend_rgba_row;
+cw_blend_mask_row_fn cw_blend_mask_row;
+
+/* ---- Scalar kernels (reference; also handle SIMD tails) ---- */
+
+static void
+blend_rgba_row_scalar(uint8_t *dst, const uint8_t *src, long n)
+{
+    for (long i = 0; i < n; i++, dst += 4, src += 4) {
+        uint8_t a = src[3];
+
+        if (a == 0) continue;
+
+        if (a == 255) {
+            memcpy(dst, src, 4);
+        } else {
+            uint32_t inv = 255u - a;
+            dst[0] = cw_div255(src[0] * a + dst[0] * inv);
+            dst[1] = cw_div255(src[1] * a + dst[1] * inv);
+            dst[2] = cw_div255(src[2] * a + dst[2] * inv);
+            dst[3] = 255;
+        }
+    }
+}
+
+static void
+blend_mask_row_scalar(uint8_t *dst, const uint8_t *mask, long n,
+                      uint8_t r, uint8_t g, uint8_t b)
+{
+    for (long i = 0; i < n; i++, dst += 4) {
+        uint8_t a = mask[i];
+
+        if (a == 0) continue;
+
+        if (a == 255) {
+            dst[0] = r;
+            dst[1] = g;
+            dst[2] = b;
+        } else {
+            uint32_t inv = 255u - a;
+            dst[0] = cw_div255(r * a + dst[0] * inv);
+            dst[1] = cw_div255(g * a + dst[1] * inv);
+            dst[2] = cw_div255(b * a + dst[2] * inv);
+        }
+        dst[3] = 255;
+    }
+}
+
+/* ---- SSE2: 4 pixels per iteration ----
+ *
+ * Channels are widened to 16 bits; fg * a + bg * (255 - a) peaks at
+ * 65025 and the div255 intermediates at 65407, so unsigned 16-bit lanes
+ * never overflow. The alpha byte of each result is then replaced with
+ * 255, or with the old destination alpha where a == 0 (where the
+ * formula already reproduces the destination color). */
+
+#ifdef CW_BLEND_SSE2
+
+static inline __m128i
+sse2_div255(__m128i x)
+{
+    __m128i t = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+/* Blends 4 RGBA pixels: fg/alpha are RGBA-shaped (alpha replicated per pixel) */
+static inline __m128i
+sse2_blend4(__m128i fg, __m128i alpha, __m128i bg)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i amask = _mm_set1_epi32((int)0xFF000000u);
+
+    __m128i a_lo = _mm_unpacklo_epi8(alpha, zero);
+    __m128i a_hi = _mm_unpackhi_epi8(alpha, zero);
+
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(fg, zero), a_lo),
+                               _mm_mullo_epi16(_mm_unpacklo_epi8(bg, zero), _mm_sub_epi16(full, a_lo)));
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(fg, zero), a_hi),
+                               _mm_mullo_epi16(_mm_unpackhi_epi8(bg, zero), _mm_sub_epi16(full, a_hi)));
+    __m128i out = _mm_packus_epi16(sse2_div255(lo), sse2_div255(hi));
+
+    __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(alpha, amask), zero);
+    __m128i out_alpha = _mm_or_si128(_mm_and_si128(transparent, _mm_and_si128(bg, amask)),
+                                     _mm_andnot_si128(transparent, amask));
+    return _mm_or_si128(_mm_andnot_si128(amask, out), out_alpha);
+}
+
+static void
+blend_rgba_row_sse2(uint8_t *dst, const uint8_t *src, long n)
+{
+    const __m128i amask = _mm_set1_epi32((int)0xFF000000u);
+    long i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i * 4));
+        __m128i a = _mm_and_si128(s, amask);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, _mm_setzero_si128())) == 0xFFFF) continue;
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, amask)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i *)(dst + i * 4), s);
+            continue;
+        }
+
+        /* replicate each pixel's alpha byte across its 4 bytes */
+        __m128i a32 = _mm_srli_epi32(s, 24);
+        __m128i alpha = _mm_or_si128(a32, _mm_slli_epi32(a32, 8));
+        alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i * 4));
+        _mm_storeu_si128((__m128i *)(dst + i * 4), sse2_blend4(s, alpha, d));
+    }
+
+    blend_rgba_row_scalar(dst + i * 4, src + i * 4, n - i);
+}
+
+static void
+blend_mask_row_sse2(uint8_t *dst, const uint8_t *mask, long n,
+                    uint8_t r, uint8_t g, uint8_t b)
+{
+    const __m128i fg = _mm_set1_epi32((int)(0xFF000000u | ((uint32_t)b << 16) |
+                                            ((uint32_t)g << 8) | r));
+    long i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        uint32_t m4;
+        memcpy(&m4, mask + i, 4);
+
+        if (m4 == 0) continue;
+        if (m4 == 0xFFFFFFFFu) {
+            _mm_storeu_si128((__m128i *)(dst + i * 4), fg);
+            continue;
+        }
+
+        __m128i m = _mm_cvtsi32_si128((int)m4);
+        m = _mm_unpacklo_epi8(m, m);
+        __m128i alpha = _mm_unpacklo_epi16(m, m);
+
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i * 4));
+        _mm_storeu_si128((__m128i *)(dst + i * 4), sse2_blend4(fg, alpha, d));
+    }
+
+    blend_mask_row_scalar(dst + i * 4, mask + i, n - i, r, g, b);
+}
+
+#endif /* CW_BLEND_SSE2 */
+
+/* ---- AVX2: 8 pixels per iteration ----
+ *
+ * Same arithmetic as SSE2 on 256-bit vectors. unpack/pack work within
+ * 128-bit lanes, so widening and narrowing preserve pixel order.
+ * Compiled with a target attribute and only selected when the CPU
+ * reports AVX2 at load time. */
+
+#ifdef CW_BLEND_AVX2
+
+#define CW_AVX2 __attribute__((target("avx2")))
+
+CW_AVX2 static inline __m256i
+avx2_div255(__m256i x)
+{
+    __m256i t = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+CW_AVX2 static inline __m256i
+avx2_blend8(__m256i fg, __m256i alpha, __m256i bg)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i full = _mm256_set1_epi16(255);
+    const __m256i amask = _mm256_set1_epi32((int)0xFF000000u);
+
+    __m256i a_lo = _mm256_unpacklo_epi8(alpha, zero);
+    __m256i a_hi = _mm256_unpackhi_epi8(alpha, zero);
+
+    __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(fg, zero), a_lo),
+                                  _mm256_mullo_epi16(_mm256_unpacklo_epi8(bg, zero), _mm256_sub_epi16(full, a_lo)));
+    __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(fg, zero), a_hi),
+                                  _mm256_mullo_epi16(_mm256_unpackhi_epi8(bg, zero), _mm256_sub_epi16(full, a_hi)));
+    __m256i out = _mm256_packus_epi16(avx2_div255(lo), avx2_div255(hi));
+
+    __m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(alpha, amask), zero);
+    __m256i out_alpha = _mm256_or_si256(_mm256_and_si256(transparent, _mm256_and_si256(bg, amask)),
+                                        _mm256_andnot_si256(transparent, amask));
+    return _mm256_or_si256(_mm256_andnot_si256(amask, out), out_alpha);
+}
+
+CW_AVX2 static void
+blend_rgba_row_avx2(uint8_t *dst, const uint8_t *src, long n)
+{
+    const __m256i amask = _mm256_set1_epi32((int)0xFF000000u);
+    const __m256i spread = _mm256_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15,
+                                            3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+    long i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i * 4));
+        __m256i a = _mm256_and_si256(s, amask);
+
+        if ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, _mm256_setzero_si256())) == 0xFFFFFFFFu)
+            continue;
+        if ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, amask)) == 0xFFFFFFFFu) {
+            _mm256_storeu_si256((__m256i *)(dst + i * 4), s);
+            continue;
+        }
+
+        __m256i alpha = _mm256_shuffle_epi8(s, spread);
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i * 4));
+        _mm256_storeu_si256((__m256i *)(dst + i * 4), avx2_blend8(s, alpha, d));
+    }
+
+    blend_rgba_row_scalar(dst + i * 4, src + i * 4, n - i);
+}
+
+CW_AVX2 static void
+blend_mask_row_avx2(uint8_t *dst, const uint8_t *mask, long n,
+                    uint8_t r, uint8_t g, uint8_t b)
+{
+    const __m256i fg = _mm256_set1_epi32((int)(0xFF000000u | ((uint32_t)b << 16) |
+                                               ((uint32_t)g << 8) | r));
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                            4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+    long i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        uint64_t m8;
+        memcpy(&m8, mask + i, 8);
+
+        if (m8 == 0) continue;
+        if (m8 == UINT64_MAX) {
+            _mm256_storeu_si256((__m256i *)(dst + i * 4), fg);
+            continue;
+        }
+
+        /* both lanes hold mask bytes 0-7; the low lane spreads 0-3,
+         * the high lane 4-7 */
+        __m128i m = _mm_loadl_epi64((const __m128i *)(mask + i));
+        __m256i alpha = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(m), spread);
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i * 4));
+        _mm256_storeu_si256((__m256i *)(dst + i * 4), avx2_blend8(fg, alpha, d));
+    }
+
+    blend_mask_row_scalar(dst + i * 4, mask + i, n - i, r, g, b);
+}
+
+#endif /* CW_BLEND_AVX2 */
+
+/* ---- NEON: 8 pixels per iteration ----
+ *
+ * vld4/vst4 de-interleave RGBA into planes, so alpha needs no shuffle.
+ * NEON is baseline on AArch64 and assumed whenever the compiler
+ * targets it on 32-bit ARM. */
+
+#ifdef CW_BLEND_NEON
+
+static inline uint8x8_t
+neon_blend_channel(uint8x8_t fg, uint8x8_t bg, uint8x8_t a, uint8x8_t inv)
+{
+    uint16x8_t t = vaddq_u16(vmlal_u8(vmull_u8(fg, a), bg, inv), vdupq_n_u16(128));
+    return vshrn_n_u16(vaddq_u16(t, vshrq_n_u16(t, 8)), 8);
+}
+
+static inline void
+neon_blend8(uint8_t *dst, uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+{
+    uint8x8x4_t d = vld4_u8(dst);
+    uint8x8_t inv = vmvn_u8(a);
+
+    d.val[0] = neon_blend_channel(r, d.val[0], a, inv);
+    d.val[1] = neon_blend_channel(g, d.val[1], a, inv);
+    d.val[2] = neon_blend_channel(b, d.val[2], a, inv);
+    d.val[3] = vbsl_u8(vceq_u8(a, vdup_n_u8(0)), d.val[3], vdup_n_u8(255));
+    vst4_u8(dst, d);
+}
+
+static void
+blend_rgba_row_neon(uint8_t *dst, const uint8_t *src, long n)
+{
+    long i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        uint8x8x4_t s = vld4_u8(src + i * 4);
+        uint64_t alphas = vget_lane_u64(vreinterpret_u64_u8(s.val[3]), 0);
+
+        if (alphas == 0) continue;
+        if (alphas == UINT64_MAX) {
+            vst4_u8(dst + i * 4, s);
+            continue;
+        }
+
+        neon_blend8(dst + i * 4, s.val[0], s.val[1], s.val[2], s.val[3]);
+    }
+
+    blend_rgba_row_scalar(dst + i * 4, src + i * 4, n - i);
+}
+
+static void
+blend_mask_row_neon(uint8_t *dst, const uint8_t *mask, long n,
+                    uint8_t r, uint8_t g, uint8_t b)
+{
+    uint8x8_t vr = vdup_n_u8(r), vg = vdup_n_u8(g), vb = vdup_n_u8(b);
+    long i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        uint8x8_t a = vld1_u8(mask + i);
+        uint64_t alphas = vget_lane_u64(vreinterpret_u64_u8(a), 0);
+
+        if (alphas == 0) continue;
+        neon_blend8(dst + i * 4, vr, vg, vb, a);
+    }
+
+    blend_mask_row_scalar(dst + i * 4, mask + i, n - i, r, g, b);
+}
+
+#endif /* CW_BLEND_NEON */
+
+/* ---- Backend table and load-time selection ---- */
+
+typedef struct {
+    const char          *name;
+    cw_blend_rgba_row_fn rgba_row;
+    cw_blend_mask_row_fn mask_row;
+    int                (*supported)(void);
+} blend_backend_t;
+
+static int always(void) { return 1; }
+
+#ifdef CW_BLEND_AVX2
+static int
+cpu_has_avx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+/* Fastest first; the last entry is always available */
+static const blend_backend_t backends[] = {
+#ifdef CW_BLEND_AVX2
+    { "avx2",   blend_rgba_row_avx2,   blend_mask_row_avx2,   cpu_has_avx2 },
+#endif
+#ifdef CW_BLEND_SSE2
+    { "sse2",   blend_rgba_row_sse2,   blend_mask_row_sse2,   always },
+#endif
+#ifdef CW_BLEND_NEON
+    { "neon",   blend_rgba_row_neon,   blend_mask_row_neon,   always },
+#endif
+    { "scalar", blend_rgba_row_scalar, blend_mask_row_scalar, always },
+};
+
+#define BACKEND_COUNT ((int)(sizeof(backends) / sizeof(backends[0])))
+
+static const blend_backend_t *active;
+
+static void
+activate(const blend_backend_t *backend)
+{
+    active            = backend;
+    cw_blend_rgba_row = backend->rgba_row;
+    cw_blend_mask_row = backend->mask_row;
+}
+
+void
+cw_blend_init(void)
+{
+    for (int i = 0; i < BACKEND_COUNT; i++) {
+        if (backends[i].supported()) {
+            activate(&backends[i]);
+            return;
+        }
+    }
+}
+
+const char *
+cw_blend_backend(void)
+{
+    return active ? active->name : "scalar";
+}
+
+int
+cw_blend_select(const char *name)
+{
+    for (int i = 0; i < BACKEND_COUNT; i++) {
+        if (strcmp(backends[i].name, name) == 0 && backends[i].supported()) {
+            activate(&backends[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int
+cw_blend_backend_count(void)
+{
+    int count = 0;
+    for (int i = 0; i < BACKEND_COUNT; i++) {
+        if (backends[i].supported()) count++;
+    }
+    return count;
+}
+
+const char *
+cw_blend_backend_name(int index)
+{
+    for (int i = 0; i < BACKEND_COUNT; i++) {
+        if (!backends[i].supported()) continue;
+        if (index-- == 0) return backends[i].name;
+    }
+    return NULL;
+}
@@ -0,0 +1,59 @@
+#ifndef CHROMA_WAVE_BLEND_H
+#define CHROMA_WAVE_BLEND_H
+
+#include <stdint.h>
+
+/*
+ * Row kernels for source-over compositing onto an opaque-result RGBA
+ * buffer. Callers clip to the destination once per row and pass the
+ * number of in-bounds pixels; kernels never bounds-check.
+ *
+ * Both kernels compute, per channel,
+ *
+ *   out = div255(fg * a + bg * (255 - a))
+ *
+ * with the exact rounding divide div255(x) = (x + 127) / 255, and set
+ * the output alpha to 255 — except where a == 0, which leaves the
+ * destination pixel untouched. Every backend produces bit-identical
+ * results.
+ */
+
+/* dst, src: n RGBA pixels; src alpha drives the blend */
+typedef void (*cw_blend_rgba_row_fn)(uint8_t *dst, const uint8_t *src, long n);
+
+/* dst: n RGBA pixels; mask: n alpha bytes; fg = (r, g, b) */
+typedef void (*cw_blend_mask_row_fn)(uint8_t *dst, const uint8_t *mask, long n,
+                                     uint8_t r, uint8_t g, uint8_t b);
+
+extern cw_blend_rgba_row_fn cw_blend_rgba_row;
+extern cw_blend_mask_row_fn cw_blend_mask_row;
+
+/* Exact (x + 127) / 255 for 0 <= x <= 255 * 255, without a division */
+static inline uint8_t
+cw_div255(uint32_t x)
+{
+    uint32_t t = x + 128;
+    return (uint8_t)((t + (t >> 8)) >> 8);
+}
+
+/* BT.601 luma with 8-bit weights (77 + 150 + 29 = 256), so grays map to themselves */
+static inline uint8_t
+cw_luma(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (uint8_t)((77u * r + 150u * g + 29u * b + 128u) >> 8);
+}
+
+/* Picks the fastest backend the CPU supports. Called once from Init. */
+void cw_blend_init(void);
+
+/* Name of the active backend ("avx2", "sse2", "neon", or "scalar") */
+const char *cw_blend_backend(void);
+
+/* Selects a backend by name; returns 0 if it is unknown or unsupported */
+int cw_blend_select(const char *name);
+
+/* Number of supported backends and their names, fastest first */
+int         cw_blend_backend_count(void);
+const char *cw_blend_backend_name(int i);
+
+#endif /* CHROMA_WAVE_BLEND_H */
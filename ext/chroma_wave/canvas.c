@@ -1,7 +1,11 @@
 #include "chroma_wave.h"
+#include "blend.h"
+#include "pixel_buffer.h"
 #include "ruby/encoding.h"
 
 VALUE rb_cCanvas;
+VALUE rb_cGrayCanvas;
+VALUE rb_cIndexedCanvas;
 
 /* ---- _canvas_clear(buf, r, g, b, a) ---- */
 static VALUE
@@ -9,11 +13,8 @@ canvas_clear(VALUE self, VALUE rb_buf, VALUE rb_r, VALUE rb_g, VALUE rb_b, VALUE
 {
     (void)self;
 
-    Check_Type(rb_buf, T_STRING);
-    rb_str_modify(rb_buf);
-
-    uint8_t *buf = (uint8_t *)RSTRING_PTR(rb_buf);
-    long len     = RSTRING_LEN(rb_buf);
+    cw_view_t v;
+    cw_view(rb_buf, 4, 0, 1, &v);
 
     uint8_t r = (uint8_t)(NUM2INT(rb_r) & 0xFF);
     uint8_t g = (uint8_t)(NUM2INT(rb_g) & 0xFF);
@@ -22,17 +23,46 @@ canvas_clear(VALUE self, VALUE rb_buf, VALUE rb_r, VALUE rb_g, VALUE rb_b, VALUE
 
     uint8_t stamp[4] = { r, g, b, a };
 
-    for (long i = 0; i < len; i += 4) {
-        memcpy(buf + i, stamp, 4);
+    /* row padding is stamped too; it is never read back */
+    for (long i = 0; i + 4 <= v.len; i += 4) {
+        memcpy(v.data + i, stamp, 4);
     }
 
     return Qnil;
 }
 
+/* ---- Row clipping ----
+ *
+ * Clips a w x h source rectangle placed at (x, y) against a dw x dh
+ * destination. On return [*x0, *x1) and [*y0, *y1) are the visible
+ * source columns and rows; the span is empty when *x0 >= *x1. */
+static void
+clip_span(int x, int y, int w, int h, int dw, int dh,
+          int *x0, int *x1, int *y0, int *y1)
+{
+    *x0 = x < 0 ? -x : 0;
+    *x1 = (dw - x) < w ? (dw - x) : w;
+    *y0 = y < 0 ? -y : 0;
+    *y1 = (dh - y) < h ? (dh - y) : h;
+}
+
+/* Number of whole units of +unit+ bytes available in a buffer of +len+
+ * bytes starting at +off+, capped at +want+. */
+static long
+clamp_units(long off, long len, long unit, long want)
+{
+    if (off >= len) return 0;
+    long avail = (len - off) / unit;
+    return avail < want ? avail : want;
+}
+
 /* ---- _canvas_blit_alpha(dst, src, dx, dy, sw, sh, dw, dh) ----
  *
  * Alpha-composited blit from src onto dst.
  * Integer alpha blending: (s*a + d*(255-a) + 127) / 255
+ *
+ * Clipping and buffer bounds are resolved once per row; each visible
+ * row span goes to the active blend kernel (see blend.c).
  */
 static VALUE
 canvas_blit_alpha(VALUE self,
@@ -43,15 +73,6 @@ canvas_blit_alpha(VALUE self,
 {
     (void)self;
 
-    Check_Type(rb_dst, T_STRING);
-    Check_Type(rb_src, T_STRING);
-    rb_str_modify(rb_dst);
-
-    uint8_t       *dst = (uint8_t *)RSTRING_PTR(rb_dst);
-    const uint8_t *src = (const uint8_t *)RSTRING_PTR(rb_src);
-    long dst_len = RSTRING_LEN(rb_dst);
-    long src_len = RSTRING_LEN(rb_src);
-
     int dx = NUM2INT(rb_dx);
     int dy = NUM2INT(rb_dy);
     int sw = NUM2INT(rb_sw);
@@ -65,37 +86,25 @@ canvas_blit_alpha(VALUE self,
         return Qnil;
     }
 
-    for (int sy = 0; sy < sh; sy++) {
-        int dest_y = dy + sy;
-        if (dest_y < 0 || dest_y >= dh) continue;
-
-        for (int sx = 0; sx < sw; sx++) {
-            int dest_x = dx + sx;
-            if (dest_x < 0 || dest_x >= dw) continue;
-
-            long s_off = ((long)sy * sw + sx) * 4;
-            long d_off = ((long)dest_y * dw + dest_x) * 4;
-
-            if (s_off + 3 >= src_len || d_off + 3 >= dst_len) continue;
+    cw_view_t d, s;
+    cw_view(rb_dst, 4, dw, 1, &d);
+    cw_view(rb_src, 4, sw, 0, &s);
 
-            uint8_t sa = src[s_off + 3];
+    int x0, x1, y0, y1;
+    clip_span(dx, dy, sw, sh, dw, dh, &x0, &x1, &y0, &y1);
+    if (x0 >= x1) return Qnil;
 
-            if (sa == 0) continue; /* fully transparent — skip */
+    for (int sy = y0; sy < y1; sy++) {
+        long s_off = (long)sy * (long)s.stride + (long)x0 * 4;
+        long d_off = (long)(dy + sy) * (long)d.stride + (long)(dx + x0) * 4;
 
-            if (sa == 255) {
-                /* fully opaque — direct copy */
-                memcpy(dst + d_off, src + s_off, 4);
-            } else {
-                /* semi-transparent — alpha blend */
-                uint8_t inv_a = 255 - sa;
-                dst[d_off + 0] = (uint8_t)((src[s_off + 0] * sa + dst[d_off + 0] * inv_a + 127) / 255);
-                dst[d_off + 1] = (uint8_t)((src[s_off + 1] * sa + dst[d_off + 1] * inv_a + 127) / 255);
-                dst[d_off + 2] = (uint8_t)((src[s_off + 2] * sa + dst[d_off + 2] * inv_a + 127) / 255);
-                dst[d_off + 3] = 255; /* result is always opaque */
-            }
-        }
+        long n = clamp_units(s_off, s.len, 4, x1 - x0);
+        n = clamp_units(d_off, d.len, 4, n);
+        if (n > 0) cw_blend_rgba_row(d.data + d_off, s.data + s_off, n);
     }
 
+    RB_GC_GUARD(rb_dst);
+    RB_GC_GUARD(rb_src);
     return Qnil;
 }
 
@@ -112,17 +121,8 @@ canvas_load_rgba(VALUE self,
 {
     (void)self;
 
-    Check_Type(rb_dst, T_STRING);
-    Check_Type(rb_src, T_STRING);
-    rb_str_modify(rb_dst);
-
     int dw = NUM2INT(rb_dw);
-    if (dw <= 0) return Qnil;
-
-    uint8_t       *dst = (uint8_t *)RSTRING_PTR(rb_dst);
-    const uint8_t *src = (const uint8_t *)RSTRING_PTR(rb_src);
-    long dst_len = RSTRING_LEN(rb_dst);
-    long src_len = RSTRING_LEN(rb_src);
+    if (dw <= 0 || dw > EPD_MAX_DIMENSION) return Qnil;
 
     int x  = NUM2INT(rb_x);
     int y  = NUM2INT(rb_y);
@@ -132,9 +132,11 @@ canvas_load_rgba(VALUE self,
     if (w <= 0 || h <= 0) return Qnil;
     if (w > EPD_MAX_DIMENSION || h > EPD_MAX_DIMENSION) return Qnil;
 
-    int dh = (int)(dst_len / 4 / dw);
+    cw_view_t d, s;
+    cw_view(rb_dst, 4, dw, 1, &d);
+    cw_view(rb_src, 4, w, 0, &s);
 
-    int src_row_bytes = w * 4;
+    int dh = (int)d.rows;
 
     for (int sy = 0; sy < h; sy++) {
         int dest_y = y + sy;
@@ -144,16 +146,18 @@ canvas_load_rgba(VALUE self,
         int dx_end   = (w < (dw - x)) ? w : (dw - x);
         if (dx_start >= dx_end) continue;
 
-        long s_off   = (long)sy * src_row_bytes + (long)dx_start * 4;
-        long d_off   = ((long)dest_y * dw + x + dx_start) * 4;
+        long s_off   = (long)sy * (long)s.stride + (long)dx_start * 4;
+        long d_off   = (long)dest_y * (long)d.stride + (long)(x + dx_start) * 4;
         long copy_len = (long)(dx_end - dx_start) * 4;
 
-        if (s_off + copy_len > src_len) continue;
-        if (d_off + copy_len > dst_len) continue;
+        if (s_off + copy_len > s.len) continue;
+        if (d_off + copy_len > d.len) continue;
 
-        memcpy(dst + d_off, src + s_off, (size_t)copy_len);
+        memcpy(d.data + d_off, s.data + s_off, (size_t)copy_len);
     }
 
+    RB_GC_GUARD(rb_dst);
+    RB_GC_GUARD(rb_src);
     return Qnil;
 }
 
@@ -161,7 +165,7 @@ canvas_load_rgba(VALUE self,
  *
  * Alpha-composites a glyph bitmap onto a Canvas RGBA buffer.
  *
- * buf    – Canvas RGBA buffer String (modified in-place)
+ * buf    – Canvas PixelBuffer (or packed RGBA String), modified in-place
  * bitmap – glyph alpha bitmap String (1 byte per pixel, 0–255)
  * gx, gy – destination position on canvas
  * gw, gh – glyph dimensions in pixels
@@ -170,6 +174,9 @@ canvas_load_rgba(VALUE self,
  *
  * Per-pixel: skip alpha==0, direct write alpha==255, else integer blend:
  *   (fg * alpha + bg * (255 - alpha) + 127) / 255
+ *
+ * Rows are clipped once; each visible span goes to the active blend
+ * kernel (see blend.c).
  */
 static VALUE
 canvas_blit_glyph(VALUE self,
@@ -181,14 +188,7 @@ canvas_blit_glyph(VALUE self,
 {
     (void)self;
 
-    Check_Type(rb_buf, T_STRING);
     Check_Type(rb_bmp, T_STRING);
-    rb_str_modify(rb_buf);
-
-    uint8_t       *dst = (uint8_t *)RSTRING_PTR(rb_buf);
-    const uint8_t *bmp = (const uint8_t *)RSTRING_PTR(rb_bmp);
-    long dst_len = RSTRING_LEN(rb_buf);
-    long bmp_len = RSTRING_LEN(rb_bmp);
 
     int gx = NUM2INT(rb_gx);
     int gy = NUM2INT(rb_gy);
@@ -203,41 +203,473 @@ canvas_blit_glyph(VALUE self,
 
     if (gw <= 0 || gh <= 0 || dw <= 0 || dh <= 0) return Qnil;
 
-    for (int row = 0; row < gh; row++) {
-        int dest_y = gy + row;
-        if (dest_y < 0 || dest_y >= dh) continue;
+    cw_view_t d;
+    cw_view(rb_buf, 4, dw, 1, &d);
+
+    const uint8_t *bmp = (const uint8_t *)RSTRING_PTR(rb_bmp);
+    long bmp_len = RSTRING_LEN(rb_bmp);
+
+    int x0, x1, y0, y1;
+    clip_span(gx, gy, gw, gh, dw, dh, &x0, &x1, &y0, &y1);
+    if (x0 >= x1) return Qnil;
+
+    for (int row = y0; row < y1; row++) {
+        long b_off = (long)row * gw + x0;
+        long d_off = (long)(gy + row) * (long)d.stride + (long)(gx + x0) * 4;
 
-        for (int col = 0; col < gw; col++) {
-            int dest_x = gx + col;
-            if (dest_x < 0 || dest_x >= dw) continue;
-
-            long b_off = (long)row * gw + col;
-            if (b_off >= bmp_len) continue;
-
-            uint8_t alpha = bmp[b_off];
-            if (alpha == 0) continue;
-
-            long d_off = ((long)dest_y * dw + dest_x) * 4;
-            if (d_off + 3 >= dst_len) continue;
-
-            if (alpha == 255) {
-                dst[d_off + 0] = fr;
-                dst[d_off + 1] = fg;
-                dst[d_off + 2] = fb;
-                dst[d_off + 3] = 255;
-            } else {
-                uint8_t inv = 255 - alpha;
-                dst[d_off + 0] = (uint8_t)((fr * alpha + dst[d_off + 0] * inv + 127) / 255);
-                dst[d_off + 1] = (uint8_t)((fg * alpha + dst[d_off + 1] * inv + 127) / 255);
-                dst[d_off + 2] = (uint8_t)((fb * alpha + dst[d_off + 2] * inv + 127) / 255);
-                dst[d_off + 3] = 255;
+        long n = clamp_units(b_off, bmp_len, 1, x1 - x0);
+        n = clamp_units(d_off, d.len, 4, n);
+        if (n > 0) cw_blend_mask_row(d.data + d_off, bmp + b_off, n, fr, fg, fb);
+    }
+
+    RB_GC_GUARD(rb_buf);
+    RB_GC_GUARD(rb_bmp);
+    return Qnil;
+}
+
+/* ---- GrayCanvas: one luma byte per pixel ----
+ *
+ * The gray8 counterparts of the RGBA accelerators above. Colours arrive
+ * as RGBA (from Canvas sources) or as a pre-computed luma byte, and are
+ * reduced with cw_luma(); compositing uses the same div255 rounding as
+ * the RGBA kernels, on the single channel.
+ */
+
+/* ---- _gray_clear(buf, luma), _indexed_clear(buf, index) ---- */
+static VALUE
+byte_clear(VALUE self, VALUE rb_buf, VALUE rb_luma)
+{
+    (void)self;
+
+    cw_view_t v;
+    cw_view(rb_buf, 1, 0, 1, &v);
+
+    memset(v.data, NUM2INT(rb_luma) & 0xFF, (size_t)v.len);
+    return Qnil;
+}
+
+/* ---- _gray_blit_alpha(dst, src, dx, dy, sw, sh, dw, dh) ----
+ *
+ * Composites an RGBA source onto a gray buffer:
+ *   out = div255(luma(src) * a + dst * (255 - a))
+ * skipping a == 0 and copying the luma where a == 255.
+ */
+static VALUE
+gray_blit_alpha(VALUE self,
+                VALUE rb_dst, VALUE rb_src,
+                VALUE rb_dx, VALUE rb_dy,
+                VALUE rb_sw, VALUE rb_sh,
+                VALUE rb_dw, VALUE rb_dh)
+{
+    (void)self;
+
+    int dx = NUM2INT(rb_dx);
+    int dy = NUM2INT(rb_dy);
+    int sw = NUM2INT(rb_sw);
+    int sh = NUM2INT(rb_sh);
+    int dw = NUM2INT(rb_dw);
+    int dh = NUM2INT(rb_dh);
+
+    if (sw <= 0 || sh <= 0 || dw <= 0 || dh <= 0 ||
+        sw > EPD_MAX_DIMENSION || sh > EPD_MAX_DIMENSION ||
+        dw > EPD_MAX_DIMENSION || dh > EPD_MAX_DIMENSION) {
+        return Qnil;
+    }
+
+    cw_view_t dv, sv;
+    cw_view(rb_dst, 1, dw, 1, &dv);
+    cw_view(rb_src, 4, sw, 0, &sv);
+
+    int x0, x1, y0, y1;
+    clip_span(dx, dy, sw, sh, dw, dh, &x0, &x1, &y0, &y1);
+    if (x0 >= x1) return Qnil;
+
+    for (int sy = y0; sy < y1; sy++) {
+        long s_off = (long)sy * (long)sv.stride + (long)x0 * 4;
+        long d_off = (long)(dy + sy) * (long)dv.stride + dx + x0;
+
+        long n = clamp_units(s_off, sv.len, 4, x1 - x0);
+        n = clamp_units(d_off, dv.len, 1, n);
+
+        const uint8_t *s = sv.data + s_off;
+        uint8_t       *d = dv.data + d_off;
+        for (long i = 0; i < n; i++, s += 4, d++) {
+            uint8_t a = s[3];
+
+            if (a == 0) continue;
+            *d = a == 255 ? cw_luma(s[0], s[1], s[2])
+                          : cw_div255(cw_luma(s[0], s[1], s[2]) * a + *d * (255u - a));
+        }
+    }
+
+    RB_GC_GUARD(rb_dst);
+    RB_GC_GUARD(rb_src);
+    return Qnil;
+}
+
+/* ---- _gray_load / _indexed_load(dst, src, x, y, w, h, dw, src_bpp) ----
+ *
+ * Bulk-loads one-byte rows (src_bpp 1, a plain copy) or RGBA rows
+ * (src_bpp 4, reduced to luma with alpha ignored; GrayCanvas only)
+ * into a rectangular region with clipping.
+ */
+static VALUE
+byte_load(VALUE self,
+          VALUE rb_dst, VALUE rb_src,
+          VALUE rb_x, VALUE rb_y,
+          VALUE rb_w, VALUE rb_h,
+          VALUE rb_dw, VALUE rb_bpp)
+{
+    (void)self;
+
+    int dw  = NUM2INT(rb_dw);
+    int bpp = NUM2INT(rb_bpp);
+    if (dw <= 0 || dw > EPD_MAX_DIMENSION || (bpp != 1 && bpp != 4)) return Qnil;
+
+    int x = NUM2INT(rb_x);
+    int y = NUM2INT(rb_y);
+    int w = NUM2INT(rb_w);
+    int h = NUM2INT(rb_h);
+
+    if (w <= 0 || h <= 0 || w > EPD_MAX_DIMENSION || h > EPD_MAX_DIMENSION) return Qnil;
+
+    cw_view_t d, s;
+    cw_view(rb_dst, 1, dw, 1, &d);
+    cw_view(rb_src, bpp, w, 0, &s);
+
+    int x0, x1, y0, y1;
+    clip_span(x, y, w, h, dw, (int)d.rows, &x0, &x1, &y0, &y1);
+    if (x0 >= x1) return Qnil;
+
+    for (int sy = y0; sy < y1; sy++) {
+        long s_off = (long)sy * (long)s.stride + (long)x0 * bpp;
+        long d_off = (long)(y + sy) * (long)d.stride + x + x0;
+
+        long n = clamp_units(s_off, s.len, bpp, x1 - x0);
+        n = clamp_units(d_off, d.len, 1, n);
+
+        if (bpp == 1) {
+            if (n > 0) memcpy(d.data + d_off, s.data + s_off, (size_t)n);
+        } else {
+            const uint8_t *p = s.data + s_off;
+            for (long i = 0; i < n; i++, p += 4) d.data[d_off + i] = cw_luma(p[0], p[1], p[2]);
+        }
+    }
+
+    RB_GC_GUARD(rb_dst);
+    RB_GC_GUARD(rb_src);
+    return Qnil;
+}
+
+/* ---- _gray_blit_glyph(buf, bitmap, gx, gy, gw, gh, dw, dh, luma) ----
+ *
+ * Composites a glyph coverage bitmap in gray +luma+:
+ *   out = div255(luma * m + dst * (255 - m))
+ */
+static VALUE
+gray_blit_glyph(VALUE self,
+                VALUE rb_buf, VALUE rb_bmp,
+                VALUE rb_gx, VALUE rb_gy,
+                VALUE rb_gw, VALUE rb_gh,
+                VALUE rb_dw, VALUE rb_dh,
+                VALUE rb_luma)
+{
+    (void)self;
+
+    Check_Type(rb_bmp, T_STRING);
+
+    int gx = NUM2INT(rb_gx);
+    int gy = NUM2INT(rb_gy);
+    int gw = NUM2INT(rb_gw);
+    int gh = NUM2INT(rb_gh);
+    int dw = NUM2INT(rb_dw);
+    int dh = NUM2INT(rb_dh);
+    uint32_t l = (uint32_t)(NUM2INT(rb_luma) & 0xFF);
+
+    if (gw <= 0 || gh <= 0 || dw <= 0 || dh <= 0) return Qnil;
+
+    cw_view_t v;
+    cw_view(rb_buf, 1, dw, 1, &v);
+
+    const uint8_t *bmp = (const uint8_t *)RSTRING_PTR(rb_bmp);
+    long bmp_len = RSTRING_LEN(rb_bmp);
+
+    int x0, x1, y0, y1;
+    clip_span(gx, gy, gw, gh, dw, dh, &x0, &x1, &y0, &y1);
+    if (x0 >= x1) return Qnil;
+
+    for (int row = y0; row < y1; row++) {
+        long b_off = (long)row * gw + x0;
+        long d_off = (long)(gy + row) * (long)v.stride + gx + x0;
+
+        long n = clamp_units(b_off, bmp_len, 1, x1 - x0);
+        n = clamp_units(d_off, v.len, 1, n);
+
+        const uint8_t *m = bmp + b_off;
+        uint8_t       *d = v.data + d_off;
+        for (long i = 0; i < n; i++) {
+            if (m[i] == 0) continue;
+            d[i] = m[i] == 255 ? (uint8_t)l : cw_div255(l * m[i] + d[i] * (255u - m[i]));
+        }
+    }
+
+    RB_GC_GUARD(rb_buf);
+    RB_GC_GUARD(rb_bmp);
+    return Qnil;
+}
+
+/* ---- _gray_to_rgba(buf) ----
+ *
+ * Expands a gray buffer to opaque RGBA (a new String).
+ */
+static VALUE
+gray_to_rgba(VALUE self, VALUE rb_buf)
+{
+    (void)self;
+
+    cw_view_t v;
+    cw_view(rb_buf, 1, 0, 0, &v);
+
+    VALUE rb_out = rb_str_new(NULL, v.rows * v.width * 4);
+    uint8_t *out = (uint8_t *)RSTRING_PTR(rb_out);
+
+    for (long y = 0; y < v.rows; y++) {
+        const uint8_t *src = v.data + y * (long)v.stride;
+        for (long i = 0; i < v.width; i++, out += 4) {
+            out[0] = out[1] = out[2] = src[i];
+            out[3] = 255;
+        }
+    }
+
+    RB_GC_GUARD(rb_buf);
+    return rb_out;
+}
+
+/* ---- IndexedCanvas: one palette index per pixel ----
+ *
+ * Shares byte_clear/byte_load with GrayCanvas. Glyphs cannot blend in
+ * index space, so coverage is thresholded instead.
+ */
+
+/* ---- _indexed_blit_glyph(buf, bitmap, gx, gy, gw, gh, dw, dh, index, threshold) ----
+ *
+ * Writes +index+ wherever the glyph coverage is at least +threshold+
+ * (1..255); the caller folds the colour's alpha into the threshold.
+ */
+static VALUE
+indexed_blit_glyph(int argc, VALUE *argv, VALUE self)
+{
+    (void)self;
+
+    rb_check_arity(argc, 10, 10);
+
+    VALUE rb_buf = argv[0];
+    VALUE rb_bmp = argv[1];
+    Check_Type(rb_bmp, T_STRING);
+
+    int gx = NUM2INT(argv[2]);
+    int gy = NUM2INT(argv[3]);
+    int gw = NUM2INT(argv[4]);
+    int gh = NUM2INT(argv[5]);
+    int dw = NUM2INT(argv[6]);
+    int dh = NUM2INT(argv[7]);
+    uint8_t index = (uint8_t)(NUM2INT(argv[8]) & 0xFF);
+    int threshold = NUM2INT(argv[9]);
+
+    if (gw <= 0 || gh <= 0 || dw <= 0 || dh <= 0) return Qnil;
+    if (threshold < 1) threshold = 1;
+    if (threshold > 255) return Qnil;
+
+    cw_view_t v;
+    cw_view(rb_buf, 1, dw, 1, &v);
+
+    const uint8_t *bmp = (const uint8_t *)RSTRING_PTR(rb_bmp);
+    long bmp_len = RSTRING_LEN(rb_bmp);
+
+    int x0, x1, y0, y1;
+    clip_span(gx, gy, gw, gh, dw, dh, &x0, &x1, &y0, &y1);
+    if (x0 >= x1) return Qnil;
+
+    for (int row = y0; row < y1; row++) {
+        long b_off = (long)row * gw + x0;
+        long d_off = (long)(gy + row) * (long)v.stride + gx + x0;
+
+        long n = clamp_units(b_off, bmp_len, 1, x1 - x0);
+        n = clamp_units(d_off, v.len, 1, n);
+
+        const uint8_t *m = bmp + b_off;
+        uint8_t       *d = v.data + d_off;
+        for (long i = 0; i < n; i++) {
+            if (m[i] >= threshold) d[i] = index;
+        }
+    }
+
+    RB_GC_GUARD(rb_buf);
+    RB_GC_GUARD(rb_bmp);
+    return Qnil;
+}
+
+/*
+ * Redmean distance between two RGB triples (see Palette#nearest_color),
+ * scaled by 512 so it is exact in integers: the float formula only ever
+ * divides by 2 and 256, so the two agree on every comparison and tie.
+ */
+static long
+redmean512(const uint8_t *a, const uint8_t *b)
+{
+    long s  = (long)a[0] + b[0];
+    long dr = (long)a[0] - b[0];
+    long dg = (long)a[1] - b[1];
+    long db = (long)a[2] - b[2];
+
+    return (1024 + s) * dr * dr + 2048 * dg * dg + (1534 - s) * db * db;
+}
+
+/* ---- _indexed_quantize(dst, src, x, y, w, h, dw, lut) ----
+ *
+ * Bulk-loads RGBA rows into a rectangular region of an index buffer,
+ * matching each pixel to the nearest entry of +lut+ (4 bytes per
+ * palette entry) by redmean distance, with alpha ignored. The first
+ * entry wins ties, as in Palette#nearest_color. The last match is
+ * reused for runs of the same color.
+ */
+static VALUE
+indexed_quantize(VALUE self,
+                 VALUE rb_dst, VALUE rb_src,
+                 VALUE rb_x, VALUE rb_y,
+                 VALUE rb_w, VALUE rb_h,
+                 VALUE rb_dw, VALUE rb_lut)
+{
+    (void)self;
+
+    Check_Type(rb_lut, T_STRING);
+
+    int dw = NUM2INT(rb_dw);
+    int x  = NUM2INT(rb_x);
+    int y  = NUM2INT(rb_y);
+    int w  = NUM2INT(rb_w);
+    int h  = NUM2INT(rb_h);
+
+    long entries = RSTRING_LEN(rb_lut) / 4;
+    if (entries < 1 || entries > 256) return Qnil;
+    if (dw <= 0 || dw > EPD_MAX_DIMENSION) return Qnil;
+    if (w <= 0 || h <= 0 || w > EPD_MAX_DIMENSION || h > EPD_MAX_DIMENSION) return Qnil;
+
+    cw_view_t d, s;
+    cw_view(rb_dst, 1, dw, 1, &d);
+    cw_view(rb_src, 4, w, 0, &s);
+
+    int x0, x1, y0, y1;
+    clip_span(x, y, w, h, dw, (int)d.rows, &x0, &x1, &y0, &y1);
+    if (x0 >= x1) return Qnil;
+
+    const uint8_t *lut = (const uint8_t *)RSTRING_PTR(rb_lut);
+    uint32_t last_key = UINT32_MAX;
+    uint8_t  last_index = 0;
+
+    for (int sy = y0; sy < y1; sy++) {
+        long s_off = (long)sy * (long)s.stride + (long)x0 * 4;
+        long d_off = (long)(y + sy) * (long)d.stride + x + x0;
+
+        long n = clamp_units(s_off, s.len, 4, x1 - x0);
+        n = clamp_units(d_off, d.len, 1, n);
+
+        const uint8_t *p = s.data + s_off;
+        uint8_t       *o = d.data + d_off;
+        for (long i = 0; i < n; i++, p += 4) {
+            uint32_t key = (uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2];
+
+            if (key != last_key) {
+                long best = redmean512(p, lut);
+                last_index = 0;
+                for (long e = 1; e < entries; e++) {
+                    long dist = redmean512(p, lut + e * 4);
+                    if (dist < best) {
+                        best = dist;
+                        last_index = (uint8_t)e;
+                    }
+                }
+                last_key = key;
             }
+            o[i] = last_index;
         }
     }
 
+    RB_GC_GUARD(rb_dst);
+    RB_GC_GUARD(rb_src);
+    RB_GC_GUARD(rb_lut);
     return Qnil;
 }
 
+/* ---- _indexed_to_rgba(buf, lut) ----
+ *
+ * Expands indices to RGBA through +lut+ (4 bytes per palette entry;
+ * indices past the table map to transparent black).
+ */
+static VALUE
+indexed_to_rgba(VALUE self, VALUE rb_buf, VALUE rb_lut)
+{
+    (void)self;
+
+    Check_Type(rb_lut, T_STRING);
+
+    cw_view_t v;
+    cw_view(rb_buf, 1, 0, 0, &v);
+
+    long entries = RSTRING_LEN(rb_lut) / 4;
+    VALUE rb_out = rb_str_new(NULL, v.rows * v.width * 4);
+    const uint8_t *lut = (const uint8_t *)RSTRING_PTR(rb_lut);
+    uint8_t       *out = (uint8_t *)RSTRING_PTR(rb_out);
+
+    for (long y = 0; y < v.rows; y++) {
+        const uint8_t *src = v.data + y * (long)v.stride;
+        for (long i = 0; i < v.width; i++, out += 4) {
+            if (src[i] < entries)
+                memcpy(out, lut + (size_t)src[i] * 4, 4);
+            else
+                memset(out, 0, 4);
+        }
+    }
+
+    RB_GC_GUARD(rb_buf);
+    RB_GC_GUARD(rb_lut);
+    return rb_out;
+}
+
+/* ---- Native.simd_backend / simd_backends / simd_backend= ---- */
+
+static VALUE
+native_simd_backend(VALUE self)
+{
+    (void)self;
+    return ID2SYM(rb_intern(cw_blend_backend()));
+}
+
+static VALUE
+native_simd_backends(VALUE self)
+{
+    (void)self;
+    int count = cw_blend_backend_count();
+    VALUE result = rb_ary_new_capa(count);
+
+    for (int i = 0; i < count; i++) {
+        rb_ary_push(result, ID2SYM(rb_intern(cw_blend_backend_name(i))));
+    }
+    return result;
+}
+
+static VALUE
+native_set_simd_backend(VALUE self, VALUE rb_name)
+{
+    (void)self;
+    VALUE name = rb_sym2str(rb_to_symbol(rb_name));
+
+    if (!cw_blend_select(StringValueCStr(name))) {
+        rb_raise(rb_eArgError, "unsupported SIMD backend: %"PRIsVALUE, rb_name);
+    }
+    return rb_name;
+}
+
 /* ---- Init_canvas() ---- */
 void
 Init_canvas(void)
@@ -248,4 +680,26 @@ Init_canvas(void)
     rb_define_private_method(rb_cCanvas, "_canvas_blit_alpha",  canvas_blit_alpha,  8);
     rb_define_private_method(rb_cCanvas, "_canvas_load_rgba",   canvas_load_rgba,   7);
     rb_define_private_method(rb_cCanvas, "_canvas_blit_glyph",  canvas_blit_glyph,  11);
+
+    rb_cGrayCanvas = rb_define_class_under(rb_mChromaWave, "GrayCanvas", rb_cCanvas);
+
+    rb_define_private_method(rb_cGrayCanvas, "_gray_clear",      byte_clear,      2);
+    rb_define_private_method(rb_cGrayCanvas, "_gray_blit_alpha", gray_blit_alpha, 8);
+    rb_define_private_method(rb_cGrayCanvas, "_gray_load",       byte_load,       8);
+    rb_define_private_method(rb_cGrayCanvas, "_gray_blit_glyph", gray_blit_glyph, 9);
+    rb_define_private_method(rb_cGrayCanvas, "_gray_to_rgba",    gray_to_rgba,    1);
+
+    rb_cIndexedCanvas = rb_define_class_under(rb_mChromaWave, "IndexedCanvas", rb_cCanvas);
+
+    rb_define_private_method(rb_cIndexedCanvas, "_indexed_clear",      byte_clear,         2);
+    rb_define_private_method(rb_cIndexedCanvas, "_indexed_load",       byte_load,          8);
+    rb_define_private_method(rb_cIndexedCanvas, "_indexed_blit_glyph", indexed_blit_glyph, -1);
+    rb_define_private_method(rb_cIndexedCanvas, "_indexed_quantize",   indexed_quantize,   8);
+    rb_define_private_method(rb_cIndexedCanvas, "_indexed_to_rgba",    indexed_to_rgba,    2);
+
+    /* Pick the compositing kernels for this CPU once, at load time */
+    cw_blend_init();
+    rb_define_module_function(rb_mChromaWaveNative, "simd_backend",  native_simd_backend,     0);
+    rb_define_module_function(rb_mChromaWaveNative, "simd_backends", native_simd_backends,    0);
+    rb_define_module_function(rb_mChromaWaveNative, "simd_backend=", native_set_simd_backend, 1);
 }
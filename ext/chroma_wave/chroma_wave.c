@@ -1,9 +1,9 @@
 #include "chroma_wave.h"
 
 /* ---- Cached symbol IDs for pixel format conversion ---- */
-static ID id_mono, id_gray4, id_color4, id_color7;
+static ID id_mono, id_gray4, id_color4, id_color7, id_color4_2bpp;
 
-/* Convert a Ruby Symbol (:mono, :gray4, :color4, :color7) to pixel_format_t.
+/* Convert a Ruby Symbol (:mono, :gray4, :color4, :color7, :color4_2bpp) to pixel_format_t.
  * Raises ArgumentError for unrecognized symbols. */
 pixel_format_t
 cw_sym_to_pixel_format(VALUE sym)
@@ -14,10 +14,11 @@ cw_sym_to_pixel_format(VALUE sym)
     if (id == id_gray4)  return PIXEL_FORMAT_GRAY4;
     if (id == id_color4) return PIXEL_FORMAT_COLOR4;
     if (id == id_color7) return PIXEL_FORMAT_COLOR7;
+    if (id == id_color4_2bpp) return PIXEL_FORMAT_COLOR4_2BPP;
 
     rb_raise(rb_eArgError,
              "unknown pixel format: %"PRIsVALUE
-             " (expected :mono, :gray4, :color4, or :color7)",
+             " (expected :mono, :gray4, :color4, :color7, or :color4_2bpp)",
              sym);
     return 0; /* unreachable */
 }
@@ -31,6 +32,7 @@ cw_pixel_format_to_sym(pixel_format_t fmt)
     case PIXEL_FORMAT_GRAY4:  return ID2SYM(id_gray4);
     case PIXEL_FORMAT_COLOR4: return ID2SYM(id_color4);
     case PIXEL_FORMAT_COLOR7: return ID2SYM(id_color7);
+    case PIXEL_FORMAT_COLOR4_2BPP: return ID2SYM(id_color4_2bpp);
     }
     return Qnil; /* unreachable */
 }
@@ -56,6 +58,7 @@ Init_chroma_wave(void)
     id_gray4  = rb_intern("gray4");
     id_color4 = rb_intern("color4");
     id_color7 = rb_intern("color7");
+    id_color4_2bpp = rb_intern("color4_2bpp");
 
     /* Top-level module */
     rb_mChromaWave = rb_define_module("ChromaWave");
@@ -81,8 +84,19 @@ Init_chroma_wave(void)
 
     /* Initialize sub-modules */
     Init_framebuffer();
+    Init_pixel_buffer();
     Init_driver_registry();
     Init_canvas();
     Init_device();
     Init_freetype();
+    Init_bitmap_font();
+    Init_raster();
+    Init_coverage();
+    Init_resample();
+    Init_bitblt();
+    Init_transform();
+    Init_shared_frame();
+    Init_digest();
+    Init_convert();
+    Init_snapshot();
 }
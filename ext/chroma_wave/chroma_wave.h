@@ -10,7 +10,8 @@ typedef enum {
     PIXEL_FORMAT_MONO   = 1,  /* 1bpp, 8 pixels/byte */
     PIXEL_FORMAT_GRAY4  = 2,  /* 2bpp, 4 pixels/byte */
     PIXEL_FORMAT_COLOR4 = 3,  /* 4bpp, 2 pixels/byte (tri-color) */
-    PIXEL_FORMAT_COLOR7 = 4   /* 4bpp, 2 pixels/byte (7-color ACeP) */
+    PIXEL_FORMAT_COLOR7 = 4,  /* 4bpp, 2 pixels/byte (7-color ACeP) */
+    PIXEL_FORMAT_COLOR4_2BPP = 5 /* 2bpp, 4 pixels/byte (4-color "g" panels) */
 } pixel_format_t;
 
 /* Busy pin polarity */
@@ -58,6 +59,8 @@ extern VALUE rb_mChromaWave;
 extern VALUE rb_mChromaWaveNative;
 extern VALUE rb_cFramebuffer;
 extern VALUE rb_cCanvas;
+extern VALUE rb_cGrayCanvas;
+extern VALUE rb_cIndexedCanvas;
 extern VALUE rb_cDevice;
 extern VALUE rb_eChromaWaveError;
 extern VALUE rb_eDeviceError;
@@ -75,11 +78,25 @@ VALUE          cw_pixel_format_to_sym(pixel_format_t fmt);
 /* Font class VALUE (defined by freetype.c) */
 extern VALUE rb_cFont;
 
+/* BitmapFont class VALUE (defined by bitmap_font.c) */
+extern VALUE rb_cBitmapFont;
+
 /* Init functions for sub-modules */
 void Init_framebuffer(void);
+void Init_pixel_buffer(void);
 void Init_driver_registry(void);
 void Init_canvas(void);
 void Init_device(void);
 void Init_freetype(void);
+void Init_bitmap_font(void);
+void Init_raster(void);
+void Init_coverage(void);
+void Init_resample(void);
+void Init_bitblt(void);
+void Init_transform(void);
+void Init_shared_frame(void);
+void Init_digest(void);
+void Init_convert(void);
+void Init_snapshot(void);
 
 #endif /* CHROMA_WAVE_H */
@@ -0,0 +1,151 @@
+#include "bitblt.h"
+
+/*
+ * Conversion of packed framebuffers between pixel formats through a
+ * palette index table, e.g. COLOR4 to the black and red MONO planes of
+ * a tri-color panel, GRAY4 to the two bit planes of a 4-gray waveform,
+ * or MONO to GRAY4 for previews.
+ *
+ * The index table is expanded into a 256-entry table from a source
+ * byte to the target bits of all its pixels (2 to 32 bits), so each
+ * source byte costs one lookup; the bits are streamed into the target
+ * row through a small accumulator. Target row padding bits are left
+ * as they are.
+ *
+ * Expansion to RGB or RGBA bytes (previews, PNG export, editing a frame
+ * as a Canvas) works the same way, with a table from a source byte to
+ * the color bytes of all its pixels.
+ */
+
+/* Checks that into is a framebuffer of src's size */
+static framebuffer_t *
+target_of(VALUE into, const framebuffer_t *src)
+{
+    framebuffer_t *dst;
+
+    if (!rb_typeddata_is_kind_of(into, &framebuffer_type)) {
+        rb_raise(rb_eTypeError, "expected a Framebuffer, got %"PRIsVALUE, rb_obj_class(into));
+    }
+    TypedData_Get_Struct(into, framebuffer_t, &framebuffer_type, dst);
+    if (dst->width != src->width || dst->height != src->height) {
+        rb_raise(rb_eArgError, "target must be a %dx%d framebuffer", src->width, src->height);
+    }
+    return dst;
+}
+
+/* ---- _convert(into, table) ----
+ *
+ * Writes every pixel of self into +into+ (same size, any format) as
+ * table[index], where +table+ is a String of 16 target indices.
+ */
+static VALUE
+fb_convert(VALUE self, VALUE into, VALUE rb_table)
+{
+    framebuffer_t *src;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, src);
+    framebuffer_t *dst = target_of(into, src);
+
+    StringValue(rb_table);
+    if (RSTRING_LEN(rb_table) != 16) {
+        rb_raise(rb_eArgError, "expected a 16-byte index table, got %ld bytes", RSTRING_LEN(rb_table));
+    }
+    const uint8_t *table = (const uint8_t *)RSTRING_PTR(rb_table);
+
+    int sbpp = cw_fb_bits_per_pixel(src), dbpp = cw_fb_bits_per_pixel(dst);
+    int per_byte = 8 / sbpp;
+    int nbits = per_byte * dbpp;
+    uint32_t lut[256];
+
+    for (int v = 0; v < 256; v++) {
+        uint32_t out = 0;
+        for (int k = 0; k < per_byte; k++) {
+            int index = (v >> (8 - (k + 1) * sbpp)) & ((1 << sbpp) - 1);
+            out = (out << dbpp) | (table[index] & ((1u << dbpp) - 1));
+        }
+        lut[v] = out;
+    }
+
+    long pad = (long)dst->width_byte * 8 - (long)dst->width * dbpp;
+    uint8_t keep = (uint8_t)((1u << pad) - 1);
+
+    for (long y = 0; y < dst->height; y++) {
+        const uint8_t *in = src->buffer + (size_t)y * src->width_byte;
+        uint8_t *out = dst->buffer + (size_t)y * dst->width_byte;
+        uint8_t *end = out + dst->width_byte;
+        uint8_t padding = end[-1] & keep;
+        uint64_t acc = 0;
+        int bits = 0;
+
+        for (long i = 0; i < src->width_byte && out < end; i++) {
+            acc = (acc << nbits) | lut[in[i]];
+            bits += nbits;
+            while (bits >= 8 && out < end) {
+                bits -= 8;
+                *out++ = (uint8_t)(acc >> bits);
+            }
+        }
+        /* Source rows may end in fewer padding pixels than target rows */
+        if (out < end) *out = (uint8_t)(acc << (8 - bits));
+        end[-1] = (uint8_t)((end[-1] & ~keep) | padding);
+    }
+
+    cw_fb_touch(dst);
+    RB_GC_GUARD(rb_table);
+    return into;
+}
+
+/* ---- _expand(lut) ----
+ *
+ * Returns the pixels of self as a String of color bytes, row-major
+ * with no padding. +lut+ holds 16 entries of 1 to 4 bytes each, one
+ * per palette index (e.g. RGB or RGBA).
+ */
+static VALUE
+fb_expand(VALUE self, VALUE rb_lut)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+
+    StringValue(rb_lut);
+    long k = RSTRING_LEN(rb_lut) / 16;
+    if (RSTRING_LEN(rb_lut) % 16 != 0 || k < 1 || k > 4) {
+        rb_raise(rb_eArgError, "expected 16 table entries of 1 to 4 bytes, got %ld bytes", RSTRING_LEN(rb_lut));
+    }
+    const uint8_t *lut = (const uint8_t *)RSTRING_PTR(rb_lut);
+
+    int bpp = cw_fb_bits_per_pixel(fb);
+    int per_byte = 8 / bpp;
+    long span = per_byte * k;
+    uint8_t table[256][32];
+
+    for (int v = 0; v < 256; v++) {
+        for (int i = 0; i < per_byte; i++) {
+            int index = (v >> (8 - (i + 1) * bpp)) & ((1 << bpp) - 1);
+            memcpy(table[v] + i * k, lut + index * k, (size_t)k);
+        }
+    }
+
+    long full = fb->width / per_byte, rest = (fb->width % per_byte) * k;
+    VALUE str = rb_str_new(NULL, (long)fb->width * fb->height * k);
+    uint8_t *out = (uint8_t *)RSTRING_PTR(str);
+
+    for (long y = 0; y < fb->height; y++) {
+        const uint8_t *in = fb->buffer + (size_t)y * fb->width_byte;
+        for (long i = 0; i < full; i++, out += span) memcpy(out, table[in[i]], (size_t)span);
+        if (rest) {
+            memcpy(out, table[in[full]], (size_t)rest);
+            out += rest;
+        }
+    }
+
+    RB_GC_GUARD(rb_lut);
+    return str;
+}
+
+/* ---- Init_convert() ---- */
+void
+Init_convert(void)
+{
+    rb_define_private_method(rb_cFramebuffer, "_convert", fb_convert, 2);
+    rb_define_private_method(rb_cFramebuffer, "_expand",  fb_expand,  1);
+}
@@ -0,0 +1,458 @@
+#include "chroma_wave.h"
+#include "ruby/encoding.h"
+#include <math.h>
+
+/*
+ * Anti-aliased path rasterizer.
+ *
+ * Edges are accumulated as signed area into a float buffer, one cell
+ * per pixel plus two guard columns, in the style of font rasterizers
+ * (font-rs, stb_truetype v2): each edge deposits the exact area it
+ * sweeps through the cells of every row it crosses, and a running sum
+ * along each row turns those deltas into coverage. The result is an
+ * 8-bit coverage mask in the same layout as a glyph bitmap, which the
+ * caller composites with the regular glyph path (_canvas_blit_glyph).
+ *
+ * Coverage is min(|winding area|, 1): overlapping contours with the
+ * same orientation saturate, opposite orientations cancel (holes).
+ * Strokes are expanded into convex pieces — one quad per segment plus
+ * join and cap polygons — all emitted with the same orientation so
+ * their overlaps saturate instead of cancelling.
+ */
+
+#define COVERAGE_TOLERANCE  0.1  /* max flattening error of round joins, px */
+#define COVERAGE_MITER_LIMIT 4.0 /* miter length / half width before bevel */
+#define COVERAGE_MAX_ARC    256
+
+enum { JOIN_ROUND, JOIN_MITER, JOIN_BEVEL };
+enum { CAP_BUTT, CAP_ROUND, CAP_SQUARE };
+
+typedef struct {
+    float *a;
+    int    w, h;
+    long   stride; /* w + 2 */
+    double ox, oy; /* surface position of cell (0, 0) */
+} acc_t;
+
+typedef struct {
+    double x, y;
+} vec_t;
+
+/* ---- Edge accumulation ---- */
+
+/* One edge already clamped to 0 <= x <= w, in cell coordinates */
+static void
+acc_edge(acc_t *c, double x0, double y0, double x1, double y1)
+{
+    double dir = 1.0;
+
+    if (y0 == y1) return;
+    if (y0 > y1) {
+        double t;
+        t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+        dir = -1.0;
+    }
+    if (y1 <= 0 || y0 >= c->h) return;
+
+    double dxdy = (x1 - x0) / (y1 - y0);
+    double x = x0;
+    if (y0 < 0) {
+        x -= y0 * dxdy;
+        y0 = 0;
+    }
+
+    int y_end = y1 < c->h ? (int)ceil(y1) : c->h;
+    for (int y = (int)y0; y < y_end; y++) {
+        float *row = c->a + (long)y * c->stride;
+        double dy = ((y + 1) < y1 ? (y + 1) : y1) - (y > y0 ? y : y0);
+        double xnext = x + dxdy * dy;
+        if (xnext < 0) xnext = 0;          /* absorb rounding drift */
+        if (xnext > c->w) xnext = c->w;
+        double d = dy * dir;
+        double xa = x < xnext ? x : xnext;
+        double xb = x < xnext ? xnext : x;
+        double xa_floor = floor(xa);
+        int xa_i = (int)xa_floor;
+        double xb_ceil = ceil(xb);
+        int xb_i = (int)xb_ceil;
+
+        if (xb_i <= xa_i + 1) {
+            double xmf = 0.5 * (x + xnext) - xa_floor;
+            row[xa_i]     += (float)(d - d * xmf);
+            row[xa_i + 1] += (float)(d * xmf);
+        } else {
+            double s = 1.0 / (xb - xa);
+            double xa_f = xa - xa_floor;
+            double a0 = 0.5 * s * (1.0 - xa_f) * (1.0 - xa_f);
+            double xb_f = xb - xb_ceil + 1.0;
+            double am = 0.5 * s * xb_f * xb_f;
+
+            row[xa_i] += (float)(d * a0);
+            if (xb_i == xa_i + 2) {
+                row[xa_i + 1] += (float)(d * (1.0 - a0 - am));
+            } else {
+                double a1 = s * (1.5 - xa_f);
+                row[xa_i + 1] += (float)(d * (a1 - a0));
+                for (int xi = xa_i + 2; xi < xb_i - 1; xi++) {
+                    row[xi] += (float)(d * s);
+                }
+                double a2 = a1 + (double)(xb_i - xa_i - 3) * s;
+                row[xb_i - 1] += (float)(d * (1.0 - a2 - am));
+            }
+            row[xb_i] += (float)(d * am);
+        }
+        x = xnext;
+    }
+}
+
+/* Adds a surface-space edge. Parts left of the mask are projected onto
+ * x = 0 and parts right of it onto x = w, which leaves the winding of
+ * every visible cell unchanged. */
+static void
+acc_line(acc_t *c, double x0, double y0, double x1, double y1)
+{
+    x0 -= c->ox; x1 -= c->ox;
+    y0 -= c->oy; y1 -= c->oy;
+    if (y0 == y1) return;
+
+    double ts[4] = { 0.0, 0.0, 0.0, 1.0 };
+    int n = 1;
+    double bounds[2] = { 0.0, (double)c->w };
+
+    for (int i = 0; i < 2; i++) {
+        double b = bounds[i];
+        if ((x0 < b && x1 > b) || (x0 > b && x1 < b)) ts[n++] = (b - x0) / (x1 - x0);
+    }
+    if (n == 3 && ts[1] > ts[2]) {
+        double t = ts[1]; ts[1] = ts[2]; ts[2] = t;
+    }
+    ts[n] = 1.0;
+
+    double px = x0, py = y0;
+    for (int i = 1; i <= n; i++) {
+        double qx = i == n ? x1 : x0 + (x1 - x0) * ts[i];
+        double qy = i == n ? y1 : y0 + (y1 - y0) * ts[i];
+        double mid = 0.5 * (px + qx);
+        double cx = mid < 0 ? 0 : (mid > c->w ? c->w : -1);
+
+        if (cx >= 0)
+            acc_edge(c, cx, py, cx, qy);
+        else
+            acc_edge(c, px < 0 ? 0 : (px > c->w ? c->w : px), py,
+                     qx < 0 ? 0 : (qx > c->w ? c->w : qx), qy);
+        px = qx;
+        py = qy;
+    }
+}
+
+/* Emits a closed polygon; with +orient+ it is first flipped if needed
+ * so that its signed area is positive. */
+static void
+acc_polygon(acc_t *c, const vec_t *p, int n, int orient)
+{
+    int reverse = 0;
+
+    if (orient) {
+        double area = 0;
+        for (int i = 0; i < n; i++) {
+            const vec_t *a = &p[i], *b = &p[(i + 1) % n];
+            area += a->x * b->y - b->x * a->y;
+        }
+        if (area == 0) return;
+        reverse = area < 0;
+    }
+
+    for (int i = 0; i < n; i++) {
+        const vec_t *a = &p[i], *b = &p[(i + 1) % n];
+        if (reverse)
+            acc_line(c, b->x, b->y, a->x, a->y);
+        else
+            acc_line(c, a->x, a->y, b->x, b->y);
+    }
+}
+
+/* ---- Stroke expansion ---- */
+
+static void
+acc_disc(acc_t *c, vec_t p, double r)
+{
+    vec_t pts[COVERAGE_MAX_ARC];
+    int n = 8;
+
+    if (r > COVERAGE_TOLERANCE) {
+        double step = 2.0 * acos(1.0 - COVERAGE_TOLERANCE / r);
+        n = (int)ceil(2.0 * M_PI / step);
+    }
+    if (n < 8) n = 8;
+    if (n > COVERAGE_MAX_ARC) n = COVERAGE_MAX_ARC;
+
+    for (int i = 0; i < n; i++) {
+        double a = 2.0 * M_PI * i / n;
+        pts[i].x = p.x + r * cos(a);
+        pts[i].y = p.y + r * sin(a);
+    }
+    acc_polygon(c, pts, n, 1);
+}
+
+/* Quad covering the segment p..q (unit direction d) at half width hw */
+static void
+acc_segment(acc_t *c, vec_t p, vec_t q, vec_t d, double hw)
+{
+    vec_t n = { -d.y * hw, d.x * hw };
+    vec_t quad[4] = {
+        { p.x + n.x, p.y + n.y }, { q.x + n.x, q.y + n.y },
+        { q.x - n.x, q.y - n.y }, { p.x - n.x, p.y - n.y },
+    };
+    acc_polygon(c, quad, 4, 1);
+}
+
+/* Cap at endpoint p, with d the unit direction pointing out of the line */
+static void
+acc_cap(acc_t *c, vec_t p, vec_t d, double hw, int cap)
+{
+    if (cap == CAP_ROUND) {
+        acc_disc(c, p, hw);
+    } else if (cap == CAP_SQUARE) {
+        vec_t q = { p.x + d.x * hw, p.y + d.y * hw };
+        acc_segment(c, p, q, d, hw);
+    }
+}
+
+/* Join at vertex p between incoming direction d0 and outgoing d1 */
+static void
+acc_join(acc_t *c, vec_t p, vec_t d0, vec_t d1, double hw, int join)
+{
+    double cross = d0.x * d1.y - d0.y * d1.x;
+    double dot = d0.x * d1.x + d0.y * d1.y;
+
+    if (fabs(cross) < 1e-9 && dot > 0) return; /* straight through */
+    if (join == JOIN_ROUND) {
+        acc_disc(c, p, hw);
+        return;
+    }
+
+    /* Normals point left of travel; the gap opens on the outer side */
+    double s = cross > 0 ? -hw : hw;
+    vec_t n0 = { -d0.y, d0.x }, n1 = { -d1.y, d1.x };
+    vec_t o0 = { p.x + n0.x * s, p.y + n0.y * s };
+    vec_t o1 = { p.x + n1.x * s, p.y + n1.y * s };
+    vec_t m = { n0.x + n1.x, n0.y + n1.y };
+    double mlen = hypot(m.x, m.y);
+
+    if (join == JOIN_MITER && mlen > 1e-9) {
+        double cos_half = mlen / 2.0;
+        if (1.0 / cos_half <= COVERAGE_MITER_LIMIT) {
+            double k = s / (cos_half * mlen);
+            vec_t quad[4] = { p, o0, { p.x + m.x * k, p.y + m.y * k }, o1 };
+            acc_polygon(c, quad, 4, 1);
+            return;
+        }
+    }
+
+    vec_t tri[3] = { p, o0, o1 };
+    acc_polygon(c, tri, 3, 1);
+}
+
+static vec_t
+unit(vec_t a, vec_t b)
+{
+    double len = hypot(b.x - a.x, b.y - a.y);
+    vec_t d = { (b.x - a.x) / len, (b.y - a.y) / len };
+    return d;
+}
+
+/* Strokes n points with consecutive duplicates already removed */
+static void
+acc_stroke(acc_t *c, const vec_t *p, long n, int closed, double hw, int join, int cap)
+{
+    if (n == 1) {
+        if (cap == CAP_ROUND) {
+            acc_disc(c, p[0], hw);
+        } else if (cap == CAP_SQUARE) {
+            vec_t d = { 1.0, 0.0 };
+            vec_t a = { p[0].x - hw, p[0].y }, b = { p[0].x + hw, p[0].y };
+            acc_segment(c, a, b, d, hw);
+        }
+        return;
+    }
+    if (n == 2) closed = 0;
+
+    long segs = closed ? n : n - 1;
+    for (long i = 0; i < segs; i++) {
+        vec_t a = p[i], b = p[(i + 1) % n];
+        acc_segment(c, a, b, unit(a, b), hw);
+    }
+
+    for (long i = closed ? 0 : 1; i < (closed ? n : n - 1); i++) {
+        vec_t prev = p[(i + n - 1) % n], cur = p[i], next = p[(i + 1) % n];
+        acc_join(c, cur, unit(prev, cur), unit(cur, next), hw, join);
+    }
+
+    if (!closed) {
+        acc_cap(c, p[0], unit(p[1], p[0]), hw, cap);
+        acc_cap(c, p[n - 1], unit(p[n - 2], p[n - 1]), hw, cap);
+    }
+}
+
+/* ---- Contour decoding ---- */
+
+typedef struct {
+    const char *data;
+    long        n;      /* points */
+    int         closed;
+} contour_t;
+
+static contour_t
+contour_at(VALUE contours, long i)
+{
+    VALUE entry = rb_ary_entry(contours, i);
+    Check_Type(entry, T_ARRAY);
+
+    /* No to_str conversion: both passes must see the same points */
+    VALUE coords = rb_ary_entry(entry, 0);
+    Check_Type(coords, T_STRING);
+
+    contour_t ct = {
+        .data   = RSTRING_PTR(coords),
+        .n      = RSTRING_LEN(coords) / (long)(2 * sizeof(double)),
+        .closed = RTEST(rb_ary_entry(entry, 1)),
+    };
+    return ct;
+}
+
+static vec_t
+contour_point(const contour_t *ct, long i)
+{
+    double xy[2];
+    memcpy(xy, ct->data + i * (long)sizeof(xy), sizeof(xy));
+    vec_t v = { xy[0], xy[1] };
+    return v;
+}
+
+/* ---- Native.rasterize_path(contours, clip_w, clip_h, alpha, stroke) ----
+ *
+ * contours – Array of [coords, closed] pairs; coords packs x, y doubles
+ *            in native byte order (Array#pack('d*'))
+ * clip_w/h – surface size; the mask is clipped to 0...clip_w, 0...clip_h
+ * alpha    – colour alpha (0–255) folded into the coverage
+ * stroke   – nil to fill, or [width, join, cap] with join 0/1/2 =
+ *            round/miter/bevel and cap 0/1/2 = butt/round/square
+ *
+ * Returns [mask, x, y, width, height] — mask is one coverage byte per
+ * pixel, row-major — or nil when nothing is visible.
+ */
+static VALUE
+native_rasterize_path(VALUE self, VALUE contours, VALUE rb_clip_w, VALUE rb_clip_h,
+                      VALUE rb_alpha, VALUE stroke)
+{
+    (void)self;
+
+    Check_Type(contours, T_ARRAY);
+    int clip_w = NUM2INT(rb_clip_w);
+    int clip_h = NUM2INT(rb_clip_h);
+    int alpha  = NUM2INT(rb_alpha);
+    if (clip_w <= 0 || clip_h <= 0 || clip_w > EPD_MAX_DIMENSION || clip_h > EPD_MAX_DIMENSION)
+        return Qnil;
+    if (alpha <= 0) return Qnil;
+    if (alpha > 255) alpha = 255;
+
+    double hw = 0.0;
+    int join = JOIN_ROUND, cap = CAP_BUTT;
+    if (!NIL_P(stroke)) {
+        Check_Type(stroke, T_ARRAY);
+        hw   = NUM2DBL(rb_ary_entry(stroke, 0)) / 2.0;
+        join = NUM2INT(rb_ary_entry(stroke, 1));
+        cap  = NUM2INT(rb_ary_entry(stroke, 2));
+        if (!(hw > 0)) return Qnil;
+    }
+
+    /* Bounding box of the geometry, grown by the stroke's reach */
+    double min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+    long total = 0;
+    for (long i = 0; i < RARRAY_LEN(contours); i++) {
+        contour_t ct = contour_at(contours, i);
+        for (long j = 0; j < ct.n; j++) {
+            vec_t v = contour_point(&ct, j);
+            if (!isfinite(v.x) || !isfinite(v.y))
+                rb_raise(rb_eArgError, "path coordinates must be finite");
+            if (v.x < min_x) min_x = v.x;
+            if (v.x > max_x) max_x = v.x;
+            if (v.y < min_y) min_y = v.y;
+            if (v.y > max_y) max_y = v.y;
+        }
+        if (ct.n > total) total = ct.n;
+    }
+    if (total == 0) return Qnil;
+
+    double reach = hw;
+    if (!NIL_P(stroke)) {
+        if (join == JOIN_MITER) reach = hw * COVERAGE_MITER_LIMIT;
+        else if (cap == CAP_SQUARE) reach = hw * M_SQRT2;
+    }
+
+    double fx0 = floor(min_x - reach), fy0 = floor(min_y - reach);
+    double fx1 = ceil(max_x + reach) + 1, fy1 = ceil(max_y + reach) + 1;
+    if (fx0 >= clip_w || fy0 >= clip_h || fx1 <= 0 || fy1 <= 0) return Qnil;
+
+    /* Clamp before casting: far-off coordinates do not fit in an int */
+    int x0 = (int)fmax(fx0, 0), y0 = (int)fmax(fy0, 0);
+    int x1 = (int)fmin(fx1, clip_w), y1 = (int)fmin(fy1, clip_h);
+    if (x0 >= x1 || y0 >= y1) return Qnil;
+
+    acc_t c = { .w = x1 - x0, .h = y1 - y0, .stride = x1 - x0 + 2, .ox = x0, .oy = y0 };
+    VALUE acc_tmp, pts_tmp;
+    c.a = ALLOCV_N(float, acc_tmp, (size_t)(c.stride * c.h));
+    memset(c.a, 0, sizeof(float) * (size_t)(c.stride * c.h));
+    vec_t *pts = ALLOCV_N(vec_t, pts_tmp, (size_t)total);
+
+    for (long i = 0; i < RARRAY_LEN(contours); i++) {
+        contour_t ct = contour_at(contours, i);
+        long n = 0;
+
+        for (long j = 0; j < ct.n; j++) {
+            vec_t v = contour_point(&ct, j);
+            if (n > 0 && v.x == pts[n - 1].x && v.y == pts[n - 1].y) continue;
+            pts[n++] = v;
+        }
+        if (n > 1 && ct.closed && pts[0].x == pts[n - 1].x && pts[0].y == pts[n - 1].y) n--;
+        if (n == 0) continue;
+
+        if (NIL_P(stroke)) {
+            if (n >= 3) acc_polygon(&c, pts, (int)n, 0);
+        } else {
+            acc_stroke(&c, pts, n, ct.closed, hw, join, cap);
+        }
+    }
+
+    VALUE mask = rb_str_new(NULL, (long)c.w * c.h);
+    rb_enc_associate(mask, rb_ascii8bit_encoding());
+    uint8_t *out = (uint8_t *)RSTRING_PTR(mask);
+    int visible = 0;
+
+    for (int y = 0; y < c.h; y++) {
+        const float *row = c.a + (long)y * c.stride;
+        float sum = 0;
+        for (int x = 0; x < c.w; x++) {
+            sum += row[x];
+            float cov = fabsf(sum);
+            if (cov > 1.0f) cov = 1.0f;
+            uint8_t v = (uint8_t)(cov * (float)alpha + 0.5f);
+            out[(long)y * c.w + x] = v;
+            visible |= v;
+        }
+    }
+
+    ALLOCV_END(pts_tmp);
+    ALLOCV_END(acc_tmp);
+    if (!visible) return Qnil;
+
+    return rb_ary_new_from_args(5, mask, INT2NUM(x0), INT2NUM(y0), INT2NUM(c.w), INT2NUM(c.h));
+}
+
+/* ---- Init_coverage() ---- */
+void
+Init_coverage(void)
+{
+    rb_define_module_function(rb_mChromaWaveNative, "rasterize_path", native_rasterize_path, 5);
+}
@@ -349,23 +349,27 @@ display_dual_without_gvl(void *arg)
         if (rc != EPD_OK) { args->result = rc; return NULL; }
     }
 
-    /* Send black channel via primary display command */
-    epd_send_command(cfg->display_cmd);
-    epd_send_data_bulk(args->black_buf, args->black_len);
-
-    /* Check cancellation between buffer sends */
-    if (cancel_flag && *cancel_flag) {
-        args->result = EPD_ERR_TIMEOUT;
-        return NULL;
-    }
+    if (drv && drv->custom_display_dual) {
+        args->result = drv->custom_display_dual(cfg, args->black_buf, args->black_len,
+                                                args->red_buf, args->red_len);
+        if (args->result != EPD_OK) return NULL;
+    } else {
+        /* Send black channel via primary display command */
+        epd_send_command(cfg->display_cmd);
+        epd_send_data_bulk(args->black_buf, args->black_len);
+
+        /* Check cancellation between buffer sends */
+        if (cancel_flag && *cancel_flag) {
+            args->result = EPD_ERR_TIMEOUT;
+            return NULL;
+        }
 
-    /* Send red/yellow channel via secondary display command */
-    if (cfg->display_cmd_2 != 0x00) {
+        /* Send red/yellow channel via secondary display command */
         epd_send_command(cfg->display_cmd_2);
         epd_send_data_bulk(args->red_buf, args->red_len);
-    }
 
-    args->result = EPD_OK;
+        args->result = EPD_OK;
+    }
 
     /* Post-display hook */
     if (drv && drv->post_display) {
@@ -395,6 +399,11 @@ device_epd_display_dual(VALUE self, VALUE rb_black_fb, VALUE rb_red_fb)
     TypedData_Get_Struct(rb_black_fb, framebuffer_t, &framebuffer_type, black_fb);
     TypedData_Get_Struct(rb_red_fb,   framebuffer_t, &framebuffer_type, red_fb);
 
+    /* The second plane would otherwise be dropped without a word */
+    if (!epd_supports_dual_display(dev->config)) {
+        rb_raise(rb_eDeviceError, "%s has no second display command", dev->config->name);
+    }
+
     /* Prepare args for non-GVL execution */
     args.dev       = dev;
     args.black_buf = black_fb->buffer;
@@ -540,13 +549,14 @@ device_epd_sleep(VALUE self)
 /* ---- Clear helpers ---- */
 
 /* Returns bytes per row for the given width and pixel format.
- * Mirrors framebuffer.c calc_width_byte(). */
+ * Mirrors framebuffer.c cw_fb_width_byte(). */
 static uint16_t
 clear_width_byte(uint16_t width, pixel_format_t fmt)
 {
     switch (fmt) {
     case PIXEL_FORMAT_MONO:   return (uint16_t)((width + 7) / 8);
-    case PIXEL_FORMAT_GRAY4:  return (uint16_t)((width + 3) / 4);
+    case PIXEL_FORMAT_GRAY4:
+    case PIXEL_FORMAT_COLOR4_2BPP: return (uint16_t)((width + 3) / 4);
     case PIXEL_FORMAT_COLOR4:
     case PIXEL_FORMAT_COLOR7: return (uint16_t)((width + 1) / 2);
     default:                  return (uint16_t)((width + 7) / 8);
@@ -561,7 +571,8 @@ clear_width_byte(uint16_t width, pixel_format_t fmt)
  *   COLOR4 -- 4bpp, white=palette index 1, two pixels/byte: 0x11
  *             (Palette order: black=0, white=1, red/yellow=2, ...)
  *   COLOR7 -- 4bpp, white=palette index 1, two pixels/byte: 0x11
- *             (ACeP order: black=0, white=1, green=2, blue=3, ...) */
+ *             (ACeP order: black=0, white=1, green=2, blue=3, ...)
+ *   COLOR4_2BPP -- 2bpp, white=palette index 1, four pixels/byte: 0x55 */
 static uint8_t
 clear_fill_byte(pixel_format_t fmt)
 {
@@ -570,6 +581,7 @@ clear_fill_byte(pixel_format_t fmt)
     case PIXEL_FORMAT_GRAY4:  return 0xFF;
     case PIXEL_FORMAT_COLOR4: return 0x11;
     case PIXEL_FORMAT_COLOR7: return 0x11;
+    case PIXEL_FORMAT_COLOR4_2BPP: return 0x55;
     default:                  return 0xFF;
     }
 }
@@ -0,0 +1,199 @@
+#include "bitblt.h"
+
+/*
+ * Content digests of packed framebuffers, for telling cheaply whether a
+ * frame (or part of one) changed since it was last sent to the panel.
+ *
+ * The hash is a wyhash-style multiply-fold: 16 bytes per step, each
+ * pair of 64-bit words xored with constants and multiplied into a
+ * 128-bit product whose halves are folded together, with three
+ * independent lanes over long inputs. Words are read little-endian, so
+ * digests are the same on every host. Results keep 62 bits, which are
+ * Fixnums on 64-bit Rubies. This is a change detector, not a
+ * cryptographic hash.
+ *
+ * Digests cover the raw buffer including row padding, like ==. The
+ * whole-frame digest is cached in the framebuffer until the next write
+ * (cw_fb_touch); digests of mapped framebuffers, which other processes
+ * write, are never cached.
+ */
+
+static const uint64_t K0 = 0xa0761d6478bd642fULL;
+static const uint64_t K1 = 0xe7037ed1a0b428dbULL;
+static const uint64_t K2 = 0x8ebc6af09c88c6e3ULL;
+static const uint64_t K3 = 0x589965cc75374cc3ULL;
+
+#define DIGEST_MASK ((1ULL << 62) - 1)
+
+/* Full 64x64 -> 128-bit product of *a and *b: low half into *a, high into *b */
+static inline void
+mum(uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), lo = t + (rm1 << 32);
+    uint64_t c = (t < rl) + (lo < t);
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t
+mix(uint64_t a, uint64_t b)
+{
+    mum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t
+read64(const uint8_t *p)
+{
+    return (uint64_t)p[0]       | (uint64_t)p[1] << 8  | (uint64_t)p[2] << 16 |
+           (uint64_t)p[3] << 24 | (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 |
+           (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+static inline uint64_t
+read32(const uint8_t *p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24;
+}
+
+static uint64_t
+hash_bytes(const uint8_t *p, size_t len, uint64_t seed)
+{
+    uint64_t a, b;
+    size_t i = len;
+
+    seed ^= mix(seed ^ K0, K1);
+    if (i <= 16) {
+        if (i >= 4) {
+            size_t mid = (i >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + mid);
+            b = (read32(p + i - 4) << 32) | read32(p + i - 4 - mid);
+        } else if (i > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[i >> 1] << 8) | p[i - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        if (i > 48) {
+            uint64_t s1 = seed, s2 = seed;
+            do {
+                seed = mix(read64(p) ^ K1,      read64(p + 8)  ^ seed);
+                s1   = mix(read64(p + 16) ^ K2, read64(p + 24) ^ s1);
+                s2   = mix(read64(p + 32) ^ K3, read64(p + 40) ^ s2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= s1 ^ s2;
+        }
+        while (i > 16) {
+            seed = mix(read64(p) ^ K1, read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        /* The last 16 bytes, overlapping bytes already hashed */
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+
+    a ^= K1;
+    b ^= seed;
+    mum(&a, &b);
+    return mix(a ^ K0 ^ len, b ^ K1);
+}
+
+/* Digest of the whole frame, cached until the next write */
+uint64_t
+cw_fb_digest(framebuffer_t *fb)
+{
+    if (fb->mapping || fb->digest_generation != fb->generation + 1) {
+        uint64_t seed = ((uint64_t)fb->width << 32) | ((uint64_t)fb->height << 8) | fb->pixel_format;
+        fb->digest = hash_bytes(fb->buffer, fb->buffer_size, seed) & DIGEST_MASK;
+        fb->digest_generation = fb->generation + 1;
+    }
+    return fb->digest;
+}
+
+/* ---- digest ---- */
+static VALUE
+fb_digest(VALUE self)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+    return ULL2NUM(cw_fb_digest(fb));
+}
+
+/* ---- _tile_digests(tile_width, tile_height) ----
+ *
+ * Digests of the frame cut into tiles, as an Array of rows of tiles.
+ * The tile width must be a multiple of 8 pixels (so that tiles start
+ * on a byte in every format) unless it spans the whole width; the
+ * tiles of the last row and column are cut short by the frame edges.
+ */
+static VALUE
+fb_tile_digests(VALUE self, VALUE rb_tw, VALUE rb_th)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+
+    long tw = NUM2LONG(rb_tw), th = NUM2LONG(rb_th);
+    if (tw <= 0 || th <= 0) {
+        rb_raise(rb_eArgError, "tile size must be positive, got %ldx%ld", tw, th);
+    }
+    if (tw < fb->width && tw % 8 != 0) {
+        rb_raise(rb_eArgError, "tile width must be a multiple of 8 pixels, got %ld", tw);
+    }
+    if (tw > fb->width) tw = fb->width;
+    if (th > fb->height) th = fb->height;
+
+    long tile_bytes = tw * cw_fb_bits_per_pixel(fb) / 8;
+    if (tw == fb->width) tile_bytes = fb->width_byte;
+    long cols = (fb->width_byte + tile_bytes - 1) / tile_bytes;
+
+    VALUE tmp;
+    uint8_t *scratch = ALLOCV(tmp, (size_t)tile_bytes * th);
+    VALUE rows = rb_ary_new_capa((fb->height + th - 1) / th);
+
+    for (long y0 = 0; y0 < fb->height; y0 += th) {
+        long h = y0 + th > fb->height ? fb->height - y0 : th;
+        VALUE row = rb_ary_new_capa(cols);
+        for (long c = 0; c < cols; c++) {
+            long x0 = c * tile_bytes;
+            long n = x0 + tile_bytes > fb->width_byte ? fb->width_byte - x0 : tile_bytes;
+            for (long k = 0; k < h; k++) {
+                memcpy(scratch + k * n, fb->buffer + (size_t)(y0 + k) * fb->width_byte + x0, (size_t)n);
+            }
+            rb_ary_push(row, ULL2NUM(hash_bytes(scratch, (size_t)(n * h), (uint64_t)n) & DIGEST_MASK));
+        }
+        rb_ary_push(rows, rb_ary_freeze(row));
+    }
+
+    ALLOCV_END(tmp);
+    return rb_ary_freeze(rows);
+}
+
+/* ---- _generation: changes with every write to the pixels ---- */
+static VALUE
+fb_generation(VALUE self)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+    return ULL2NUM(fb->generation);
+}
+
+/* ---- Init_digest() ---- */
+void
+Init_digest(void)
+{
+    rb_define_method(rb_cFramebuffer, "digest", fb_digest, 0);
+    rb_define_private_method(rb_cFramebuffer, "_tile_digests", fb_tile_digests, 2);
+    rb_define_private_method(rb_cFramebuffer, "_generation",   fb_generation,   0);
+}
@@ -1558,7 +1558,7 @@ static const epd_model_config_t epd_model_configs[] = {
         .name = "epd_1in64g",
         .width = 168,
         .height = 168,
-        .pixel_format = PIXEL_FORMAT_COLOR4,
+        .pixel_format = PIXEL_FORMAT_COLOR4_2BPP,
         .busy_polarity = BUSY_ACTIVE_HIGH,
         .reset_ms = {20, 1, 20},
         .display_cmd = 0x10,
@@ -1748,7 +1748,7 @@ static const epd_model_config_t epd_model_configs[] = {
         .name = "epd_2in13g",
         .width = 122,
         .height = 250,
-        .pixel_format = PIXEL_FORMAT_COLOR4,
+        .pixel_format = PIXEL_FORMAT_COLOR4_2BPP,
         .busy_polarity = BUSY_ACTIVE_HIGH,
         .reset_ms = {200, 2, 200},
         .display_cmd = 0x10,
@@ -1786,7 +1786,7 @@ static const epd_model_config_t epd_model_configs[] = {
         .name = "epd_2in15g",
         .width = 160,
         .height = 296,
-        .pixel_format = PIXEL_FORMAT_COLOR4,
+        .pixel_format = PIXEL_FORMAT_COLOR4_2BPP,
         .busy_polarity = BUSY_ACTIVE_LOW,
         .reset_ms = {200, 2, 200},
         .display_cmd = 0x10,
@@ -1805,7 +1805,7 @@ static const epd_model_config_t epd_model_configs[] = {
         .name = "epd_2in36g",
         .width = 168,
         .height = 296,
-        .pixel_format = PIXEL_FORMAT_COLOR4,
+        .pixel_format = PIXEL_FORMAT_COLOR4_2BPP,
         .busy_polarity = BUSY_ACTIVE_HIGH,
         .reset_ms = {20, 2, 20},
         .display_cmd = 0x10,
@@ -1862,7 +1862,7 @@ static const epd_model_config_t epd_model_configs[] = {
         .name = "epd_2in66g",
         .width = 184,
         .height = 360,
-        .pixel_format = PIXEL_FORMAT_COLOR4,
+        .pixel_format = PIXEL_FORMAT_COLOR4_2BPP,
         .busy_polarity = BUSY_ACTIVE_HIGH,
         .reset_ms = {20, 2, 20},
         .display_cmd = 0x10,
@@ -2090,7 +2090,7 @@ static const epd_model_config_t epd_model_configs[] = {
         .name = "epd_3in0g",
         .width = 168,
         .height = 400,
-        .pixel_format = PIXEL_FORMAT_COLOR4,
+        .pixel_format = PIXEL_FORMAT_COLOR4_2BPP,
         .busy_polarity = BUSY_ACTIVE_HIGH,
         .reset_ms = {20, 2, 20},
         .display_cmd = 0x10,
@@ -2299,7 +2299,7 @@ static const epd_model_config_t epd_model_configs[] = {
         .name = "epd_4in37g",
         .width = 512,
         .height = 368,
-        .pixel_format = PIXEL_FORMAT_COLOR4,
+        .pixel_format = PIXEL_FORMAT_COLOR4_2BPP,
         .busy_polarity = BUSY_ACTIVE_HIGH,
         .reset_ms = {20, 2, 20},
         .display_cmd = 0x10,
@@ -2375,7 +2375,7 @@ static const epd_model_config_t epd_model_configs[] = {
         .name = "epd_5in79g",
         .width = 792,
         .height = 272,
-        .pixel_format = PIXEL_FORMAT_COLOR4,
+        .pixel_format = PIXEL_FORMAT_COLOR4_2BPP,
         .busy_polarity = BUSY_ACTIVE_HIGH,
         .reset_ms = {20, 2, 20},
         .display_cmd = 0x24,
@@ -2527,7 +2527,7 @@ static const epd_model_config_t epd_model_configs[] = {
         .name = "epd_7in3g",
         .width = 800,
         .height = 480,
-        .pixel_format = PIXEL_FORMAT_COLOR4,
+        .pixel_format = PIXEL_FORMAT_COLOR4_2BPP,
         .busy_polarity = BUSY_ACTIVE_HIGH,
         .reset_ms = {20, 2, 20},
         .display_cmd = 0x10,
@@ -19,6 +19,7 @@ static const char *tier2_model_names[] = {
     "epd_1in54",
     "epd_1in64g",
     "epd_2in13",
+    "epd_2in13g",
     "epd_2in15g",
     "epd_2in36g",
     "epd_2in7",
@@ -61,6 +62,7 @@ tier2_resolve_configs(void)
         tier2_drivers[i].config                = epd_find_config(tier2_model_names[i]);
         tier2_drivers[i].custom_init           = NULL;
         tier2_drivers[i].custom_display        = NULL;
+        tier2_drivers[i].custom_display_dual   = NULL;
         tier2_drivers[i].pre_display           = NULL;
         tier2_drivers[i].post_display          = NULL;
         tier2_drivers[i].custom_display_region = NULL;
@@ -358,6 +360,18 @@ epd_find_driver(const char *name)
     return NULL;
 }
 
+/* Whether the model can take two planes in one refresh: through its
+ * second display command, or a Tier 2 dual display override */
+int
+epd_supports_dual_display(const epd_model_config_t *cfg)
+{
+    const epd_driver_t *drv;
+
+    if (cfg->display_cmd_2 != 0x00) return 1;
+    drv = epd_find_driver(cfg->name);
+    return drv && drv->custom_display_dual;
+}
+
 size_t
 epd_model_count(void)
 {
@@ -443,6 +457,8 @@ rb_model_config(VALUE self, VALUE rb_name)
                  UINT2NUM(cfg->display_cmd));
     rb_hash_aset(hash, ID2SYM(rb_intern("display_cmd_2")),
                  UINT2NUM(cfg->display_cmd_2));
+    rb_hash_aset(hash, ID2SYM(rb_intern("dual_display")),
+                 epd_supports_dual_display(cfg) ? Qtrue : Qfalse);
     rb_hash_aset(hash, ID2SYM(rb_intern("sleep_cmd")),
                  UINT2NUM(cfg->sleep_cmd));
     rb_hash_aset(hash, ID2SYM(rb_intern("sleep_data")),
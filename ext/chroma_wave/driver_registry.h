@@ -32,6 +32,9 @@ typedef struct epd_driver {
     int  (*custom_init)(const epd_model_config_t *cfg, uint8_t mode);
     int  (*custom_display)(const epd_model_config_t *cfg,
                            const uint8_t *buf, size_t len);
+    int  (*custom_display_dual)(const epd_model_config_t *cfg,
+                                const uint8_t *buf, size_t len,
+                                const uint8_t *buf_2, size_t len_2);
     int  (*pre_display)(const epd_model_config_t *cfg,
                         volatile int *cancel_flag);
     int  (*post_display)(const epd_model_config_t *cfg,
@@ -57,6 +60,7 @@ void epd_generic_sleep(const epd_model_config_t *cfg);
 /* Registry lookup */
 const epd_model_config_t *epd_find_config(const char *name);
 const epd_driver_t       *epd_find_driver(const char *name);
+int                       epd_supports_dual_display(const epd_model_config_t *cfg);
 size_t                     epd_model_count(void);
 const epd_model_config_t *epd_model_at(size_t index);
 
@@ -172,4 +172,12 @@ end
 
 # rubocop:enable Style/GlobalVars
 
+# ── Aligned allocation (Canvas pixel storage; falls back to malloc) ──
+
+have_func('posix_memalign', 'stdlib.h')
+
+# ── Memory-mapped files (optional — zero-copy baked font loading) ──
+
+have_header('sys/mman.h')
+
 create_makefile('chroma_wave/chroma_wave')
@@ -1,28 +1,49 @@
 #include "framebuffer.h"
+#include "pixel_buffer.h"
 #include "ruby/encoding.h"
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
 /* ---- Helper: calculate bytes per row ---- */
-static uint16_t
-calc_width_byte(uint16_t width, pixel_format_t fmt)
+uint16_t
+cw_fb_width_byte(uint16_t width, pixel_format_t fmt)
 {
     switch (fmt) {
     case PIXEL_FORMAT_MONO:   return (uint16_t)((width + 7) / 8);
-    case PIXEL_FORMAT_GRAY4:  return (uint16_t)((width + 3) / 4);
+    case PIXEL_FORMAT_GRAY4:  /* fall through */
+    case PIXEL_FORMAT_COLOR4_2BPP: return (uint16_t)((width + 3) / 4);
     case PIXEL_FORMAT_COLOR4: /* fall through */
     case PIXEL_FORMAT_COLOR7: return (uint16_t)((width + 1) / 2);
     }
     return 0; /* unreachable */
 }
 
-/* ---- TypedData callbacks ---- */
-static void
-fb_dfree(void *ptr)
+/* Frees the pixel buffer, or unmaps it for a shared framebuffer */
+void
+cw_fb_release_buffer(framebuffer_t *fb)
 {
-    framebuffer_t *fb = (framebuffer_t *)ptr;
+#ifdef HAVE_SYS_MMAN_H
+    if (fb->mapping) {
+        munmap(fb->mapping, fb->mapping_size);
+        fb->mapping = NULL;
+        fb->buffer  = NULL;
+        return;
+    }
+#endif
     if (fb->buffer) {
         xfree(fb->buffer);
         fb->buffer = NULL;
     }
+}
+
+/* ---- TypedData callbacks ---- */
+static void
+fb_dfree(void *ptr)
+{
+    framebuffer_t *fb = (framebuffer_t *)ptr;
+    cw_fb_release_buffer(fb);
     xfree(fb);
 }
 
@@ -55,16 +76,23 @@ fb_alloc(VALUE klass)
     fb->pixel_format = PIXEL_FORMAT_MONO;
     fb->width_byte  = 0;
     fb->buffer_size = 0;
+    fb->mapping     = NULL;
+    fb->mapping_size = 0;
+    fb->generation  = 0;
+    fb->digest_generation = 0;
     return obj;
 }
 
 /* ---- Initialize ---- */
 static VALUE
-fb_initialize(VALUE self, VALUE rb_width, VALUE rb_height, VALUE rb_format)
+fb_initialize(int argc, VALUE *argv, VALUE self)
 {
     framebuffer_t *fb;
     TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
 
+    VALUE rb_width, rb_height, rb_format, rb_clear;
+    rb_scan_args(argc, argv, "31", &rb_width, &rb_height, &rb_format, &rb_clear);
+
     int w = NUM2INT(rb_width);
     int h = NUM2INT(rb_height);
 
@@ -76,17 +104,27 @@ fb_initialize(VALUE self, VALUE rb_width, VALUE rb_height, VALUE rb_format)
     fb->width       = (uint16_t)w;
     fb->height      = (uint16_t)h;
     fb->pixel_format = cw_sym_to_pixel_format(rb_format);
-    fb->width_byte  = calc_width_byte(fb->width, fb->pixel_format);
+    fb->width_byte  = cw_fb_width_byte(fb->width, fb->pixel_format);
     fb->buffer_size = (size_t)fb->width_byte * fb->height;
 
+    cw_fb_release_buffer(fb);
     fb->buffer = (uint8_t *)xmalloc(fb->buffer_size);
 
     /* MONO defaults to white (all bits set), others to 0x00 */
-    if (fb->pixel_format == PIXEL_FORMAT_MONO)
-        memset(fb->buffer, 0xFF, fb->buffer_size);
-    else
-        memset(fb->buffer, 0x00, fb->buffer_size);
+    uint8_t fill = fb->pixel_format == PIXEL_FORMAT_MONO ? 0xFF : 0x00;
+
+    if (NIL_P(rb_clear) || RTEST(rb_clear)) {
+        memset(fb->buffer, fill, fb->buffer_size);
+    } else if (cw_fb_width_byte(fb->width + 1, fb->pixel_format) == fb->width_byte) {
+        /* Rows end in padding (one more pixel would fit in the same
+         * bytes). Pixels are left for the caller to overwrite; only the
+         * byte holding each row's padding is set, so the buffer matches
+         * a cleared one once every pixel has been written. */
+        for (size_t i = fb->width_byte - 1; i < fb->buffer_size; i += fb->width_byte)
+            fb->buffer[i] = fill;
+    }
 
+    cw_fb_touch(fb);
     return self;
 }
 
@@ -101,11 +139,9 @@ fb_initialize_copy(VALUE copy, VALUE orig)
     TypedData_Get_Struct(copy, framebuffer_t, &framebuffer_type, fb_copy);
     TypedData_Get_Struct(orig, framebuffer_t, &framebuffer_type, fb_orig);
 
-    /* Free any existing buffer in the copy */
-    if (fb_copy->buffer) {
-        xfree(fb_copy->buffer);
-        fb_copy->buffer = NULL;
-    }
+    /* Free any existing buffer in the copy; a copy of a shared
+     * framebuffer is a private snapshot */
+    cw_fb_release_buffer(fb_copy);
 
     /* Copy metadata */
     fb_copy->width        = fb_orig->width;
@@ -119,6 +155,7 @@ fb_initialize_copy(VALUE copy, VALUE orig)
         fb_copy->buffer = (uint8_t *)xmalloc(fb_orig->buffer_size);
         memcpy(fb_copy->buffer, fb_orig->buffer, fb_orig->buffer_size);
     }
+    cw_fb_touch(fb_copy);
 
     return copy;
 }
@@ -185,6 +222,7 @@ fb_set_pixel(VALUE self, VALUE rb_x, VALUE rb_y, VALUE rb_color)
         break;
 
     case PIXEL_FORMAT_GRAY4:
+    case PIXEL_FORMAT_COLOR4_2BPP:
         addr = (size_t)(x / 4) + (size_t)y * fb->width_byte;
         color = color & 0x03; /* 2-bit color */
         rdata = fb->buffer[addr];
@@ -201,6 +239,7 @@ fb_set_pixel(VALUE self, VALUE rb_x, VALUE rb_y, VALUE rb_color)
         fb->buffer[addr] = rdata | ((color << 4) >> ((x % 2) * 4));
         break;
     }
+    cw_fb_touch(fb);
 
     return self;
 }
@@ -230,6 +269,7 @@ fb_get_pixel(VALUE self, VALUE rb_x, VALUE rb_y)
         return INT2NUM(color);
 
     case PIXEL_FORMAT_GRAY4:
+    case PIXEL_FORMAT_COLOR4_2BPP:
         addr = (size_t)(x / 4) + (size_t)y * fb->width_byte;
         rdata = fb->buffer[addr];
         color = (rdata >> (6 - (x % 4) * 2)) & 0x03;
@@ -261,6 +301,7 @@ fb_clear(VALUE self, VALUE rb_color)
         fill = (c == 0) ? 0x00 : 0xFF;
         break;
     case PIXEL_FORMAT_GRAY4:
+    case PIXEL_FORMAT_COLOR4_2BPP:
         c = c & 0x03;
         fill = (uint8_t)((c << 6) | (c << 4) | (c << 2) | c);
         break;
@@ -275,6 +316,80 @@ fb_clear(VALUE self, VALUE rb_color)
     }
 
     memset(fb->buffer, fill, fb->buffer_size);
+    cw_fb_touch(fb);
+    return self;
+}
+
+/* ---- load_indices(bytes) ----
+ *
+ * Packs one palette index per byte (a row-major String of width *
+ * height bytes, or a one-byte PixelBuffer of the same size) into the
+ * buffer: a pure bit-packing pass with no colour matching.
+ * Indices are masked to the format's bit depth like set_pixel (MONO
+ * maps 0 to black and anything else to white); row padding bits are
+ * left untouched.
+ */
+static VALUE
+fb_load_indices(VALUE self, VALUE rb_bytes)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+
+    if (rb_typeddata_is_kind_of(rb_bytes, &cw_pixbuf_type)) {
+        cw_pixbuf_t *pb = cw_pixbuf_get(rb_bytes);
+        if (pb->width != fb->width || pb->height != fb->height) {
+            rb_raise(rb_eArgError, "expected a %dx%d index buffer, got %dx%d",
+                     fb->width, fb->height, pb->width, pb->height);
+        }
+    } else {
+        StringValue(rb_bytes);
+        if (RSTRING_LEN(rb_bytes) != (long)fb->width * fb->height) {
+            rb_raise(rb_eArgError, "expected %ld index bytes, got %ld",
+                     (long)fb->width * fb->height, RSTRING_LEN(rb_bytes));
+        }
+    }
+
+    cw_view_t v;
+    cw_view(rb_bytes, 1, fb->width, 0, &v);
+    int bpp, ppb;
+    uint8_t mask;
+
+    switch (fb->pixel_format) {
+    case PIXEL_FORMAT_MONO:  bpp = 1; mask = 0x01; break;
+    case PIXEL_FORMAT_GRAY4:
+    case PIXEL_FORMAT_COLOR4_2BPP: bpp = 2; mask = 0x03; break;
+    default:                 bpp = 4; mask = 0x0F; break;
+    }
+    ppb = 8 / bpp;
+
+    for (uint16_t y = 0; y < fb->height; y++) {
+        const uint8_t *s = v.data + (size_t)y * v.stride;
+        uint8_t *row = fb->buffer + (size_t)y * fb->width_byte;
+        int full = fb->width / ppb;
+
+        for (int b = 0; b < full; b++, s += ppb) {
+            unsigned v = 0;
+            for (int k = 0; k < ppb; k++) {
+                uint8_t c = bpp == 1 ? (s[k] != 0) : (uint8_t)(s[k] & mask);
+                v = (v << bpp) | c;
+            }
+            row[b] = (uint8_t)v;
+        }
+
+        int rest = fb->width % ppb;
+        if (rest > 0) {
+            unsigned v = row[full];
+            for (int k = 0; k < rest; k++) {
+                int shift = 8 - (k + 1) * bpp;
+                uint8_t c = bpp == 1 ? (s[k] != 0) : (uint8_t)(s[k] & mask);
+                v = (v & ~((unsigned)mask << shift)) | ((unsigned)c << shift);
+            }
+            row[full] = (uint8_t)v;
+        }
+    }
+
+    cw_fb_touch(fb);
+    RB_GC_GUARD(rb_bytes);
     return self;
 }
 
@@ -323,6 +438,7 @@ pixel_format_name(pixel_format_t fmt)
     case PIXEL_FORMAT_GRAY4:  return "gray4";
     case PIXEL_FORMAT_COLOR4: return "color4";
     case PIXEL_FORMAT_COLOR7: return "color7";
+    case PIXEL_FORMAT_COLOR4_2BPP: return "color4_2bpp";
     }
     return "unknown";
 }
@@ -346,7 +462,7 @@ Init_framebuffer(void)
     rb_cFramebuffer = rb_define_class_under(rb_mChromaWave, "Framebuffer", rb_cObject);
 
     rb_define_alloc_func(rb_cFramebuffer, fb_alloc);
-    rb_define_method(rb_cFramebuffer, "initialize",      fb_initialize,      3);
+    rb_define_method(rb_cFramebuffer, "initialize",      fb_initialize,      -1);
     rb_define_method(rb_cFramebuffer, "initialize_copy", fb_initialize_copy, 1);
     rb_define_method(rb_cFramebuffer, "width",           fb_width,           0);
     rb_define_method(rb_cFramebuffer, "height",          fb_height,          0);
@@ -356,6 +472,7 @@ Init_framebuffer(void)
     rb_define_method(rb_cFramebuffer, "get_pixel",       fb_get_pixel,       2);
     rb_define_method(rb_cFramebuffer, "clear",           fb_clear,           1);
     rb_define_method(rb_cFramebuffer, "bytes",           fb_bytes,           0);
+    rb_define_method(rb_cFramebuffer, "load_indices",    fb_load_indices,    1);
     rb_define_method(rb_cFramebuffer, "==",              fb_eq,              1);
     rb_define_method(rb_cFramebuffer, "inspect",         fb_inspect,         0);
 }
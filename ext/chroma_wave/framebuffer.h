@@ -10,9 +10,25 @@ typedef struct {
     pixel_format_t pixel_format;
     uint16_t       width_byte;   /* bytes per row */
     size_t         buffer_size;  /* width_byte * height */
+    void          *mapping;      /* shared file mapping holding buffer, or NULL */
+    size_t         mapping_size;
+    uint64_t       generation;   /* bumped by every write, see cw_fb_touch() */
+    uint64_t       digest;       /* cached digest, valid while ... */
+    uint64_t       digest_generation; /* ... this equals generation + 1 */
 } framebuffer_t;
 
 extern const rb_data_type_t framebuffer_type;
+uint16_t cw_fb_width_byte(uint16_t width, pixel_format_t fmt);
+void cw_fb_release_buffer(framebuffer_t *fb);
+uint64_t cw_fb_digest(framebuffer_t *fb);
 void Init_framebuffer(void);
 
+/* Marks the pixels as changed, dropping cached digests. Every C method
+ * that writes to fb->buffer calls this. */
+static inline void
+cw_fb_touch(framebuffer_t *fb)
+{
+    fb->generation++;
+}
+
 #endif /* FRAMEBUFFER_H */
@@ -1,6 +1,11 @@
 #include "freetype.h"
 #include "ruby/encoding.h"
 
+#ifndef NO_FREETYPE
+#include FT_TRUETYPE_TABLES_H
+#include FT_TRUETYPE_TAGS_H
+#endif
+
 VALUE rb_cFont;
 
 #ifndef NO_FREETYPE
@@ -336,6 +341,212 @@ ft_descent(VALUE self)
     return INT2NUM(-(face_data->face->size->metrics.descender >> 6));
 }
 
+/*
+ * _ft_char_index(codepoint) → Integer
+ *
+ * Returns the face's glyph index for a codepoint, or 0 when the face
+ * has no mapping (the .notdef glyph).
+ */
+static VALUE
+ft_char_index(VALUE self, VALUE rb_codepoint)
+{
+    cw_font_face_t *face_data = get_face_data(self);
+    FT_ULong codepoint = codepoint_from_value(rb_codepoint);
+
+    return UINT2NUM(FT_Get_Char_Index(face_data->face, codepoint));
+}
+
+/* ---- Kerning pairs ---- */
+
+static unsigned
+kern_be16(const FT_Byte *p)
+{
+    return (unsigned)(p[0] << 8 | p[1]);
+}
+
+static int
+cmp_kern_key(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Pushes [left, right, kern_x] when the pixel adjustment is non-zero */
+static void
+push_kerning(VALUE result, FT_Face face, FT_UInt l, FT_UInt r, FT_ULong cp_l, FT_ULong cp_r)
+{
+    FT_Vector delta;
+    if (FT_Get_Kerning(face, l, r, FT_KERNING_DEFAULT, &delta) != 0) return;
+
+    long kern = (long)((delta.x + 32) >> 6);
+    if (kern == 0) return;
+
+    rb_ary_push(result, rb_ary_new_from_args(3, ULONG2NUM(cp_l), ULONG2NUM(cp_r), LONG2NUM(kern)));
+}
+
+/*
+ * _ft_kerning_pairs(codepoints) → Array
+ *
+ * Returns the non-zero horizontal kerning adjustments between the given
+ * codepoints, as FT_Get_Kerning reports them.
+ *
+ * For SFNT faces the pairs are read from the 'kern' table itself (the
+ * horizontal subtables FreeType uses), so the cost follows the number of
+ * pairs the font defines rather than the square of the codepoint count.
+ * Other faces fall back to asking FT_Get_Kerning for every ordered pair.
+ *
+ * codepoints: Array of Integer
+ *
+ * Returns Array of [left, right, kern_x] triples (kern_x in pixels,
+ * rounded). Returns an empty Array when the face has no kerning.
+ */
+static VALUE
+ft_kerning_pairs(VALUE self, VALUE rb_codepoints)
+{
+    cw_font_face_t *face_data = get_face_data(self);
+    FT_Face face = face_data->face;
+
+    Check_Type(rb_codepoints, T_ARRAY);
+
+    VALUE result = rb_ary_new();
+    if (!FT_HAS_KERNING(face)) return result;
+
+    /* ALLOCV buffers are GC-owned, so a raise mid-loop cannot leak them */
+    long n = RARRAY_LEN(rb_codepoints);
+    VALUE cps_tmp, idx_tmp;
+    FT_ULong *cps = ALLOCV_N(FT_ULong, cps_tmp, n > 0 ? n : 1);
+    FT_UInt  *idx = ALLOCV_N(FT_UInt,  idx_tmp, n > 0 ? n : 1);
+
+    for (long i = 0; i < n; i++) {
+        cps[i] = codepoint_from_value(RARRAY_AREF(rb_codepoints, i));
+        idx[i] = FT_Get_Char_Index(face, cps[i]);
+    }
+
+    FT_ULong kern_len = 0;
+    if (!FT_IS_SFNT(face) || FT_Load_Sfnt_Table(face, TTAG_kern, 0, NULL, &kern_len) != 0 || kern_len < 4) {
+        for (long l = 0; l < n; l++) {
+            if (idx[l] == 0) continue;
+            for (long r = 0; r < n; r++) {
+                if (idx[r] != 0) push_kerning(result, face, idx[l], idx[r], cps[l], cps[r]);
+            }
+        }
+        ALLOCV_END(cps_tmp);
+        ALLOCV_END(idx_tmp);
+        return result;
+    }
+
+    VALUE tbl_tmp, first_tmp, next_tmp, keys_tmp;
+    FT_Byte *tbl = ALLOCV_N(FT_Byte, tbl_tmp, kern_len);
+    if (FT_Load_Sfnt_Table(face, TTAG_kern, 0, tbl, &kern_len) != 0) kern_len = 0;
+
+    /* Requested codepoints by glyph: first[g] starts a chain through next[] */
+    long num_glyphs = face->num_glyphs;
+    long *first = ALLOCV_N(long, first_tmp, num_glyphs > 0 ? num_glyphs : 1);
+    long *next  = ALLOCV_N(long, next_tmp, n > 0 ? n : 1);
+    for (long g = 0; g < num_glyphs; g++) first[g] = -1;
+    for (long i = n - 1; i >= 0; i--) {
+        if (idx[i] == 0 || (long)idx[i] >= num_glyphs) continue;
+        next[i] = first[idx[i]];
+        first[idx[i]] = i;
+    }
+
+    /* Collect wanted glyph pairs as left << 16 | right, walking subtables
+     * the way FreeType's tt_face_load_kern does (version 0 header,
+     * horizontal non-minimum coverage, counts trimmed to the data) */
+    uint32_t *keys = ALLOCV_N(uint32_t, keys_tmp, kern_len / 6 + 1);
+    long count = 0;
+    const FT_Byte *p = tbl, *limit = tbl + kern_len;
+
+    if (kern_len >= 4 && kern_be16(p) == 0) {
+        unsigned num_tables = kern_be16(p + 2);
+        p += 4;
+
+        for (unsigned t = 0; t < num_tables && limit - p >= 6; t++) {
+            unsigned length = kern_be16(p + 2), coverage = kern_be16(p + 4);
+            if (length <= 6 + 8) break;
+
+            const FT_Byte *sub_end = (long)length > limit - p ? limit : p + length;
+            const FT_Byte *q = p + 6;
+            p = sub_end;
+            if ((coverage & 3U) != 0x0001 || sub_end - q < 8) continue;
+
+            long num_pairs = kern_be16(q);
+            q += 8;
+            if (num_pairs > (sub_end - q) / 6) num_pairs = (sub_end - q) / 6;
+
+            for (long k = 0; k < num_pairs; k++, q += 6) {
+                unsigned l = kern_be16(q), r = kern_be16(q + 2);
+                if ((long)l < num_glyphs && (long)r < num_glyphs && first[l] >= 0 && first[r] >= 0)
+                    keys[count++] = (uint32_t)l << 16 | r;
+            }
+        }
+    }
+
+    qsort(keys, (size_t)count, sizeof(uint32_t), cmp_kern_key);
+
+    for (long k = 0; k < count; k++) {
+        if (k > 0 && keys[k] == keys[k - 1]) continue;
+        FT_UInt l = keys[k] >> 16, r = keys[k] & 0xFFFF;
+
+        /* Codepoints sharing a glyph (space and no-break space) share its kerning */
+        for (long i = first[l]; i >= 0; i = next[i]) {
+            for (long j = first[r]; j >= 0; j = next[j]) {
+                push_kerning(result, face, l, r, cps[i], cps[j]);
+            }
+        }
+    }
+
+    ALLOCV_END(keys_tmp);
+    ALLOCV_END(next_tmp);
+    ALLOCV_END(first_tmp);
+    ALLOCV_END(tbl_tmp);
+    ALLOCV_END(cps_tmp);
+    ALLOCV_END(idx_tmp);
+    return result;
+}
+
+/*
+ * _ft_coverage → String
+ *
+ * Returns the face's cmap coverage as a bitset: bit (cp & 7) of byte
+ * (cp >> 3) is set when the face maps codepoint cp to a glyph. The
+ * String is sized to the highest mapped codepoint, so a Latin face
+ * costs a few dozen bytes and a full CJK face under 30 KB.
+ *
+ * Returns a binary String (empty when the face has no Unicode cmap).
+ */
+static VALUE
+ft_coverage(VALUE self)
+{
+    cw_font_face_t *face_data = get_face_data(self);
+    FT_Face face = face_data->face;
+    FT_ULong cp, max_cp = 0;
+    FT_UInt gindex;
+    int any = 0;
+
+    for (cp = FT_Get_First_Char(face, &gindex); gindex != 0;
+         cp = FT_Get_Next_Char(face, cp, &gindex)) {
+        if (cp > 0x10FFFF) continue;
+        if (cp > max_cp) max_cp = cp;
+        any = 1;
+    }
+
+    if (!any) return rb_str_new(NULL, 0);
+
+    long len = (long)(max_cp >> 3) + 1;
+    VALUE bits = rb_str_new(NULL, len);
+    unsigned char *p = (unsigned char *)RSTRING_PTR(bits);
+    memset(p, 0, (size_t)len);
+
+    for (cp = FT_Get_First_Char(face, &gindex); gindex != 0;
+         cp = FT_Get_Next_Char(face, cp, &gindex)) {
+        if (cp > 0x10FFFF) continue;
+        p[cp >> 3] |= (unsigned char)(1u << (cp & 7));
+    }
+
+    return bits;
+}
+
 #endif /* NO_FREETYPE */
 
 /* ---- Init_freetype() ---- */
@@ -361,5 +572,8 @@ Init_freetype(void)
     rb_define_private_method(rb_cFont, "_ft_line_height",   ft_line_height,   0);
     rb_define_private_method(rb_cFont, "_ft_ascent",        ft_ascent,        0);
     rb_define_private_method(rb_cFont, "_ft_descent",       ft_descent,       0);
+    rb_define_private_method(rb_cFont, "_ft_char_index",    ft_char_index,    1);
+    rb_define_private_method(rb_cFont, "_ft_kerning_pairs", ft_kerning_pairs, 1);
+    rb_define_private_method(rb_cFont, "_ft_coverage",      ft_coverage,      0);
 #endif
 }
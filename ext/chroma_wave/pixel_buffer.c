@@ -0,0 +1,482 @@
+#include "pixel_buffer.h"
+#include "ruby/encoding.h"
+#include <stdlib.h>
+
+VALUE rb_cPixelBuffer;
+
+/* ---- Aligned allocation ----
+ *
+ * Without posix_memalign the block is over-allocated and the original
+ * pointer is kept in the word just before the aligned address. */
+static void *
+pb_aligned_alloc(size_t size)
+{
+#ifdef HAVE_POSIX_MEMALIGN
+    void *p = NULL;
+    return posix_memalign(&p, CW_PIXBUF_ALIGN, size) == 0 ? p : NULL;
+#else
+    uint8_t *raw = malloc(size + CW_PIXBUF_ALIGN + sizeof(void *));
+    if (!raw) return NULL;
+
+    uintptr_t at = ((uintptr_t)raw + sizeof(void *) + CW_PIXBUF_ALIGN - 1) & ~(uintptr_t)(CW_PIXBUF_ALIGN - 1);
+    ((void **)at)[-1] = raw;
+    return (void *)at;
+#endif
+}
+
+static void
+pb_aligned_free(void *p)
+{
+    if (!p) return;
+#ifdef HAVE_POSIX_MEMALIGN
+    free(p);
+#else
+    free(((void **)p)[-1]);
+#endif
+}
+
+/* ---- TypedData callbacks ---- */
+static void
+pb_release(cw_pixbuf_t *pb)
+{
+    if (!pb->data) return;
+
+    pb_aligned_free(pb->data);
+    rb_gc_adjust_memory_usage(-(ssize_t)pb->capacity);
+    pb->data     = NULL;
+    pb->capacity = 0;
+}
+
+static void
+pb_dfree(void *ptr)
+{
+    pb_release((cw_pixbuf_t *)ptr);
+    xfree(ptr);
+}
+
+static size_t
+pb_dsize(const void *ptr)
+{
+    return sizeof(cw_pixbuf_t) + ((const cw_pixbuf_t *)ptr)->capacity;
+}
+
+const rb_data_type_t cw_pixbuf_type = {
+    .wrap_struct_name = "ChromaWave::PixelBuffer",
+    .function = {
+        .dmark = NULL,
+        .dfree = pb_dfree,
+        .dsize = pb_dsize,
+    },
+    .flags = RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+cw_pixbuf_t *
+cw_pixbuf_get(VALUE obj)
+{
+    cw_pixbuf_t *pb;
+    TypedData_Get_Struct(obj, cw_pixbuf_t, &cw_pixbuf_type, pb);
+    if (!pb->data) rb_raise(rb_eRuntimeError, "uninitialized pixel buffer");
+    return pb;
+}
+
+/* Raises unless +obj+ may be written: not frozen and not pinned. */
+static cw_pixbuf_t *
+pb_writable(VALUE obj)
+{
+    cw_pixbuf_t *pb = cw_pixbuf_get(obj);
+
+    rb_check_frozen(obj);
+    if (pb->pins > 0) rb_raise(rb_eRuntimeError, "can't modify pixel buffer; pinned by a reader");
+    return pb;
+}
+
+/* (Re)allocates +pb+ for width x height pixels of +bpp+ bytes. */
+static void
+pb_allocate(cw_pixbuf_t *pb, int width, int height, int bpp)
+{
+    size_t stride   = ((size_t)width * bpp + CW_PIXBUF_ALIGN - 1) & ~(size_t)(CW_PIXBUF_ALIGN - 1);
+    size_t capacity = stride * (size_t)height;
+    uint8_t *data   = pb_aligned_alloc(capacity);
+
+    if (!data) {
+        rb_gc();
+        data = pb_aligned_alloc(capacity);
+        if (!data) rb_memerror();
+    }
+
+    pb_release(pb);
+    pb->data     = data;
+    pb->stride   = stride;
+    pb->capacity = capacity;
+    pb->width    = width;
+    pb->height   = height;
+    pb->bpp      = bpp;
+    pb->pins     = 0;
+    rb_gc_adjust_memory_usage((ssize_t)capacity);
+}
+
+/* ---- Views ----
+ *
+ * Fills +view+ for a PixelBuffer or a packed String of +width+-pixel
+ * rows (a String with width <= 0 is one row). A PixelBuffer must hold
+ * +bpp+-byte pixels and be at least +width+ wide, so clipping spans to
+ * +width+ keeps them off the row padding. Writable views raise for
+ * frozen or pinned buffers.
+ */
+void
+cw_view(VALUE obj, int bpp, long width, int writable, cw_view_t *view)
+{
+    if (rb_typeddata_is_kind_of(obj, &cw_pixbuf_type)) {
+        cw_pixbuf_t *pb = writable ? pb_writable(obj) : cw_pixbuf_get(obj);
+
+        if (pb->bpp != bpp)
+            rb_raise(rb_eArgError, "expected a %d-byte pixel buffer, got %d", bpp, pb->bpp);
+        if (width > pb->width)
+            rb_raise(rb_eArgError, "pixel buffer is %d pixels wide, not %ld", pb->width, width);
+
+        view->data   = pb->data;
+        view->stride = pb->stride;
+        view->len    = (long)pb->capacity;
+        view->width  = width > 0 ? width : pb->width;
+        view->rows   = pb->height;
+        return;
+    }
+
+    Check_Type(obj, T_STRING);
+    if (writable) rb_str_modify(obj);
+
+    view->data   = (uint8_t *)RSTRING_PTR(obj);
+    view->len    = RSTRING_LEN(obj);
+    view->width  = width > 0 ? width : view->len / bpp;
+    view->stride = (size_t)view->width * bpp;
+    view->rows   = view->stride > 0 ? view->len / (long)view->stride : 0;
+}
+
+/* ---- Packed offsets ----
+ *
+ * The byte-level methods address the pixels as if they were packed
+ * row-major (offset = (y * width + x) * bpp, like the String buffer they
+ * replace), and skip the row padding. */
+static inline uint8_t *
+pb_at(const cw_pixbuf_t *pb, long off)
+{
+    long row_bytes = (long)pb->width * pb->bpp;
+    return pb->data + (size_t)(off / row_bytes) * pb->stride + (size_t)(off % row_bytes);
+}
+
+static inline long
+pb_bytesize(const cw_pixbuf_t *pb)
+{
+    return (long)pb->width * pb->height * pb->bpp;
+}
+
+/* Copies +len+ packed bytes between +pb+ at +off+ and +mem+. */
+static void
+pb_copy(cw_pixbuf_t *pb, long off, uint8_t *mem, long len, int store)
+{
+    long row_bytes = (long)pb->width * pb->bpp;
+
+    while (len > 0) {
+        long n = row_bytes - off % row_bytes;
+        if (n > len) n = len;
+
+        uint8_t *p = pb_at(pb, off);
+        if (store) memcpy(p, mem, (size_t)n);
+        else       memcpy(mem, p, (size_t)n);
+
+        off += n;
+        mem += n;
+        len -= n;
+    }
+}
+
+/* ---- Allocation / initialize(width, height, bytes_per_pixel, fill = nil) ---- */
+static VALUE
+pb_alloc(VALUE klass)
+{
+    cw_pixbuf_t *pb;
+    VALUE obj = TypedData_Make_Struct(klass, cw_pixbuf_t, &cw_pixbuf_type, pb);
+    pb->data = NULL;
+    return obj;
+}
+
+static VALUE
+pb_initialize(int argc, VALUE *argv, VALUE self)
+{
+    cw_pixbuf_t *pb;
+    TypedData_Get_Struct(self, cw_pixbuf_t, &cw_pixbuf_type, pb);
+
+    VALUE rb_w, rb_h, rb_bpp, rb_fill;
+    rb_scan_args(argc, argv, "31", &rb_w, &rb_h, &rb_bpp, &rb_fill);
+    if (pb->data) pb_writable(self);
+
+    int w   = NUM2INT(rb_w);
+    int h   = NUM2INT(rb_h);
+    int bpp = NUM2INT(rb_bpp);
+
+    if (w <= 0 || w > EPD_MAX_DIMENSION)
+        rb_raise(rb_eArgError, "width must be between 1 and %d", EPD_MAX_DIMENSION);
+    if (h <= 0 || h > EPD_MAX_DIMENSION)
+        rb_raise(rb_eArgError, "height must be between 1 and %d", EPD_MAX_DIMENSION);
+    if (bpp != 1 && bpp != 4)
+        rb_raise(rb_eArgError, "bytes per pixel must be 1 or 4, got %d", bpp);
+    if (!NIL_P(rb_fill)) {
+        StringValue(rb_fill);
+        if (RSTRING_LEN(rb_fill) != bpp)
+            rb_raise(rb_eArgError, "fill must be %d bytes, got %ld", bpp, RSTRING_LEN(rb_fill));
+    }
+
+    pb_allocate(pb, w, h, bpp);
+
+    if (NIL_P(rb_fill) || bpp == 1) {
+        memset(pb->data, NIL_P(rb_fill) ? 0 : RSTRING_PTR(rb_fill)[0], pb->capacity);
+    } else {
+        /* the stride is a multiple of 4, so stamping the padding is harmless */
+        for (size_t i = 0; i < pb->capacity; i += 4) memcpy(pb->data + i, RSTRING_PTR(rb_fill), 4);
+    }
+
+    return self;
+}
+
+/* ---- initialize_copy (deep copy for dup/clone; pins are not copied) ---- */
+static VALUE
+pb_initialize_copy(VALUE copy, VALUE orig)
+{
+    if (copy == orig) return copy;
+
+    cw_pixbuf_t *dst;
+    TypedData_Get_Struct(copy, cw_pixbuf_t, &cw_pixbuf_type, dst);
+    cw_pixbuf_t *src = cw_pixbuf_get(orig);
+
+    pb_allocate(dst, src->width, src->height, src->bpp);
+    memcpy(dst->data, src->data, src->capacity);
+    return copy;
+}
+
+/* ---- Accessors ---- */
+static VALUE
+pb_width(VALUE self)
+{
+    return INT2NUM(cw_pixbuf_get(self)->width);
+}
+
+static VALUE
+pb_height(VALUE self)
+{
+    return INT2NUM(cw_pixbuf_get(self)->height);
+}
+
+static VALUE
+pb_bytes_per_pixel(VALUE self)
+{
+    return INT2NUM(cw_pixbuf_get(self)->bpp);
+}
+
+static VALUE
+pb_stride(VALUE self)
+{
+    return SIZET2NUM(cw_pixbuf_get(self)->stride);
+}
+
+static VALUE
+pb_bytesize_m(VALUE self)
+{
+    return LONG2NUM(pb_bytesize(cw_pixbuf_get(self)));
+}
+
+static VALUE
+pb_pinned_p(VALUE self)
+{
+    return cw_pixbuf_get(self)->pins > 0 ? Qtrue : Qfalse;
+}
+
+/* ---- getbyte(offset) / setbyte(offset, value) ---- */
+static VALUE
+pb_getbyte(VALUE self, VALUE rb_off)
+{
+    cw_pixbuf_t *pb = cw_pixbuf_get(self);
+    long off = NUM2LONG(rb_off);
+
+    if (off < 0 || off >= pb_bytesize(pb)) return Qnil;
+    return INT2FIX(*pb_at(pb, off));
+}
+
+static VALUE
+pb_setbyte(VALUE self, VALUE rb_off, VALUE rb_value)
+{
+    cw_pixbuf_t *pb = pb_writable(self);
+    long off = NUM2LONG(rb_off);
+
+    if (off < 0 || off >= pb_bytesize(pb))
+        rb_raise(rb_eIndexError, "offset %ld out of pixel buffer", off);
+    *pb_at(pb, off) = (uint8_t)(NUM2INT(rb_value) & 0xFF);
+    return rb_value;
+}
+
+/* ---- byteslice(offset, length) ---- */
+static VALUE
+pb_byteslice(VALUE self, VALUE rb_off, VALUE rb_len)
+{
+    cw_pixbuf_t *pb = cw_pixbuf_get(self);
+    long off  = NUM2LONG(rb_off);
+    long len  = NUM2LONG(rb_len);
+    long size = pb_bytesize(pb);
+
+    if (off < 0 || off > size || len < 0) return Qnil;
+    if (len > size - off) len = size - off;
+
+    VALUE str = rb_str_new(NULL, len);
+    pb_copy(pb, off, (uint8_t *)RSTRING_PTR(str), len, 0);
+    rb_enc_associate(str, rb_ascii8bit_encoding());
+    return str;
+}
+
+/* ---- []=(offset, length, bytes) ----
+ *
+ * Overwrites +length+ bytes in place; unlike String#[]= the buffer
+ * never resizes, so +bytes+ must be exactly +length+ bytes long.
+ */
+static VALUE
+pb_aset(VALUE self, VALUE rb_off, VALUE rb_len, VALUE rb_bytes)
+{
+    cw_pixbuf_t *pb = pb_writable(self);
+    long off = NUM2LONG(rb_off);
+    long len = NUM2LONG(rb_len);
+
+    StringValue(rb_bytes);
+    if (RSTRING_LEN(rb_bytes) != len)
+        rb_raise(rb_eArgError, "expected %ld bytes, got %ld", len, RSTRING_LEN(rb_bytes));
+    if (off < 0 || len < 0 || len > pb_bytesize(pb) - off)
+        rb_raise(rb_eIndexError, "range %ld+%ld out of pixel buffer", off, len);
+
+    pb_copy(pb, off, (uint8_t *)RSTRING_PTR(rb_bytes), len, 1);
+    RB_GC_GUARD(rb_bytes);
+    return rb_bytes;
+}
+
+/* ---- replace(bytes) — loads a full packed image ---- */
+static VALUE
+pb_replace(VALUE self, VALUE rb_bytes)
+{
+    cw_pixbuf_t *pb = pb_writable(self);
+
+    StringValue(rb_bytes);
+    if (RSTRING_LEN(rb_bytes) != pb_bytesize(pb))
+        rb_raise(rb_eArgError, "expected %ld bytes, got %ld", pb_bytesize(pb), RSTRING_LEN(rb_bytes));
+
+    pb_copy(pb, 0, (uint8_t *)RSTRING_PTR(rb_bytes), RSTRING_LEN(rb_bytes), 1);
+    RB_GC_GUARD(rb_bytes);
+    return self;
+}
+
+/* ---- to_s — the pixels as a packed binary String ---- */
+static VALUE
+pb_to_s(VALUE self)
+{
+    cw_pixbuf_t *pb = cw_pixbuf_get(self);
+    long size = pb_bytesize(pb);
+
+    VALUE str = rb_str_new(NULL, size);
+    pb_copy(pb, 0, (uint8_t *)RSTRING_PTR(str), size, 0);
+    rb_enc_associate(str, rb_ascii8bit_encoding());
+    return str;
+}
+
+/* ---- pin { |buffer| ... } ----
+ *
+ * Yields self with writes disabled (from Ruby and from the kernels)
+ * until the block returns. Pins nest.
+ */
+static VALUE
+pb_pin_yield(VALUE self)
+{
+    return rb_yield(self);
+}
+
+static VALUE
+pb_unpin(VALUE self)
+{
+    cw_pixbuf_get(self)->pins--;
+    return Qnil;
+}
+
+static VALUE
+pb_pin(VALUE self)
+{
+    rb_need_block();
+    cw_pixbuf_get(self)->pins++;
+    return rb_ensure(pb_pin_yield, self, pb_unpin, self);
+}
+
+/* ---- equality / hash (pixels only, padding ignored) ---- */
+static VALUE
+pb_eq(VALUE self, VALUE other)
+{
+    if (self == other) return Qtrue;
+    if (!rb_typeddata_is_kind_of(other, &cw_pixbuf_type)) return Qfalse;
+
+    cw_pixbuf_t *a = cw_pixbuf_get(self);
+    cw_pixbuf_t *b = cw_pixbuf_get(other);
+
+    if (a->width != b->width || a->height != b->height || a->bpp != b->bpp) return Qfalse;
+
+    size_t row_bytes = (size_t)a->width * a->bpp;
+    for (int y = 0; y < a->height; y++) {
+        if (memcmp(a->data + (size_t)y * a->stride, b->data + (size_t)y * b->stride, row_bytes) != 0)
+            return Qfalse;
+    }
+    return Qtrue;
+}
+
+static VALUE
+pb_hash(VALUE self)
+{
+    cw_pixbuf_t *pb = cw_pixbuf_get(self);
+    size_t row_bytes = (size_t)pb->width * pb->bpp;
+
+    st_index_t h = rb_hash_start((st_index_t)pb->width);
+    h = rb_hash_uint(h, (st_index_t)pb->height);
+    h = rb_hash_uint(h, (st_index_t)pb->bpp);
+    for (int y = 0; y < pb->height; y++) {
+        h = rb_hash_uint(h, rb_memhash(pb->data + (size_t)y * pb->stride, (long)row_bytes));
+    }
+    return ST2FIX(rb_hash_end(h));
+}
+
+static VALUE
+pb_inspect(VALUE self)
+{
+    cw_pixbuf_t *pb = cw_pixbuf_get(self);
+    return rb_sprintf("#<%"PRIsVALUE" %dx%d bpp=%d stride=%zu>",
+                      rb_class_name(CLASS_OF(self)), pb->width, pb->height, pb->bpp, pb->stride);
+}
+
+/* ---- Init_pixel_buffer() ---- */
+void
+Init_pixel_buffer(void)
+{
+    rb_cPixelBuffer = rb_define_class_under(rb_mChromaWave, "PixelBuffer", rb_cObject);
+    rb_define_alloc_func(rb_cPixelBuffer, pb_alloc);
+
+    rb_define_const(rb_cPixelBuffer, "ALIGNMENT", INT2NUM(CW_PIXBUF_ALIGN));
+
+    rb_define_method(rb_cPixelBuffer, "initialize",      pb_initialize,      -1);
+    rb_define_method(rb_cPixelBuffer, "initialize_copy", pb_initialize_copy, 1);
+    rb_define_method(rb_cPixelBuffer, "width",           pb_width,           0);
+    rb_define_method(rb_cPixelBuffer, "height",          pb_height,          0);
+    rb_define_method(rb_cPixelBuffer, "bytes_per_pixel", pb_bytes_per_pixel, 0);
+    rb_define_method(rb_cPixelBuffer, "stride",          pb_stride,          0);
+    rb_define_method(rb_cPixelBuffer, "bytesize",        pb_bytesize_m,      0);
+    rb_define_method(rb_cPixelBuffer, "pinned?",         pb_pinned_p,        0);
+    rb_define_method(rb_cPixelBuffer, "getbyte",         pb_getbyte,         1);
+    rb_define_method(rb_cPixelBuffer, "setbyte",         pb_setbyte,         2);
+    rb_define_method(rb_cPixelBuffer, "byteslice",       pb_byteslice,       2);
+    rb_define_method(rb_cPixelBuffer, "[]=",             pb_aset,            3);
+    rb_define_method(rb_cPixelBuffer, "replace",         pb_replace,         1);
+    rb_define_method(rb_cPixelBuffer, "to_s",            pb_to_s,            0);
+    rb_define_method(rb_cPixelBuffer, "pin",             pb_pin,             0);
+    rb_define_method(rb_cPixelBuffer, "==",              pb_eq,              1);
+    rb_define_method(rb_cPixelBuffer, "eql?",            pb_eq,              1);
+    rb_define_method(rb_cPixelBuffer, "hash",            pb_hash,            0);
+    rb_define_method(rb_cPixelBuffer, "inspect",         pb_inspect,         0);
+}
@@ -0,0 +1,41 @@
+#ifndef PIXEL_BUFFER_H
+#define PIXEL_BUFFER_H
+
+#include "chroma_wave.h"
+
+/* Row alignment in bytes: a cache line, and wide enough for any SIMD load */
+#define CW_PIXBUF_ALIGN 64
+
+/* Native-owned pixel storage behind Canvas and its subclasses.
+ *
+ * Rows start on CW_PIXBUF_ALIGN boundaries; the bytes between a row's
+ * last pixel and the next row are padding and never read back. The
+ * memory does not move and is not owned by a Ruby String, so kernels
+ * may work on it with the GVL released while it is pinned. */
+typedef struct {
+    uint8_t *data;      /* first row, CW_PIXBUF_ALIGN-aligned */
+    size_t   stride;    /* row pitch in bytes, a multiple of CW_PIXBUF_ALIGN */
+    size_t   capacity;  /* stride * height, reported to the GC */
+    int      width;
+    int      height;
+    int      bpp;       /* bytes per pixel: 1 or 4 */
+    int      pins;      /* active readers; writes raise while non-zero */
+} cw_pixbuf_t;
+
+/* Row-addressed window onto a PixelBuffer or a packed String.
+ * Pixel (x, y) lives at data + y * stride + x * bpp. */
+typedef struct {
+    uint8_t *data;
+    size_t   stride;    /* row pitch in bytes */
+    long     len;       /* addressable bytes from data */
+    long     width;     /* pixels per row */
+    long     rows;      /* complete rows available */
+} cw_view_t;
+
+extern VALUE rb_cPixelBuffer;
+extern const rb_data_type_t cw_pixbuf_type;
+
+cw_pixbuf_t *cw_pixbuf_get(VALUE obj);
+void         cw_view(VALUE obj, int bpp, long width, int writable, cw_view_t *view);
+
+#endif /* PIXEL_BUFFER_H */
@@ -0,0 +1,950 @@
+#include "raster.h"
+#include "framebuffer.h"
+#include "pixel_buffer.h"
+#include <math.h>
+#include <stdlib.h>
+
+/*
+ * Native span rasterizer behind Drawing::Primitives.
+ *
+ * Each shape is a straight port of its Ruby counterpart in
+ * lib/chroma_wave/drawing/primitives.rb — same integer and floating
+ * point steps, same rounding — so both paths light exactly the same
+ * pixels. Instead of calling set_pixel per pixel, shapes emit clipped
+ * horizontal spans: a run of RGBA stamps on a Canvas, or a masked
+ * head byte, memset body and masked tail byte on a packed Framebuffer.
+ *
+ * Shapes clip before they iterate where the port allows it (rows of
+ * the scanline shapes, the visible steps of a line), so a shape far
+ * larger than the target costs about as much as its visible part.
+ *
+ * Arguments the ports cannot represent (non-Integer coordinates or
+ * values beyond RASTER_LIMIT) make the entry points return false so
+ * the caller falls back to the Ruby path.
+ */
+
+#define RASTER_LIMIT        (1L << 20)
+#define RASTER_RADIUS_LIMIT (1L << 14)
+
+static ID id_line, id_thick_line, id_rect, id_fill_circle, id_circle, id_annulus,
+          id_quarter_circle, id_fill_ellipse, id_ellipse, id_ellipse_annulus,
+          id_arc, id_polygon, id_flood, id_points, id_runs;
+
+/* ---- Span writers ---- */
+
+static void
+span_rgba(const cw_raster_t *t, long x0, long x1, long y)
+{
+    uint8_t *p = t->buf + y * t->stride + x0 * 4;
+
+    for (long x = x0; x <= x1; x++, p += 4) {
+        memcpy(p, t->rgba, 4);
+    }
+}
+
+/* Bits of pixels p0..p1 (inclusive) within one byte, MSB first */
+static uint8_t
+packed_mask(int bpp, long p0, long p1)
+{
+    unsigned head = 0xFFu >> (p0 * bpp);
+    unsigned tail = (0xFFu << (8 - (p1 + 1) * bpp)) & 0xFFu;
+    return (uint8_t)(head & tail);
+}
+
+static void
+span_packed(const cw_raster_t *t, long x0, long x1, long y)
+{
+    int ppb = 8 / t->bpp;
+    uint8_t *row = t->buf + y * t->stride;
+    long b0 = x0 / ppb;
+    long b1 = x1 / ppb;
+    uint8_t m;
+
+    if (b0 == b1) {
+        m = packed_mask(t->bpp, x0 % ppb, x1 % ppb);
+        row[b0] = (uint8_t)((row[b0] & ~m) | (t->fill & m));
+        return;
+    }
+
+    m = packed_mask(t->bpp, x0 % ppb, ppb - 1);
+    row[b0] = (uint8_t)((row[b0] & ~m) | (t->fill & m));
+    if (b1 > b0 + 1) memset(row + b0 + 1, t->fill, (size_t)(b1 - b0 - 1));
+    m = packed_mask(t->bpp, 0, x1 % ppb);
+    row[b1] = (uint8_t)((row[b1] & ~m) | (t->fill & m));
+}
+
+void
+cw_raster_span(const cw_raster_t *t, long x0, long x1, long y)
+{
+    if (y < t->clip_y0 || y >= t->clip_y1) return;
+    if (x0 < t->clip_x0) x0 = t->clip_x0;
+    if (x1 >= t->clip_x1) x1 = t->clip_x1 - 1;
+    if (x0 > x1) return;
+
+    if (t->bpp == 32)
+        span_rgba(t, t->ox + x0, t->ox + x1, t->oy + y);
+    else
+        span_packed(t, t->ox + x0, t->ox + x1, t->oy + y);
+}
+
+static inline void
+plot(const cw_raster_t *t, long x, long y)
+{
+    cw_raster_span(t, x, x, y);
+}
+
+/* ---- Numeric helpers matching Ruby semantics ---- */
+
+/* Integer#/ (floors toward negative infinity); b > 0 */
+static int64_t
+floor_div(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+    return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+/* Integer.sqrt */
+static int64_t
+isqrt64(int64_t n)
+{
+    int64_t r = (int64_t)sqrt((double)n);
+    while (r * r > n) r--;
+    while ((r + 1) * (r + 1) <= n) r++;
+    return r;
+}
+
+/* Float#% (result takes the sign of the divisor) */
+static double
+flo_mod(double x, double y)
+{
+    double mod = (x == 0.0 || (isinf(y) && !isinf(x))) ? x : fmod(x, y);
+    if (y * mod < 0) mod += y;
+    return mod;
+}
+
+/* Row range [lo, hi] of a shape spanning cy - ext .. cy + ext, clipped */
+static void
+clip_rows(const cw_raster_t *t, long cy, long ext, long *lo, long *hi)
+{
+    *lo = -ext > (t->clip_y0 - cy) ? -ext : (t->clip_y0 - cy);
+    *hi = ext < (t->clip_y1 - 1 - cy) ? ext : (t->clip_y1 - 1 - cy);
+}
+
+/* ---- Lines ---- */
+
+/* Steps k in [*lo, *hi] whose coordinate c0 + s * k lies in [c_lo, c_hi) */
+static void
+clip_steps(long c0, long s, long c_lo, long c_hi, long *lo, long *hi)
+{
+    long first = s > 0 ? c_lo - c0 : c0 - (c_hi - 1);
+    long last  = s > 0 ? c_hi - 1 - c0 : c0 - c_lo;
+    if (first > *lo) *lo = first;
+    if (last < *hi) *hi = last;
+}
+
+/*
+ * Bresenham, walking only the steps whose major-axis coordinate is
+ * inside the clip. The Ruby loop's error term has a closed form: after
+ * k steps along the major axis, an x-major line has taken
+ * (dx + 2 * dy * k) / (2 * dx) steps in y (and the same with the axes
+ * swapped), so lines reaching far off-screen cost only their visible
+ * part. Pixels on one row are contiguous, so each row is one span.
+ */
+static void
+raster_line(const cw_raster_t *t, long x0, long y0, long x1, long y1)
+{
+    int64_t dx = labs(x1 - x0);
+    int64_t dy = labs(y1 - y0);
+    long sx = x0 < x1 ? 1 : -1;
+    long sy = y0 < y1 ? 1 : -1;
+    int x_major = dx >= dy;
+    long lo = 0, hi = (long)(x_major ? dx : dy);
+
+    if (x_major)
+        clip_steps(x0, sx, t->clip_x0, t->clip_x1, &lo, &hi);
+    else
+        clip_steps(y0, sy, t->clip_y0, t->clip_y1, &lo, &hi);
+    if (lo > hi) return;
+
+    long run_y = 0, run_lo = 0, run_hi = 0;
+    for (long k = lo; k <= hi; k++) {
+        long x, y;
+        if (x_major) {
+            x = x0 + sx * k;
+            y = y0 + sy * (dx == 0 ? 0 : (long)((dx + 2 * dy * k) / (2 * dx)));
+        } else {
+            x = x0 + sx * (long)((dy + 2 * dx * k) / (2 * dy));
+            y = y0 + sy * k;
+        }
+
+        if (k == lo || y != run_y) {
+            if (k != lo) cw_raster_span(t, run_lo, run_hi, run_y);
+            run_y = y;
+            run_lo = run_hi = x;
+        } else if (x < run_lo) {
+            run_lo = x;
+        } else if (x > run_hi) {
+            run_hi = x;
+        }
+    }
+    cw_raster_span(t, run_lo, run_hi, run_y);
+}
+
+static void raster_fill_circle(const cw_raster_t *t, long cx, long cy, long r);
+
+static void
+raster_thick_line(const cw_raster_t *t, long x0, long y0, long x1, long y1, long w)
+{
+    double half = (double)(w - 1) / 2.0;
+    long dx = x1 - x0;
+    long dy = y1 - y0;
+    double len = sqrt((double)((int64_t)dx * dx + (int64_t)dy * dy));
+
+    if (len == 0.0) {
+        raster_fill_circle(t, x0, y0, (long)round(half));
+        return;
+    }
+
+    double px = (double)(-dy) / len;
+    double py = (double)dx / len;
+    long h = (long)ceil(half);
+
+    for (long offset = -h; offset <= h; offset++) {
+        long ox = (long)round(px * (double)offset);
+        long oy = (long)round(py * (double)offset);
+        raster_line(t, x0 + ox, y0 + oy, x1 + ox, y1 + oy);
+    }
+}
+
+static void
+raster_rect(const cw_raster_t *t, long x, long y, long w, long h)
+{
+    if (w <= 0) return;
+    for (long row = 0; row < h; row++) {
+        cw_raster_span(t, x, x + w - 1, y + row);
+    }
+}
+
+/* ---- Circles ---- */
+
+static void
+raster_fill_circle(const cw_raster_t *t, long cx, long cy, long r)
+{
+    long xi = 0, yi = r, d = 1 - r;
+
+    while (xi <= yi) {
+        cw_raster_span(t, cx - yi, cx + yi, cy + xi);
+        if (xi != 0) cw_raster_span(t, cx - yi, cx + yi, cy - xi);
+        if (xi != yi) cw_raster_span(t, cx - xi, cx + xi, cy + yi);
+        if (xi != yi && yi != 0) cw_raster_span(t, cx - xi, cx + xi, cy - yi);
+        xi++;
+        if (d < 0) {
+            d += 2 * xi + 1;
+        } else {
+            yi--;
+            d += 2 * (xi - yi) + 1;
+        }
+    }
+}
+
+static void
+raster_circle(const cw_raster_t *t, long cx, long cy, long r)
+{
+    long xi = 0, yi = r, d = 1 - r;
+
+    while (xi <= yi) {
+        plot(t, cx + xi, cy + yi);
+        plot(t, cx - xi, cy + yi);
+        plot(t, cx + xi, cy - yi);
+        plot(t, cx - xi, cy - yi);
+        plot(t, cx + yi, cy + xi);
+        plot(t, cx - yi, cy + xi);
+        plot(t, cx + yi, cy - xi);
+        plot(t, cx - yi, cy - xi);
+        xi++;
+        if (d < 0) {
+            d += 2 * xi + 1;
+        } else {
+            yi--;
+            d += 2 * (xi - yi) + 1;
+        }
+    }
+}
+
+static void
+raster_annulus(const cw_raster_t *t, long cx, long cy, long outer, long inner)
+{
+    int64_t outer_sq = (int64_t)outer * outer;
+    int64_t inner_sq = (int64_t)inner * inner;
+    long lo, hi;
+
+    clip_rows(t, cy, outer, &lo, &hi);
+    for (long dy = lo; dy <= hi; dy++) {
+        int64_t dy_sq = (int64_t)dy * dy;
+        if (dy_sq > outer_sq) continue;
+
+        long outer_x = (long)isqrt64(outer_sq - dy_sq);
+        if (dy_sq >= inner_sq) {
+            cw_raster_span(t, cx - outer_x, cx + outer_x, cy + dy);
+        } else {
+            long inner_x = (long)isqrt64(inner_sq - dy_sq);
+            cw_raster_span(t, cx - outer_x, cx - inner_x - 1, cy + dy);
+            cw_raster_span(t, cx + inner_x + 1, cx + outer_x, cy + dy);
+        }
+    }
+}
+
+static void
+raster_quarter_circle(const cw_raster_t *t, long cx, long cy, long r, long sx, long sy)
+{
+    long xi = 0, yi = r, d = 1 - r;
+
+    while (xi <= yi) {
+        if (sx > 0) {
+            cw_raster_span(t, cx, cx + yi, cy + sy * xi);
+            if (xi != yi) cw_raster_span(t, cx, cx + xi, cy + sy * yi);
+        } else {
+            cw_raster_span(t, cx - yi, cx, cy + sy * xi);
+            if (xi != yi) cw_raster_span(t, cx - xi, cx, cy + sy * yi);
+        }
+        xi++;
+        if (d < 0) {
+            d += 2 * xi + 1;
+        } else {
+            yi--;
+            d += 2 * (xi - yi) + 1;
+        }
+    }
+}
+
+/* ---- Ellipses ---- */
+
+static void
+ellipse_emit(const cw_raster_t *t, long cx, long cy, long x, long y, int fill)
+{
+    if (fill) {
+        cw_raster_span(t, cx - x, cx + x, cy + y);
+        if (y != 0) cw_raster_span(t, cx - x, cx + x, cy - y);
+    } else {
+        plot(t, cx + x, cy + y);
+        plot(t, cx - x, cy + y);
+        plot(t, cx + x, cy - y);
+        plot(t, cx - x, cy - y);
+    }
+}
+
+static void raster_ellipse_annulus(const cw_raster_t *t, long cx, long cy,
+                                   long orx, long ory, long irx, long iry);
+
+/*
+ * Midpoint ellipse; fill emits row spans, otherwise the outline. Past
+ * RASTER_RADIUS_LIMIT the midpoint terms overflow 64 bits, so large
+ * ellipses are drawn row by row, clipped, as a scanline annulus (a
+ * one-pixel ring for the outline), which is what the Ruby path does too.
+ */
+static void
+raster_ellipse(const cw_raster_t *t, long cx, long cy, long rx, long ry, int fill)
+{
+    if (rx > 0 && ry > 0 && (rx > RASTER_RADIUS_LIMIT || ry > RASTER_RADIUS_LIMIT)) {
+        raster_ellipse_annulus(t, cx, cy, rx, ry, fill ? 0 : rx - 1, fill ? 0 : ry - 1);
+        return;
+    }
+
+    int64_t rx2 = (int64_t)rx * rx;
+    int64_t ry2 = (int64_t)ry * ry;
+    int64_t x = 0, y = ry;
+    int64_t px = 0, py = 2 * rx2 * y;
+    double d;
+
+    /* Region 1 */
+    d = (double)(ry2 - rx2 * ry) + 0.25 * (double)rx2;
+    while (px < py) {
+        ellipse_emit(t, cx, cy, (long)x, (long)y, fill);
+        x++;
+        px += 2 * ry2;
+        if (d < 0) {
+            d += (double)(ry2 + px);
+        } else {
+            y--;
+            py -= 2 * rx2;
+            d += (double)(ry2 + px - py);
+        }
+    }
+
+    /* Region 2 */
+    d = (double)ry2 * ((double)x + 0.5) * ((double)x + 0.5) +
+        (double)(rx2 * (y - 1) * (y - 1)) - (double)(rx2 * ry2);
+    while (y >= 0) {
+        ellipse_emit(t, cx, cy, (long)x, (long)y, fill);
+        y--;
+        py -= 2 * rx2;
+        if (d > 0) {
+            d += (double)(rx2 - py);
+        } else {
+            x++;
+            px += 2 * ry2;
+            d += (double)(rx2 - py + px);
+        }
+    }
+}
+
+static void
+raster_ellipse_annulus(const cw_raster_t *t, long cx, long cy,
+                       long orx, long ory, long irx, long iry)
+{
+    long lo, hi;
+
+    if (orx <= 0 || ory <= 0) return;
+
+    clip_rows(t, cy, ory, &lo, &hi);
+    for (long dy = lo; dy <= hi; dy++) {
+        double outer_val = 1.0 - pow((double)dy / (double)ory, 2.0);
+        if (outer_val < 0) continue;
+
+        long outer_x = (long)round((double)orx * sqrt(outer_val));
+        if (irx > 0 && iry > 0 && labs(dy) < iry) {
+            double inner_val = 1.0 - pow((double)dy / (double)iry, 2.0);
+            long inner_x = (long)round((double)irx * sqrt(inner_val));
+            cw_raster_span(t, cx - outer_x, cx - inner_x - 1, cy + dy);
+            cw_raster_span(t, cx + inner_x + 1, cx + outer_x, cy + dy);
+        } else {
+            cw_raster_span(t, cx - outer_x, cx + outer_x, cy + dy);
+        }
+    }
+}
+
+/* ---- Arc ---- */
+
+static void
+arc_plot(const cw_raster_t *t, long cx, long cy, long dx, long dy, double sa, double ea)
+{
+    long x = cx + dx, y = cy + dy;
+    if (x < t->clip_x0 || x >= t->clip_x1 || y < t->clip_y0 || y >= t->clip_y1) return;
+
+    double angle = flo_mod(atan2((double)(-dy), (double)dx), 2 * M_PI);
+    int in_range = sa <= ea ? (sa <= angle && angle <= ea) : (angle >= sa || angle <= ea);
+
+    if (in_range) plot(t, cx + dx, cy + dy);
+}
+
+static void
+raster_arc(const cw_raster_t *t, long cx, long cy, long r,
+           double start_angle, double end_angle, long sw)
+{
+    double sa = flo_mod(start_angle, 2 * M_PI);
+    double ea = flo_mod(end_angle, 2 * M_PI);
+    long r_lo = sw <= 1 ? r : r - sw / 2;
+    long r_hi = sw <= 1 ? r : r + (sw - 1) / 2;
+
+    for (long cr = r_lo; cr <= r_hi; cr++) {
+        if (cr <= 0) continue;
+
+        long xi = 0, yi = cr, d = 1 - cr;
+        while (xi <= yi) {
+            arc_plot(t, cx, cy,  xi,  yi, sa, ea);
+            arc_plot(t, cx, cy, -xi,  yi, sa, ea);
+            arc_plot(t, cx, cy,  xi, -yi, sa, ea);
+            arc_plot(t, cx, cy, -xi, -yi, sa, ea);
+            arc_plot(t, cx, cy,  yi,  xi, sa, ea);
+            arc_plot(t, cx, cy, -yi,  xi, sa, ea);
+            arc_plot(t, cx, cy,  yi, -xi, sa, ea);
+            arc_plot(t, cx, cy, -yi, -xi, sa, ea);
+            xi++;
+            if (d < 0) {
+                d += 2 * xi + 1;
+            } else {
+                yi--;
+                d += 2 * (xi - yi) + 1;
+            }
+        }
+    }
+}
+
+/* ---- Polygon ---- */
+
+static int
+cmp_long(const void *a, const void *b)
+{
+    long x = *(const long *)a, y = *(const long *)b;
+    return (x > y) - (x < y);
+}
+
+/* Scanline edge intersection over n vertices (xs[i], ys[i]) */
+static void
+raster_polygon(const cw_raster_t *t, const long *xs, const long *ys, long n, long *hits)
+{
+    long min_y = ys[0], max_y = ys[0];
+
+    for (long i = 1; i < n; i++) {
+        if (ys[i] < min_y) min_y = ys[i];
+        if (ys[i] > max_y) max_y = ys[i];
+    }
+    if (min_y < t->clip_y0) min_y = t->clip_y0;
+    if (max_y > t->clip_y1 - 1) max_y = t->clip_y1 - 1;
+
+    for (long scan_y = min_y; scan_y <= max_y; scan_y++) {
+        long count = 0;
+
+        for (long i = 0; i < n; i++) {
+            long x0 = xs[i], y0 = ys[i];
+            long x1 = xs[(i + 1) % n], y1 = ys[(i + 1) % n];
+
+            if (y0 == y1) continue;
+            if (y0 > y1) {
+                long tx = x0, ty = y0;
+                x0 = x1; y0 = y1;
+                x1 = tx; y1 = ty;
+            }
+            if (scan_y < y0 || scan_y >= y1) continue;
+
+            hits[count++] = x0 + (long)floor_div((int64_t)(scan_y - y0) * (x1 - x0), y1 - y0);
+        }
+
+        qsort(hits, (size_t)count, sizeof(long), cmp_long);
+        for (long i = 0; i + 1 < count; i += 2) {
+            cw_raster_span(t, hits[i], hits[i + 1], scan_y);
+        }
+    }
+}
+
+/* ---- Flood fill ---- */
+
+/* Raw pixel value at local (x, y): the RGBA word, or the palette index bits */
+static inline uint32_t
+pixel_at(const cw_raster_t *t, long x, long y)
+{
+    const uint8_t *row = t->buf + (t->oy + y) * t->stride;
+
+    x += t->ox;
+
+    if (t->bpp == 32) {
+        uint32_t v;
+        memcpy(&v, row + x * 4, 4);
+        return v;
+    }
+
+    int ppb = 8 / t->bpp;
+    int shift = 8 - (int)(x % ppb + 1) * t->bpp;
+    return (uint32_t)(row[x / ppb] >> shift) & ((1u << t->bpp) - 1);
+}
+
+/* The value a span write stores, in pixel_at's representation */
+static uint32_t
+paint_value(const cw_raster_t *t)
+{
+    if (t->bpp == 32) {
+        uint32_t v;
+        memcpy(&v, t->rgba, 4);
+        return v;
+    }
+    return (uint32_t)t->fill & ((1u << t->bpp) - 1);
+}
+
+typedef struct {
+    VALUE str; /* backing String, grown by doubling */
+    long  len; /* seeds in use */
+    long  cap;
+} seed_stack_t;
+
+static void
+seed_push(seed_stack_t *st, long x, long y)
+{
+    if (st->len == st->cap) {
+        st->cap *= 2;
+        rb_str_resize(st->str, st->cap * 2 * (long)sizeof(long));
+    }
+    long *seeds = (long *)RSTRING_PTR(st->str);
+    seeds[st->len * 2]     = x;
+    seeds[st->len * 2 + 1] = y;
+    st->len++;
+}
+
+/* Pushes the first pixel of every run of +target+ in row y, x0..x1 */
+static void
+seed_runs(const cw_raster_t *t, seed_stack_t *st, long x0, long x1, long y, uint32_t target)
+{
+    int in_run = 0;
+
+    for (long x = x0; x <= x1; x++) {
+        if (pixel_at(t, x, y) == target) {
+            if (!in_run) seed_push(st, x, y);
+            in_run = 1;
+        } else {
+            in_run = 0;
+        }
+    }
+}
+
+/* Scanline fill of the 4-connected region of (x, y)'s value. Seeds live
+ * in a String-backed stack (one per run, sized for a screenful up front),
+ * so the fill allocates nothing per pixel. */
+static void
+raster_flood(const cw_raster_t *t, long x, long y)
+{
+    if (x < t->clip_x0 || x >= t->clip_x1 || y < t->clip_y0 || y >= t->clip_y1) return;
+
+    uint32_t target = pixel_at(t, x, y);
+    if (target == paint_value(t)) return;
+
+    seed_stack_t st = { .len = 0, .cap = (t->clip_y1 - t->clip_y0) * 2 };
+    st.str = rb_str_buf_new(st.cap * 2 * (long)sizeof(long));
+    rb_str_resize(st.str, st.cap * 2 * (long)sizeof(long));
+    seed_push(&st, x, y);
+
+    while (st.len > 0) {
+        st.len--;
+        const long *seed = (const long *)RSTRING_PTR(st.str) + st.len * 2;
+        long sx = seed[0], sy = seed[1];
+        if (pixel_at(t, sx, sy) != target) continue;
+
+        long lx = sx, rx = sx;
+        while (lx > t->clip_x0 && pixel_at(t, lx - 1, sy) == target) lx--;
+        while (rx < t->clip_x1 - 1 && pixel_at(t, rx + 1, sy) == target) rx++;
+
+        cw_raster_span(t, lx, rx, sy);
+
+        if (sy > t->clip_y0) seed_runs(t, &st, lx, rx, sy - 1, target);
+        if (sy < t->clip_y1 - 1) seed_runs(t, &st, lx, rx, sy + 1, target);
+    }
+
+    RB_GC_GUARD(st.str);
+}
+
+/* ---- Argument decoding and dispatch ---- */
+
+static int
+arg_long(VALUE v, long limit, long *out)
+{
+    if (!FIXNUM_P(v)) return 0;
+
+    long n = FIX2LONG(v);
+    if (n < -limit || n > limit) return 0;
+    *out = n;
+    return 1;
+}
+
+static int
+args_long(int argc, const VALUE *argv, long limit, long *out)
+{
+    for (int i = 0; i < argc; i++) {
+        if (!arg_long(argv[i], limit, &out[i])) return 0;
+    }
+    return 1;
+}
+
+static VALUE
+draw_polygon(const cw_raster_t *t, VALUE rb_points)
+{
+    if (!RB_TYPE_P(rb_points, T_ARRAY)) return Qfalse;
+
+    long n = RARRAY_LEN(rb_points);
+    if (n < 3) return Qfalse;
+
+    VALUE tmp;
+    long *xs = ALLOCV_N(long, tmp, (size_t)n * 3);
+    long *ys = xs + n;
+
+    for (long i = 0; i < n; i++) {
+        VALUE pt = RARRAY_AREF(rb_points, i);
+        if (!RB_TYPE_P(pt, T_ARRAY) || RARRAY_LEN(pt) != 2 ||
+            !arg_long(RARRAY_AREF(pt, 0), RASTER_LIMIT, &xs[i]) ||
+            !arg_long(RARRAY_AREF(pt, 1), RASTER_LIMIT, &ys[i])) {
+            ALLOCV_END(tmp);
+            return Qfalse;
+        }
+    }
+
+    raster_polygon(t, xs, ys, n, ys + n);
+    ALLOCV_END(tmp);
+    return Qtrue;
+}
+
+/*
+ * Coordinate lists of the batch shapes: a String of packed little-endian
+ * int16, or an Array of Integers (points) or of Integer triples (runs).
+ */
+static inline long
+packed_at(VALUE str, long i)
+{
+    const uint8_t *p = (const uint8_t *)RSTRING_PTR(str) + i * 2;
+    return (long)(int16_t)(uint16_t)(p[0] | (p[1] << 8));
+}
+
+/* Number of coordinates in +v+, or -1 if it cannot be read natively */
+static long
+coords_len(VALUE v)
+{
+    if (RB_TYPE_P(v, T_STRING)) return RSTRING_LEN(v) % 2 ? -1 : RSTRING_LEN(v) / 2;
+    if (!RB_TYPE_P(v, T_ARRAY)) return -1;
+
+    long n = RARRAY_LEN(v), unused;
+    for (long i = 0; i < n; i++) {
+        if (!arg_long(RARRAY_AREF(v, i), RASTER_LIMIT, &unused)) return -1;
+    }
+    return n;
+}
+
+static inline long
+coord_at(VALUE v, long i)
+{
+    return RB_TYPE_P(v, T_STRING) ? packed_at(v, i) : FIX2LONG(RARRAY_AREF(v, i));
+}
+
+static VALUE
+draw_points(const cw_raster_t *t, VALUE rb_xs, VALUE rb_ys)
+{
+    long n = coords_len(rb_xs);
+    if (n < 0 || coords_len(rb_ys) != n) return Qfalse;
+
+    for (long i = 0; i < n; i++) plot(t, coord_at(rb_xs, i), coord_at(rb_ys, i));
+    return Qtrue;
+}
+
+static VALUE
+draw_runs(const cw_raster_t *t, VALUE rb_runs)
+{
+    if (RB_TYPE_P(rb_runs, T_STRING)) {
+        long n = RSTRING_LEN(rb_runs) / 6;
+        if (RSTRING_LEN(rb_runs) % 6) return Qfalse;
+        for (long i = 0; i < n; i++) {
+            long x = packed_at(rb_runs, i * 3), len = packed_at(rb_runs, i * 3 + 2);
+            if (len > 0) cw_raster_span(t, x, x + len - 1, packed_at(rb_runs, i * 3 + 1));
+        }
+        return Qtrue;
+    }
+    if (!RB_TYPE_P(rb_runs, T_ARRAY)) return Qfalse;
+
+    long n = RARRAY_LEN(rb_runs);
+    for (long i = 0; i < n; i++) {
+        VALUE run = RARRAY_AREF(rb_runs, i);
+        if (!RB_TYPE_P(run, T_ARRAY) || RARRAY_LEN(run) != 3 || coords_len(run) != 3) return Qfalse;
+    }
+    for (long i = 0; i < n; i++) {
+        VALUE run = RARRAY_AREF(rb_runs, i);
+        long x = FIX2LONG(RARRAY_AREF(run, 0)), len = FIX2LONG(RARRAY_AREF(run, 2));
+        if (len > 0) cw_raster_span(t, x, x + len - 1, FIX2LONG(RARRAY_AREF(run, 1)));
+    }
+    return Qtrue;
+}
+
+static VALUE
+raster_draw(const cw_raster_t *t, VALUE rb_shape, int argc, const VALUE *argv)
+{
+    ID shape = SYM2ID(rb_to_symbol(rb_shape));
+    long a[6];
+
+#define SHAPE(id, n, limit) (shape == (id) && argc == (n) && args_long(argc, argv, (limit), a))
+
+    if (shape == id_polygon && argc == 1) return draw_polygon(t, argv[0]);
+    if (shape == id_points && argc == 2)  return draw_points(t, argv[0], argv[1]);
+    if (shape == id_runs && argc == 1)    return draw_runs(t, argv[0]);
+
+    if (shape == id_arc && argc == 6) {
+        if (!arg_long(argv[0], RASTER_LIMIT, &a[0]) || !arg_long(argv[1], RASTER_LIMIT, &a[1]) ||
+            !arg_long(argv[2], RASTER_LIMIT, &a[2]) || !arg_long(argv[5], RASTER_LIMIT, &a[5]))
+            return Qfalse;
+        raster_arc(t, a[0], a[1], a[2], NUM2DBL(argv[3]), NUM2DBL(argv[4]), a[5]);
+    } else if (SHAPE(id_flood, 2, RASTER_LIMIT)) {
+        raster_flood(t, a[0], a[1]);
+    } else if (SHAPE(id_line, 4, RASTER_LIMIT)) {
+        raster_line(t, a[0], a[1], a[2], a[3]);
+    } else if (SHAPE(id_thick_line, 5, RASTER_LIMIT)) {
+        raster_thick_line(t, a[0], a[1], a[2], a[3], a[4]);
+    } else if (SHAPE(id_rect, 4, RASTER_LIMIT)) {
+        raster_rect(t, a[0], a[1], a[2], a[3]);
+    } else if (SHAPE(id_fill_circle, 3, RASTER_LIMIT)) {
+        raster_fill_circle(t, a[0], a[1], a[2]);
+    } else if (SHAPE(id_circle, 3, RASTER_LIMIT)) {
+        raster_circle(t, a[0], a[1], a[2]);
+    } else if (SHAPE(id_annulus, 4, RASTER_LIMIT)) {
+        raster_annulus(t, a[0], a[1], a[2], a[3]);
+    } else if (SHAPE(id_quarter_circle, 5, RASTER_LIMIT)) {
+        raster_quarter_circle(t, a[0], a[1], a[2], a[3], a[4]);
+    } else if (SHAPE(id_fill_ellipse, 4, RASTER_LIMIT)) {
+        raster_ellipse(t, a[0], a[1], a[2], a[3], 1);
+    } else if (SHAPE(id_ellipse, 4, RASTER_LIMIT)) {
+        raster_ellipse(t, a[0], a[1], a[2], a[3], 0);
+    } else if (SHAPE(id_ellipse_annulus, 6, RASTER_LIMIT)) {
+        raster_ellipse_annulus(t, a[0], a[1], a[2], a[3], a[4], a[5]);
+    } else {
+        return Qfalse;
+    }
+
+#undef SHAPE
+
+    return Qtrue;
+}
+
+/*
+ * Sets up the offset and clip of a width x height target from +rb_window+:
+ * nil for the whole target, or [ox, oy, x0, y0, x1, y1] to draw local
+ * coordinates at (ox, oy) clipped to [x0, x1) x [y0, y1) — the window a
+ * Layer composes from its offset and bounds. The clip is narrowed to the
+ * target. Returns 0 if the window is malformed.
+ */
+static int
+raster_window(cw_raster_t *t, VALUE rb_window, long width, long height)
+{
+    long w[6] = { 0, 0, 0, 0, width, height };
+
+    if (!NIL_P(rb_window)) {
+        if (!RB_TYPE_P(rb_window, T_ARRAY) || RARRAY_LEN(rb_window) != 6) return 0;
+        for (int i = 0; i < 6; i++) {
+            if (!arg_long(RARRAY_AREF(rb_window, i), RASTER_LIMIT, &w[i])) return 0;
+        }
+    }
+
+    t->ox = w[0];
+    t->oy = w[1];
+    t->clip_x0 = w[2] > -w[0] ? w[2] : -w[0];
+    t->clip_y0 = w[3] > -w[1] ? w[3] : -w[1];
+    t->clip_x1 = w[4] < width - w[0] ? w[4] : width - w[0];
+    t->clip_y1 = w[5] < height - w[1] ? w[5] : height - w[1];
+    return 1;
+}
+
+/* ---- Canvas#_canvas_raster(buf, dw, dh, window, shape, rgba, *args) ----
+ *
+ * Rasterizes +shape+ into a Canvas RGBA buffer with the 4-byte colour
+ * +rgba+, through +window+ (see raster_window()). Returns true, or false
+ * if the arguments need the Ruby path.
+ */
+static VALUE
+canvas_raster(int argc, VALUE *argv, VALUE self)
+{
+    (void)self;
+
+    if (argc < 6) rb_error_arity(argc, 6, UNLIMITED_ARGUMENTS);
+
+    VALUE rb_buf  = argv[0];
+    VALUE rb_rgba = argv[5];
+    Check_Type(rb_rgba, T_STRING);
+
+    int dw = NUM2INT(argv[1]);
+    int dh = NUM2INT(argv[2]);
+    if (dw <= 0 || dh <= 0 || dw > EPD_MAX_DIMENSION || dh > EPD_MAX_DIMENSION) return Qfalse;
+    if (RSTRING_LEN(rb_rgba) != 4) return Qfalse;
+
+    cw_view_t v;
+    cw_view(rb_buf, 4, dw, 1, &v);
+    if (v.rows < dh) return Qfalse;
+
+    cw_raster_t t = {
+        .buf    = v.data,
+        .stride = (long)v.stride,
+        .bpp    = 32,
+    };
+    if (!raster_window(&t, argv[3], dw, dh)) return Qfalse;
+    memcpy(t.rgba, RSTRING_PTR(rb_rgba), 4);
+
+    VALUE drawn = raster_draw(&t, argv[4], argc - 6, argv + 6);
+    RB_GC_GUARD(rb_buf);
+    return drawn;
+}
+
+/* ---- GrayCanvas#_gray_raster(buf, dw, dh, window, shape, luma, *args) ----
+ * ---- IndexedCanvas#_indexed_raster(buf, dw, dh, window, shape, index, *args) ----
+ *
+ * Rasterizes +shape+ into a one-byte-per-pixel buffer with the value
+ * +luma+ / +index+; the buffer is written like a packed target of
+ * eight bits per pixel.
+ */
+static VALUE
+byte_raster(int argc, VALUE *argv, VALUE self)
+{
+    (void)self;
+
+    if (argc < 6) rb_error_arity(argc, 6, UNLIMITED_ARGUMENTS);
+
+    VALUE rb_buf = argv[0];
+
+    int dw = NUM2INT(argv[1]);
+    int dh = NUM2INT(argv[2]);
+    if (dw <= 0 || dh <= 0 || dw > EPD_MAX_DIMENSION || dh > EPD_MAX_DIMENSION) return Qfalse;
+
+    cw_view_t v;
+    cw_view(rb_buf, 1, dw, 1, &v);
+    if (v.rows < dh) return Qfalse;
+
+    cw_raster_t t = {
+        .buf    = v.data,
+        .stride = (long)v.stride,
+        .bpp    = 8,
+        .fill   = (uint8_t)(NUM2INT(argv[5]) & 0xFF),
+    };
+    if (!raster_window(&t, argv[3], dw, dh)) return Qfalse;
+
+    VALUE drawn = raster_draw(&t, argv[4], argc - 6, argv + 6);
+    RB_GC_GUARD(rb_buf);
+    return drawn;
+}
+
+/* ---- Framebuffer#_raster(window, shape, color, *args) ----
+ *
+ * Rasterizes +shape+ into the packed buffer with palette index +color+,
+ * through +window+ (see raster_window()). Returns true, or false if the
+ * arguments need the Ruby path.
+ */
+static VALUE
+fb_raster(int argc, VALUE *argv, VALUE self)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+
+    if (argc < 3) rb_error_arity(argc, 3, UNLIMITED_ARGUMENTS);
+
+    uint8_t c = (uint8_t)(NUM2INT(argv[2]) & 0xFF);
+    cw_raster_t t = {
+        .buf    = fb->buffer,
+        .stride = fb->width_byte,
+    };
+    if (!raster_window(&t, argv[0], fb->width, fb->height)) return Qfalse;
+
+    switch (fb->pixel_format) {
+    case PIXEL_FORMAT_MONO:
+        t.bpp  = 1;
+        t.fill = c == 0 ? 0x00 : 0xFF;
+        break;
+    case PIXEL_FORMAT_GRAY4:
+    case PIXEL_FORMAT_COLOR4_2BPP:
+        c &= 0x03;
+        t.bpp  = 2;
+        t.fill = (uint8_t)((c << 6) | (c << 4) | (c << 2) | c);
+        break;
+    case PIXEL_FORMAT_COLOR4:
+    case PIXEL_FORMAT_COLOR7:
+        c &= 0x0F;
+        t.bpp  = 4;
+        t.fill = (uint8_t)((c << 4) | c);
+        break;
+    }
+
+    cw_fb_touch(fb);
+    return raster_draw(&t, argv[1], argc - 3, argv + 3);
+}
+
+/* ---- Init_raster() ---- */
+void
+Init_raster(void)
+{
+    id_line            = rb_intern("line");
+    id_thick_line      = rb_intern("thick_line");
+    id_rect            = rb_intern("rect");
+    id_fill_circle     = rb_intern("fill_circle");
+    id_circle          = rb_intern("circle");
+    id_annulus         = rb_intern("annulus");
+    id_quarter_circle  = rb_intern("quarter_circle");
+    id_fill_ellipse    = rb_intern("fill_ellipse");
+    id_ellipse         = rb_intern("ellipse");
+    id_ellipse_annulus = rb_intern("ellipse_annulus");
+    id_arc             = rb_intern("arc");
+    id_polygon         = rb_intern("polygon");
+    id_flood           = rb_intern("flood");
+    id_points          = rb_intern("points");
+    id_runs            = rb_intern("runs");
+
+    rb_define_private_method(rb_cCanvas,        "_canvas_raster",  canvas_raster, -1);
+    rb_define_private_method(rb_cGrayCanvas,    "_gray_raster",    byte_raster,   -1);
+    rb_define_private_method(rb_cIndexedCanvas, "_indexed_raster", byte_raster,   -1);
+    rb_define_private_method(rb_cFramebuffer,   "_raster",         fb_raster,     -1);
+}
@@ -0,0 +1,34 @@
+#ifndef CHROMA_WAVE_RASTER_H
+#define CHROMA_WAVE_RASTER_H
+
+#include "chroma_wave.h"
+
+/*
+ * Span target for the native shape rasterizer: either a Canvas RGBA
+ * buffer (bpp == 32), a GrayCanvas buffer (bpp == 8) or a packed
+ * Framebuffer buffer (bpp 1, 2 or 4, most significant bits first). Every write is an opaque overwrite
+ * with a single pre-resolved colour, so shapes can be emitted as
+ * horizontal spans in any order.
+ *
+ * Shapes are drawn in local coordinates: pixel (x, y) lands at buffer
+ * (ox + x, oy + y), and only local pixels inside the clip window
+ * [clip_x0, clip_x1) x [clip_y0, clip_y1) are written. A whole surface
+ * has a zero offset and a clip of its full size; a Layer translates
+ * and narrows both (see raster_window()).
+ */
+typedef struct {
+    uint8_t *buf;
+    long     stride;  /* bytes per row */
+    long     ox, oy;  /* local -> buffer offset */
+    long     clip_x0, clip_y0, clip_x1, clip_y1;
+    int      bpp;
+    uint8_t  rgba[4]; /* bpp == 32: the colour's RGBA bytes */
+    uint8_t  fill;    /* bpp < 32: the colour replicated across a byte */
+} cw_raster_t;
+
+/* Writes local pixels x0..x1 (inclusive) of row y, clipped to the window */
+void cw_raster_span(const cw_raster_t *t, long x0, long x1, long y);
+
+void Init_raster(void);
+
+#endif /* CHROMA_WAVE_RASTER_H */
@@ -0,0 +1,245 @@
+#include "chroma_wave.h"
+#include "pixel_buffer.h"
+
+/*
+ * Fixed-point RGBA resampler behind Canvas#resample, #downsample and
+ * #blit_scaled.
+ *
+ * Each axis is reduced to a tap table once: for every destination
+ * column (or row) the first source index and a run of weights in
+ * 1/256 pixel units. Nearest picks the source pixel under the centre,
+ * bilinear weights the two neighbours of the centre-aligned sample
+ * point, and box weights every source pixel by how much of it the
+ * destination pixel covers — an exact factor x factor average when
+ * downsampling by an integer factor.
+ *
+ * The filter is separable: each contributing source row is resampled
+ * horizontally into a row of 64-bit sums, which is then accumulated
+ * vertically. Colours are weighted by alpha (premultiplied) so
+ * transparent pixels do not bleed their colour into their
+ * neighbours, then divided back out with rounding. All arithmetic is
+ * integer, so the Ruby fallback (lib/chroma_wave/resampling.rb)
+ * reproduces it exactly.
+ *
+ * Bounds: a single tap weighs at most 256, and per-pixel weight sums
+ * are at most EPD_MAX_DIMENSION * 256 per axis, so the largest sum
+ * (2^20 * 2^20 * 255 * 255) stays below 2^57.
+ */
+
+enum { FILTER_NEAREST, FILTER_BILINEAR, FILTER_BOX };
+
+static ID id_nearest, id_bilinear, id_box;
+
+typedef struct {
+    long     *first; /* first source index per destination index */
+    int      *count; /* number of taps */
+    long     *wofs;  /* offset of the taps' weights in w */
+    uint32_t *w;     /* weights, 256 == one whole source pixel */
+    uint64_t *wsum;  /* sum of the taps' weights */
+} taps_t;
+
+/* Upper bound on the total number of taps build_taps() emits */
+static long
+taps_capacity(long s, long d)
+{
+    return s + 2 * d;
+}
+
+static void
+build_taps(int filter, long s, long d, taps_t *t)
+{
+    long n = 0;
+
+    for (long i = 0; i < d; i++) {
+        t->wofs[i] = n;
+
+        if (filter == FILTER_NEAREST) {
+            t->first[i] = (2 * i + 1) * s / (2 * d);
+            t->count[i] = 1;
+            t->w[n++]   = 256;
+        } else if (filter == FILTER_BILINEAR) {
+            long p = (2 * i + 1) * s * 256 / (2 * d) - 128;
+            if (p < 0) p = 0;
+            long i0 = p >> 8;
+            if (i0 >= s - 1) {
+                t->first[i] = s - 1;
+                t->count[i] = 1;
+                t->w[n++]   = 256;
+            } else {
+                t->first[i] = i0;
+                t->count[i] = 2;
+                t->w[n++]   = (uint32_t)(256 - (p & 255));
+                t->w[n++]   = (uint32_t)(p & 255);
+            }
+        } else {
+            long start = i * s * 256 / d;
+            long end   = (i + 1) * s * 256 / d;
+            if (end <= start) end = start + 1;
+            long i0 = start >> 8;
+            long i1 = (end - 1) >> 8;
+            t->first[i] = i0;
+            t->count[i] = (int)(i1 - i0 + 1);
+            for (long k = i0; k <= i1; k++) {
+                long lo = k * 256 > start ? k * 256 : start;
+                long hi = (k + 1) * 256 < end ? (k + 1) * 256 : end;
+                t->w[n++] = (uint32_t)(hi - lo);
+            }
+        }
+
+        uint64_t sum = 0;
+        for (int k = 0; k < t->count[i]; k++) sum += t->w[t->wofs[i] + k];
+        t->wsum[i] = sum;
+    }
+}
+
+/* Horizontal pass: one source row into dw premultiplied (r, g, b, a) sums */
+static void
+resample_row(const uint8_t *src, const taps_t *tx, long dw, uint64_t *out)
+{
+    for (long dx = 0; dx < dw; dx++) {
+        const uint8_t  *p = src + tx->first[dx] * 4;
+        const uint32_t *w = tx->w + tx->wofs[dx];
+        uint64_t r = 0, g = 0, b = 0, a = 0;
+
+        for (int k = 0; k < tx->count[dx]; k++, p += 4) {
+            uint64_t wa = (uint64_t)w[k] * p[3];
+            r += wa * p[0];
+            g += wa * p[1];
+            b += wa * p[2];
+            a += wa;
+        }
+        out[dx * 4 + 0] = r;
+        out[dx * 4 + 1] = g;
+        out[dx * 4 + 2] = b;
+        out[dx * 4 + 3] = a;
+    }
+}
+
+static int
+filter_from_symbol(VALUE sym)
+{
+    ID id = SYMBOL_P(sym) ? SYM2ID(sym) : 0;
+    if (id == id_nearest)  return FILTER_NEAREST;
+    if (id == id_bilinear) return FILTER_BILINEAR;
+    if (id == id_box)      return FILTER_BOX;
+    rb_raise(rb_eArgError, "unknown filter: %+"PRIsVALUE, sym);
+    UNREACHABLE_RETURN(FILTER_NEAREST);
+}
+
+/* ---- _canvas_resample(dst, dw, dh, src, sw, sh, filter) ----
+ *
+ * Resamples the whole sw x sh RGBA src onto the whole dw x dh RGBA
+ * dst, overwriting it.
+ */
+static VALUE
+canvas_resample(VALUE self,
+                VALUE rb_dst, VALUE rb_dw, VALUE rb_dh,
+                VALUE rb_src, VALUE rb_sw, VALUE rb_sh,
+                VALUE rb_filter)
+{
+    (void)self;
+
+    long dw = NUM2LONG(rb_dw);
+    long dh = NUM2LONG(rb_dh);
+    long sw = NUM2LONG(rb_sw);
+    long sh = NUM2LONG(rb_sh);
+    int filter = filter_from_symbol(rb_filter);
+
+    if (sw <= 0 || sh <= 0 || dw <= 0 || dh <= 0 ||
+        sw > EPD_MAX_DIMENSION || sh > EPD_MAX_DIMENSION ||
+        dw > EPD_MAX_DIMENSION || dh > EPD_MAX_DIMENSION) {
+        rb_raise(rb_eArgError, "invalid resample dimensions %ldx%ld -> %ldx%ld", sw, sh, dw, dh);
+    }
+
+    cw_view_t d, s;
+    cw_view(rb_dst, 4, dw, 1, &d);
+    cw_view(rb_src, 4, sw, 0, &s);
+    if (d.rows < dh || s.rows < sh) {
+        rb_raise(rb_eArgError, "buffer too small for %ldx%ld -> %ldx%ld", sw, sh, dw, dh);
+    }
+
+    VALUE tmp_x, tmp_y, tmp_row;
+    taps_t tx, ty;
+    long   cap_x = taps_capacity(sw, dw);
+    long   cap_y = taps_capacity(sh, dh);
+    /* One block per axis: first/wofs (longs), wsum (u64), count (ints), w (u32) */
+    size_t size_x = (size_t)dw * (2 * sizeof(long) + sizeof(uint64_t) + sizeof(int)) +
+                    (size_t)cap_x * sizeof(uint32_t);
+    size_t size_y = (size_t)dh * (2 * sizeof(long) + sizeof(uint64_t) + sizeof(int)) +
+                    (size_t)cap_y * sizeof(uint32_t);
+    char *bx = ALLOCV(tmp_x, size_x);
+    char *by = ALLOCV(tmp_y, size_y);
+
+    tx.first = (long *)bx;      tx.wofs  = tx.first + dw;
+    tx.wsum  = (uint64_t *)(tx.wofs + dw);
+    tx.count = (int *)(tx.wsum + dw);
+    tx.w     = (uint32_t *)(tx.count + dw);
+    ty.first = (long *)by;      ty.wofs  = ty.first + dh;
+    ty.wsum  = (uint64_t *)(ty.wofs + dh);
+    ty.count = (int *)(ty.wsum + dh);
+    ty.w     = (uint32_t *)(ty.count + dh);
+
+    build_taps(filter, sw, dw, &tx);
+    build_taps(filter, sh, dh, &ty);
+
+    if (filter == FILTER_NEAREST) {
+        for (long dy = 0; dy < dh; dy++) {
+            const uint8_t *srow = s.data + (size_t)ty.first[dy] * s.stride;
+            uint8_t       *drow = d.data + (size_t)dy * d.stride;
+            for (long dx = 0; dx < dw; dx++) {
+                memcpy(drow + dx * 4, srow + tx.first[dx] * 4, 4);
+            }
+        }
+        ALLOCV_END(tmp_y);
+        ALLOCV_END(tmp_x);
+        return Qnil;
+    }
+
+    uint64_t *hrow = ALLOCV_N(uint64_t, tmp_row, (size_t)dw * 8);
+    uint64_t *acc  = hrow + dw * 4;
+
+    for (long dy = 0; dy < dh; dy++) {
+        const uint32_t *wy = ty.w + ty.wofs[dy];
+
+        memset(acc, 0, (size_t)dw * 4 * sizeof(uint64_t));
+        for (int k = 0; k < ty.count[dy]; k++) {
+            resample_row(s.data + (size_t)(ty.first[dy] + k) * s.stride, &tx, dw, hrow);
+            /* Vertical pass: a straight multiply-add over the row */
+            uint64_t w = wy[k];
+            for (long i = 0; i < dw * 4; i++) acc[i] += w * hrow[i];
+        }
+
+        uint8_t *drow = d.data + (size_t)dy * d.stride;
+        for (long dx = 0; dx < dw; dx++) {
+            const uint64_t *px = acc + dx * 4;
+            uint64_t total = tx.wsum[dx] * ty.wsum[dy];
+            uint64_t a     = px[3];
+            uint8_t *out   = drow + dx * 4;
+
+            out[3] = (uint8_t)((a + total / 2) / total);
+            if (a == 0) {
+                out[0] = out[1] = out[2] = 0;
+            } else {
+                out[0] = (uint8_t)((px[0] + a / 2) / a);
+                out[1] = (uint8_t)((px[1] + a / 2) / a);
+                out[2] = (uint8_t)((px[2] + a / 2) / a);
+            }
+        }
+    }
+
+    ALLOCV_END(tmp_row);
+    ALLOCV_END(tmp_y);
+    ALLOCV_END(tmp_x);
+    return Qnil;
+}
+
+/* ---- Init_resample() ---- */
+void
+Init_resample(void)
+{
+    id_nearest  = rb_intern("nearest");
+    id_bilinear = rb_intern("bilinear");
+    id_box      = rb_intern("box");
+
+    rb_define_private_method(rb_cCanvas, "_canvas_resample", canvas_resample, 7);
+}
@@ -0,0 +1,369 @@
+#include "framebuffer.h"
+
+#ifdef HAVE_SYS_MMAN_H
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <ruby/thread.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Framebuffers backed by a shared file mapping, so that one process can
+ * render frames and another send them to the panel with no copying or
+ * encoding in between.
+ *
+ * The file (a regular file, or an object under /dev/shm) is a 64-byte
+ * header followed by the packed pixels, laid out exactly as in a heap
+ * framebuffer:
+ *
+ *    0  magic "CWFRAME" + version byte   8 bytes
+ *    8  width, height                    uint32 each
+ *   16  pixel format, bytes per row      uint32 each
+ *   24  pixel bytes                      uint64
+ *   32  sequence                         uint32
+ *   36  reserved (zero)
+ *
+ * Fields are in host byte order: both sides run on the same machine.
+ *
+ * The sequence is both a seqlock and a wait word. The producer makes it
+ * odd before writing a frame and even again after (_frame_begin and
+ * _frame_end); consumers block until it reaches a new even value
+ * (_frame_wait), on Linux with a futex on the shared word, elsewhere by
+ * polling every millisecond.
+ */
+
+typedef struct {
+    char     magic[8];
+    uint32_t width;
+    uint32_t height;
+    uint32_t pixel_format;
+    uint32_t width_byte;
+    uint64_t buffer_size;
+    uint32_t sequence;
+    uint8_t  reserved[28];
+} frame_header_t;
+
+#define FRAME_HEADER_SIZE 64
+
+static const char frame_magic[8] = { 'C', 'W', 'F', 'R', 'A', 'M', 'E', 1 };
+
+static frame_header_t *
+header_of(VALUE self)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+    if (!fb->mapping) rb_raise(rb_eChromaWaveError, "framebuffer is not mapped");
+    return (frame_header_t *)fb->mapping;
+}
+
+static int
+valid_dimension(uint32_t v)
+{
+    return v >= 1 && v <= EPD_MAX_DIMENSION;
+}
+
+/* Arguments passed to flock_without_gvl (no VALUE fields!) */
+typedef struct {
+    int fd;
+    int result;
+    int error;
+} flock_args_t;
+
+/* Runs WITHOUT the GVL: takes the exclusive lock, however long another
+ * process holds it */
+static void *
+flock_without_gvl(void *arg)
+{
+    flock_args_t *args = (flock_args_t *)arg;
+    args->result = flock(args->fd, LOCK_EX);
+    args->error  = errno;
+    return NULL;
+}
+
+/*
+ * Opens path and takes its exclusive lock with the GVL released, so
+ * other threads run while another process holds it. RUBY_UBF_IO
+ * interrupts a waiting flock with EINTR; the file is then closed before
+ * pending interrupts run (they may raise) and the wait starts over.
+ * Returns the locked descriptor.
+ */
+static int
+open_locked(VALUE rb_path, const char *path, int flags)
+{
+    for (;;) {
+        int fd = open(path, flags, 0666);
+        if (fd < 0) rb_sys_fail_str(rb_path);
+
+        flock_args_t args = { fd, -1, 0 };
+        rb_thread_call_without_gvl(flock_without_gvl, &args, RUBY_UBF_IO, NULL);
+        if (args.result == 0) return fd;
+
+        close(fd);
+        if (args.error != EINTR) {
+            errno = args.error;
+            rb_sys_fail_str(rb_path);
+        }
+        rb_thread_check_ints();
+    }
+}
+
+/*
+ * _map(path, width, height, format)
+ *
+ * Backs this (allocated, uninitialized) framebuffer with the frame file
+ * at path. With a format, creates the file if it is missing or empty and
+ * otherwise checks that it holds frames of that shape; with nil for all
+ * three, adopts the shape recorded in the file. Returns the format.
+ */
+static VALUE
+fb_map(VALUE self, VALUE rb_path, VALUE rb_width, VALUE rb_height, VALUE rb_format)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+
+    int create = !NIL_P(rb_format);
+    uint32_t w = 0, h = 0;
+    pixel_format_t fmt = PIXEL_FORMAT_MONO;
+    if (create) {
+        w   = NUM2UINT(rb_width);
+        h   = NUM2UINT(rb_height);
+        fmt = cw_sym_to_pixel_format(rb_format);
+        if (!valid_dimension(w) || !valid_dimension(h))
+            rb_raise(rb_eArgError, "width and height must be between 1 and %d", EPD_MAX_DIMENSION);
+    }
+
+    FilePathValue(rb_path);
+    const char *path = StringValueCStr(rb_path);
+
+    /* The lock serializes creation against other processes mapping the file */
+    int fd = open_locked(rb_path, path, O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0));
+
+    struct stat st;
+    int saved = 0;
+    const char *problem = NULL;
+    VALUE error = rb_eArgError;
+    void *map = MAP_FAILED;
+    size_t size = 0;
+
+    if (fstat(fd, &st) != 0) {
+        saved = errno;
+        goto done;
+    }
+
+    if (st.st_size == 0) {
+        if (!create) {
+            problem = "holds no frame yet; give width:, height: and format: to create it";
+            goto done;
+        }
+        uint16_t wb = cw_fb_width_byte((uint16_t)w, fmt);
+        size = FRAME_HEADER_SIZE + (size_t)wb * h;
+        if (ftruncate(fd, (off_t)size) != 0 ||
+            (map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+            saved = errno;
+            goto done;
+        }
+        frame_header_t *hdr = (frame_header_t *)map;
+        hdr->width        = w;
+        hdr->height       = h;
+        hdr->pixel_format = (uint32_t)fmt;
+        hdr->width_byte   = wb;
+        hdr->buffer_size  = (uint64_t)wb * h;
+        memset((uint8_t *)map + FRAME_HEADER_SIZE, fmt == PIXEL_FORMAT_MONO ? 0xFF : 0x00,
+               size - FRAME_HEADER_SIZE);
+        memcpy(hdr->magic, frame_magic, sizeof(frame_magic));
+        goto done;
+    }
+
+    size = (size_t)st.st_size;
+    if (size < FRAME_HEADER_SIZE ||
+        (map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        if (size < FRAME_HEADER_SIZE) problem = "is not a frame file";
+        else saved = errno;
+        goto done;
+    }
+
+    const frame_header_t *hdr = (const frame_header_t *)map;
+    if (memcmp(hdr->magic, frame_magic, sizeof(frame_magic)) != 0 ||
+        !valid_dimension(hdr->width) || !valid_dimension(hdr->height) ||
+        hdr->pixel_format < PIXEL_FORMAT_MONO || hdr->pixel_format > PIXEL_FORMAT_COLOR4_2BPP ||
+        hdr->width_byte != cw_fb_width_byte((uint16_t)hdr->width, (pixel_format_t)hdr->pixel_format) ||
+        hdr->buffer_size != (uint64_t)hdr->width_byte * hdr->height ||
+        size != FRAME_HEADER_SIZE + hdr->buffer_size) {
+        problem = "is not a frame file";
+    } else if (create && (hdr->width != w || hdr->height != h || hdr->pixel_format != (uint32_t)fmt)) {
+        problem = "holds frames of another shape";
+        error = rb_eFormatMismatchError;
+    }
+
+done:
+    /* The mapping keeps the open file alive, so closing alone would not
+     * drop the lock */
+    flock(fd, LOCK_UN);
+    close(fd);
+    if (problem || saved) {
+        if (map != MAP_FAILED) munmap(map, size);
+        if (saved) {
+            errno = saved;
+            rb_sys_fail_str(rb_path);
+        }
+        rb_raise(error, "%s %s", path, problem);
+    }
+
+    const frame_header_t *mapped = (const frame_header_t *)map;
+    cw_fb_release_buffer(fb);
+    fb->mapping      = map;
+    fb->mapping_size = size;
+    fb->buffer       = (uint8_t *)map + FRAME_HEADER_SIZE;
+    fb->width        = (uint16_t)mapped->width;
+    fb->height       = (uint16_t)mapped->height;
+    fb->pixel_format = (pixel_format_t)mapped->pixel_format;
+    fb->width_byte   = (uint16_t)mapped->width_byte;
+    fb->buffer_size  = (size_t)mapped->buffer_size;
+    cw_fb_touch(fb);
+
+    return cw_pixel_format_to_sym(fb->pixel_format);
+}
+
+/* ---- _frame_sequence ---- */
+static VALUE
+fb_frame_sequence(VALUE self)
+{
+    return UINT2NUM(__atomic_load_n(&header_of(self)->sequence, __ATOMIC_ACQUIRE));
+}
+
+/* ---- _frame_begin: sequence made odd before the pixels change ---- */
+static VALUE
+fb_frame_begin(VALUE self)
+{
+    frame_header_t *hdr = header_of(self);
+    uint32_t seq = __atomic_load_n(&hdr->sequence, __ATOMIC_RELAXED);
+    if (!(seq & 1)) {
+        __atomic_store_n(&hdr->sequence, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+    return UINT2NUM(seq | 1);
+}
+
+/* ---- _frame_end: sequence made even again, waiters woken ---- */
+static VALUE
+fb_frame_end(VALUE self)
+{
+    frame_header_t *hdr = header_of(self);
+    uint32_t seq = __atomic_load_n(&hdr->sequence, __ATOMIC_RELAXED);
+    seq += (seq & 1) ? 1 : 2;
+    __atomic_store_n(&hdr->sequence, seq, __ATOMIC_RELEASE);
+#ifdef __linux__
+    syscall(SYS_futex, &hdr->sequence, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+    return UINT2NUM(seq);
+}
+
+/* Arguments passed to frame_wait_without_gvl (no VALUE fields!) */
+typedef struct {
+    uint32_t       *word;
+    uint32_t        expected;
+    struct timespec timeout;
+} frame_wait_args_t;
+
+/* Runs WITHOUT the GVL: sleeps until the word changes, a wake-up, or
+ * the timeout */
+static void *
+frame_wait_without_gvl(void *arg)
+{
+    frame_wait_args_t *args = (frame_wait_args_t *)arg;
+#ifdef __linux__
+    syscall(SYS_futex, args->word, FUTEX_WAIT, args->expected, &args->timeout, NULL, 0);
+#else
+    struct timespec tick = { 0, 1000000 };
+    if (args->timeout.tv_sec == 0 && args->timeout.tv_nsec < tick.tv_nsec) tick = args->timeout;
+    nanosleep(&tick, NULL);
+#endif
+    return NULL;
+}
+
+/* Unblocking function: a spurious wake-up makes the waiter recheck */
+static void
+frame_wait_ubf(void *arg)
+{
+#ifdef __linux__
+    frame_wait_args_t *args = (frame_wait_args_t *)arg;
+    syscall(SYS_futex, args->word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+static double
+monotonic_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * _frame_wait(after, timeout)
+ *
+ * Blocks until the sequence is even and differs from after, returning
+ * it, or returns nil once timeout seconds (nil: no limit) have passed.
+ */
+static VALUE
+fb_frame_wait(VALUE self, VALUE rb_after, VALUE rb_timeout)
+{
+    frame_header_t *hdr = header_of(self);
+    uint32_t after = NUM2UINT(rb_after);
+    double deadline = NIL_P(rb_timeout) ? 0 : monotonic_now() + NUM2DBL(rb_timeout);
+    frame_wait_args_t args = { &hdr->sequence, 0, { 0, 0 } };
+
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&hdr->sequence, __ATOMIC_ACQUIRE);
+        if (!(seq & 1) && seq != after) return UINT2NUM(seq);
+
+        /* Without a limit, wake up once a second anyway */
+        double remaining = 1.0;
+        if (!NIL_P(rb_timeout)) {
+            remaining = deadline - monotonic_now();
+            if (remaining <= 0) return Qnil;
+            if (remaining > 1.0) remaining = 1.0;
+        }
+        args.expected = seq;
+        args.timeout.tv_sec  = (time_t)remaining;
+        args.timeout.tv_nsec = (long)((remaining - (double)args.timeout.tv_sec) * 1e9);
+
+        rb_thread_call_without_gvl(frame_wait_without_gvl, &args, frame_wait_ubf, &args);
+        rb_thread_check_ints();
+        RB_GC_GUARD(self);
+    }
+}
+
+#endif /* HAVE_SYS_MMAN_H */
+
+/* ---- mapped? ---- */
+static VALUE
+fb_mapped_p(VALUE self)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+    return fb->mapping ? Qtrue : Qfalse;
+}
+
+/* ---- Init_shared_frame() ---- */
+void
+Init_shared_frame(void)
+{
+    rb_define_method(rb_cFramebuffer, "mapped?", fb_mapped_p, 0);
+#ifdef HAVE_SYS_MMAN_H
+    rb_define_private_method(rb_cFramebuffer, "_map",            fb_map,            4);
+    rb_define_private_method(rb_cFramebuffer, "_frame_sequence", fb_frame_sequence, 0);
+    rb_define_private_method(rb_cFramebuffer, "_frame_begin",    fb_frame_begin,    0);
+    rb_define_private_method(rb_cFramebuffer, "_frame_end",      fb_frame_end,      0);
+    rb_define_private_method(rb_cFramebuffer, "_frame_wait",     fb_frame_wait,     2);
+#endif
+}
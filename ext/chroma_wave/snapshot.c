@@ -0,0 +1,206 @@
+#include "framebuffer.h"
+
+/*
+ * Compact snapshots of packed framebuffers, for keeping the last frame
+ * on disk and sending it again at boot without re-rendering.
+ *
+ * A snapshot is a 20-byte header followed by the rows, each coded on
+ * its own with PackBits over the packed bytes:
+ *
+ *    0  magic "CWSNAP"                   6 bytes
+ *    6  version, pixel format            uint8 each
+ *    8  width, height                    uint16 each
+ *   12  digest of the frame              uint64
+ *   20  rows
+ *
+ * Fields are little-endian, so snapshots move between hosts. PackBits
+ * works on bytes, so it needs no per-format cases: a flat area folds
+ * into a run of one byte whether it holds 8, 4 or 2 pixels per byte,
+ * as does any pattern whose period divides a byte (50% dither, stripes).
+ * Runs never cross rows, so a reader can decode a row at a time, and
+ * the digest (see Framebuffer#digest) catches truncated or damaged
+ * files, which would otherwise come back as a silently wrong frame.
+ */
+
+static const char snapshot_magic[6] = { 'C', 'W', 'S', 'N', 'A', 'P' };
+
+#define SNAPSHOT_VERSION     1
+#define SNAPSHOT_HEADER_SIZE 20
+
+/* A literal run is at most 128 bytes, so coding adds at most 1 byte in 128 */
+#define PACKED_ROW_MAX(n) ((size_t)(n) + ((size_t)(n) + 127) / 128)
+
+static void
+put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t
+get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+/*
+ * Codes n bytes as PackBits into out, returning the coded length. A
+ * control byte c < 128 is followed by c + 1 literal bytes; c > 128
+ * repeats the next byte 257 - c times. Runs of 3 or more are repeated;
+ * shorter ones stay in the literal, where they cost nothing extra.
+ */
+static size_t
+pack_row(const uint8_t *in, long n, uint8_t *out)
+{
+    uint8_t *o = out;
+    long i = 0;
+
+    while (i < n) {
+        long run = 1;
+        while (i + run < n && run < 128 && in[i + run] == in[i]) run++;
+        if (run >= 3) {
+            *o++ = (uint8_t)(257 - run);
+            *o++ = in[i];
+            i += run;
+            continue;
+        }
+
+        long start = i;
+        while (i < n && i - start < 128) {
+            if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2]) break;
+            i++;
+        }
+        *o++ = (uint8_t)(i - start - 1);
+        memcpy(o, in + start, (size_t)(i - start));
+        o += i - start;
+    }
+    return (size_t)(o - out);
+}
+
+/*
+ * Decodes exactly n bytes of PackBits from *src (up to end) into out,
+ * advancing *src. Returns 0 if the input runs out or a run overflows
+ * the row.
+ */
+static int
+unpack_row(const uint8_t **src, const uint8_t *end, uint8_t *out, long n)
+{
+    const uint8_t *p = *src;
+    long i = 0;
+
+    while (i < n) {
+        if (p >= end) return 0;
+        uint8_t c = *p++;
+        if (c < 128) {
+            long len = c + 1;
+            if (len > n - i || len > end - p) return 0;
+            memcpy(out + i, p, (size_t)len);
+            p += len;
+            i += len;
+        } else if (c > 128) {
+            long len = 257 - c;
+            if (len > n - i || p >= end) return 0;
+            memset(out + i, *p++, (size_t)len);
+            i += len;
+        }
+        /* 128 is a no-op */
+    }
+    *src = p;
+    return 1;
+}
+
+/* ---- _dump: the snapshot as a binary String ---- */
+static VALUE
+fb_dump(VALUE self)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+
+    size_t capa = SNAPSHOT_HEADER_SIZE + PACKED_ROW_MAX(fb->width_byte) * fb->height;
+    VALUE str = rb_str_buf_new((long)capa);
+    uint8_t *base = (uint8_t *)RSTRING_PTR(str);
+
+    uint64_t digest = cw_fb_digest(fb);
+    memcpy(base, snapshot_magic, sizeof(snapshot_magic));
+    base[6] = SNAPSHOT_VERSION;
+    base[7] = (uint8_t)fb->pixel_format;
+    put16(base + 8, fb->width);
+    put16(base + 10, fb->height);
+    for (int k = 0; k < 8; k++) base[12 + k] = (uint8_t)(digest >> (8 * k));
+
+    uint8_t *o = base + SNAPSHOT_HEADER_SIZE;
+    for (long y = 0; y < fb->height; y++) {
+        o += pack_row(fb->buffer + (size_t)y * fb->width_byte, fb->width_byte, o);
+    }
+
+    rb_str_set_len(str, (long)(o - base));
+    return str;
+}
+
+/* ---- _load(data) ----
+ *
+ * Fills this (allocated, uninitialized) framebuffer from a snapshot
+ * String, adopting its shape. Returns the pixel format.
+ */
+static VALUE
+fb_load(VALUE self, VALUE rb_data)
+{
+    framebuffer_t *fb;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, fb);
+
+    StringValue(rb_data);
+    const uint8_t *p = (const uint8_t *)RSTRING_PTR(rb_data);
+    const uint8_t *end = p + RSTRING_LEN(rb_data);
+
+    if (end - p < SNAPSHOT_HEADER_SIZE || memcmp(p, snapshot_magic, sizeof(snapshot_magic)) != 0) {
+        rb_raise(rb_eArgError, "not a framebuffer snapshot");
+    }
+    if (p[6] != SNAPSHOT_VERSION) {
+        rb_raise(rb_eArgError, "unsupported snapshot version %d", p[6]);
+    }
+
+    int fmt = p[7], w = get16(p + 8), h = get16(p + 10);
+    if (fmt < PIXEL_FORMAT_MONO || fmt > PIXEL_FORMAT_COLOR4_2BPP ||
+        w < 1 || w > EPD_MAX_DIMENSION || h < 1 || h > EPD_MAX_DIMENSION) {
+        rb_raise(rb_eArgError, "not a framebuffer snapshot");
+    }
+    uint64_t digest = 0;
+    for (int k = 0; k < 8; k++) digest |= (uint64_t)p[12 + k] << (8 * k);
+
+    uint16_t wb = cw_fb_width_byte((uint16_t)w, (pixel_format_t)fmt);
+    uint8_t *buffer = (uint8_t *)xmalloc((size_t)wb * h);
+    const uint8_t *src = p + SNAPSHOT_HEADER_SIZE;
+
+    for (long y = 0; y < h; y++) {
+        if (!unpack_row(&src, end, buffer + (size_t)y * wb, wb)) {
+            xfree(buffer);
+            rb_raise(rb_eArgError, "snapshot is truncated or corrupt (row %ld)", y);
+        }
+    }
+
+    cw_fb_release_buffer(fb);
+    fb->buffer       = buffer;
+    fb->width        = (uint16_t)w;
+    fb->height       = (uint16_t)h;
+    fb->pixel_format = (pixel_format_t)fmt;
+    fb->width_byte   = wb;
+    fb->buffer_size  = (size_t)wb * h;
+    cw_fb_touch(fb);
+
+    if (src != end) {
+        rb_raise(rb_eArgError, "snapshot has %ld bytes of trailing data", (long)(end - src));
+    }
+    if (cw_fb_digest(fb) != digest) {
+        rb_raise(rb_eArgError, "snapshot is corrupt (digest mismatch)");
+    }
+    RB_GC_GUARD(rb_data);
+    return cw_pixel_format_to_sym(fb->pixel_format);
+}
+
+/* ---- Init_snapshot() ---- */
+void
+Init_snapshot(void)
+{
+    rb_define_private_method(rb_cFramebuffer, "_dump", fb_dump, 0);
+    rb_define_private_method(rb_cFramebuffer, "_load", fb_load, 1);
+}
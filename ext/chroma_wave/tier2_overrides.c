@@ -242,6 +242,35 @@ color_post_display(const epd_model_config_t *cfg,
     return epd_read_busy(cfg->busy_polarity, EPD_BUSY_TIMEOUT_MS, cancel_flag);
 }
 
+/* -- epd_2in13g ---------------------------------------------------- */
+/* RAM rows are 128 pixels (32 bytes at 2bpp) for the 122-pixel panel,
+ * so each 31-byte framebuffer row is padded with a zero byte. */
+
+static int
+epd_2in13g_display(const epd_model_config_t *cfg,
+                   const uint8_t *buf, size_t len)
+{
+    size_t row = (size_t)(cfg->width + 3) / 4;
+
+    if (!buf || len < row * cfg->height) return EPD_ERR_PARAM;
+
+    epd_send_command(cfg->display_cmd);  /* 0x10 */
+    for (uint16_t y = 0; y < cfg->height; y++) {
+        epd_send_data_bulk(buf + y * row, row);
+        epd_send_data(0x00);
+    }
+    return EPD_OK;
+}
+
+static int
+epd_2in13g_post_display(const epd_model_config_t *cfg,
+                        volatile int *cancel_flag)
+{
+    epd_send_command(0x12);  /* DISPLAY_REFRESH */
+    epd_send_data(0x00);
+    return epd_read_busy(cfg->busy_polarity, EPD_BUSY_TIMEOUT_MS, cancel_flag);
+}
+
 /* Color models without charge pump control (7in3 family) */
 static int
 color_7in3_pre_display(const epd_model_config_t *cfg,
@@ -520,7 +549,41 @@ epd_3in52_post_display(const epd_model_config_t *cfg,
 }
 
 /* -- epd_3in7 (SSD1677-based, 4-level gray) ---------------------- */
-/* Uses command 0x12 for refresh with busy-wait */
+/* Uses command 0x12 for refresh with busy-wait. The 4-gray planes go
+ * to RAM 0x24 and 0x26, with the RAM cursor reset before each, as in
+ * the vendor 4Gray_Display. */
+
+static void
+epd_3in7_reset_cursor(void)
+{
+    epd_send_command(0x4E);
+    epd_send_data(0x00);
+    epd_send_data(0x00);
+    epd_send_command(0x4F);
+    epd_send_data(0x00);
+    epd_send_data(0x00);
+}
+
+static int
+epd_3in7_display_dual(const epd_model_config_t *cfg,
+                      const uint8_t *buf, size_t len,
+                      const uint8_t *buf_2, size_t len_2)
+{
+    if (!buf || len == 0 || !buf_2 || len_2 == 0) return EPD_ERR_PARAM;
+
+    epd_send_command(0x49);
+    epd_send_data(0x00);
+
+    epd_3in7_reset_cursor();
+    epd_send_command(cfg->display_cmd);  /* 0x24 */
+    epd_send_data_bulk(buf, len);
+
+    epd_3in7_reset_cursor();
+    epd_send_command(0x26);
+    epd_send_data_bulk(buf_2, len_2);
+
+    return EPD_OK;
+}
 
 static int
 epd_3in7_post_display(const epd_model_config_t *cfg,
@@ -737,6 +800,12 @@ tier2_register_overrides(epd_driver_t *drivers, size_t count,
         d->post_display = color_post_display;
     }
 
+    d = find_driver_slot(drivers, count, names, "epd_2in13g");
+    if (d) {
+        d->custom_display = epd_2in13g_display;
+        d->post_display   = epd_2in13g_post_display;
+    }
+
     d = find_driver_slot(drivers, count, names, "epd_2in15g");
     if (d) {
         d->pre_display  = color_pre_display;
@@ -836,7 +905,8 @@ tier2_register_overrides(epd_driver_t *drivers, size_t count,
 
     d = find_driver_slot(drivers, count, names, "epd_3in7");
     if (d) {
-        d->post_display = epd_3in7_post_display;
+        d->custom_display_dual = epd_3in7_display_dual;
+        d->post_display        = epd_3in7_post_display;
     }
 
     /* ---- Category 6: Regional refresh ---- */
@@ -0,0 +1,221 @@
+#include "bitblt.h"
+
+/*
+ * Rotation and mirroring of packed framebuffers, for panels mounted in
+ * another orientation than the one the application draws in.
+ *
+ * Everything is built from three in-format passes:
+ *
+ *   transpose  n x n pixel blocks, one byte wide: 8x8 bits for MONO,
+ *              4x4 crumbs for the 2bpp formats, 2x2 nibbles for the
+ *              4bpp ones, each done as a handful of masked
+ *              shift-and-swap steps on a register holding the
+ *              block's rows
+ *   flip_h     each row's bytes reversed through a pixel-reversal
+ *              table, then shifted left by the row's padding pixels
+ *   flip_v     rows swapped end for end
+ *
+ * Clockwise 90 is transpose + flip_h, 270 is transpose + flip_v and
+ * 180 is flip_h + flip_v. The transpose and flip_h leave the padding
+ * bits at the end of each target row untouched.
+ */
+
+static ID id_h, id_v;
+
+/* Byte with its pixels in reverse order, per bits-per-pixel (1, 2, 4) */
+static uint8_t reverse_table[3][256];
+
+static int
+bpp_slot(int bpp)
+{
+    return bpp == 1 ? 0 : bpp == 2 ? 1 : 2;
+}
+
+/* Transposes an n x n block of pixels held as n row bytes, first row in
+ * the most significant byte. Each step swaps the two off-diagonal
+ * quarters of every sub-block twice the size of the previous step's. */
+static uint64_t
+transpose_block(uint64_t x, int bpp)
+{
+    uint64_t t;
+
+    switch (bpp) {
+    case 1:
+        t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAULL; x ^= t ^ (t << 7);
+        t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x ^= t ^ (t << 14);
+        t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x ^= t ^ (t << 28);
+        return x;
+    case 2:
+        t = (x ^ (x >> 6))  & 0x00CC00CCULL; x ^= t ^ (t << 6);
+        t = (x ^ (x >> 12)) & 0x0000F0F0ULL; x ^= t ^ (t << 12);
+        return x;
+    default:
+        t = (x ^ (x >> 4)) & 0x00F0ULL; x ^= t ^ (t << 4);
+        return x;
+    }
+}
+
+/* dst (h x w pixels, dst_wb bytes per row) = transpose of src (w x h) */
+static void
+transpose(uint8_t *dst, long dst_wb, const uint8_t *src, long src_wb, long w, long h, int bpp)
+{
+    int n = 8 / bpp;
+    /* Row padding bits of the target are kept as they are */
+    uint8_t tail = h % n ? (uint8_t)(0xFF << (8 - (h % n) * bpp)) : 0xFF;
+
+    for (long by = 0; by < dst_wb; by++) {
+        long y0 = by * n;
+        uint8_t keep = by == dst_wb - 1 ? (uint8_t)~tail : 0x00;
+        for (long bx = 0; bx < src_wb; bx++) {
+            uint64_t x = 0;
+            for (int k = 0; k < n; k++) {
+                x = (x << 8) | (y0 + k < h ? src[(size_t)(y0 + k) * src_wb + bx] : 0);
+            }
+            x = transpose_block(x, bpp);
+
+            long x0 = bx * n;
+            for (int k = 0; k < n && x0 + k < w; k++) {
+                uint8_t *out = dst + (size_t)(x0 + k) * dst_wb + by;
+                *out = (uint8_t)((*out & keep) | ((x >> (8 * (n - 1 - k))) & ~keep));
+            }
+        }
+    }
+}
+
+static void
+flip_h(uint8_t *buf, long wb, long w, long h, int bpp, uint8_t *row_tmp)
+{
+    const uint8_t *rev = reverse_table[bpp_slot(bpp)];
+    long pad = wb * (8 / bpp) - w;
+
+    for (long y = 0; y < h; y++) {
+        uint8_t *row = buf + (size_t)y * wb;
+        for (long i = 0; i < wb; i++) row_tmp[i] = rev[row[wb - 1 - i]];
+        cw_rop_row(row, 0, row_tmp, wb, pad * bpp, 0, w * bpp, ROP_COPY);
+    }
+}
+
+static void
+flip_v(uint8_t *buf, long wb, long h, uint8_t *row_tmp)
+{
+    for (long y = 0; y < h / 2; y++) {
+        uint8_t *a = buf + (size_t)y * wb;
+        uint8_t *b = buf + (size_t)(h - 1 - y) * wb;
+        memcpy(row_tmp, a, (size_t)wb);
+        memcpy(a, b, (size_t)wb);
+        memcpy(b, row_tmp, (size_t)wb);
+    }
+}
+
+/* Checks that into is a framebuffer of src's format sized w x h */
+static framebuffer_t *
+target_of(VALUE into, const framebuffer_t *src, long w, long h)
+{
+    framebuffer_t *dst;
+
+    if (!rb_typeddata_is_kind_of(into, &framebuffer_type)) {
+        rb_raise(rb_eTypeError, "expected a Framebuffer, got %"PRIsVALUE, rb_obj_class(into));
+    }
+    TypedData_Get_Struct(into, framebuffer_t, &framebuffer_type, dst);
+    if (dst->pixel_format != src->pixel_format || dst->width != w || dst->height != h) {
+        rb_raise(rb_eArgError, "target must be a %ldx%ld framebuffer of the same format", w, h);
+    }
+    return dst;
+}
+
+/* ---- _rotate(into, degrees) ---- */
+static VALUE
+fb_rotate(VALUE self, VALUE into, VALUE rb_degrees)
+{
+    framebuffer_t *src;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, src);
+
+    int degrees = NUM2INT(rb_degrees);
+    if (degrees != 0 && degrees != 90 && degrees != 180 && degrees != 270) {
+        rb_raise(rb_eArgError, "rotation must be 0, 90, 180 or 270, got %d", degrees);
+    }
+    int quarter = degrees == 90 || degrees == 270;
+    framebuffer_t *dst = target_of(into, src,
+                                   quarter ? src->height : src->width,
+                                   quarter ? src->width : src->height);
+    int bpp = cw_fb_bits_per_pixel(src);
+
+    VALUE tmp;
+    long row_max = src->width_byte > dst->width_byte ? src->width_byte : dst->width_byte;
+    uint8_t *row_tmp = ALLOCV(tmp, (size_t)row_max + (quarter && dst == src ? src->buffer_size : 0));
+
+    if (!quarter) {
+        if (dst != src) memcpy(dst->buffer, src->buffer, src->buffer_size);
+        if (degrees == 180) {
+            flip_h(dst->buffer, dst->width_byte, dst->width, dst->height, bpp, row_tmp);
+            flip_v(dst->buffer, dst->width_byte, dst->height, row_tmp);
+        }
+    } else {
+        const uint8_t *pixels = src->buffer;
+        if (dst == src) {
+            /* Square in-place rotation: transpose from a snapshot */
+            uint8_t *copy = row_tmp + row_max;
+            memcpy(copy, src->buffer, src->buffer_size);
+            pixels = copy;
+        }
+        transpose(dst->buffer, dst->width_byte, pixels, src->width_byte, src->width, src->height, bpp);
+        if (degrees == 90) {
+            flip_h(dst->buffer, dst->width_byte, dst->width, dst->height, bpp, row_tmp);
+        } else {
+            flip_v(dst->buffer, dst->width_byte, dst->height, row_tmp);
+        }
+    }
+
+    cw_fb_touch(dst);
+    ALLOCV_END(tmp);
+    return into;
+}
+
+/* ---- _flip(into, axis) ---- */
+static VALUE
+fb_flip(VALUE self, VALUE into, VALUE rb_axis)
+{
+    framebuffer_t *src;
+    TypedData_Get_Struct(self, framebuffer_t, &framebuffer_type, src);
+
+    ID axis = SYMBOL_P(rb_axis) ? SYM2ID(rb_axis) : 0;
+    if (axis != id_h && axis != id_v) {
+        rb_raise(rb_eArgError, "flip axis must be :h or :v, got %+"PRIsVALUE, rb_axis);
+    }
+    framebuffer_t *dst = target_of(into, src, src->width, src->height);
+
+    VALUE tmp;
+    uint8_t *row_tmp = ALLOCV(tmp, (size_t)src->width_byte);
+
+    if (dst != src) memcpy(dst->buffer, src->buffer, src->buffer_size);
+    if (axis == id_h) {
+        flip_h(dst->buffer, dst->width_byte, dst->width, dst->height, cw_fb_bits_per_pixel(dst), row_tmp);
+    } else {
+        flip_v(dst->buffer, dst->width_byte, dst->height, row_tmp);
+    }
+
+    cw_fb_touch(dst);
+    ALLOCV_END(tmp);
+    return into;
+}
+
+/* ---- Init_transform() ---- */
+void
+Init_transform(void)
+{
+    for (int v = 0; v < 256; v++) {
+        for (int slot = 0; slot < 3; slot++) {
+            int bpp = 1 << slot;
+            int mask = (1 << bpp) - 1;
+            int r = 0;
+            for (int k = 0; k < 8; k += bpp) r = (r << bpp) | ((v >> k) & mask);
+            reverse_table[slot][v] = (uint8_t)r;
+        }
+    }
+
+    id_h = rb_intern("h");
+    id_v = rb_intern("v");
+
+    rb_define_private_method(rb_cFramebuffer, "_rotate", fb_rotate, 2);
+    rb_define_private_method(rb_cFramebuffer, "_flip",   fb_flip,   2);
+}
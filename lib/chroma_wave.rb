@@ -16,17 +16,28 @@ require_relative 'chroma_wave/pixel_format' # PixelFormat before Framebuffer wra
 require_relative 'chroma_wave/pen'          # Pen before Surface (used by Drawing::Primitives)
 require_relative 'chroma_wave/surface'      # Surface before Framebuffer (included by FB)
 require_relative 'chroma_wave/framebuffer'  # Reopens C class, prepends bridge, includes Surface
+require_relative 'chroma_wave/resampling'   # Scaled copies (included by Canvas)
 require_relative 'chroma_wave/canvas'       # RGBA pixel buffer, includes Surface
+require_relative 'chroma_wave/gray_canvas'  # One-byte-per-pixel Canvas for mono/gray panels
+require_relative 'chroma_wave/indexed_canvas' # Palette-index Canvas, packs to Framebuffer without dithering
 require_relative 'chroma_wave/layer'        # Clipped sub-region, includes Surface
 require_relative 'chroma_wave/drawing/text' # Text drawing (Canvas & Layer only, not Framebuffer)
 ChromaWave::Canvas.include(ChromaWave::Drawing::Text)
 ChromaWave::Layer.include(ChromaWave::Drawing::Text)
+require_relative 'chroma_wave/path'           # Vector paths (flattened to contours)
+require_relative 'chroma_wave/drawing/vector' # Anti-aliased paths (Canvas & Layer, composited like glyphs)
+ChromaWave::Canvas.include(ChromaWave::Drawing::Vector)
+ChromaWave::Layer.include(ChromaWave::Drawing::Vector)
 require_relative 'chroma_wave/text_metrics' # TextMetrics value type (used by Font#measure)
+require_relative 'chroma_wave/text_layout'  # Cached text layouts (used by draw_text, Font#measure)
 require_relative 'chroma_wave/font'         # Font loading, glyph measurement (requires Surface)
 require_relative 'chroma_wave/icon_font'    # IconFont < Font with glyph name registry
+require_relative 'chroma_wave/bitmap_font'  # Baked, FreeType-free Font-compatible bitmap fonts
+require_relative 'chroma_wave/font_stack'   # Fallback chains across Font/BitmapFont faces
 require_relative 'chroma_wave/image'        # Optional vips-backed image loading
 require_relative 'chroma_wave/device'       # Reopens C class, adds Mutex + open/close lifecycle
 require_relative 'chroma_wave/dither'       # Dithering strategies (loaded before Renderer)
+require_relative 'chroma_wave/framebuffer_pool' # Reusable render buffers (used by Renderer, Display)
 require_relative 'chroma_wave/renderer'     # Canvas -> Framebuffer rendering pipeline
 
 require_relative 'chroma_wave/capabilities/partial_refresh'  # Partial-refresh display mode
@@ -0,0 +1,358 @@
+# frozen_string_literal: true
+
+require_relative 'bitmap_font/writer'
+require_relative 'bitmap_font/baker'
+
+module ChromaWave
+  # A pre-rasterized font loaded from a baked +.cwbf+ file.
+  #
+  # Responds to the same text API as {Font} (+measure+, +each_glyph+,
+  # +line_height+, +ascent+, +descent+), so it can be passed as +font:+
+  # to +draw_text+. Loading never touches FreeType, which makes baked
+  # fonts usable in +NO_FREETYPE+ builds and removes FreeType start-up
+  # and first-glyph rasterization from the boot path.
+  #
+  # Files are memory-mapped where the platform supports it (see
+  # +bitmap_font.c+); glyph bitmaps are byte slices of the mapping and
+  # glyph records are decoded lazily on first use.
+  #
+  # A file may contain several sizes ("strikes"). Unlike {Font}, stored
+  # kerning pairs are applied by {#measure} and {#each_glyph}.
+  #
+  # @example Bake once, load at boot
+  #   BitmapFont.bake('DejaVu Sans', path: 'dejavu.cwbf', sizes: [16, 24])
+  #   font = BitmapFont.load('dejavu.cwbf', size: 16)
+  #   canvas.draw_text('Hello', x: 0, y: 0, font: font, color: Color::BLACK)
+  #
+  # @example Built-in Waveshare fixed-width fonts
+  #   font = BitmapFont.builtin(:font12)
+  class BitmapFont
+    # File signature for baked bitmap fonts.
+    MAGIC = 'CWBF'
+
+    # Current file format version.
+    VERSION = 1
+
+    # File header: magic, version, strike count, reserved.
+    HEADER_FORMAT = 'a4CCS<'
+
+    # File header size in bytes.
+    HEADER_SIZE = 8
+
+    # Strike directory record: size, line height, ascent, descent, glyph
+    # count, kerning pair count, glyph table offset, kerning table offset,
+    # and bitmap blob offset (offsets are absolute file positions).
+    STRIKE_FORMAT = 'S<S<s<s<L<L<L<L<L<'
+
+    # Strike directory record size in bytes.
+    STRIKE_SIZE = 28
+
+    # Glyph table record (sorted by codepoint): codepoint, width, height,
+    # bearing x, bearing y, advance, bitmap offset within the strike blob.
+    GLYPH_FORMAT = 'L<S<S<s<s<s<L<'
+
+    # Glyph table record size in bytes.
+    GLYPH_SIZE = 18
+
+    # Kerning table record: left codepoint, right codepoint, x adjustment.
+    KERN_FORMAT = 'L<L<s<'
+
+    # Kerning table record size in bytes.
+    KERN_SIZE = 10
+
+    # Codepoint under which the font's .notdef glyph is stored. Lookups
+    # for unmapped codepoints fall back to it, mirroring {Font}.
+    NOTDEF = 0
+
+    # Printable ASCII, the default bake range.
+    ASCII = (0x20..0x7E)
+
+    # Names of the fixed-width Waveshare fonts shipped in +data/fonts/+.
+    BUILTIN = %i[font8 font12 font16 font20 font24].freeze
+
+    # Mutex protecting the class-level file mapping cache.
+    MAP_CACHE_MUTEX = Mutex.new
+
+    # Decoded glyph returned by {#glyph}.
+    Glyph = Data.define(:codepoint, :bitmap, :width, :height, :bearing_x, :bearing_y, :advance)
+
+    attr_reader :path, :size, :line_height, :ascent, :descent
+
+    # Loads a strike from a baked font file.
+    #
+    # @param path [String] path to a +.cwbf+ file
+    # @param size [Integer, nil] pixel size to select (default: the first strike)
+    # @return [BitmapFont]
+    # @raise [ArgumentError] if the file is invalid or has no strike of +size+
+    def self.load(path, size: nil)
+      new(path, size: size)
+    end
+
+    # Loads one of the bundled Waveshare fixed-width fonts.
+    #
+    # @param name [Symbol] one of {BUILTIN}
+    # @return [BitmapFont]
+    # @raise [ArgumentError] if +name+ is not a built-in font
+    def self.builtin(name)
+      unless BUILTIN.include?(name)
+        raise ArgumentError, "unknown built-in font: #{name.inspect} (expected one of #{BUILTIN.join(', ')})"
+      end
+
+      load(File.join(Font::DATA_DIR, 'fonts', "#{name}.cwbf"))
+    end
+
+    # Rasterizes a TrueType font with FreeType and writes a baked file.
+    #
+    # Every codepoint is rendered once per size. Kerning is read from the
+    # face's +kern+ table, so its cost follows the pairs the font defines
+    # rather than the square of the codepoint count; faces without one
+    # (non-SFNT formats) fall back to querying every ordered pair, which
+    # is only practical for small ranges.
+    #
+    # @param source [String] path or name of a TrueType font (see {Font#initialize})
+    # @param path [String] output file path
+    # @param sizes [Array<Integer>] pixel sizes to bake
+    # @param ranges [Array<Range, Integer>] codepoints to include
+    # @return [String] +path+
+    # @raise [DependencyError] if FreeType is not available
+    def self.bake(source, path:, sizes:, ranges: [ASCII])
+      Writer.new(Baker.new(source).bake(sizes: sizes, ranges: ranges)).write(path)
+    end
+
+    # Opens a baked font file and selects a strike.
+    #
+    # @param path [String] path to a +.cwbf+ file
+    # @param size [Integer, nil] pixel size to select (default: the first strike)
+    # @raise [ArgumentError] if the file is invalid or has no strike of +size+
+    def initialize(path, size: nil)
+      @path = File.expand_path(path)
+      @data = self.class.send(:map, @path)
+      strike = select_strike(size)
+      @size, @line_height, @ascent, @descent, @glyph_count, @kern_count,
+        @glyph_table, @kern_table, @blob = strike
+      @glyphs = {}
+    end
+
+    # Measures the pixel dimensions of rendered text.
+    #
+    # Same semantics as {Font#measure}, with stored kerning applied.
+    #
+    # @param text [String] the text to measure
+    # @return [TextMetrics] width, height, ascent, and descent
+    def measure(text)
+      lines = text.split("\n", -1)
+      widest = lines.map { |line| line_width(line) }.max || 0
+
+      TextMetrics.new(width: widest, height: line_height * lines.length, ascent: ascent, descent: descent)
+    end
+
+    # Sums advances (plus kerning) for a single line of text.
+    #
+    # Same semantics as {Font#line_width}.
+    #
+    # @param line [String] a single line (no newlines)
+    # @return [Integer] total advance width in pixels
+    def line_width(line)
+      w = 0
+      prev = nil
+      line.each_codepoint do |cp|
+        w += kerning(prev, cp) if prev
+        w += glyph(cp).advance
+        prev = cp
+      end
+      w
+    end
+
+    # Iterates over each glyph in the text, yielding positioned glyph data.
+    #
+    # Yields hashes in the same shape as {Font#each_glyph}.
+    #
+    # @param text [String] the text to iterate
+    # @yield [Hash] glyph data for each character
+    # @return [Integer, Enumerator] pen advance after the last glyph
+    #   (kerning included), or an Enumerator if no block given
+    def each_glyph(text)
+      return enum_for(:each_glyph, text) unless block_given?
+
+      pen_x = 0
+      prev = nil
+      text.each_codepoint do |cp|
+        g = glyph(cp)
+        pen_x += kerning(prev, cp) if prev
+        yield({ bitmap: g.bitmap, x: pen_x + g.bearing_x, y: ascent - g.bearing_y,
+                width: g.width, height: g.height })
+        pen_x += g.advance
+        prev = cp
+      end
+      pen_x
+    end
+
+    # Returns the glyph for a codepoint, falling back to .notdef (or an
+    # empty zero-advance glyph when the file has none).
+    #
+    # @param codepoint [Integer]
+    # @return [Glyph]
+    def glyph(codepoint)
+      @glyphs[codepoint] ||= find_glyph(codepoint) || notdef
+    end
+
+    # Returns true if the strike contains a glyph for +codepoint+.
+    #
+    # @param codepoint [Integer]
+    # @return [Boolean]
+    def include_codepoint?(codepoint)
+      !glyph_index(codepoint).nil?
+    end
+
+    # Returns the strike's coverage as a bitset String in the same layout
+    # as {Font#coverage} (the stored .notdef is not counted).
+    #
+    # @return [String] frozen binary String
+    def coverage
+      @coverage ||= begin
+        cps = Array.new(@glyph_count) { |n| codepoint_at(n) } - [NOTDEF]
+        bits = "\0".b * (cps.empty? ? 0 : (cps.max >> 3) + 1)
+        cps.each { |cp| bits.setbyte(cp >> 3, bits.getbyte(cp >> 3) | (1 << (cp & 7))) }
+        bits.freeze
+      end
+    end
+
+    # Returns the kerning adjustment between two codepoints in pixels.
+    #
+    # @param left [Integer] left codepoint
+    # @param right [Integer] right codepoint
+    # @return [Integer]
+    def kerning(left, right)
+      kerning_table.fetch((left << 32) | right, 0)
+    end
+
+    # Identity of this face and size for shared caches ({TextLayout}).
+    #
+    # @return [Array]
+    def cache_key
+      [self.class, path, size]
+    end
+
+    # Returns a human-readable description.
+    #
+    # @return [String]
+    def inspect
+      "#<#{self.class} #{File.basename(path)} @#{size}px (#{@glyph_count} glyphs)>"
+    end
+
+    # Maps (or reads) a baked file, caching one entry per path.
+    #
+    # The entry is replaced when the file's mtime or size changes. Mappings
+    # are never unmapped (glyph bitmaps are substrings of them; see
+    # +bitmap_font.c+), so only the first version of a path is mapped and
+    # rebaked versions are read into ordinary, collectable Strings.
+    #
+    # @param path [String] absolute path
+    # @return [String] frozen binary file contents
+    def self.map(path)
+      stat = File.stat(path)
+      version = [stat.mtime, stat.size]
+
+      MAP_CACHE_MUTEX.synchronize do
+        cache = (@map_cache ||= {})
+        entry = cache[path]
+        next entry.last if entry&.first == version
+
+        data = entry.nil? && respond_to?(:_map_file, true) ? _map_file(path) : File.binread(path).freeze
+        cache[path] = [version, data]
+        data
+      end
+    end
+    private_class_method :map
+
+    private
+
+    # Parses the header and returns the strike directory record for +size+.
+    #
+    # @param size [Integer, nil] requested pixel size
+    # @return [Array<Integer>] unpacked strike record
+    # @raise [ArgumentError] if the file is invalid or lacks the strike
+    def select_strike(size)
+      magic, version, count = @data.unpack(HEADER_FORMAT)
+      raise ArgumentError, "not a baked bitmap font: #{path}" unless magic == MAGIC
+      check_range(0, HEADER_SIZE, 'header')
+      raise ArgumentError, "unsupported bitmap font version #{version}" unless version == VERSION
+
+      check_range(HEADER_SIZE, count * STRIKE_SIZE, 'strike directory')
+      strikes = Array.new(count) { |i| @data.unpack(STRIKE_FORMAT, offset: HEADER_SIZE + (i * STRIKE_SIZE)) }
+      strike = size ? strikes.find { |s| s.first == size } : strikes.first
+      unless strike
+        raise ArgumentError, "#{File.basename(path)} has no #{size}px strike (has #{strikes.map(&:first).join(', ')})"
+      end
+
+      _, _, _, _, glyph_count, kern_count, glyph_table, kern_table, blob = strike
+      check_range(glyph_table, glyph_count * GLYPH_SIZE, 'glyph table')
+      check_range(kern_table, kern_count * KERN_SIZE, 'kerning table')
+      check_range(blob, 0, 'bitmap blob')
+      strike
+    end
+
+    # Checks that +length+ bytes at +offset+ lie inside the file.
+    #
+    # @param offset [Integer] absolute file position
+    # @param length [Integer] byte count
+    # @param what [String] name of the range for the error message
+    # @raise [ArgumentError] if the range runs past the end of the file
+    def check_range(offset, length, what)
+      return if offset + length <= @data.bytesize
+
+      raise ArgumentError, "#{File.basename(path)} is truncated or corrupt (#{what} outside the file)"
+    end
+
+    # Binary-searches the glyph table for +codepoint+.
+    #
+    # @param codepoint [Integer]
+    # @return [Integer, nil] table index
+    def glyph_index(codepoint)
+      i = (0...@glyph_count).bsearch { |n| codepoint_at(n) >= codepoint }
+      i if i && codepoint_at(i) == codepoint
+    end
+
+    # Reads the codepoint of glyph table entry +n+.
+    #
+    # @param n [Integer] table index
+    # @return [Integer]
+    def codepoint_at(n)
+      @data.unpack1('L<', offset: @glyph_table + (n * GLYPH_SIZE))
+    end
+
+    # Decodes the glyph record for +codepoint+, or nil if absent.
+    #
+    # @param codepoint [Integer]
+    # @return [Glyph, nil]
+    # @raise [ArgumentError] if the glyph's bitmap lies outside the file
+    def find_glyph(codepoint)
+      i = glyph_index(codepoint)
+      return nil unless i
+
+      cp, w, h, bx, by, adv, off = @data.unpack(GLYPH_FORMAT, offset: @glyph_table + (i * GLYPH_SIZE))
+      check_range(@blob + off, w * h, "bitmap of U+#{format('%04X', cp)}")
+      Glyph.new(codepoint: cp, bitmap: @data.byteslice(@blob + off, w * h).freeze,
+                width: w, height: h, bearing_x: bx, bearing_y: by, advance: adv)
+    end
+
+    # Fallback glyph for unmapped codepoints.
+    #
+    # @return [Glyph]
+    def notdef
+      @notdef ||= find_glyph(NOTDEF) ||
+                  Glyph.new(codepoint: NOTDEF, bitmap: ''.b, width: 0, height: 0,
+                            bearing_x: 0, bearing_y: 0, advance: 0)
+    end
+
+    # Lazily decodes the kerning table into a Hash keyed by packed pair.
+    #
+    # @return [Hash{Integer => Integer}]
+    def kerning_table
+      @kerning_table ||= Array.new(@kern_count) do |i|
+        left, right, kern = @data.unpack(KERN_FORMAT, offset: @kern_table + (i * KERN_SIZE))
+        [(left << 32) | right, kern]
+      end.to_h.freeze
+    end
+  end
+end
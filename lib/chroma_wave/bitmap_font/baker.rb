@@ -0,0 +1,60 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  class BitmapFont
+    # Rasterizes a TrueType font into {Strike}s via FreeType.
+    #
+    # Codepoints the face does not map are skipped; the face's .notdef
+    # glyph is stored under {NOTDEF} so lookups for missing characters
+    # render the same box {Font} would.
+    #
+    # @example
+    #   strikes = Baker.new('DejaVu Sans').bake(sizes: [16], ranges: [BitmapFont::ASCII])
+    class Baker
+      # @param source [String] path or name of a TrueType font
+      def initialize(source)
+        @source = source
+      end
+
+      # Rasterizes every requested size.
+      #
+      # @param sizes [Array<Integer>] pixel sizes
+      # @param ranges [Array<Range, Integer>] codepoints to include
+      # @return [Array<Strike>]
+      # @raise [DependencyError] if FreeType is not available
+      def bake(sizes:, ranges:)
+        codepoints = ranges.flat_map { |r| Array(r) }.uniq.sort
+        sizes.map { |size| bake_strike(Font.new(source, size: size), codepoints) }
+      end
+
+      private
+
+      attr_reader :source
+
+      # Rasterizes one size.
+      #
+      # @param font [Font] loaded font at the strike size
+      # @param codepoints [Array<Integer>] requested codepoints
+      # @return [Strike]
+      def bake_strike(font, codepoints)
+        mapped = codepoints.select { |cp| cp != NOTDEF && font.send(:_ft_char_index, cp).positive? }
+        glyphs = ([NOTDEF] + mapped).map { |cp| render(font, cp) }
+
+        Strike.new(size: font.size, line_height: font.line_height,
+                   ascent: font.ascent, descent: font.descent,
+                   glyphs: glyphs, kerning: font.send(:_ft_kerning_pairs, mapped))
+      end
+
+      # Renders one glyph into a Strike glyph hash.
+      #
+      # @param font [Font] loaded font
+      # @param codepoint [Integer]
+      # @return [Hash]
+      def render(font, codepoint)
+        g = font.send(:_ft_render_glyph, codepoint)
+        { codepoint: codepoint, bitmap: g[:bitmap], width: g[:width], height: g[:height],
+          bearing_x: g[:bearing_x], bearing_y: g[:bearing_y], advance: g[:advance_x] }
+      end
+    end
+  end
+end
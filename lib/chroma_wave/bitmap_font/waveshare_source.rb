@@ -0,0 +1,80 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  class BitmapFont
+    # Converts a vendored Waveshare +sFONT+ C source (+lib/Fonts/fontNN.c+)
+    # into a {Strike}.
+    #
+    # The vendor tables hold printable ASCII (0x20..0x7E) as fixed-size
+    # cells: +Height+ rows of +ceil(Width / 8)+ bytes, MSB first. Each
+    # cell becomes a full-cell glyph with alpha 0 or 255, advancing by
+    # +Width+. The cells have no baseline information, so the whole cell
+    # is treated as ascent.
+    #
+    # Used by +rake fonts:builtin+; not loaded at runtime.
+    class WaveshareSource
+      # Matches the trailing +sFONT+ definition's width and height.
+      DIMENSIONS = %r{sFONT\s+\w+\s*=\s*\{\s*\w+,\s*(\d+),\s*/\*\s*Width\s*\*/\s*(\d+),}
+
+      # @param source [String] contents of a vendor font C file
+      def initialize(source)
+        @source = source
+      end
+
+      # Parses the table into a Strike.
+      #
+      # @return [Strike]
+      # @raise [ArgumentError] if the source is not a recognizable sFONT table
+      def to_strike
+        width, height = dimensions
+        row_bytes = (width + 7) / 8
+        cell = row_bytes * height
+        bytes = table_bytes
+        raise ArgumentError, 'font table size does not match ASCII cells' unless bytes.size == cell * ASCII.size
+
+        glyphs = ASCII.each_with_index.map do |cp, i|
+          glyph(cp, bytes[i * cell, cell], width, height, row_bytes)
+        end
+        Strike.new(size: height, line_height: height, ascent: height, descent: 0, glyphs: glyphs, kerning: [])
+      end
+
+      private
+
+      attr_reader :source
+
+      # @return [Array(Integer, Integer)] cell width and height
+      def dimensions
+        match = DIMENSIONS.match(source)
+        raise ArgumentError, 'no sFONT definition found' unless match
+
+        [match[1].to_i, match[2].to_i]
+      end
+
+      # Extracts the hex bytes of the +_Table[]+ initializer, ignoring comments.
+      #
+      # @return [Array<Integer>]
+      def table_bytes
+        body = source[/_Table\s*\[\]\s*=\s*\{(.*?)\};/m, 1]
+        raise ArgumentError, 'no font table found' unless body
+
+        body.gsub(%r{//[^\n]*}, '').scan(/0x\h{2}/).map(&:hex)
+      end
+
+      # Expands one 1bpp cell into an alpha glyph hash.
+      #
+      # @return [Hash]
+      def glyph(codepoint, cell, width, height, row_bytes)
+        bitmap = String.new(capacity: width * height, encoding: Encoding::BINARY)
+        height.times do |row|
+          width.times do |col|
+            bit = cell[(row * row_bytes) + (col / 8)] & (0x80 >> (col % 8))
+            bitmap << (bit.zero? ? 0 : 255)
+          end
+        end
+
+        { codepoint: codepoint, bitmap: bitmap, width: width, height: height,
+          bearing_x: 0, bearing_y: height, advance: width }
+      end
+    end
+  end
+end
@@ -0,0 +1,104 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  class BitmapFont
+    # One baked size of a bitmap font, as produced by {Baker} and
+    # consumed by {Writer}.
+    #
+    # +glyphs+ is an Array of Hashes with +:codepoint+, +:bitmap+
+    # (1 byte/pixel alpha), +:width+, +:height+, +:bearing_x+,
+    # +:bearing_y+ and +:advance+. +kerning+ is an Array of
+    # +[left, right, adjustment]+ triples.
+    Strike = Data.define(:size, :line_height, :ascent, :descent, :glyphs, :kerning)
+
+    # Serializes {Strike}s into the +.cwbf+ file format read by {BitmapFont}.
+    #
+    # Layout: header, strike directory, then per strike a glyph table
+    # sorted by codepoint, a kerning table sorted by pair, and one packed
+    # alpha blob. All integers are little-endian.
+    #
+    # @example
+    #   Writer.new([strike]).write('font.cwbf')
+    class Writer
+      # @param strikes [Array<Strike>] strikes to serialize
+      # @raise [ArgumentError] if no strikes are given or sizes repeat
+      def initialize(strikes)
+        raise ArgumentError, 'at least one strike is required' if strikes.empty?
+        raise ArgumentError, 'strike sizes must be unique' if strikes.map(&:size).uniq.size != strikes.size
+
+        @strikes = strikes
+      end
+
+      # Returns the serialized file contents.
+      #
+      # @return [String] binary data
+      def to_s
+        header = [MAGIC, VERSION, strikes.size, 0].pack(HEADER_FORMAT)
+        directory = String.new(encoding: Encoding::BINARY)
+        body = String.new(encoding: Encoding::BINARY)
+        base = HEADER_SIZE + (strikes.size * STRIKE_SIZE)
+
+        strikes.each do |strike|
+          directory << append_strike(body, base, strike)
+        end
+
+        header + directory + body
+      end
+
+      # Writes the file atomically (temp file + rename) so processes that
+      # still have the previous version mapped keep reading valid pages.
+      #
+      # @param path [String] output file path
+      # @return [String] +path+
+      def write(path)
+        tmp = "#{path}.#{Process.pid}.tmp"
+        File.binwrite(tmp, to_s)
+        File.rename(tmp, path)
+        path
+      ensure
+        File.delete(tmp) if tmp && File.exist?(tmp)
+      end
+
+      private
+
+      attr_reader :strikes
+
+      # Appends a strike's tables and blob to +body+.
+      #
+      # @param body [String] file body (mutated)
+      # @param base [Integer] absolute file offset of +body+
+      # @param strike [Strike]
+      # @return [String] the packed strike directory record
+      def append_strike(body, base, strike)
+        glyphs = strike.glyphs.sort_by { |g| g[:codepoint] }
+        kerning = strike.kerning.sort_by { |l, r, _| [l, r] }
+
+        glyph_table = base + body.bytesize
+        blob = String.new(encoding: Encoding::BINARY)
+        glyphs.each { |g| body << pack_glyph(g, blob) }
+
+        kern_table = base + body.bytesize
+        kerning.each { |triple| body << triple.pack(KERN_FORMAT) }
+
+        blob_offset = base + body.bytesize
+        body << blob
+
+        [strike.size, strike.line_height, strike.ascent, strike.descent, glyphs.size, kerning.size,
+         glyph_table, kern_table, blob_offset].pack(STRIKE_FORMAT)
+      end
+
+      # Packs one glyph table record and appends its bitmap to +blob+.
+      #
+      # @param glyph [Hash] glyph hash
+      # @param blob [String] strike blob (mutated)
+      # @return [String] the packed record
+      def pack_glyph(glyph, blob)
+        offset = blob.bytesize
+        blob << glyph[:bitmap].b
+
+        [glyph[:codepoint], glyph[:width], glyph[:height], glyph[:bearing_x],
+         glyph[:bearing_y], glyph[:advance], offset].pack(GLYPH_FORMAT)
+      end
+    end
+  end
+end
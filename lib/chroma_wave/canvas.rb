@@ -3,12 +3,13 @@
 module ChromaWave
   # RGBA pixel buffer for compositing content before rendering to hardware.
   #
-  # Canvas stores pixels as a flat binary String of packed RGBA quads
-  # (4 bytes per pixel, row-major). This keeps GC overhead minimal — only
-  # two Ruby objects (the Canvas and its buffer String).
+  # Canvas stores pixels as RGBA quads (4 bytes per pixel, row-major) in a
+  # natively owned {PixelBuffer}: rows are 64-byte aligned and padded for
+  # the C kernels, and the memory is reported to the GC. This keeps GC
+  # overhead minimal — only two Ruby objects (the Canvas and its buffer).
   #
   # Includes {Surface} for drawing protocol compatibility. Drawing primitives,
-  # blit, and clear are all available.
+  # blit, and clear are all available; {Resampling} adds scaled copies.
   #
   # @example
   #   canvas = Canvas.new(width: 200, height: 100)
@@ -16,12 +17,25 @@ module ChromaWave
   #   canvas.clear(Color::BLACK)
   class Canvas
     include Surface
+    include Resampling
 
     # Bytes per pixel in the RGBA buffer.
     BYTES_PER_PIXEL = 4
 
     attr_reader :width, :height
 
+    # Creates a Canvas from packed RGBA bytes in a single copy, without
+    # filling a background first.
+    #
+    # @param bytes [String] raw RGBA pixel data (4 bytes per pixel, row-major)
+    # @param width [Integer] canvas width in pixels (must be positive)
+    # @param height [Integer] canvas height in pixels (must be positive)
+    # @return [Canvas]
+    # @raise [ArgumentError] if the dimensions are invalid or +bytes+ is the wrong size
+    def self.from_rgba_bytes(bytes, width:, height:)
+      Canvas.allocate.tap { |canvas| canvas.send(:load_buffer, bytes, width, height) }
+    end
+
     # Creates a new Canvas filled with the given background color.
     #
     # @param width [Integer] canvas width in pixels (must be positive)
@@ -32,7 +46,7 @@ module ChromaWave
       validate_dimensions!(width, height)
       @width  = width
       @height = height
-      @buffer = (background.to_rgba_bytes * (width * height)).b
+      @buffer = PixelBuffer.new(width, height, BYTES_PER_PIXEL, background.to_rgba_bytes)
     end
 
     # Sets the pixel at (x, y) to the given color.
@@ -95,8 +109,10 @@ module ChromaWave
     # @return [self]
     def blit(source, x:, y:)
       if source.is_a?(Canvas) && respond_to?(:_canvas_blit_alpha, true)
-        _canvas_blit_alpha(buffer, source.rgba_bytes, x, y,
-                           source.width, source.height, width, height)
+        source = source.dup if source.equal?(self)
+        source.with_rgba_buffer do |bytes|
+          _canvas_blit_alpha(buffer, bytes, x, y, source.width, source.height, width, height)
+        end
       else
         blit_ruby(source, x, y)
       end
@@ -122,19 +138,34 @@ module ChromaWave
       self
     end
 
-    # Returns the raw RGBA buffer as a frozen binary string.
+    # Returns a packed copy of the RGBA pixels as a frozen binary string.
     #
     # @return [String] the pixel data (4 bytes per pixel, row-major)
     def rgba_bytes
-      buffer.dup.freeze
+      buffer.to_s.freeze
+    end
+
+    # Yields the live RGBA buffer for zero-copy reads.
+    #
+    # The buffer is pinned for the duration of the block: it must not be
+    # retained past the block, and drawing on this canvas inside the block
+    # raises. Prefer this over {#rgba_bytes} for read-only passes over the
+    # whole canvas (dithering, export, blitting onto another surface).
+    #
+    # @yieldparam bytes [PixelBuffer] the pixels, addressed by packed
+    #   offsets (+getbyte+, +byteslice+) like {#rgba_bytes}
+    # @return [Object] the block's result
+    # @raise [RuntimeError] if the canvas is modified inside the block
+    def with_rgba_buffer(&)
+      borrow_buffer(&)
     end
 
-    # Returns true if +other+ is a Canvas with the same dimensions and pixels.
+    # Returns true if +other+ is a canvas of the same class, dimensions and pixels.
     #
     # @param other [Object] the object to compare
     # @return [Boolean]
     def ==(other)
-      other.is_a?(Canvas) &&
+      other.instance_of?(self.class) &&
         width == other.width &&
         height == other.height &&
         buffer == other.raw_buffer
@@ -202,7 +233,7 @@ module ChromaWave
 
     # Exposes the internal buffer for same-class peer comparison in {#==}.
     #
-    # @return [String] the raw RGBA buffer
+    # @return [PixelBuffer] the raw RGBA buffer
     def raw_buffer
       @buffer
     end
@@ -219,6 +250,19 @@ module ChromaWave
       @buffer = source.raw_buffer.dup
     end
 
+    # Allocates the pixel buffer from packed bytes (see {.from_rgba_bytes}).
+    def load_buffer(bytes, width, height)
+      validate_dimensions!(width, height)
+      @width  = width
+      @height = height
+      @buffer = PixelBuffer.new(width, height, BYTES_PER_PIXEL).replace(bytes)
+    end
+
+    # Yields the pixel buffer pinned against writes (see {#with_rgba_buffer}).
+    def borrow_buffer(&)
+      buffer.pin(&)
+    end
+
     # Byte offset for pixel (x, y) in the RGBA buffer.
     def pixel_offset(x, y)
       ((y * width) + x) * BYTES_PER_PIXEL
@@ -235,6 +279,8 @@ module ChromaWave
     # @param h [Integer] height
     # @param color [Object] fill color
     def fill_rect(x, y, w, h, color)
+      return if native_raster(:rect, color, x, y, w, h)
+
       # Clip to canvas bounds
       x0 = [x, 0].max
       y0 = [y, 0].max
@@ -251,19 +297,38 @@ module ChromaWave
       end
     end
 
-    # C-accelerated glyph compositing. Blends directly into the RGBA
-    # buffer with integer alpha math, avoiding per-pixel Color allocation.
-    # Falls back to the pure-Ruby path when the C method is unavailable.
+    # Hands a shape to the native span rasterizer (see {Drawing::Primitives}).
+    #
+    # @param shape [Symbol] shape name
+    # @param color [Color] the color to paint
+    # @param args [Array] shape arguments
+    # @return [Boolean] true if the C path drew the shape
+    def native_raster(shape, color, *args)
+      native_raster_window(nil, shape, color, *args)
+    end
+
+    # Rasterizes a shape through a {Layer}'s translate-and-clip window.
+    #
+    # @param window [Array(Integer, Integer, Integer, Integer, Integer, Integer), nil]
+    #   +[ox, oy, x0, y0, x1, y1]+: draw at offset (ox, oy), clipped to
+    #   local x0...x1, y0...y1; nil for the whole canvas
+    # @return [Boolean] true if the C path drew the shape
+    def native_raster_window(window, shape, color, *args)
+      return false unless respond_to?(:_canvas_raster, true)
+
+      _canvas_raster(buffer, width, height, window, shape, color.to_rgba_bytes, *args)
+    end
+
+    # C-accelerated glyph compositing through {#blit_glyph}. Blends
+    # directly into the buffer with integer alpha math, avoiding
+    # per-pixel Color allocation. Falls back to the pure-Ruby path when
+    # the C method is unavailable.
     def render_glyph(glyph, base_x, base_y, color)
-      if respond_to?(:_canvas_blit_glyph, true)
-        _canvas_blit_glyph(buffer, glyph[:bitmap],
-                           base_x + glyph[:x], base_y + glyph[:y],
-                           glyph[:width], glyph[:height],
-                           width, height,
-                           color.r, color.g, color.b)
-      else
-        super
-      end
+      return if blit_glyph(glyph[:bitmap],
+                           x: base_x + glyph[:x], y: base_y + glyph[:y],
+                           width: glyph[:width], height: glyph[:height], color: color)
+
+      super
     end
 
     # Ruby fallback for clear.
@@ -29,7 +29,7 @@ module ChromaWave
         if canvas_or_fb.is_a?(Canvas) && pixel_format == PixelFormat::COLOR4
           ensure_initialized!
           black_fb, red_fb = renderer.render_dual(canvas_or_fb)
-          synchronize_device { device.send(:_epd_display_dual, black_fb, red_fb) }
+          transmit(:_epd_display_dual, black_fb, red_fb, rented: [black_fb, red_fb])
           self
         else
           super
@@ -50,7 +50,7 @@ module ChromaWave
       def show_raw(black_fb, red_fb)
         validate_dual_framebuffers!(black_fb, red_fb)
         ensure_initialized!
-        synchronize_device { device.send(:_epd_display_dual, black_fb, red_fb) }
+        transmit(:_epd_display_dual, black_fb, red_fb)
         self
       end
 
@@ -29,7 +29,7 @@ module ChromaWave
       def display_fast(framebuffer)
         validate_framebuffer!(framebuffer)
         init_fast unless current_mode == :fast
-        synchronize_device { device.send(:_epd_display, framebuffer) }
+        transmit(:_epd_display, framebuffer)
         self
       end
     end
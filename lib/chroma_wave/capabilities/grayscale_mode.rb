@@ -6,7 +6,15 @@ module ChromaWave
     #
     # Grayscale mode uses multi-level waveforms to display 4 shades of gray,
     # providing richer image detail at the cost of slower refresh.
+    #
+    # A GRAY4 framebuffer is sent as its two bit planes (see
+    # {Framebuffer#split_planes}), one through each of the controller's
+    # display RAM commands.
     module GrayscaleMode
+      # Models whose 4-gray waveform takes the low bit plane through the
+      # first display command; the others take the high bit plane first.
+      LOW_PLANE_FIRST = %i[epd_3in7 epd_4in2_v2 epd_5in79 epd_5in83_v2].freeze
+
       # Initializes the display for grayscale mode.
       #
       # @return [self]
@@ -23,13 +31,37 @@ module ChromaWave
       #
       # Automatically initializes grayscale mode if not already active.
       #
-      # @param framebuffer [Framebuffer] the framebuffer to display
+      # @param framebuffer [Framebuffer] the framebuffer to display, in the
+      #   display's pixel format or GRAY4
       # @return [self]
       # @raise [FormatMismatchError] if the framebuffer format does not match
       def display_grayscale(framebuffer)
+        return display_gray_planes(framebuffer) if framebuffer.pixel_format == PixelFormat::GRAY4
+
         validate_framebuffer!(framebuffer)
         init_grayscale unless current_mode == :grayscale
-        synchronize_device { device.send(:_epd_display, framebuffer) }
+        transmit(:_epd_display, framebuffer)
+        self
+      end
+
+      private
+
+      # Splits a GRAY4 framebuffer into pooled bit planes and sends them
+      # in the order this model's waveform expects.
+      #
+      # @param framebuffer [Framebuffer] GRAY4 content in drawing orientation
+      # @return [self]
+      # @raise [ArgumentError] if its size does not match the display
+      def display_gray_planes(framebuffer)
+        unless framebuffer.width == width && framebuffer.height == height
+          raise ArgumentError, "framebuffer dimensions must match display (#{width}x#{height})"
+        end
+
+        planes = Array.new(2) { framebuffer_pool.rent(width, height, PixelFormat::MONO) }
+        high, low = framebuffer.split_planes(into: planes)
+        init_grayscale unless current_mode == :grayscale
+        first, second = LOW_PLANE_FIRST.include?(model) ? [low, high] : [high, low]
+        transmit(:_epd_display_dual, first, second, rented: planes)
         self
       end
     end
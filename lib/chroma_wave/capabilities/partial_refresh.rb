@@ -41,7 +41,7 @@ module ChromaWave
       def display_partial(framebuffer)
         validate_framebuffer!(framebuffer)
         init_partial unless current_mode == :partial
-        synchronize_device { device.send(:_epd_display, framebuffer) }
+        transmit(:_epd_display, framebuffer)
         self
       end
 
@@ -53,7 +53,7 @@ module ChromaWave
       def display_base(framebuffer)
         validate_framebuffer!(framebuffer)
         ensure_initialized!
-        synchronize_device { device.send(:_epd_display, framebuffer) }
+        transmit(:_epd_display, framebuffer)
         self
       end
     end
@@ -18,7 +18,9 @@ module ChromaWave
       #
       # X and width are automatically aligned to 8-pixel byte boundaries.
       # The framebuffer must be full-screen sized; only the region pixels
-      # are sent to the display controller.
+      # are sent to the display controller. On a rotated display the region
+      # is given in drawing coordinates and aligned after mapping it onto
+      # the panel.
       #
       # @param framebuffer [Framebuffer] the full-screen framebuffer
       # @param x [Integer] left edge of the region (aligned down to 8px)
@@ -31,12 +33,10 @@ module ChromaWave
       def display_region(framebuffer, x:, y:, width:, height:)
         validate_framebuffer!(framebuffer)
         validate_region!(x, y, width, height)
+        x, y, width, height = panel_region(x, y, width, height)
         aligned_x, aligned_w = align_x_to_byte_boundary(x, width)
         ensure_initialized!
-        synchronize_device do
-          device.send(:_epd_display_region, framebuffer,
-                      aligned_x, y, aligned_w, height)
-        end
+        transmit(:_epd_display_region, framebuffer, args: [aligned_x, y, aligned_w, height])
         self
       end
 
@@ -60,11 +60,24 @@ module ChromaWave
         raise ArgumentError, 'region height exceeds display' unless y + h <= max_h
       end
 
+      # Maps a region in drawing coordinates onto the panel, following
+      # the display's rotation.
+      #
+      # @return [Array(Integer, Integer, Integer, Integer)] panel [x, y, w, h]
+      def panel_region(x, y, w, h)
+        case rotation
+        when 90  then [panel_width - y - h, x, h, w]
+        when 180 then [panel_width - x - w, panel_height - y - h, w, h]
+        when 270 then [y, panel_height - x - w, h, w]
+        else [x, y, w, h]
+        end
+      end
+
       # Aligns X coordinate and width to 8-pixel byte boundaries.
       #
       # Floors X to the nearest lower multiple of 8, and ceils the end
       # (X + width) to the nearest higher multiple of 8. Clamps the
-      # result to the display width.
+      # result to the panel width.
       #
       # @param x [Integer] original X coordinate
       # @param w [Integer] original width
@@ -72,7 +85,7 @@ module ChromaWave
       def align_x_to_byte_boundary(x, w)
         aligned_x = x & ~7 # floor to 8px
         aligned_end = ((x + w + 7) & ~7) # ceil end to 8px
-        aligned_end = [aligned_end, width].min # clamp to display
+        aligned_end = [aligned_end, panel_width].min # clamp to display
         [aligned_x, aligned_end - aligned_x]
       end
     end
@@ -16,8 +16,14 @@ module ChromaWave
   #     canvas.set_pixel(10, 20, Color::BLACK)
   #     display.show(canvas)
   #   end
+  #
+  # @example Portrait drawing on a landscape panel
+  #   Display.open(model: :epd_7in5_v2, rotation: 90) do |display|
+  #     display.width # => 480 (the panel is 800x480)
+  #     display.show(Canvas.new(width: display.width, height: display.height))
+  #   end
   class Display
-    attr_reader :model, :width, :height, :pixel_format
+    attr_reader :model, :width, :height, :pixel_format, :rotation
 
     # Factory method -- builds the correct Display subclass via {Registry}.
     #
@@ -25,18 +31,22 @@ module ChromaWave
     # internally by {Registry}).
     #
     # @param model [Symbol, String] model name (e.g. +:epd_2in13_v4+)
+    # @param rotation [Integer] clockwise angle from the panel's native
+    #   orientation to the one content is drawn in, one of
+    #   {Framebuffer::ROTATIONS}; 90 and 270 swap {#width} and {#height}
     # @return [Display] a subclass instance with appropriate capabilities
     # @raise [ModelNotFoundError] if the model is not in the registry
-    def self.new(model: nil, **kwargs)
+    # @raise [ArgumentError] for an unsupported rotation
+    def self.new(model: nil, rotation: 0, **kwargs)
       if self == Display
         raise ArgumentError, 'missing keyword: :model' unless model
         raise ArgumentError, "unknown keyword(s): #{kwargs.keys.join(', ')}" unless kwargs.empty?
 
-        return Registry.build(model)
+        return Registry.build(model, rotation: rotation)
       end
 
       instance = allocate
-      instance.send(:initialize, **kwargs)
+      instance.send(:initialize, **kwargs, rotation: rotation)
       instance
     end
 
@@ -45,10 +55,11 @@ module ChromaWave
     # Without a block, returns the open display.
     #
     # @param model [Symbol, String] model name
+    # @param rotation [Integer] drawing orientation (see {Display.new})
     # @yield [display] the opened display
     # @return [Display, Object] the display (no block) or the block's return value
-    def self.open(model:)
-      display = new(model: model)
+    def self.open(model:, rotation: 0)
+      display = new(model: model, rotation: rotation)
       return display unless block_given?
 
       begin
@@ -67,7 +78,8 @@ module ChromaWave
 
     # Renders a Canvas and sends to the display, or sends a Framebuffer directly.
     #
-    # Lazily initializes the EPD on first use.
+    # Lazily initializes the EPD on first use. Content is in the drawing
+    # orientation and is rotated to the panel's on the way out.
     #
     # @param canvas_or_fb [Canvas, Framebuffer] content to display
     # @return [self]
@@ -77,10 +89,10 @@ module ChromaWave
       case canvas_or_fb
       when Canvas
         fb = renderer.render(canvas_or_fb)
-        synchronize_device { device.send(:_epd_display, fb) }
+        transmit(:_epd_display, fb, rented: [fb])
       when Framebuffer
         validate_framebuffer!(canvas_or_fb)
-        synchronize_device { device.send(:_epd_display, canvas_or_fb) }
+        transmit(:_epd_display, canvas_or_fb)
       else
         raise TypeError, "expected Canvas or Framebuffer, got #{canvas_or_fb.class}"
       end
@@ -126,16 +138,21 @@ module ChromaWave
 
     # Returns the lazy-initialized Renderer for this display.
     #
+    # It renders into framebuffers rented from the display's pool (see
+    # {FramebufferPool}), which {#show} hands back after sending, so
+    # repeated frames reuse the same buffers.
+    #
     # @return [Renderer]
     def renderer
-      @renderer ||= Renderer.new(pixel_format: pixel_format)
+      @renderer ||= Renderer.new(pixel_format: pixel_format, pool: framebuffer_pool)
     end
 
     # Human-readable description of the display.
     #
     # @return [String]
     def inspect
-      "#<#{self.class} #{model} #{width}x#{height} #{pixel_format.name}>"
+      suffix = rotation.zero? ? '' : " rotated #{rotation}"
+      "#<#{self.class} #{model} #{width}x#{height} #{pixel_format.name}#{suffix}>"
     end
 
     protected
@@ -146,10 +163,10 @@ module ChromaWave
     #
     # @param model_name [Symbol, String] the model identifier
     # @param config [Hash] the model configuration from {Native.model_config}
-    def initialize(model_name:, config:)
+    # @param rotation [Integer] drawing orientation (see {Display.new})
+    def initialize(model_name:, config:, rotation: 0)
       @model = model_name.to_sym
-      @width = config[:width]
-      @height = config[:height]
+      configure_geometry(config, rotation)
       @pixel_format = PixelFormat.from_name(config[:pixel_format])
       @device = Device.new(model_name.to_s)
       @initialized = false
@@ -158,7 +175,63 @@ module ChromaWave
 
     private
 
-    attr_reader :device, :current_mode
+    attr_reader :device, :current_mode, :panel_width, :panel_height
+
+    # Sets the panel size and the drawing size, which is the panel's
+    # turned by +rotation+.
+    #
+    # @param config [Hash] the model configuration
+    # @param rotation [Integer] one of {Framebuffer::ROTATIONS}
+    # @raise [ArgumentError] for an unsupported rotation
+    def configure_geometry(config, rotation)
+      unless Framebuffer::ROTATIONS.include?(rotation)
+        raise ArgumentError,
+              "rotation must be one of #{Framebuffer::ROTATIONS.join(', ')}, got #{rotation.inspect}"
+      end
+
+      @rotation = rotation
+      @panel_width = config[:width]
+      @panel_height = config[:height]
+      quarter = rotation == 90 || rotation == 270
+      @width, @height = quarter ? [@panel_height, @panel_width] : [@panel_width, @panel_height]
+    end
+
+    # Pool of render and rotation buffers, shared by all send paths.
+    #
+    # @return [FramebufferPool]
+    def framebuffer_pool
+      @framebuffer_pool ||= FramebufferPool.new
+    end
+
+    # Sends framebuffers in drawing orientation to the device.
+    #
+    # Each is first rotated into a pooled panel-sized buffer (see
+    # {#orient}). Once the device has returned, or raised, the rotated
+    # buffers and the +rented+ ones go back to the pool.
+    #
+    # @param command [Symbol] the device method, e.g. +:_epd_display+
+    # @param framebuffers [Array<Framebuffer>] content to send
+    # @param args [Array] extra arguments after the framebuffers
+    # @param rented [Array<Framebuffer>] pool buffers the content lives in
+    # @return [void]
+    def transmit(command, *framebuffers, args: [], rented: [])
+      panel = []
+      framebuffers.each { |fb| panel << orient(fb) }
+      synchronize_device { device.send(command, *panel, *args) }
+    ensure
+      framebuffer_pool.release(*rented, *(rotation.zero? ? [] : panel))
+    end
+
+    # Turns a framebuffer drawn in the display's orientation into the
+    # panel's, natively (see {Framebuffer#rotate}), in a pooled buffer.
+    #
+    # @param framebuffer [Framebuffer] content in drawing orientation
+    # @return [Framebuffer] +framebuffer+ itself when there is no rotation
+    def orient(framebuffer)
+      return framebuffer if rotation.zero?
+
+      framebuffer.rotate(rotation, into: framebuffer_pool.rent(panel_width, panel_height, framebuffer.pixel_format))
+    end
 
     # Lazily initializes the EPD on first use with full refresh mode.
     #
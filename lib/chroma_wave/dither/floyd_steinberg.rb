@@ -33,7 +33,6 @@ module ChromaWave
       # @return [void]
       def call(canvas, framebuffer)
         pal = palette
-        bytes = canvas.rgba_bytes
         width = canvas.width
         color_rgb = build_color_rgb(pal)
         pixel = RGB.new(0, 0, 0)
@@ -41,11 +40,13 @@ module ChromaWave
         current_errors = Array.new(width) { [0.0, 0.0, 0.0] }
         next_errors    = Array.new(width) { [0.0, 0.0, 0.0] }
 
-        canvas.height.times do |y|
-          process_row(bytes, y, width, pixel, pal, color_rgb, framebuffer,
-                      current_errors, next_errors)
-          current_errors, next_errors = next_errors, current_errors
-          next_errors.each { |err| err[0] = 0.0; err[1] = 0.0; err[2] = 0.0 } # rubocop:disable Style/Semicolon
+        with_pixel_source(canvas) do |*source|
+          canvas.height.times do |y|
+            process_row(source, y, width, pixel, pal, color_rgb, framebuffer,
+                        current_errors, next_errors)
+            current_errors, next_errors = next_errors, current_errors
+            next_errors.each { |err| err[0] = 0.0; err[1] = 0.0; err[2] = 0.0 } # rubocop:disable Style/Semicolon
+          end
         end
       end
 
@@ -53,7 +54,7 @@ module ChromaWave
 
       # Processes a single row for Floyd-Steinberg dithering.
       #
-      # @param bytes [String] raw RGBA canvas bytes
+      # @param source [Array(String, Integer, Array<Integer>)] see {Strategy#with_pixel_source}
       # @param y_pos [Integer] current row index
       # @param width [Integer] row width in pixels
       # @param pixel [RGB] reusable pixel struct (mutated in place)
@@ -62,11 +63,12 @@ module ChromaWave
       # @param framebuffer [Framebuffer] target framebuffer
       # @param current_errors [Array<Array<Float>>] current row error buffer
       # @param next_errors [Array<Array<Float>>] next row error buffer
-      def process_row(bytes, y_pos, width, pixel, pal, color_rgb, # rubocop:disable Metrics/ParameterLists
+      def process_row(source, y_pos, width, pixel, pal, color_rgb, # rubocop:disable Metrics/ParameterLists
                       framebuffer, current_errors, next_errors)
-        row_offset = y_pos * width * BYTES_PER_PIXEL
+        bytes, bpp, channels = source
+        row_offset = y_pos * width * bpp
         width.times do |x|
-          adjust_pixel!(pixel, bytes, row_offset + (x * BYTES_PER_PIXEL), current_errors[x])
+          adjust_pixel!(pixel, bytes, row_offset + (x * bpp), channels, current_errors[x])
           nearest_name = pal.nearest_color(pixel)
           framebuffer.set_pixel(x, y_pos, nearest_name)
           distribute(current_errors, next_errors, x, width, pixel, color_rgb[nearest_name])
@@ -78,13 +80,14 @@ module ChromaWave
       # Mutates the given {RGB} struct to avoid per-pixel allocation.
       #
       # @param pixel [RGB] the struct to fill (mutated)
-      # @param bytes [String] raw RGBA canvas bytes
-      # @param offset [Integer] byte offset into the canvas buffer
+      # @param bytes [PixelBuffer, String] raw canvas bytes
+      # @param offset [Integer] byte offset of the pixel in the canvas buffer
+      # @param channels [Array<Integer>] R, G, B sample offsets within the pixel
       # @param err [Array<Float>] [r, g, b] accumulated error for this pixel
-      def adjust_pixel!(pixel, bytes, offset, err)
-        pixel.r = (bytes.getbyte(offset) + err[0]).round.clamp(0, 255)
-        pixel.g = (bytes.getbyte(offset + 1) + err[1]).round.clamp(0, 255)
-        pixel.b = (bytes.getbyte(offset + 2) + err[2]).round.clamp(0, 255)
+      def adjust_pixel!(pixel, bytes, offset, channels, err)
+        pixel.r = (bytes.getbyte(offset + channels[0]) + err[0]).round.clamp(0, 255)
+        pixel.g = (bytes.getbyte(offset + channels[1]) + err[1]).round.clamp(0, 255)
+        pixel.b = (bytes.getbyte(offset + channels[2]) + err[2]).round.clamp(0, 255)
       end
 
       # Builds a lookup table from palette color names to [r, g, b] arrays.
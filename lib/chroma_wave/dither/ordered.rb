@@ -28,17 +28,18 @@ module ChromaWave
       # @return [void]
       def call(canvas, framebuffer)
         pal = palette
-        bytes = canvas.rgba_bytes
         width = canvas.width
         spread = 256.0 / pal.size
         pixel = RGB.new(0, 0, 0)
 
-        canvas.height.times do |y|
-          width.times do |x|
-            offset = ((y * width) + x) * BYTES_PER_PIXEL
-            threshold = (BAYER_4X4[y % 4][x % 4] - 0.5) * spread
-            bayer_adjust_pixel!(pixel, bytes, offset, threshold)
-            framebuffer.set_pixel(x, y, pal.nearest_color(pixel))
+        with_pixel_source(canvas) do |bytes, bpp, channels|
+          canvas.height.times do |y|
+            width.times do |x|
+              offset = ((y * width) + x) * bpp
+              threshold = (BAYER_4X4[y % 4][x % 4] - 0.5) * spread
+              bayer_adjust_pixel!(pixel, bytes, offset, channels, threshold)
+              framebuffer.set_pixel(x, y, pal.nearest_color(pixel))
+            end
           end
         end
       end
@@ -50,13 +51,14 @@ module ChromaWave
       # Mutates +pixel+ in place to avoid per-pixel Color allocation.
       #
       # @param pixel [RGB] the struct to fill (mutated)
-      # @param bytes [String] raw RGBA canvas bytes
-      # @param offset [Integer] byte offset into the canvas buffer
+      # @param bytes [PixelBuffer, String] raw canvas bytes
+      # @param offset [Integer] byte offset of the pixel in the canvas buffer
+      # @param channels [Array<Integer>] R, G, B sample offsets within the pixel
       # @param threshold [Float] Bayer threshold value scaled by spread
-      def bayer_adjust_pixel!(pixel, bytes, offset, threshold)
-        pixel.r = (bytes.getbyte(offset) + threshold).round.clamp(0, 255)
-        pixel.g = (bytes.getbyte(offset + 1) + threshold).round.clamp(0, 255)
-        pixel.b = (bytes.getbyte(offset + 2) + threshold).round.clamp(0, 255)
+      def bayer_adjust_pixel!(pixel, bytes, offset, channels, threshold)
+        pixel.r = (bytes.getbyte(offset + channels[0]) + threshold).round.clamp(0, 255)
+        pixel.g = (bytes.getbyte(offset + channels[1]) + threshold).round.clamp(0, 255)
+        pixel.b = (bytes.getbyte(offset + channels[2]) + threshold).round.clamp(0, 255)
       end
     end
   end
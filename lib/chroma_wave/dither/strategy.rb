@@ -13,6 +13,12 @@ module ChromaWave
       # Bytes per pixel in the Canvas RGBA buffer.
       BYTES_PER_PIXEL = 4
 
+      # Byte offsets of the R, G and B samples within an RGBA pixel.
+      RGB_CHANNELS = [0, 1, 2].freeze
+
+      # A {GrayCanvas} luma byte serves as all three samples.
+      GRAY_CHANNELS = [0, 0, 0].freeze
+
       # Lightweight RGB triple used in hot loops to avoid full Color allocation.
       # Responds to .r, .g, .b for duck-type compatibility with Palette#nearest_color.
       RGB = Struct.new(:r, :g, :b)
@@ -51,6 +57,22 @@ module ChromaWave
 
       private
 
+      # Yields the canvas pixel bytes (borrowed, not copied), the bytes
+      # per pixel, and the offsets of the R, G and B samples within a pixel.
+      #
+      # @param canvas [Canvas] source canvas (RGBA or {GrayCanvas})
+      # @yieldparam bytes [PixelBuffer, String] the pixel data, valid only inside the block
+      # @yieldparam bpp [Integer] bytes per pixel
+      # @yieldparam channels [Array<Integer>] R, G, B sample offsets
+      # @return [Object] the block's result
+      def with_pixel_source(canvas)
+        if canvas.is_a?(GrayCanvas)
+          canvas.with_gray_buffer { |bytes| yield bytes, GrayCanvas::BYTES_PER_PIXEL, GRAY_CHANNELS }
+        else
+          canvas.with_rgba_buffer { |bytes| yield bytes, BYTES_PER_PIXEL, RGB_CHANNELS }
+        end
+      end
+
       # Returns the palette from the pixel format.
       #
       # @return [Palette]
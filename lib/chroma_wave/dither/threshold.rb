@@ -4,7 +4,7 @@ module ChromaWave
   module Dither
     # Threshold quantization: simple nearest-color mapping with no error diffusion.
     #
-    # Reads raw RGBA bytes from the canvas and maps each pixel to the nearest
+    # Reads raw pixel bytes from the canvas and maps each pixel to the nearest
     # palette color using the palette's redmean distance calculation. Uses a
     # reusable {RGB} struct to avoid per-pixel Color allocation.
     #
@@ -19,17 +19,18 @@ module ChromaWave
       # @return [void]
       def call(canvas, framebuffer)
         pal = palette
-        bytes = canvas.rgba_bytes
         width = canvas.width
         pixel = RGB.new(0, 0, 0)
 
-        canvas.height.times do |y|
-          width.times do |x|
-            offset = ((y * width) + x) * BYTES_PER_PIXEL
-            pixel.r = bytes.getbyte(offset)
-            pixel.g = bytes.getbyte(offset + 1)
-            pixel.b = bytes.getbyte(offset + 2)
-            framebuffer.set_pixel(x, y, pal.nearest_color(pixel))
+        with_pixel_source(canvas) do |bytes, bpp, (ro, go, bo)|
+          canvas.height.times do |y|
+            width.times do |x|
+              offset = ((y * width) + x) * bpp
+              pixel.r = bytes.getbyte(offset + ro)
+              pixel.g = bytes.getbyte(offset + go)
+              pixel.b = bytes.getbyte(offset + bo)
+              framebuffer.set_pixel(x, y, pal.nearest_color(pixel))
+            end
           end
         end
       end
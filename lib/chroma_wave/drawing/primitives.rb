@@ -13,7 +13,24 @@ module ChromaWave
     #
     # All public drawing methods accept a +pen:+ keyword argument — a
     # {Pen} value object bundling stroke color, fill color, and stroke width.
+    #
+    # Canvas and Framebuffer hand each shape to a native span rasterizer
+    # (see +raster.c+) through {#native_raster}, resolving the color once
+    # and writing whole rows instead of calling +set_pixel+ per pixel; a
+    # {Layer} passes its shapes up to the root surface's rasterizer with
+    # a translate-and-clip window. The Ruby implementations below remain
+    # the reference and the fallback for every other surface.
     module Primitives
+      # Radius past which ellipses are drawn row by row as a scanline
+      # annulus instead of with the midpoint walk, whose terms would
+      # overflow 64 bits in +raster.c+. Both paths switch at this size.
+      MIDPOINT_ELLIPSE_LIMIT = 1 << 14
+
+      # Radius past which circles are drawn row by row as a scanline
+      # annulus. The native rasterizer takes radii up to this size, so
+      # only the Ruby path ever switches.
+      MIDPOINT_CIRCLE_LIMIT = 1 << 20
+
       # Draws a straight line using Bresenham's algorithm.
       #
       # @param x0 [Integer] start x
@@ -27,10 +44,10 @@ module ChromaWave
         color = pen.stroke
         sw = pen.stroke_width
 
-        if sw <= 1
-          bresenham(x0, y0, x1, y1) { |x, y| set_pixel(x, y, color) }
-        else
+        if sw > 1
           draw_thick_line(x0, y0, x1, y1, color, sw)
+        elsif !native_raster(:line, color, x0, y0, x1, y1)
+          bresenham(x0, y0, x1, y1) { |x, y| set_pixel(x, y, color) }
         end
         self
       end
@@ -167,6 +184,8 @@ module ChromaWave
       # Flood-fills a contiguous region starting at (x, y).
       #
       # Uses a scanline algorithm for O(pixels) time with O(height) stack.
+      # Canvas and Framebuffer fill natively, comparing raw pixel values
+      # instead of allocating a color per probe.
       #
       # @param x [Integer] seed x
       # @param y [Integer] seed y
@@ -174,7 +193,9 @@ module ChromaWave
       # @return [self]
       def flood_fill(x, y, color:)
         return self unless in_bounds?(x, y)
+        return self if native_raster(:flood, color, x, y)
 
+        color = surface_color(color)
         target = get_pixel(x, y)
         return self if target == color
 
@@ -182,8 +203,78 @@ module ChromaWave
         self
       end
 
+      # Sets many pixels to one color in a single call, e.g. the points
+      # of a scatter plot.
+      #
+      # Coordinates are two Arrays of Integers or two Strings of packed
+      # little-endian int16 (+pack('s<*')+), which the native
+      # rasterizer reads without a Ruby object per point. Points outside
+      # the surface are skipped.
+      #
+      # @example
+      #   canvas.set_pixels(xs.pack('s<*'), ys.pack('s<*'), Color::BLACK)
+      #
+      # @param xs [Array<Integer>, String] x coordinates
+      # @param ys [Array<Integer>, String] y coordinates, as many as +xs+
+      # @param color [Object] a color understood by +set_pixel+
+      # @return [self]
+      # @raise [ArgumentError] if the lists differ in length or a packed
+      #   String has an odd size
+      def set_pixels(xs, ys, color)
+        count = coordinate_count(xs, 1)
+        unless coordinate_count(ys, 1) == count
+          raise ArgumentError, "got #{count} x and #{coordinate_count(ys, 1)} y coordinates"
+        end
+        return self if native_raster(:points, color, xs, ys)
+
+        unpack_coordinates(xs).zip(unpack_coordinates(ys)) { |x, y| set_pixel(x, y, color) }
+        self
+      end
+
+      # Sets horizontal runs of pixels to one color in a single call, e.g.
+      # the rows of a custom glyph.
+      #
+      # Runs are +[x, y, length]+ triples, or a String of packed
+      # little-endian int16 triples (+pack('s<*')+). Runs are clipped to
+      # the surface; those of zero or negative length are skipped.
+      #
+      # @param runs [Array<Array(Integer, Integer, Integer)>, String] the runs
+      # @param color [Object] a color understood by +set_pixel+
+      # @return [self]
+      # @raise [ArgumentError] if a packed String is not whole triples
+      def set_pixel_runs(runs, color)
+        coordinate_count(runs, 3)
+        return self if native_raster(:runs, color, runs)
+
+        runs = unpack_coordinates(runs).each_slice(3) if runs.is_a?(String)
+        runs.each { |x, y, length| fill_rect(x, y, length, 1, color) if length.positive? }
+        self
+      end
+
       private
 
+      # Number of items in a coordinate list (see {#set_pixels}).
+      #
+      # @param list [Array, String] items, or packed int16 values
+      # @param group [Integer] int16 values per item of a packed String
+      # @return [Integer]
+      # @raise [ArgumentError] if a packed String is not whole items
+      def coordinate_count(list, group)
+        return list.size unless list.is_a?(String)
+
+        size = 2 * group
+        return list.bytesize / size if (list.bytesize % size).zero?
+
+        raise ArgumentError, "packed coordinates must come in #{size}-byte items, got #{list.bytesize} bytes"
+      end
+
+      # Integers of a coordinate list (see {#set_pixels}).
+      #
+      # @return [Array<Integer>]
+      def unpack_coordinates(list)
+        list.is_a?(String) ? list.unpack('s<*') : list
+      end
+
       # Validates that a pen does not include fill when fill is disallowed.
       #
       # Stroke/fill presence is already validated by {Pen#initialize}, so
@@ -197,38 +288,66 @@ module ChromaWave
         raise ArgumentError, 'fill is not supported for this shape' if !allow_fill && pen.fill?
       end
 
+      # Rasterizes a shape natively when the surface supports it.
+      #
+      # Surfaces with a native span rasterizer override this to resolve
+      # +color+ once and pass +shape+ and +args+ (the arguments of the
+      # matching Ruby helper) to C. The default has none.
+      #
+      # @param shape [Symbol] shape name, e.g. +:fill_circle+
+      # @param color [Object] the color to paint
+      # @param args [Array] shape arguments
+      # @return [Boolean] true if the shape was drawn, false to use the Ruby path
+      def native_raster(shape, color, *args) # rubocop:disable Lint/UnusedMethodArgument
+        false
+      end
+
       # ── Bresenham line ────────────────────────────────────────────
 
-      # Standard Bresenham integer line algorithm.
+      # Bresenham integer line algorithm, visiting only the steps whose
+      # major-axis coordinate is on the surface.
+      #
+      # The error term of the classic loop has a closed form: after +k+
+      # steps along x, an x-major line has taken
+      # +(dx + 2 * dy * k) / (2 * dx)+ steps along y (and the same with
+      # the axes swapped), so the walk can start at the first visible
+      # step. Lines reaching far off the surface cost only their visible
+      # part.
       #
       # @param x0 [Integer] start x
       # @param y0 [Integer] start y
       # @param x1 [Integer] end x
       # @param y1 [Integer] end y
-      # @yield [x, y] called for each pixel along the line
+      # @yield [x, y] called for each visible pixel along the line
       def bresenham(x0, y0, x1, y1)
         dx = (x1 - x0).abs
-        dy = -(y1 - y0).abs
+        dy = (y1 - y0).abs
         sx = x0 < x1 ? 1 : -1
         sy = y0 < y1 ? 1 : -1
-        err = dx + dy
-
-        loop do
-          yield x0, y0
-          break if x0 == x1 && y0 == y1
 
-          e2 = 2 * err
-          if e2 >= dy
-            err += dy
-            x0 += sx
+        if dx >= dy
+          visible_steps(x0, sx, dx, width).each do |k|
+            yield x0 + (sx * k), y0 + (sy * (dx.zero? ? 0 : (dx + (2 * dy * k)) / (2 * dx)))
           end
-          if e2 <= dx
-            err += dx
-            y0 += sy
+        else
+          visible_steps(y0, sy, dy, height).each do |k|
+            yield x0 + (sx * ((dy + (2 * dx * k)) / (2 * dy))), y0 + (sy * k)
           end
         end
       end
 
+      # Steps +k+ in +0..n+ whose coordinate +c0 + s * k+ lies in +0...size+.
+      #
+      # @param c0 [Integer] start coordinate
+      # @param s [Integer] step direction (-1 or 1)
+      # @param n [Integer] last step
+      # @param size [Integer] surface extent along the axis
+      # @return [Range]
+      def visible_steps(c0, s, n, size)
+        first, last = s.positive? ? [-c0, size - 1 - c0] : [c0 - (size - 1), c0]
+        ([first, 0].max..[last, n].min)
+      end
+
       # Draws a thick line using perpendicular offset Bresenham lines.
       #
       # @param x0 [Integer] start x
@@ -238,6 +357,8 @@ module ChromaWave
       # @param color [Object] line color
       # @param w [Integer] line thickness
       def draw_thick_line(x0, y0, x1, y1, color, w) # rubocop:disable Metrics/AbcSize
+        return if native_raster(:thick_line, color, x0, y0, x1, y1, w)
+
         half = (w - 1) / 2.0
         dx = x1 - x0
         dy = y1 - y0
@@ -271,9 +392,22 @@ module ChromaWave
       # @param h [Integer] height
       # @param color [Object] fill color
       def fill_rect(x, y, w, h, color)
-        h.times do |row|
-          w.times { |col| set_pixel(x + col, y + row, color) }
-        end
+        return if native_raster(:rect, color, x, y, w, h)
+
+        ([y, 0].max..[y + h - 1, height - 1].min).each { |row| fill_span(x, x + w - 1, row, color) }
+      end
+
+      # Sets pixels +x0..x1+ of row +y+, clipped to the surface first so
+      # shapes far larger than the surface cost only their visible pixels.
+      #
+      # @param x0 [Integer] first x
+      # @param x1 [Integer] last x (inclusive)
+      # @param y [Integer] row
+      # @param color [Object] pixel color
+      def fill_span(x0, x1, y, color)
+        return unless y >= 0 && y < height
+
+        ([x0, 0].max..[x1, width - 1].min).each { |x| set_pixel(x, y, color) }
       end
 
       # Strokes a rectangle outline using four thick lines.
@@ -337,6 +471,8 @@ module ChromaWave
       # @param sx [Integer] x direction (-1 or 1)
       # @param sy [Integer] y direction (-1 or 1)
       def fill_quarter_circle(cx, cy, r, color, sx, sy)
+        return if native_raster(:quarter_circle, color, cx, cy, r, sx, sy)
+
         xi = 0
         yi = r
         d = 1 - r
@@ -363,9 +499,9 @@ module ChromaWave
       # @param color [Object] color
       def draw_horizontal_span(cx, y, sx, len, color)
         if sx.positive?
-          (len + 1).times { |i| set_pixel(cx + i, y, color) }
+          fill_span(cx, cx + len, y, color)
         else
-          (len + 1).times { |i| set_pixel(cx - i, y, color) }
+          fill_span(cx - len, cx, y, color)
         end
       end
 
@@ -407,15 +543,18 @@ module ChromaWave
       # @param color [Object] fill color
       # rubocop:disable Metrics/AbcSize, Metrics/CyclomaticComplexity, Metrics/PerceivedComplexity
       def fill_circle(cx, cy, r, color)
+        return if native_raster(:fill_circle, color, cx, cy, r)
+        return fill_annulus(cx, cy, r, 0, color) if r > MIDPOINT_CIRCLE_LIMIT
+
         xi = 0
         yi = r
         d = 1 - r
 
         while xi <= yi
-          (-yi..yi).each { |dx| set_pixel(cx + dx, cy + xi, color) }
-          (-yi..yi).each { |dx| set_pixel(cx + dx, cy - xi, color) } if xi != 0
-          (-xi..xi).each { |dx| set_pixel(cx + dx, cy + yi, color) } if xi != yi
-          (-xi..xi).each { |dx| set_pixel(cx + dx, cy - yi, color) } if xi != yi && yi != 0
+          fill_span(cx - yi, cx + yi, cy + xi, color)
+          fill_span(cx - yi, cx + yi, cy - xi, color) if xi != 0
+          fill_span(cx - xi, cx + xi, cy + yi, color) if xi != yi
+          fill_span(cx - xi, cx + xi, cy - yi, color) if xi != yi && yi != 0
           xi += 1
           if d.negative?
             d += (2 * xi) + 1
@@ -454,6 +593,9 @@ module ChromaWave
       # @param r [Integer] radius
       # @param color [Object] pixel color
       def midpoint_circle(cx, cy, r, color)
+        return if native_raster(:circle, color, cx, cy, r)
+        return fill_annulus(cx, cy, r, r - 1, color) if r > MIDPOINT_CIRCLE_LIMIT
+
         xi = 0
         yi = r
         d = 1 - r
@@ -499,10 +641,12 @@ module ChromaWave
       # @param inner [Integer] inner radius
       # @param color [Object] fill color
       def fill_annulus(cx, cy, outer, inner, color) # rubocop:disable Metrics/AbcSize
+        return if native_raster(:annulus, color, cx, cy, outer, inner)
+
         outer_sq = outer * outer
         inner_sq = inner * inner
 
-        (-outer..outer).each do |dy|
+        ([-outer, -cy].max..[outer, height - 1 - cy].min).each do |dy|
           dy_sq = dy * dy
           next if dy_sq > outer_sq
 
@@ -510,12 +654,12 @@ module ChromaWave
 
           if dy_sq >= inner_sq
             # Row is beyond the inner circle — fill the full span
-            (-outer_x..outer_x).each { |dx| set_pixel(cx + dx, cy + dy, color) }
+            fill_span(cx - outer_x, cx + outer_x, cy + dy, color)
           else
             # Row intersects both circles — fill only the left and right arcs
             inner_x = Integer.sqrt(inner_sq - dy_sq)
-            (-outer_x..(-inner_x - 1)).each { |dx| set_pixel(cx + dx, cy + dy, color) }
-            ((inner_x + 1)..outer_x).each { |dx| set_pixel(cx + dx, cy + dy, color) }
+            fill_span(cx - outer_x, cx - inner_x - 1, cy + dy, color)
+            fill_span(cx + inner_x + 1, cx + outer_x, cy + dy, color)
           end
         end
       end
@@ -530,9 +674,20 @@ module ChromaWave
       # @param ry [Integer] vertical radius
       # @param color [Object] fill color
       def fill_ellipse(cx, cy, rx, ry, color)
-        midpoint_ellipse(cx, cy, rx, ry) do |x0, x1, y|
-          (x0..x1).each { |xi| set_pixel(xi, y, color) }
-        end
+        return if native_raster(:fill_ellipse, color, cx, cy, rx, ry)
+        return fill_ellipse_annulus(cx, cy, rx, ry, 0, 0, color) if scanline_ellipse?(rx, ry)
+
+        midpoint_ellipse(cx, cy, rx, ry) { |x0, x1, y| fill_span(x0, x1, y, color) }
+      end
+
+      # Whether an ellipse is past {MIDPOINT_ELLIPSE_LIMIT} and is drawn
+      # as a scanline annulus.
+      #
+      # @param rx [Integer] horizontal radius
+      # @param ry [Integer] vertical radius
+      # @return [Boolean]
+      def scanline_ellipse?(rx, ry)
+        rx.positive? && ry.positive? && [rx, ry].max > MIDPOINT_ELLIPSE_LIMIT
       end
 
       # Strokes an ellipse outline.
@@ -621,6 +776,9 @@ module ChromaWave
       # @param color [Object] pixel color
       # rubocop:disable Metrics/AbcSize, Metrics/MethodLength
       def midpoint_ellipse_outline(cx, cy, rx, ry, color)
+        return if native_raster(:ellipse, color, cx, cy, rx, ry)
+        return fill_ellipse_annulus(cx, cy, rx, ry, rx - 1, ry - 1, color) if scanline_ellipse?(rx, ry)
+
         rx2 = rx * rx
         ry2 = ry * ry
         x = 0
@@ -689,8 +847,9 @@ module ChromaWave
       # rubocop:disable Metrics/AbcSize, Metrics/CyclomaticComplexity, Metrics/PerceivedComplexity, Metrics/ParameterLists
       def fill_ellipse_annulus(cx, cy, orx, ory, irx, iry, color)
         return unless orx.positive? && ory.positive?
+        return if native_raster(:ellipse_annulus, color, cx, cy, orx, ory, irx, iry)
 
-        (-ory..ory).each do |dy|
+        ([-ory, -cy].max..[ory, height - 1 - cy].min).each do |dy|
           # Outer ellipse x-extent: dx^2 <= orx^2 * (1 - dy^2/ory^2)
           outer_val = 1.0 - ((dy.to_f / ory)**2)
           next if outer_val.negative?
@@ -701,10 +860,10 @@ module ChromaWave
           if has_inner_hole
             inner_val = 1.0 - ((dy.to_f / iry)**2)
             inner_x = (irx * Math.sqrt(inner_val)).round
-            (-outer_x..(-inner_x - 1)).each { |dx| set_pixel(cx + dx, cy + dy, color) }
-            ((inner_x + 1)..outer_x).each { |dx| set_pixel(cx + dx, cy + dy, color) }
+            fill_span(cx - outer_x, cx - inner_x - 1, cy + dy, color)
+            fill_span(cx + inner_x + 1, cx + outer_x, cy + dy, color)
           else
-            (-outer_x..outer_x).each { |dx| set_pixel(cx + dx, cy + dy, color) }
+            fill_span(cx - outer_x, cx + outer_x, cy + dy, color)
           end
         end
       end
@@ -723,12 +882,14 @@ module ChromaWave
       # @param sw [Integer] stroke width
       # rubocop:disable Metrics/AbcSize, Metrics/MethodLength
       def draw_arc_pixels(cx, cy, r, start_angle, end_angle, color, sw) # rubocop:disable Metrics/ParameterLists
+        return if native_raster(:arc, color, cx, cy, r, start_angle, end_angle, sw)
+
         # Normalize angles to [0, 2π)
         two_pi = 2 * Math::PI
         sa = start_angle % two_pi
         ea = end_angle % two_pi
 
-        radii = sw <= 1 ? [r] : ((r - (sw / 2))..[r + ((sw - 1) / 2)]).to_a.select(&:positive?)
+        radii = sw <= 1 ? [r] : ((r - (sw / 2))..(r + ((sw - 1) / 2))).select(&:positive?)
 
         radii.each do |current_r|
           xi = 0
@@ -737,6 +898,8 @@ module ChromaWave
 
           while xi <= yi
             each_circle_octant(xi, yi) do |dx, dy|
+              next unless in_bounds?(cx + dx, cy + dy)
+
               angle = Math.atan2(-dy, dx) % two_pi
               set_pixel(cx + dx, cy + dy, color) if angle_in_range?(angle, sa, ea)
             end
@@ -794,9 +957,11 @@ module ChromaWave
       # @param points [Array<Array(Integer, Integer)>] polygon vertices
       # @param color [Object] fill color
       def fill_polygon(points, color)
+        return if native_raster(:polygon, color, points)
+
         ys = points.map(&:last)
-        min_y = ys.min
-        max_y = ys.max
+        min_y = [ys.min, 0].max
+        max_y = [ys.max, height - 1].min
 
         (min_y..max_y).each do |scan_y|
           intersections = polygon_intersections(points, scan_y)
@@ -804,7 +969,7 @@ module ChromaWave
           intersections.each_slice(2) do |x_start, x_end|
             next unless x_end
 
-            (x_start..x_end).each { |x| set_pixel(x, scan_y, color) }
+            fill_span(x_start, x_end, scan_y, color)
           end
         end
       end
@@ -838,6 +1003,16 @@ module ChromaWave
 
       # ── Scanline flood fill ───────────────────────────────────────
 
+      # Returns +color+ as {#get_pixel} would report it once set, so the
+      # fill can tell filled pixels from the target. Surfaces that store
+      # colors in another form (palette indices) override this.
+      #
+      # @param color [Object] the fill color
+      # @return [Object]
+      def surface_color(color)
+        color
+      end
+
       # Scanline flood fill: O(pixels) time, O(height) stack.
       #
       # @param x [Integer] seed x
@@ -14,6 +14,10 @@ module ChromaWave
       # Each glyph pixel is alpha-composited against the surface background.
       # Fully opaque pixels (alpha 255) are set directly for performance.
       #
+      # The wrapped, aligned, and rasterized layout is memoized in
+      # {TextLayout.cache}, so redrawing the same string with the same
+      # font and options only composites glyphs.
+      #
       # @param text [String] the text to render
       # @param x [Integer] left edge of the alignment box.
       #   For +align: :left+, text starts at this x coordinate.
@@ -29,31 +33,62 @@ module ChromaWave
       # @param line_spacing [Float] multiplier for line height (default 1.2)
       # @return [self]
       def draw_text(text, x:, y:, font:, color:, align: :left, max_width: nil, line_spacing: 1.2) # rubocop:disable Metrics/ParameterLists
-        lines = max_width ? word_wrap(text, font, max_width) : text.split("\n", -1)
-        line_h = (font.line_height * line_spacing).round
+        layout = layout_text(text, font, align, max_width, line_spacing)
 
-        lines.each_with_index do |line, i|
-          line_y = y + (i * line_h)
-          line_x = compute_text_x(line, x, font, align, max_width)
-          render_line(line, line_x, line_y, font, color)
+        layout.lines.each do |line|
+          line.glyphs.each { |glyph| render_glyph(glyph, x + line.x, y + line.y, color) }
         end
 
         self
       end
 
+      # Composites a single pre-rendered glyph onto the surface.
+      #
+      # Takes a glyph hash in the shape yielded by {Font#each_glyph}
+      # (+:bitmap+, +:x+, +:y+, +:width+, +:height+), positioned relative
+      # to (+x+, +y+). Used by {IconFont} to draw cached atlas entries
+      # without going through layout.
+      #
+      # @param glyph [Hash] glyph data
+      # @param x [Integer] left edge of the glyph's line box
+      # @param y [Integer] top edge of the glyph's line box
+      # @param color [Color] glyph color
+      # @return [self]
+      def draw_glyph(glyph, x:, y:, color:)
+        render_glyph(glyph, x, y, color)
+        self
+      end
+
       private
 
-      # Renders a single line of text at the given position.
+      # Returns the cached layout for the given text and options,
+      # building it on a miss.
       #
-      # @param line [String] text line
-      # @param x [Integer] x position
-      # @param y [Integer] y position (top of line)
+      # @return [TextLayout]
+      # @raise [ArgumentError] for invalid alignment options
+      def layout_text(text, font, align, max_width, line_spacing)
+        key = [TextLayout.font_key(font), -text, max_width, align, line_spacing]
+        TextLayout.cache.fetch(key) { build_text_layout(text, font, align, max_width, line_spacing) }
+      end
+
+      # Wraps, aligns, and rasterizes text into a {TextLayout} whose line
+      # offsets are relative to the draw origin.
+      #
+      # @param text [String] the text to lay out
       # @param font [Font] loaded Font
-      # @param color [Color] text color
-      def render_line(line, x, y, font, color)
-        font.each_glyph(line) do |glyph|
-          render_glyph(glyph, x, y, color)
+      # @param align [Symbol] :left, :center, or :right
+      # @param max_width [Integer, nil] alignment box / wrap width
+      # @param line_spacing [Float] line height multiplier
+      # @return [TextLayout]
+      def build_text_layout(text, font, align, max_width, line_spacing)
+        lines = max_width ? word_wrap(text, font, max_width) : text.split("\n", -1)
+        line_h = (font.line_height * line_spacing).round
+
+        laid_out = lines.each_with_index.map do |line, i|
+          TextLayout::Line.new(text: line, x: compute_text_x(line, 0, font, align, max_width), y: i * line_h,
+                               glyphs: font.each_glyph(line).map(&:freeze).freeze)
         end
+        TextLayout.new(lines: laid_out)
       end
 
       # Alpha-composites a single glyph bitmap onto the surface.
@@ -192,7 +227,7 @@ module ChromaWave
 
         words.each do |word|
           candidate = "#{current} #{word}"
-          if font.measure(candidate).width <= max_width
+          if line_width(font, candidate) <= max_width
             current = candidate
           else
             lines << current
@@ -216,13 +251,29 @@ module ChromaWave
 
         raise ArgumentError, "max_width is required for #{align.inspect} alignment" if max_width.nil?
 
-        line_w = font.measure(line).width
+        line_w = line_width(font, line)
         case align
         when :center then x + ((max_width - line_w) / 2)
         when :right  then x + (max_width - line_w)
         else raise ArgumentError, "unknown align: #{align.inspect} (expected :left, :center, or :right)"
         end
       end
+
+      # Measures the advance width of one line without the layout cache.
+      #
+      # Layout building measures every wrap candidate of a paragraph;
+      # sending those through {TextLayout.cache} would evict the finished
+      # layouts it exists to keep. Fonts without a +line_width+ (see
+      # {Font#line_width}) fall back to +measure+.
+      #
+      # @param font [Font, BitmapFont, FontStack] font to measure with
+      # @param line [String] a single line (no newlines)
+      # @return [Integer] width in pixels
+      def line_width(font, line)
+        return font.line_width(line) if font.respond_to?(:line_width)
+
+        font.measure(line).width
+      end
     end
   end
 end
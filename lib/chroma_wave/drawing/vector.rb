@@ -0,0 +1,58 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  module Drawing
+    # Anti-aliased vector drawing mixin for {Canvas} and {Layer}.
+    #
+    # Paths are rasterized by a native coverage-accumulation rasterizer
+    # (+coverage.c+) into an 8-bit coverage mask, which is composited like
+    # a text glyph — through +_canvas_blit_glyph+ on a Canvas, or the
+    # parent's accelerator from a Layer. Like {Text}, it is included only
+    # into Color-based surfaces.
+    module Vector
+      # Stroke join styles, in the order +coverage.c+ numbers them.
+      JOINS = %i[round miter bevel].freeze
+
+      # Stroke cap styles, in the order +coverage.c+ numbers them.
+      CAPS = %i[butt round square].freeze
+
+      # Draws an anti-aliased path.
+      #
+      # Fills first (every contour implicitly closed; overlapping
+      # contours of opposite direction cut holes), then strokes on top.
+      # Color alpha scales the coverage.
+      #
+      # @param path [Path] the path to draw
+      # @param pen [Pen] fill color, stroke color, and stroke width
+      # @param join [:round, :miter, :bevel] stroke join style
+      # @param cap [:butt, :round, :square] end cap style for open contours
+      # @return [self]
+      # @raise [ArgumentError] for an unknown join or cap
+      def draw_path(path, pen:, join: :round, cap: :butt)
+        join_index = JOINS.index(join) or raise ArgumentError, "unknown join: #{join.inspect}"
+        cap_index = CAPS.index(cap) or raise ArgumentError, "unknown cap: #{cap.inspect}"
+        return self if path.empty?
+
+        contours = path.native_contours
+        composite_coverage(contours, pen.fill, nil) if pen.fill?
+        composite_coverage(contours, pen.stroke, [pen.stroke_width, join_index, cap_index]) if pen.stroke?
+        self
+      end
+
+      private
+
+      # Rasterizes contours and composites the coverage mask in +color+.
+      #
+      # @param contours [Array] output of {Path#native_contours}
+      # @param color [Color, Symbol] paint color (palette names are opaque)
+      # @param stroke [Array, nil] [width, join, cap] or nil to fill
+      def composite_coverage(contours, color, stroke)
+        alpha = color.is_a?(Color) ? color.a : 255
+        mask, x, y, w, h = Native.rasterize_path(contours, width, height, alpha, stroke)
+        return unless mask
+
+        render_glyph({ bitmap: mask, x: x, y: y, width: w, height: h }, 0, 0, color)
+      end
+    end
+  end
+end
@@ -45,7 +45,8 @@ module ChromaWave
         mono: 'PIXEL_FORMAT_MONO',
         gray4: 'PIXEL_FORMAT_GRAY4',
         color4: 'PIXEL_FORMAT_COLOR4',
-        color7: 'PIXEL_FORMAT_COLOR7'
+        color7: 'PIXEL_FORMAT_COLOR7',
+        color4_2bpp: 'PIXEL_FORMAT_COLOR4_2BPP'
       }.freeze
 
       # Maps Ruby busy polarity symbols to C enum names.
@@ -15,12 +15,12 @@ module ChromaWave
 
         # Detects the pixel format for the model.
         #
-        # @return [Symbol] :mono, :color4, or :color7
+        # @return [Symbol] :mono, :color4, :color7, or :color4_2bpp
         def detect_pixel_format
           base = @model_name.sub(/^EPD_/, '')
 
           return :color7 if base.match?(COLOR7_PATTERN)
-          return :color4 if base.match?(GATE_COLOR_PATTERN)
+          return :color4_2bpp if base.match?(GATE_COLOR_PATTERN)
           return :color4 if base.match?(COLOR4_PATTERNS)
           return :color7 if @h_content.match?(/BLACK\s+0x0.*GREEN\s+0x2.*RED\s+0x4/m)
 
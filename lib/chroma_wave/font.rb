@@ -1,5 +1,7 @@
 # frozen_string_literal: true
 
+require_relative 'font/index'
+
 module ChromaWave
   # Loads a TrueType font and provides glyph measurement and iteration.
   #
@@ -35,6 +37,10 @@ module ChromaWave
     # Mutex protecting the class-level font discovery cache.
     FONT_CACHE_MUTEX = Mutex.new
 
+    # Environment variable overriding the on-disk font index location.
+    # Set it to an empty string to disable persistence.
+    INDEX_PATH_ENV = 'CHROMA_WAVE_FONT_INDEX'
+
     # @!visibility private
     class << self
       private
@@ -63,6 +69,7 @@ module ChromaWave
     #
     # Handles multi-line text (explicit +\n+ characters): returns the
     # width of the widest line and the total height of all lines.
+    # Results are memoized in {TextLayout.cache}.
     #
     # @note Kerning is not applied — each glyph advance is summed
     #   independently. This is sufficient for e-paper displays but
@@ -71,11 +78,22 @@ module ChromaWave
     # @param text [String] the text to measure
     # @return [TextMetrics] width, height, ascent, and descent
     def measure(text)
-      lines = text.split("\n", -1)
-      widest = lines.map { |line| measure_line_width(line) }.max || 0
-      total_height = line_height * lines.length
+      TextLayout.cache.fetch([:measure, cache_key, -text]) { measure_uncached(text) }
+    end
 
-      TextMetrics.new(width: widest, height: total_height, ascent: ascent, descent: descent)
+    # Sums glyph advance widths for a single line of text.
+    #
+    # Unlike {#measure}, this bypasses {TextLayout.cache}, so layout code
+    # can measure many candidate lines without evicting finished layouts.
+    #
+    # @param line [String] a single line (no newlines)
+    # @return [Integer] total advance width in pixels
+    def line_width(line)
+      w = 0
+      line.each_codepoint do |cp|
+        w += _ft_glyph_metrics(cp)[:advance_x]
+      end
+      w
     end
 
     # Iterates over each glyph in the text, yielding positioned glyph data.
@@ -91,7 +109,8 @@ module ChromaWave
     #
     # @param text [String] the text to iterate
     # @yield [Hash] glyph data for each character
-    # @return [Enumerator] if no block given
+    # @return [Integer, Enumerator] pen advance after the last glyph, or
+    #   an Enumerator if no block given
     def each_glyph(text, &block)
       return enum_for(:each_glyph, text) unless block
 
@@ -109,6 +128,7 @@ module ChromaWave
 
         pen_x += glyph[:advance_x]
       end
+      pen_x
     end
 
     # Returns the line height in pixels.
@@ -132,6 +152,31 @@ module ChromaWave
       _ft_descent
     end
 
+    # Returns the face's cmap coverage as a bitset String: bit
+    # +cp & 7+ of byte +cp >> 3+ is set when the face has a glyph for
+    # +cp+. Computed once per Font; used by {FontStack}.
+    #
+    # @return [String] frozen binary String
+    def coverage
+      @coverage ||= _ft_coverage.freeze
+    end
+
+    # Returns true if the face maps +codepoint+ to a real glyph.
+    #
+    # @param codepoint [Integer]
+    # @return [Boolean]
+    def include_codepoint?(codepoint)
+      byte = coverage.getbyte(codepoint >> 3)
+      !byte.nil? && byte.anybits?(1 << (codepoint & 7))
+    end
+
+    # Identity of this face and size for shared caches ({TextLayout}).
+    #
+    # @return [Array]
+    def cache_key
+      [self.class, path, size]
+    end
+
     # Returns a human-readable description.
     #
     # @return [String]
@@ -147,27 +192,44 @@ module ChromaWave
       new(File.join(DATA_DIR, 'fonts', 'dejavu-sans.ttf'), size: size)
     end
 
-    # Clears the font discovery cache.
+    # Clears the in-process font discovery cache.
     #
-    # Call this after installing new fonts to pick up changes.
+    # The next lookup revalidates the on-disk index (see {.index_path}),
+    # re-reading only directories that changed. Call this after
+    # installing new fonts in a long-running process.
     #
     # @return [void]
     def self.clear_font_cache!
       FONT_CACHE_MUTEX.synchronize { self.font_cache = nil }
     end
 
+    # Returns the path of the persistent font discovery index.
+    #
+    # Defaults to +$XDG_CACHE_HOME/chroma_wave/font-index.json+ (or
+    # +~/.cache/...+); overridden by +CHROMA_WAVE_FONT_INDEX+.
+    #
+    # @return [String, nil] absolute path, or nil when persistence is disabled
+    def self.index_path
+      override = ENV.fetch(INDEX_PATH_ENV, nil)
+      return (override.empty? ? nil : File.expand_path(override)) if override
+
+      File.expand_path(File.join(ENV.fetch('XDG_CACHE_HOME', '~/.cache'), 'chroma_wave', 'font-index.json'))
+    rescue ArgumentError
+      nil # no home directory to expand
+    end
+
     private
 
-    # Sums glyph advance widths for a single line of text.
+    # Measures text without consulting the layout cache.
     #
-    # @param line [String] a single line (no newlines)
-    # @return [Integer] total advance width in pixels
-    def measure_line_width(line)
-      w = 0
-      line.each_codepoint do |cp|
-        w += _ft_glyph_metrics(cp)[:advance_x]
-      end
-      w
+    # @param text [String] the text to measure
+    # @return [TextMetrics]
+    def measure_uncached(text)
+      lines = text.split("\n", -1)
+      widest = lines.map { |line| line_width(line) }.max || 0
+      total_height = line_height * lines.length
+
+      TextMetrics.new(width: widest, height: total_height, ascent: ascent, descent: descent)
     end
 
     # Raises DependencyError when FreeType is not compiled in.
@@ -196,29 +258,25 @@ module ChromaWave
 
     # Searches bundled and system font directories for a matching font.
     #
-    # Results are cached at the class level. Call {.clear_font_cache!}
-    # to pick up newly installed fonts.
-    #
     # Checks the gem's +data/fonts/+ first, then system dirs.
     # Tries exact stem match, then case-insensitive partial match.
     #
     # @param name [String] font name to search for
     # @return [String, nil] absolute path or nil
     def discover_font(name)
-      stem = normalize_name(name)
-      candidates = font_candidates
-
-      # Exact match first, then fuzzy partial match
-      candidates.find { |s, _| s == stem }&.last ||
-        candidates.find { |s, _| s.include?(stem) }&.last
+      font_index.lookup(name)
     end
 
-    # Returns cached font candidates, building the cache on first call.
+    # Returns the cached font index, building it on first call.
+    #
+    # The index is persisted at {.index_path} and revalidated against
+    # directory mtimes when first built in a process. Call
+    # {.clear_font_cache!} to revalidate again.
     #
     # Thread-safe via {FONT_CACHE_MUTEX}.
     #
-    # @return [Array<Array(String, String)>] pairs of [normalized_stem, path]
-    def font_candidates
+    # @return [Index]
+    def font_index
       # Fast path — avoid Mutex overhead when cache is warm.
       # The unsynchronized read is safe on MRI (GIL guarantees atomic
       # reference reads). On JRuby/TruffleRuby, remove this fast path
@@ -229,34 +287,11 @@ module ChromaWave
       FONT_CACHE_MUTEX.synchronize do
         self.class.send(:font_cache) || begin
           search_dirs = [File.join(DATA_DIR, 'fonts')] + FONT_DIRS.map { |d| File.expand_path(d) }
-          result = collect_font_candidates(search_dirs)
+          result = Index.build(roots: search_dirs, path: self.class.index_path)
           self.class.send(:font_cache=, result)
           result
         end
       end
     end
-
-    # Collects font paths and their normalized stems from search directories.
-    #
-    # @param dirs [Array<String>] directories to search
-    # @return [Array<Array(String, String)>] pairs of [normalized_stem, path]
-    def collect_font_candidates(dirs)
-      dirs.each_with_object([]) do |dir, result|
-        next unless File.directory?(dir)
-
-        Dir.glob(File.join(dir, TTF_GLOB)).each do |font_path|
-          stem = normalize_name(File.basename(font_path, File.extname(font_path)))
-          result << [stem, font_path].freeze
-        end
-      end.freeze
-    end
-
-    # Normalizes a font name for comparison: lowercase, strip non-alphanumeric.
-    #
-    # @param name [String]
-    # @return [String]
-    def normalize_name(name)
-      name.downcase.gsub(/[^a-z0-9]/, '')
-    end
   end
 end
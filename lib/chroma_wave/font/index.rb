@@ -0,0 +1,182 @@
+# frozen_string_literal: true
+
+require 'json'
+require 'fileutils'
+
+module ChromaWave
+  class Font
+    # Name-to-path lookup table over one or more font directory trees,
+    # persisted to disk between processes.
+    #
+    # The on-disk index stores one record per directory: the directory's
+    # mtime, the names of its TrueType files, and its subdirectories. Adding, removing, or renaming an entry changes the
+    # mtime of the directory that holds it, so on load only directories
+    # whose mtime differs are re-read; unchanged trees cost one +stat+
+    # per directory instead of a full recursive glob.
+    #
+    # Instances are immutable snapshots. Exact lookups are a hash hit;
+    # partial-name matches fall back to a scan of the stems.
+    #
+    # @example
+    #   index = Font::Index.build(roots: ['/usr/share/fonts'], path: '/tmp/fonts.json')
+    #   index.lookup('DejaVu Sans') # => "/usr/share/fonts/TTF/DejaVuSans.ttf"
+    class Index
+      # On-disk format version; files with another version are ignored.
+      VERSION = 2
+
+      # Flags under which {Font::TTF_GLOB} matches a bare file name as
+      # +Dir.glob+ would (leading +**/+ matching no directories).
+      TTF_MATCH_FLAGS = File::FNM_PATHNAME | File::FNM_EXTGLOB
+
+      # @return [Array<Array(String, String)>] frozen [normalized_stem, path]
+      #   pairs in search order
+      attr_reader :candidates
+
+      # @return [Array<String>] directories re-read while building this index
+      attr_reader :rescanned
+
+      # Normalizes a font name for comparison: lowercase, strip non-alphanumeric.
+      #
+      # @param name [String]
+      # @return [String]
+      def self.normalize(name)
+        name.downcase.gsub(/[^a-z0-9]/, '')
+      end
+
+      # Builds an index over +roots+, reusing unchanged directory records
+      # from the file at +path+ and writing the result back if anything
+      # changed.
+      #
+      # Persistence is best-effort: an unreadable or corrupt index file
+      # triggers a full scan, and a failed write (e.g. read-only home) is
+      # ignored.
+      #
+      # @param roots [Array<String>] absolute directories to index, in
+      #   search order
+      # @param path [String, nil] index file, or nil to skip persistence
+      # @return [Index] frozen index
+      def self.build(roots:, path: nil)
+        previous = path ? read(path) : {}
+        dirs = {}
+        rescanned = []
+        roots.each { |root| walk(root, previous, dirs, rescanned) }
+        write(path, dirs) if path && dirs != previous
+
+        new(dirs, rescanned)
+      end
+
+      # @param dirs [Hash{String => Hash}] directory records keyed by path
+      # @param rescanned [Array<String>] directories re-read during the build
+      def initialize(dirs, rescanned)
+        @candidates = dirs.flat_map do |dir, record|
+          record['fonts'].map do |name|
+            [self.class.normalize(File.basename(name, File.extname(name))), File.join(dir, name)].freeze
+          end
+        end.freeze
+        @by_stem = @candidates.each_with_object({}) { |(stem, path), h| h[stem] ||= path }.freeze
+        @rescanned = rescanned.freeze
+        freeze
+      end
+
+      # Finds the font file for a name.
+      #
+      # Tries an exact normalized-stem match first, then the first stem
+      # containing the name.
+      #
+      # @param name [String] font name (e.g. +'DejaVu Sans'+)
+      # @return [String, nil] absolute path or nil
+      def lookup(name)
+        stem = self.class.normalize(name)
+        @by_stem[stem] || @candidates.find { |s, _| s.include?(stem) }&.last
+      end
+
+      # @return [Integer] number of indexed font files
+      def size
+        candidates.size
+      end
+
+      # @return [String] human-readable representation
+      def inspect
+        "#<#{self.class} #{size} fonts>"
+      end
+
+      class << self
+        private
+
+        # Records +dir+ and its subtree into +dirs+, re-reading only
+        # directories whose mtime differs from +previous+.
+        #
+        # Like +Dir.glob('**/')+, hidden entries and symlinked
+        # directories are not followed.
+        #
+        # @return [void]
+        def walk(dir, previous, dirs, rescanned)
+          stat = File.stat(dir)
+          return unless stat.directory?
+
+          mtime = stat_mtime(stat)
+          record = previous[dir]
+          unless record && record['mtime'] == mtime
+            record = scan(dir, mtime)
+            rescanned << dir
+          end
+
+          dirs[dir] = record
+          record['subdirs'].each { |name| walk(File.join(dir, name), previous, dirs, rescanned) }
+        rescue SystemCallError
+          nil
+        end
+
+        # Reads one directory's entries.
+        #
+        # @return [Hash] directory record
+        def scan(dir, mtime)
+          fonts = []
+          subdirs = []
+
+          Dir.children(dir).sort.each do |name|
+            next if name.start_with?('.')
+
+            full = File.join(dir, name)
+            if File.lstat(full).directory?
+              subdirs << name
+            elsif File.fnmatch?(TTF_GLOB, name, TTF_MATCH_FLAGS)
+              fonts << name
+            end
+          rescue SystemCallError
+            next
+          end
+
+          { 'mtime' => mtime, 'fonts' => fonts, 'subdirs' => subdirs }
+        end
+
+        # @return [Integer] mtime in nanoseconds
+        def stat_mtime(stat)
+          (stat.mtime.to_i * 1_000_000_000) + stat.mtime.nsec
+        end
+
+        # Loads directory records from an index file.
+        #
+        # @return [Hash{String => Hash}] empty if missing, corrupt, or stale
+        def read(path)
+          data = JSON.parse(File.read(path))
+          data.is_a?(Hash) && data['version'] == VERSION && data['dirs'].is_a?(Hash) ? data['dirs'] : {}
+        rescue SystemCallError, JSON::ParserError
+          {}
+        end
+
+        # Atomically replaces the index file.
+        #
+        # @return [void]
+        def write(path, dirs)
+          FileUtils.mkdir_p(File.dirname(path))
+          tmp = "#{path}.#{Process.pid}.tmp"
+          File.write(tmp, JSON.generate('version' => VERSION, 'dirs' => dirs))
+          File.rename(tmp, path)
+        rescue SystemCallError
+          File.delete(tmp) if tmp && File.exist?(tmp)
+        end
+      end
+    end
+  end
+end
@@ -0,0 +1,164 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  # An ordered fallback chain of fonts that renders each character with
+  # the first font whose cmap covers it.
+  #
+  # Coverage is read once per face as a bitset ({Font#coverage}), so
+  # resolving a codepoint is a byte lookup per face rather than an
+  # +FT_Get_Char_Index+ call. Characters no face covers render with the
+  # first font's .notdef glyph.
+  #
+  # Responds to the same text API as {Font} (+measure+, +each_glyph+,
+  # +line_height+, +ascent+, +descent+), so it can be passed as +font:+
+  # to +draw_text+. Line metrics are the maximum over all faces; glyphs
+  # from faces with a smaller ascent are shifted down to share one
+  # baseline.
+  #
+  # @example Latin text with icons and CJK
+  #   stack = FontStack.new(Font.new('DejaVu Sans', size: 16),
+  #                         IconFont.lucide(size: 16),
+  #                         Font.new('Noto Sans CJK', size: 16))
+  #   canvas.draw_text("\u{E0F2} 東京 18°C", x: 0, y: 0, font: stack, color: Color::BLACK)
+  class FontStack
+    attr_reader :fonts
+
+    # @param fonts [Array<Font, BitmapFont>] faces in priority order
+    # @raise [ArgumentError] if no fonts are given or a font lacks +coverage+
+    def initialize(*fonts)
+      fonts = fonts.flatten
+      raise ArgumentError, 'FontStack needs at least one font' if fonts.empty?
+
+      fonts.each do |font|
+        raise ArgumentError, "#{font.inspect} does not report glyph coverage" unless font.respond_to?(:coverage)
+      end
+
+      @fonts = fonts.freeze
+      @coverages = fonts.map(&:coverage).freeze
+      @line_height = fonts.map(&:line_height).max
+      @ascent = fonts.map(&:ascent).max
+      @descent = fonts.map(&:descent).max
+    end
+
+    # @return [Integer] tallest line height among the faces
+    attr_reader :line_height
+
+    # @return [Integer] largest ascent among the faces
+    attr_reader :ascent
+
+    # @return [Integer] largest descent among the faces
+    attr_reader :descent
+
+    # Returns the font that renders +codepoint+: the first whose
+    # coverage includes it, or the first font when none does.
+    #
+    # @param codepoint [Integer]
+    # @return [Font, BitmapFont]
+    def font_for(codepoint)
+      byte_index = codepoint >> 3
+      mask = 1 << (codepoint & 7)
+      @coverages.each_with_index do |bits, i|
+        byte = bits.getbyte(byte_index)
+        return fonts[i] if byte && byte.anybits?(mask)
+      end
+      fonts.first
+    end
+
+    # Returns true if any face covers +codepoint+.
+    #
+    # @param codepoint [Integer]
+    # @return [Boolean]
+    def include_codepoint?(codepoint)
+      fonts.any? { |font| font.include_codepoint?(codepoint) }
+    end
+
+    # Measures the pixel dimensions of rendered text.
+    #
+    # Same semantics as {Font#measure}, summing each face's run widths.
+    # Results are memoized in {TextLayout.cache}.
+    #
+    # @param text [String] the text to measure
+    # @return [TextMetrics] width, height, ascent, and descent
+    def measure(text)
+      TextLayout.cache.fetch([:measure, cache_key, -text]) do
+        lines = text.split("\n", -1)
+        widest = lines.map { |line| line_width(line) }.max || 0
+
+        TextMetrics.new(width: widest, height: line_height * lines.length, ascent: ascent, descent: descent)
+      end
+    end
+
+    # Sums run widths for a single line of text.
+    #
+    # Same semantics as {Font#line_width}; each run is measured by its
+    # face's own {Font#line_width}.
+    #
+    # @param line [String] a single line (no newlines)
+    # @return [Integer] total advance width in pixels
+    def line_width(line)
+      width = 0
+      each_run(line) { |font, run| width += font.line_width(run) }
+      width
+    end
+
+    # Iterates over each glyph in the text, yielding positioned glyph data.
+    #
+    # Consecutive characters resolved to the same face are handed to
+    # that face as one run, so per-face behavior (e.g. {BitmapFont}
+    # kerning) applies within the run. The next run starts where the
+    # face's pen stopped.
+    #
+    # @param text [String] the text to iterate
+    # @yield [Hash] glyph data in the shape yielded by {Font#each_glyph}
+    # @return [Integer, Enumerator] pen advance after the last glyph, or
+    #   an Enumerator if no block given
+    def each_glyph(text)
+      return enum_for(:each_glyph, text) unless block_given?
+
+      pen_x = 0
+      each_run(text) do |font, run|
+        origin = pen_x
+        shift = ascent - font.ascent
+        pen_x += font.each_glyph(run) do |glyph|
+          yield glyph.merge(x: glyph[:x] + origin, y: glyph[:y] + shift)
+        end
+      end
+      pen_x
+    end
+
+    # Identity of this chain for shared caches ({TextLayout}).
+    #
+    # @return [Array]
+    def cache_key
+      [self.class, *fonts.map { |font| TextLayout.font_key(font) }]
+    end
+
+    # @return [String] human-readable representation
+    def inspect
+      "#<#{self.class} #{fonts.map(&:inspect).join(', ')}>"
+    end
+
+    private
+
+    # Splits a line into maximal runs of characters sharing a face.
+    #
+    # @param line [String] text without newlines
+    # @yieldparam font [Font, BitmapFont] face for the run
+    # @yieldparam run [String] the run's characters
+    # @return [void]
+    def each_run(line)
+      run = +''
+      current = nil
+      line.each_char do |char|
+        font = font_for(char.ord)
+        unless font.equal?(current) || run.empty?
+          yield current, run
+          run = +''
+        end
+        current = font
+        run << char
+      end
+      yield current, run unless run.empty?
+    end
+  end
+end
@@ -2,6 +2,80 @@
 
 module ChromaWave
   class Framebuffer
+    # Raster operations accepted by {#fill_rect} and {#copy_rect}.
+    ROPS = %i[copy and or xor not].freeze
+
+    # Clockwise rotations accepted by {#rotate}, in degrees.
+    ROTATIONS = [0, 90, 180, 270].freeze
+
+    # Default tile size of {#tile_digests} and {#changed_region}, in pixels.
+    TILE_WIDTH = 64
+    TILE_HEIGHT = 16
+
+    # Opens a framebuffer whose pixels live in a shared file mapping, for
+    # handing frames between processes with no copying or encoding.
+    #
+    # The file (e.g. under +/dev/shm+) holds a small header with the
+    # shape and a frame sequence number, followed by the packed pixels.
+    # Every process mapping it sees the same pixels: the producer draws
+    # into its framebuffer inside {#publish}, and the consumer waits with
+    # {#wait_for_frame} and passes its own straight to {Display#show}.
+    #
+    # Creating needs the shape; attaching to an existing file reads it
+    # from the header. The file must not be truncated while mapped. A
+    # +dup+ of a mapped framebuffer is an ordinary private copy.
+    #
+    # @example Producer (e.g. a background job)
+    #   fb = Framebuffer.map('/dev/shm/panel', width: 800, height: 480, format: :mono)
+    #   fb.publish { renderer.render(canvas, into: fb) }
+    #
+    # @example Consumer (the process driving the panel)
+    #   fb = Framebuffer.map('/dev/shm/panel')
+    #   seq = fb.frame_sequence
+    #   loop { seq = fb.wait_for_frame(after: seq) and display.show(fb) }
+    #
+    # @param path [String, Pathname] file to create or attach to
+    # @param width [Integer, nil] frame width (with height and format)
+    # @param height [Integer, nil] frame height
+    # @param format [PixelFormat, Symbol, nil] frame pixel format
+    # @return [Framebuffer] a mapped framebuffer
+    # @raise [ArgumentError] if only part of the shape is given, or the
+    #   file is not a frame file (or is empty and no shape is given)
+    # @raise [FormatMismatchError] if the file holds frames of another shape
+    # @raise [DependencyError] if the platform has no mmap
+    # @raise [SystemCallError] if the file cannot be opened or mapped
+    def self.map(path, width: nil, height: nil, format: nil)
+      raise DependencyError, 'mapped framebuffers need mmap support' unless private_method_defined?(:_map)
+
+      shape = [width, height, format]
+      unless shape.all?(&:nil?) || shape.none?(&:nil?)
+        raise ArgumentError, 'width:, height: and format: go together'
+      end
+
+      allocate.tap { |fb| fb.send(:map_file, path.to_s, width, height, format) }
+    end
+
+    # Restores a framebuffer from a snapshot written by {#dump}.
+    #
+    # Decoding is native and costs about as much as copying the frame,
+    # so a service can put the last frame back on the panel at boot
+    # without re-rendering it.
+    #
+    # @example Resend the last frame at boot
+    #   display.show(Framebuffer.load(File.binread('/var/lib/panel/last.cwsnap')))
+    #
+    # @param source [String, #read] snapshot bytes, or an IO to read them from
+    # @return [Framebuffer] a new framebuffer of the snapshot's shape
+    # @raise [ArgumentError] if the data is not a snapshot, or is
+    #   truncated or damaged
+    # @raise [TypeError] if +source+ is neither a String nor readable
+    def self.load(source)
+      data = source.respond_to?(:read) ? source.read : source
+      raise TypeError, "expected a String or IO, got #{source.class}" unless data.is_a?(String)
+
+      allocate.tap { |fb| fb.send(:load_snapshot, data) }
+    end
+
     # Translates between the Ruby PixelFormat/Palette symbol domain and the
     # C extension's integer domain.
     #
@@ -13,10 +87,13 @@ module ChromaWave
       # @param width [Integer] framebuffer width in pixels
       # @param height [Integer] framebuffer height in pixels
       # @param format [PixelFormat, Symbol] pixel format descriptor or name
+      # @param clear [Boolean] false skips filling the buffer with the
+      #   format's default color, leaving the pixels undefined; for
+      #   buffers every pixel of which is about to be written
       # @raise [ArgumentError] for unknown format symbols
-      def initialize(width, height, format)
+      def initialize(width, height, format, clear: true)
         @pixel_format_obj = resolve_pixel_format(format)
-        super(width, height, @pixel_format_obj.name)
+        super(width, height, @pixel_format_obj.name, clear)
       end
 
       # Returns the PixelFormat object for this framebuffer.
@@ -56,6 +133,265 @@ module ChromaWave
         super(resolve_color(color))
       end
 
+      # Fills a rectangle natively, combining +color+ with the existing
+      # pixels by a raster operation.
+      #
+      # ROPs act on raw palette indices: +:copy+ overwrites, +:and+, +:or+
+      # and +:xor+ combine bitwise, and +:not+ writes the inverted color
+      # (on MONO, +fill_rect(..., :white, rop: :xor)+ inverts the area).
+      # Bitwise ROPs could produce indices outside a palette that does not
+      # use every bit pattern, so they need MONO or GRAY4.
+      #
+      # @param x [Integer] top-left x
+      # @param y [Integer] top-left y
+      # @param width [Integer] rectangle width (clipped to the framebuffer)
+      # @param height [Integer] rectangle height (clipped to the framebuffer)
+      # @param color [Symbol, Integer] palette color name or raw integer
+      # @param rop [Symbol] one of {Framebuffer::ROPS}
+      # @return [self]
+      # @raise [ArgumentError] for an unknown ROP, or a bitwise ROP on a
+      #   format that does not support it
+      def fill_rect(x, y, width, height, color, rop: :copy)
+        _fill_rect(x, y, width, height, resolve_color(color), validate_rop(rop))
+      end
+
+      # Copies a rectangle of +source+ to (x, y) natively, at any pixel
+      # offset, combining it with the existing pixels by a raster
+      # operation (see {#fill_rect}).
+      #
+      # Both sides are clipped; copying a framebuffer onto itself works
+      # even when the rectangles overlap.
+      #
+      # @param source [Framebuffer] framebuffer of the same pixel format
+      # @param x [Integer] destination x
+      # @param y [Integer] destination y
+      # @param rect [Array(Integer, Integer, Integer, Integer), nil]
+      #   source +[x, y, width, height]+; nil for the whole source
+      # @param rop [Symbol] one of {Framebuffer::ROPS}
+      # @return [self]
+      # @raise [ArgumentError] if the pixel formats differ, for an unknown
+      #   ROP, or a bitwise ROP on a format that does not support it
+      def copy_rect(source, x:, y:, rect: nil, rop: :copy)
+        raise TypeError, "expected a Framebuffer, got #{source.class}" unless source.is_a?(Framebuffer)
+        unless source.pixel_format == pixel_format
+          raise ArgumentError, "source format #{source.pixel_format.name} does not match #{pixel_format.name}"
+        end
+
+        src_x, src_y, src_w, src_h = rect || [0, 0, source.width, source.height]
+        _copy_rect(source, src_x, src_y, src_w, src_h, x, y, validate_rop(rop))
+      end
+
+      # Returns this framebuffer rotated clockwise by +degrees+, natively.
+      #
+      # A 90 or 270 degree rotation swaps width and height.
+      #
+      # @param degrees [Integer] one of {Framebuffer::ROTATIONS}
+      # @param into [Framebuffer, nil] target of the rotated size and same
+      #   format to reuse (may be +self+ when square or for 0/180); nil
+      #   allocates one
+      # @return [Framebuffer] the rotated framebuffer (+into+ if given)
+      # @raise [ArgumentError] for an unsupported angle or a mismatched target
+      def rotate(degrees, into: nil)
+        unless ROTATIONS.include?(degrees)
+          raise ArgumentError, "rotation must be one of #{ROTATIONS.join(', ')}, got #{degrees.inspect}"
+        end
+
+        quarter = degrees == 90 || degrees == 270
+        into ||= self.class.new(quarter ? height : width, quarter ? width : height, pixel_format, clear: false)
+        _rotate(into, degrees)
+      end
+
+      # Returns this framebuffer mirrored natively: +:h+ swaps left and
+      # right, +:v+ swaps top and bottom.
+      #
+      # @param axis [Symbol] +:h+ or +:v+
+      # @param into [Framebuffer, nil] same-sized target to reuse (may be
+      #   +self+ to flip in place); nil allocates one
+      # @return [Framebuffer] the mirrored framebuffer (+into+ if given)
+      # @raise [ArgumentError] for an unknown axis or a mismatched target
+      def flip(axis, into: nil)
+        _flip(into || self.class.new(width, height, pixel_format, clear: false), axis)
+      end
+
+      # Returns this framebuffer converted natively to another pixel
+      # format, each palette color replaced by one of the target's.
+      #
+      # Colors left out of +mapping+ become the nearest target color, so
+      # colors both palettes share are kept (MONO to GRAY4 keeps black
+      # and white).
+      #
+      # @example Black plane of a tri-color frame
+      #   black = fb.convert(:mono, mapping: { yellow: :white, red: :white })
+      #
+      # @param format [PixelFormat, Symbol] target pixel format
+      # @param mapping [Hash{Symbol => Symbol}] source color to target color
+      # @param into [Framebuffer, nil] same-sized target of that format to
+      #   reuse; nil allocates one
+      # @return [Framebuffer] the converted framebuffer (+into+ if given)
+      # @raise [KeyError] if +mapping+ names a color missing from its palette
+      # @raise [ArgumentError] for a mismatched target
+      def convert(format, mapping: {}, into: nil)
+        target = resolve_pixel_format(format)
+        _convert(conversion_target(into, target), conversion_table(target, mapping))
+      end
+
+      # Returns the frame as packed RGB bytes (3 per pixel, row-major),
+      # e.g. for a PNG or a web preview. Expanded natively.
+      #
+      # @param palette_rgb [Hash{Symbol => Color}, nil] colors to show
+      #   palette entries as (e.g. a panel's actual paper and ink
+      #   shades); entries left out use their named {Color}
+      # @return [String] binary string of +width * height * 3+ bytes
+      # @raise [KeyError] if +palette_rgb+ names a color missing from the palette
+      def to_rgb_bytes(palette_rgb: nil)
+        _expand(expansion_table(palette_rgb, 3))
+      end
+
+      # Returns the frame as an RGBA {Canvas}, for editing an already
+      # rendered frame or compositing it into a preview.
+      #
+      # @param palette_rgb [Hash{Symbol => Color}, nil] see {#to_rgb_bytes}
+      # @return [Canvas] a canvas of the same size
+      # @raise [KeyError] if +palette_rgb+ names a color missing from the palette
+      def to_canvas(palette_rgb: nil)
+        Canvas.from_rgba_bytes(_expand(expansion_table(palette_rgb, 4)), width: width, height: height)
+      end
+
+      # Splits the frame into one MONO framebuffer per bit of the pixel
+      # indices, most significant bit first, white where the bit is set.
+      #
+      # A GRAY4 frame gives the two bit planes a 4-gray waveform is sent as.
+      #
+      # @param into [Array<Framebuffer>, nil] MONO targets of this size to
+      #   reuse, one per bit; nil allocates them
+      # @return [Array<Framebuffer>] the planes (+into+ if given)
+      # @raise [ArgumentError] for the wrong number of targets or a
+      #   mismatched one
+      def split_planes(into: nil)
+        bits = pixel_format.bits_per_pixel
+        into ||= Array.new(bits)
+        raise ArgumentError, "expected #{bits} plane framebuffers, got #{into.size}" unless into.size == bits
+
+        into.each_with_index.map do |plane, k|
+          table = Array.new(16) { |index| (index >> (bits - 1 - k)) & 1 }
+          _convert(conversion_target(plane, PixelFormat::MONO), table.pack('C*'))
+        end
+      end
+
+      # Digests of the frame cut into tiles, row by row.
+      #
+      # Comparing them with the digests of an earlier frame locates what
+      # changed without keeping that frame around (see {#changed_region}).
+      # The result is cached until the next write to the framebuffer,
+      # except for mapped framebuffers, which other processes may write.
+      # {#digest} is the matching hash of the whole frame.
+      #
+      # @param tile_width [Integer] tile width in pixels: a multiple of 8,
+      #   or at least {#width} for one tile per row band
+      # @param tile_height [Integer] tile height in pixels
+      # @return [Array<Array<Integer>>] frozen rows of tile digests; the
+      #   last row and column are cut short by the frame edges
+      # @raise [ArgumentError] for a non-positive size, or a tile width
+      #   narrower than the frame that is not a multiple of 8
+      def tile_digests(tile_width: TILE_WIDTH, tile_height: TILE_HEIGHT)
+        return _tile_digests(tile_width, tile_height) if mapped?
+
+        key = [_generation, tile_width, tile_height]
+        return @tile_digests.last if @tile_digests&.first == key
+
+        @tile_digests = [key, _tile_digests(tile_width, tile_height)]
+        @tile_digests.last
+      end
+
+      # Bounding box of the tiles that differ from an earlier frame, as
+      # keyword arguments for {Capabilities::RegionalRefresh#display_region}.
+      #
+      # @example Refresh only what changed since the last frame
+      #   tiles = framebuffer.tile_digests
+      #   # ... draw ...
+      #   region = framebuffer.changed_region(tiles)
+      #   display.display_region(framebuffer, **region) if region
+      #
+      # @param previous [Framebuffer, Array<Array<Integer>>] the earlier
+      #   frame, or its {#tile_digests} for the same tile size
+      # @param tile_width [Integer] tile width in pixels (see {#tile_digests})
+      # @param tile_height [Integer] tile height in pixels
+      # @return [Hash{Symbol => Integer}, nil] +x:+, +y:+, +width:+ and
+      #   +height:+ of the changed area, or nil if nothing changed
+      # @raise [ArgumentError] if +previous+ has another shape
+      # @raise [TypeError] if +previous+ is neither a Framebuffer nor an Array
+      def changed_region(previous, tile_width: TILE_WIDTH, tile_height: TILE_HEIGHT)
+        after = tile_digests(tile_width: tile_width, tile_height: tile_height)
+        before = previous_tile_digests(previous, tile_width, tile_height)
+        unless before.size == after.size && before.first&.size == after.first.size
+          raise ArgumentError, 'previous tile digests do not match this framebuffer'
+        end
+
+        rows = after.each_index.reject { |r| before[r] == after[r] }
+        return if rows.empty?
+
+        cols = after.first.each_index.select { |c| rows.any? { |r| before[r][c] != after[r][c] } }
+        tile_region(rows, cols, [tile_width, width].min, [tile_height, height].min)
+      end
+
+      # Serializes the frame into a compact snapshot for {Framebuffer.load}.
+      #
+      # Each row is run-length coded (PackBits) over the packed bytes, so
+      # flat areas shrink in every pixel format, and a digest of the
+      # frame lets {Framebuffer.load} refuse damaged files.
+      #
+      # @param io [#write, nil] IO to write the snapshot to
+      # @return [String, #write] the binary snapshot, or +io+ if given
+      def dump(io = nil)
+        data = _dump
+        return data unless io
+
+        io.write(data)
+        io
+      end
+
+      # Writes a frame of a {Framebuffer.map mapped} framebuffer.
+      #
+      # Marks the frame as being written, yields, then advances the
+      # frame sequence and wakes processes in {#wait_for_frame}. Without
+      # a block, just announces pixels already written.
+      #
+      # @yieldparam framebuffer [self] the framebuffer to draw into
+      # @return [Integer] the new frame sequence number
+      # @raise [ChromaWave::Error] if the framebuffer is not mapped
+      def publish
+        _frame_begin
+        begin
+          yield self if block_given?
+        ensure
+          sequence = _frame_end
+        end
+        sequence
+      end
+
+      # Current frame sequence number of a mapped framebuffer.
+      #
+      # It is odd while the producer is inside {#publish}. Reading it again
+      # after using the pixels tells whether a new frame started meanwhile.
+      #
+      # @return [Integer]
+      # @raise [ChromaWave::Error] if the framebuffer is not mapped
+      def frame_sequence
+        _frame_sequence
+      end
+
+      # Blocks until a frame newer than +after+ is published to a mapped
+      # framebuffer. Other threads keep running while waiting.
+      #
+      # @param after [Integer] the last sequence number seen
+      # @param timeout [Numeric, nil] seconds to wait at most; nil waits
+      #   indefinitely
+      # @return [Integer, nil] the new sequence number, nil on timeout
+      # @raise [ChromaWave::Error] if the framebuffer is not mapped
+      def wait_for_frame(after: frame_sequence, timeout: nil)
+        _frame_wait(after, timeout)
+      end
+
       # Deep-copies the framebuffer, preserving the PixelFormat object.
       #
       # @param other [Framebuffer] the source framebuffer
@@ -63,6 +399,7 @@ module ChromaWave
       def initialize_copy(other)
         super
         @pixel_format_obj = other.pixel_format
+        @tile_digests = nil
         self
       end
 
@@ -80,6 +417,104 @@ module ChromaWave
         end
       end
 
+      # Checks a {#convert} target, or allocates one. Its size is checked
+      # natively.
+      #
+      # @return [Framebuffer]
+      def conversion_target(into, format)
+        return self.class.new(width, height, format, clear: false) if into.nil?
+        return into unless into.is_a?(Framebuffer) && into.pixel_format != format
+
+        raise ArgumentError, "target must be a #{format.name} framebuffer, got #{into.pixel_format.name}"
+      end
+
+      # Table of color bytes by palette index for {#to_rgb_bytes} and
+      # {#to_canvas}; indices past the palette expand to zero bytes.
+      #
+      # @return [String] 16 entries of +channels+ bytes
+      def expansion_table(palette_rgb, channels)
+        palette = pixel_format.palette
+        overrides = palette_rgb || {}
+        overrides.each_key { |name| palette.index_of(name) }
+        palette.map { |name| overrides.fetch(name) { Color.from_name(name) }.to_rgba_bytes[0, channels] }
+               .join.b.ljust(16 * channels, "\0")
+      end
+
+      # Table of target palette indices by source palette index for
+      # {#convert}, as the native kernel takes it.
+      #
+      # @return [String] 16 bytes
+      def conversion_table(target, mapping)
+        source = pixel_format.palette
+        mapping.each_key { |name| source.index_of(name) }
+        table = source.map do |name|
+          target.palette.index_of(mapping.fetch(name) { target.palette.nearest_color(Color.from_name(name)) })
+        end
+        table.fill(0, table.size...16).pack('C*')
+      end
+
+      # Tile digests of an earlier frame passed to {#changed_region}.
+      #
+      # @return [Array<Array<Integer>>]
+      def previous_tile_digests(previous, tile_width, tile_height)
+        case previous
+        when Array then previous
+        when Framebuffer
+          unless previous.width == width && previous.height == height && previous.pixel_format == pixel_format
+            raise ArgumentError, 'previous framebuffer must have the same size and format'
+          end
+
+          previous.tile_digests(tile_width: tile_width, tile_height: tile_height)
+        else raise TypeError, "expected a Framebuffer or tile digests, got #{previous.class}"
+        end
+      end
+
+      # Pixel rectangle covering the given tile rows and columns, clipped
+      # to the frame.
+      #
+      # @return [Hash{Symbol => Integer}]
+      def tile_region(rows, cols, tile_width, tile_height)
+        x = cols.first * tile_width
+        y = rows.first * tile_height
+        { x: x, y: y,
+          width: [(cols.last + 1) * tile_width, width].min - x,
+          height: [(rows.last + 1) * tile_height, height].min - y }
+      end
+
+      # Maps the frame file (see {Framebuffer.map}) and adopts its format.
+      #
+      # @return [void]
+      def map_file(path, width, height, format)
+        name = _map(path, width, height, format && resolve_pixel_format(format).name)
+        @pixel_format_obj = PixelFormat.from_name(name)
+      end
+
+      # Decodes a snapshot (see {Framebuffer.load}) and adopts its format.
+      #
+      # @return [void]
+      def load_snapshot(data)
+        @pixel_format_obj = PixelFormat.from_name(_load(data))
+      end
+
+      # Hands a shape to the native span rasterizer with the color
+      # resolved once (see {Drawing::Primitives}).
+      #
+      # @param shape [Symbol] shape name
+      # @param color [Symbol, Integer] palette color name or raw integer
+      # @param args [Array] shape arguments
+      # @return [Boolean] true if the C path drew the shape
+      def native_raster(shape, color, *args)
+        native_raster_window(nil, shape, color, *args)
+      end
+
+      # Rasterizes a shape through a {Layer}'s translate-and-clip window
+      # (see {Canvas#native_raster_window}).
+      #
+      # @return [Boolean] true if the C path drew the shape
+      def native_raster_window(window, shape, color, *args)
+        _raster(window, shape, resolve_color(color), *args)
+      end
+
       # Resolves a color argument into an integer for the C layer.
       #
       # Integers are range-checked against the palette size so that
@@ -97,6 +532,20 @@ module ChromaWave
         end
       end
 
+      # Checks a ROP name, and that bitwise ROPs keep indices in the palette.
+      #
+      # @param rop [Symbol] the raster operation
+      # @return [Symbol] the ROP, if valid
+      # @raise [ArgumentError] if it is unknown or unsupported by the format
+      def validate_rop(rop)
+        unless ROPS.include?(rop)
+          raise ArgumentError, "unknown rop: #{rop.inspect} (expected one of #{ROPS.join(', ')})"
+        end
+        return rop if rop == :copy || pixel_format.palette.size == 1 << pixel_format.bits_per_pixel
+
+        raise ArgumentError, "rop #{rop.inspect} is not supported on #{pixel_format.name} (only :copy)"
+      end
+
       # Validates that an integer color index is within palette bounds.
       #
       # @param index [Integer] the color index to validate
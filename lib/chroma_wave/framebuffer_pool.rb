@@ -0,0 +1,93 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  # Recycles framebuffers of a few fixed shapes so that steady-state
+  # rendering allocates none.
+  #
+  # {#rent} hands out an idle framebuffer of the requested size and
+  # format, or allocates one (without clearing it) when none is idle;
+  # {#release} puts framebuffers back once their contents are no longer
+  # needed. A framebuffer is never handed out twice before it has been
+  # released, so frames rendered concurrently by several threads, or
+  # still being sent while the next one renders, get buffers of their
+  # own. Framebuffers that are never released are simply garbage
+  # collected.
+  #
+  # {Display} keeps one pool for its {Renderer} and rotations.
+  #
+  # @example
+  #   pool = FramebufferPool.new
+  #   fb = pool.rent(800, 480, :mono)
+  #   renderer.render(canvas, into: fb)
+  #   device.send(:_epd_display, fb)
+  #   pool.release(fb)
+  class FramebufferPool
+    # Idle framebuffers kept per shape by default.
+    DEFAULT_CAPACITY = 4
+
+    attr_reader :capacity
+
+    # @param capacity [Integer] idle framebuffers kept per shape; extra
+    #   releases are dropped
+    # @raise [ArgumentError] if capacity is not a positive Integer
+    def initialize(capacity: DEFAULT_CAPACITY)
+      unless capacity.is_a?(Integer) && capacity.positive?
+        raise ArgumentError, "capacity must be a positive Integer, got #{capacity.inspect}"
+      end
+
+      @capacity = capacity
+      @shelves = Hash.new { |hash, key| hash[key] = [] }
+      @mutex = Mutex.new
+    end
+
+    # Takes an idle framebuffer of the given shape, or allocates one.
+    #
+    # The pixels are undefined: the caller is expected to write all of
+    # them (as rendering and rotation do).
+    #
+    # @param width [Integer] width in pixels
+    # @param height [Integer] height in pixels
+    # @param pixel_format [PixelFormat, Symbol] pixel format descriptor or name
+    # @return [Framebuffer]
+    def rent(width, height, pixel_format)
+      format = pixel_format.is_a?(PixelFormat) ? pixel_format : PixelFormat.from_name(pixel_format)
+      idle = @mutex.synchronize { @shelves[[width, height, format.name]].pop }
+      idle || Framebuffer.new(width, height, format, clear: false)
+    end
+
+    # Returns framebuffers to the pool for later {#rent} calls.
+    #
+    # The caller must not use them afterwards. Releasing a framebuffer
+    # that is already idle has no effect.
+    #
+    # @param framebuffers [Array<Framebuffer>] framebuffers to recycle
+    # @return [self]
+    # @raise [TypeError] if an argument is not a Framebuffer
+    def release(*framebuffers)
+      framebuffers.each do |fb|
+        raise TypeError, "expected a Framebuffer, got #{fb.class}" unless fb.is_a?(Framebuffer)
+
+        @mutex.synchronize do
+          shelf = @shelves[[fb.width, fb.height, fb.pixel_format.name]]
+          shelf << fb unless shelf.size >= capacity || shelf.any? { |idle| idle.equal?(fb) }
+        end
+      end
+      self
+    end
+
+    # Number of idle framebuffers across all shapes.
+    #
+    # @return [Integer]
+    def size
+      @mutex.synchronize { @shelves.sum { |_, shelf| shelf.size } }
+    end
+
+    # Drops every idle framebuffer.
+    #
+    # @return [self]
+    def clear
+      @mutex.synchronize { @shelves.clear }
+      self
+    end
+  end
+end
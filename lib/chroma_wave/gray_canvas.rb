@@ -0,0 +1,224 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  # Single-channel 8-bit gray pixel buffer for mono and grayscale panels.
+  #
+  # Stores one luma byte per pixel instead of {Canvas}'s four, cutting
+  # memory and the bytes a dither pass reads by 4x. Colors are reduced
+  # to gray on write with {.luma} (alpha is dropped, as there is no
+  # alpha channel) and read back as opaque gray {Color}s.
+  #
+  # GrayCanvas is a {Canvas}: the Surface, drawing, text and vector APIs
+  # are the same, clear/blit/glyph compositing and shape rasterization
+  # have native gray paths, and {Renderer} accepts it anywhere a Canvas
+  # is accepted. {#rgba_bytes} expands to RGBA for consumers that need it.
+  #
+  # @example
+  #   canvas = GrayCanvas.new(width: 1304, height: 984)
+  #   canvas.draw_text('Hello', x: 10, y: 10, font: font, color: Color::BLACK)
+  #   display.show(canvas)
+  class GrayCanvas < Canvas
+    # Bytes per pixel in the gray buffer.
+    BYTES_PER_PIXEL = 1
+
+    # Opaque gray colors indexed by luma, so reads allocate nothing.
+    GRAYS = Array.new(256) { |l| Color.new(r: l, g: l, b: l) }.freeze
+
+    # Reduces a color to its 8-bit luma (BT.601 weights, matching the C paths).
+    #
+    # @param color [Color] the color to reduce
+    # @return [Integer] gray value 0..255
+    def self.luma(color)
+      ((77 * color.r) + (150 * color.g) + (29 * color.b) + 128) >> 8
+    end
+
+    # Creates a new GrayCanvas filled with the given background color.
+    #
+    # @param width [Integer] canvas width in pixels (must be positive)
+    # @param height [Integer] canvas height in pixels (must be positive)
+    # @param background [Color] initial fill color (default: white)
+    # @raise [ArgumentError] if width or height is not a positive integer
+    def initialize(width:, height:, background: Color::WHITE) # rubocop:disable Lint/MissingSuper
+      validate_dimensions!(width, height)
+      @width  = width
+      @height = height
+      @buffer = PixelBuffer.new(width, height, BYTES_PER_PIXEL, [self.class.luma(background)].pack('C'))
+    end
+
+    # Sets the pixel at (x, y) to the luma of +color+.
+    #
+    # Out-of-bounds coordinates are silently ignored.
+    #
+    # @param x [Integer] x coordinate
+    # @param y [Integer] y coordinate
+    # @param color [Color] the color to set
+    # @return [self]
+    def set_pixel(x, y, color)
+      return self unless in_bounds?(x, y)
+
+      buffer.setbyte(pixel_offset(x, y), self.class.luma(color))
+      self
+    end
+
+    # Returns the gray color at (x, y).
+    #
+    # @param x [Integer] x coordinate
+    # @param y [Integer] y coordinate
+    # @return [Color, nil] an opaque gray, or nil if out of bounds
+    def get_pixel(x, y)
+      return nil unless in_bounds?(x, y)
+
+      GRAYS[buffer.getbyte(pixel_offset(x, y))]
+    end
+
+    # Fills the entire canvas with the luma of +color+.
+    #
+    # @param color [Color] the fill color (default: white)
+    # @return [self]
+    def clear(color = Color::WHITE)
+      if respond_to?(:_gray_clear, true)
+        _gray_clear(buffer, self.class.luma(color))
+      else
+        buffer.replace([self.class.luma(color)].pack('C') * (width * height))
+      end
+      self
+    end
+
+    # Copies pixels from +source+ onto this canvas.
+    #
+    # GrayCanvas sources are copied row-wise; other {Canvas} sources are
+    # read as RGBA (see {Canvas#with_rgba_buffer}), reduced to luma and
+    # alpha-composited with the same integer math as {Canvas#blit}. Other
+    # surfaces use the per-pixel Ruby path.
+    #
+    # @param source [Surface] the source surface
+    # @param x [Integer] destination x offset
+    # @param y [Integer] destination y offset
+    # @return [self]
+    def blit(source, x:, y:)
+      source = source.dup if source.equal?(self)
+      if source.is_a?(GrayCanvas) && respond_to?(:_gray_load, true)
+        source.with_gray_buffer do |bytes|
+          _gray_load(buffer, bytes, x, y, source.width, source.height, width, BYTES_PER_PIXEL)
+        end
+      elsif source.is_a?(Canvas) && respond_to?(:_gray_blit_alpha, true)
+        source.with_rgba_buffer do |bytes|
+          _gray_blit_alpha(buffer, bytes, x, y, source.width, source.height, width, height)
+        end
+      else
+        blit_ruby(source, x, y)
+      end
+      self
+    end
+
+    # Bulk-loads raw RGBA bytes into a rectangular region, reduced to
+    # luma (alpha is ignored).
+    #
+    # @param bytes [String] raw RGBA pixel data
+    # @param width [Integer] source width in pixels
+    # @param height [Integer] source height in pixels
+    # @param x [Integer] destination x offset
+    # @param y [Integer] destination y offset
+    # @return [self]
+    def load_rgba_bytes(bytes, width:, height:, x:, y:)
+      if respond_to?(:_gray_load, true)
+        _gray_load(buffer, bytes, x, y, width, height, self.width, Canvas::BYTES_PER_PIXEL)
+      else
+        load_rgba_bytes_ruby(bytes, width, height, x, y)
+      end
+      self
+    end
+
+    # Returns a packed copy of the gray pixels as a frozen binary string.
+    #
+    # @return [String] the pixel data (1 byte per pixel, row-major)
+    def gray_bytes
+      buffer.to_s.freeze
+    end
+
+    # Returns the pixels expanded to opaque RGBA.
+    #
+    # @return [String] the pixel data (4 bytes per pixel, row-major)
+    def rgba_bytes
+      return _gray_to_rgba(buffer).freeze if respond_to?(:_gray_to_rgba, true)
+
+      buffer.to_s.unpack('C*').flat_map { |l| [l, l, l, 255] }.pack('C*').freeze
+    end
+
+    # Yields the pixels expanded to RGBA (a copy; see {#with_gray_buffer}).
+    #
+    # @yieldparam bytes [String] the pixel data (4 bytes per pixel, row-major)
+    # @return [Object] the block's result
+    def with_rgba_buffer
+      yield rgba_bytes
+    end
+
+    # Yields the live gray buffer for zero-copy reads, locked against
+    # writes for the duration of the block (see {Canvas#with_rgba_buffer}).
+    #
+    # @yieldparam bytes [PixelBuffer] the pixels (1 byte per pixel), addressed
+    #   by packed offsets like {#gray_bytes}
+    # @return [Object] the block's result
+    # @raise [RuntimeError] if the canvas is modified inside the block
+    def with_gray_buffer(&)
+      borrow_buffer(&)
+    end
+
+    # Composites a glyph bitmap in the luma of +color+ via the C accelerator.
+    #
+    # @param bitmap [String] grayscale alpha bitmap (1 byte/pixel)
+    # @param x [Integer] destination x in canvas coordinates
+    # @param y [Integer] destination y in canvas coordinates
+    # @param width [Integer] glyph bitmap width
+    # @param height [Integer] glyph bitmap height
+    # @param color [Color] foreground color for the glyph
+    # @return [Boolean] true if C accelerator was used, false otherwise
+    def blit_glyph(bitmap, x:, y:, width:, height:, color:) # rubocop:disable Naming/PredicateMethod
+      return false unless respond_to?(:_gray_blit_glyph, true)
+
+      _gray_blit_glyph(buffer, bitmap, x, y, width, height, self.width, self.height, self.class.luma(color))
+      true
+    end
+
+    private
+
+    # Byte offset for pixel (x, y) in the gray buffer.
+    def pixel_offset(x, y)
+      (y * width) + x
+    end
+
+    # Scanline fill_rect for the Ruby fallback (see {Canvas}).
+    def fill_rect(x, y, w, h, color)
+      return if native_raster(:rect, color, x, y, w, h)
+
+      x0 = [x, 0].max
+      y0 = [y, 0].max
+      x1 = [x + w, width].min
+      y1 = [y + h, height].min
+      return if x0 >= x1 || y0 >= y1
+
+      row = [self.class.luma(color)].pack('C') * (x1 - x0)
+      (y0...y1).each { |row_y| buffer[pixel_offset(x0, row_y), row.bytesize] = row }
+    end
+
+    # Rasterizes a shape in the luma of +color+ (see {Canvas#native_raster_window}).
+    #
+    # @return [Boolean] true if the C path drew the shape
+    def native_raster_window(window, shape, color, *args)
+      return false unless respond_to?(:_gray_raster, true)
+
+      _gray_raster(buffer, width, height, window, shape, self.class.luma(color), *args)
+    end
+
+    # Ruby fallback for bulk RGBA load.
+    def load_rgba_bytes_ruby(bytes, src_w, src_h, ox, oy)
+      src_h.times do |sy|
+        src_w.times do |sx|
+          offset = ((sy * src_w) + sx) * Canvas::BYTES_PER_PIXEL
+          rgb = Color.new(r: bytes.getbyte(offset), g: bytes.getbyte(offset + 1), b: bytes.getbyte(offset + 2))
+          set_pixel(ox + sx, oy + sy, rgb)
+        end
+      end
+    end
+  end
+end
@@ -1,33 +1,45 @@
 # frozen_string_literal: true
 
 require_relative 'icon_font/lucide_glyphs'
+require_relative 'icon_font/atlas'
 
 module ChromaWave
   # Renders named icons from an icon font via codepoint lookup.
   #
   # Extends {Font} with a symbol-to-codepoint registry so icons can be
-  # drawn by name instead of raw codepoint.
+  # drawn by name instead of raw codepoint. Each icon is rasterized once
+  # into an {Atlas} and blitted from there on every later draw.
   #
   # @example
   #   icons = IconFont.lucide(size: 24)
   #   icons.draw(canvas, :house, x: 10, y: 10, color: Color::BLACK)
   #   icons.icon_names  #=> [:a_arrow_down, :a_arrow_up, ...]
+  #
+  # @example Reuse a baked atlas across process restarts
+  #   icons = IconFont.lucide(size: 24, atlas: 'icons-24.cwia')
   class IconFont < Font
-    attr_reader :glyph_map
+    attr_reader :glyph_map, :atlas
 
     # Creates an IconFont from a font file with a glyph name registry.
     #
     # @param path_or_name [String] path or name of the icon font
     # @param size [Integer] pixel size for rendering
     # @param glyph_map [Hash{Symbol => Integer}] name-to-codepoint map
-    def initialize(path_or_name, size:, glyph_map: {})
+    # @param atlas [Atlas, String, nil] pre-rasterized icons (or a path to
+    #   a baked atlas file) to seed the cache with
+    # @raise [ArgumentError] if the atlas was rasterized at a different size
+    def initialize(path_or_name, size:, glyph_map: {}, atlas: nil)
       @glyph_map = glyph_map.dup.freeze
       super(path_or_name, size: size)
+      @atlas = resolve_atlas(atlas)
     end
 
     # Renders a named icon onto a surface.
     #
-    # @param surface [Surface] the surface to draw on
+    # The icon is rasterized into the {#atlas} on first use; later draws
+    # composite the cached bitmap in a single blit.
+    #
+    # @param surface [Canvas, Layer] the surface to draw on
     # @param name [Symbol] icon name from the glyph map
     # @param x [Integer] x position
     # @param y [Integer] y position
@@ -35,8 +47,18 @@ module ChromaWave
     # @return [surface]
     # @raise [KeyError] if the icon name is not in the glyph map
     def draw(surface, name, x:, y:, color:)
-      cp = glyph_map.fetch(name)
-      surface.draw_text(cp.chr(Encoding::UTF_8), x: x, y: y, font: self, color: color)
+      surface.draw_glyph(atlas_glyph(name), x: x, y: y, color: color)
+    end
+
+    # Rasterizes icons into the atlas ahead of the first draw.
+    #
+    # @param names [Array<Symbol>] icon names (default: every icon in the glyph map)
+    # @return [Atlas] the filled atlas, e.g. for {Atlas#write}
+    # @raise [KeyError] if a name is not in the glyph map
+    def prewarm(*names)
+      names = glyph_map.keys if names.empty?
+      names.each { |name| atlas_glyph(name) }
+      atlas
     end
 
     # Returns a sorted list of available icon names.
@@ -59,10 +81,54 @@ module ChromaWave
     # Factory: returns an IconFont using the bundled Lucide icon font.
     #
     # @param size [Integer] pixel size
+    # @param atlas [Atlas, String, nil] optional pre-rasterized icons
     # @return [IconFont]
-    def self.lucide(size:)
+    def self.lucide(size:, atlas: nil)
       new(File.join(DATA_DIR, 'fonts', 'lucide.ttf'),
-          size: size, glyph_map: LUCIDE_GLYPHS)
+          size: size, glyph_map: LUCIDE_GLYPHS, atlas: atlas)
+    end
+
+    private
+
+    # Returns the cached glyph for a named icon, rasterizing it on a miss.
+    #
+    # @param name [Symbol] icon name from the glyph map
+    # @return [Hash] glyph hash (see {Atlas})
+    # @raise [KeyError] if the icon name is not in the glyph map
+    def atlas_glyph(name)
+      atlas[name] || begin
+        cp = glyph_map.fetch(name)
+        atlas.fetch(name) { rasterize_icon(cp) }
+      end
+    end
+
+    # Renders a codepoint into a glyph hash positioned like {Font#each_glyph}.
+    #
+    # @param codepoint [Integer] icon codepoint
+    # @return [Hash]
+    def rasterize_icon(codepoint)
+      glyph = _ft_render_glyph(codepoint)
+      {
+        bitmap: glyph[:bitmap].freeze,
+        x: glyph[:bearing_x],
+        y: ascent - glyph[:bearing_y],
+        width: glyph[:width],
+        height: glyph[:height],
+        advance: glyph[:advance_x]
+      }
+    end
+
+    # Normalizes the +atlas:+ constructor argument.
+    #
+    # @param atlas [Atlas, String, nil] atlas, atlas file path, or nil
+    # @return [Atlas]
+    # @raise [ArgumentError] if the atlas size does not match the font size
+    def resolve_atlas(atlas)
+      atlas = Atlas.load(atlas) if atlas.is_a?(String)
+      return Atlas.new(size: size) if atlas.nil?
+      return atlas if atlas.size == size
+
+      raise ArgumentError, "atlas was rasterized at #{atlas.size}px, font is #{size}px"
     end
   end
 end
@@ -0,0 +1,191 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  class IconFont < Font
+    # Pre-rasterized icon bitmaps for a single icon font size.
+    #
+    # Each entry is a glyph hash in the same shape yielded by
+    # {Font#each_glyph} (+:bitmap+, +:x+, +:y+, +:width+, +:height+) plus
+    # +:advance+, positioned relative to the top-left of the line box.
+    # Drawing an entry is a single +render_glyph+ call, which Canvas and
+    # Layer route to the +_canvas_blit_glyph+ C accelerator.
+    #
+    # Atlases can be written to disk as one packed alpha blob and loaded
+    # back without FreeType, so cold starts never rasterize icons.
+    #
+    # @example Bake once, load at boot
+    #   IconFont.lucide(size: 24).prewarm(:house, :wifi).write('icons-24.cwia')
+    #   atlas = IconFont::Atlas.load('icons-24.cwia')
+    #   atlas.draw(canvas, :house, x: 10, y: 10, color: Color::BLACK)
+    class Atlas
+      # File signature for baked atlas files.
+      MAGIC = 'CWIA'
+
+      # Current file format version.
+      VERSION = 1
+
+      # Header layout: magic, version, reserved, pixel size, entry count.
+      HEADER_FORMAT = 'a4CCS<L<'
+
+      # Header size in bytes.
+      HEADER_SIZE = 12
+
+      # Per-entry record after the name: x, y, width, height, advance, blob offset.
+      ENTRY_FORMAT = 's<s<S<S<s<L<'
+
+      # Per-entry record size in bytes (excluding the length-prefixed name).
+      ENTRY_SIZE = 14
+
+      attr_reader :size
+
+      # Creates an empty atlas for the given pixel size.
+      #
+      # @param size [Integer] pixel size the entries were rasterized at
+      def initialize(size:)
+        @size = size
+        @entries = {}
+      end
+
+      # Loads a baked atlas file written by {#write}.
+      #
+      # Entry bitmaps are byte slices of a single frozen blob, so loading
+      # costs one file read regardless of icon count.
+      #
+      # @param path [String] path to the atlas file
+      # @return [Atlas]
+      # @raise [ArgumentError] if the file is not a valid atlas
+      def self.load(path)
+        data = File.binread(path)
+        magic, version, _reserved, size, count = data.unpack(HEADER_FORMAT)
+        raise ArgumentError, "not an icon atlas: #{path}" unless magic == MAGIC && data.bytesize >= HEADER_SIZE
+        raise ArgumentError, "unsupported icon atlas version #{version}" unless version == VERSION
+
+        new(size: size).tap { |atlas| atlas.send(:read_entries, data, count) }
+      end
+
+      # Returns the entry for +name+, rasterizing it via the block on a miss.
+      #
+      # @param name [Symbol] icon name
+      # @yield computes the glyph hash on cache miss
+      # @return [Hash] frozen glyph hash
+      def fetch(name)
+        entries.fetch(name) { entries[name] = yield.freeze }
+      end
+
+      # Returns the entry for +name+, or nil if it has not been rasterized.
+      #
+      # @param name [Symbol] icon name
+      # @return [Hash, nil]
+      def [](name)
+        entries[name]
+      end
+
+      # Returns true if +name+ has been rasterized into this atlas.
+      #
+      # @param name [Symbol] icon name
+      # @return [Boolean]
+      def include?(name)
+        entries.key?(name)
+      end
+
+      # Returns the names of all rasterized icons.
+      #
+      # @return [Array<Symbol>]
+      def names
+        entries.keys
+      end
+
+      # Returns the number of rasterized icons.
+      #
+      # @return [Integer]
+      def count
+        entries.size
+      end
+
+      # Composites a rasterized icon onto a surface.
+      #
+      # @param surface [Canvas, Layer] the surface to draw on
+      # @param name [Symbol] icon name
+      # @param x [Integer] left edge of the icon's line box
+      # @param y [Integer] top edge of the icon's line box
+      # @param color [Color] icon color
+      # @return [surface]
+      # @raise [KeyError] if the icon is not in the atlas
+      def draw(surface, name, x:, y:, color:)
+        surface.draw_glyph(entries.fetch(name), x: x, y: y, color: color)
+      end
+
+      # Writes the atlas to disk as a header, an entry table, and one
+      # packed alpha blob.
+      #
+      # @param path [String] output file path
+      # @return [self]
+      def write(path)
+        table = String.new(encoding: Encoding::BINARY)
+        blob = String.new(encoding: Encoding::BINARY)
+
+        entries.each do |name, glyph|
+          table << pack_entry(name, glyph, blob.bytesize)
+          blob << glyph[:bitmap]
+        end
+
+        header = [MAGIC, VERSION, 0, size, entries.size].pack(HEADER_FORMAT)
+        File.binwrite(path, header + table + blob)
+        self
+      end
+
+      # @return [String] human-readable representation
+      def inspect
+        "#<#{self.class} @#{size}px #{count} icons>"
+      end
+
+      private
+
+      attr_reader :entries
+
+      # Packs one entry table record.
+      #
+      # @param name [Symbol] icon name
+      # @param glyph [Hash] glyph hash
+      # @param offset [Integer] bitmap offset within the blob
+      # @return [String] binary record
+      def pack_entry(name, glyph, offset)
+        label = name.to_s.b
+        raise ArgumentError, "icon name too long: #{name.inspect}" if label.bytesize > 255
+
+        [label.bytesize].pack('C') + label +
+          [glyph[:x], glyph[:y], glyph[:width], glyph[:height], glyph[:advance], offset].pack(ENTRY_FORMAT)
+      end
+
+      # Parses the entry table and slices bitmaps out of the trailing blob.
+      #
+      # @param data [String] full file contents
+      # @param count [Integer] number of entries
+      # @return [void]
+      def read_entries(data, count)
+        pos = HEADER_SIZE
+        records = Array.new(count) do
+          len = data.getbyte(pos)
+          name = data.byteslice(pos + 1, len).to_sym
+          pos += 1 + len
+          fields = data.unpack(ENTRY_FORMAT, offset: pos)
+          pos += ENTRY_SIZE
+          [name, fields]
+        end
+
+        blob = data.byteslice(pos, data.bytesize - pos).freeze
+        records.each { |name, fields| entries[name] = unpack_glyph(blob, *fields) }
+      end
+
+      # Builds a frozen glyph hash backed by a slice of the blob.
+      #
+      # @return [Hash]
+      def unpack_glyph(blob, x, y, width, height, advance, offset) # rubocop:disable Metrics/ParameterLists
+        bitmap = blob.byteslice(offset, width * height)
+        raise ArgumentError, 'truncated icon atlas' if bitmap.nil? || bitmap.bytesize != width * height
+
+        { bitmap: bitmap.freeze, x: x, y: y, width: width, height: height, advance: advance }.freeze
+      end
+    end
+  end
+end
@@ -89,11 +89,12 @@ module ChromaWave
 
     # Creates a new Canvas from this image.
     #
+    # The decoded RGBA string is copied straight into the new canvas's
+    # buffer, without filling a background first.
+    #
     # @return [Canvas] a canvas with this image's pixels
     def to_canvas
-      Canvas.new(width: width, height: height).tap do |canvas|
-        draw_onto(canvas, x: 0, y: 0)
-      end
+      Canvas.from_rgba_bytes(to_rgba_bytes, width: width, height: height)
     end
 
     # Returns the raw RGBA pixel data as a binary string.
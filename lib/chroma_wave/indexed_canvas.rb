@@ -0,0 +1,290 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  # Palette-indexed pixel buffer for flat-color UIs on color E-Paper panels.
+  #
+  # Stores one palette index per pixel for a {PixelFormat}'s palette, so
+  # content drawn only in palette colors reaches the panel without any
+  # color matching: {#to_framebuffer} (and {Renderer#render}, for a
+  # matching format) bit-packs the indices straight into a
+  # {Framebuffer}, skipping the dither stage.
+  #
+  # Colors may be palette names (+:red+), raw palette indices, or
+  # {Color}s (matched to the nearest palette entry once per call).
+  # Pixels read back as the palette's {Color}s. Glyphs and anti-aliased
+  # paths cannot blend in index space, so their coverage is thresholded
+  # at 50% (scaled by the color's alpha).
+  #
+  # @example Tri-color signage
+  #   canvas = IndexedCanvas.new(width: 400, height: 300, pixel_format: :color4)
+  #   canvas.draw_rect(0, 0, 400, 40, pen: Pen.fill(:red))
+  #   canvas.draw_text('SALE', x: 10, y: 8, font: font, color: :white)
+  #   display.show(canvas)
+  class IndexedCanvas < Canvas
+    # Bytes per pixel in the index buffer.
+    BYTES_PER_PIXEL = 1
+
+    # Glyph coverage at or above which an opaque color is written.
+    GLYPH_THRESHOLD = 128
+
+    attr_reader :pixel_format
+
+    # Creates a new IndexedCanvas filled with the given background color.
+    #
+    # @param width [Integer] canvas width in pixels (must be positive)
+    # @param height [Integer] canvas height in pixels (must be positive)
+    # @param pixel_format [PixelFormat, Symbol] format whose palette indexes the pixels
+    # @param background [Symbol, Integer, Color] initial fill color (default: white)
+    # @raise [ArgumentError] if width or height is not a positive integer
+    def initialize(width:, height:, pixel_format:, background: :white) # rubocop:disable Lint/MissingSuper
+      validate_dimensions!(width, height)
+      @width  = width
+      @height = height
+      @pixel_format = pixel_format.is_a?(Symbol) ? PixelFormat.from_name(pixel_format) : pixel_format
+      @colors = palette.map { |name| Color.from_name(name) }.freeze
+      @rgba_lut = @colors.map(&:to_rgba_bytes).join.b.freeze
+      @buffer = PixelBuffer.new(width, height, BYTES_PER_PIXEL, [resolve_index(background)].pack('C'))
+    end
+
+    # Sets the pixel at (x, y) to the palette index of +color+.
+    #
+    # Out-of-bounds coordinates are silently ignored.
+    #
+    # @param x [Integer] x coordinate
+    # @param y [Integer] y coordinate
+    # @param color [Symbol, Integer, Color] the color to set
+    # @return [self]
+    def set_pixel(x, y, color)
+      return self unless in_bounds?(x, y)
+
+      buffer.setbyte(pixel_offset(x, y), resolve_index(color))
+      self
+    end
+
+    # Returns the palette color at (x, y).
+    #
+    # @param x [Integer] x coordinate
+    # @param y [Integer] y coordinate
+    # @return [Color, nil] the palette entry's color, or nil if out of bounds
+    def get_pixel(x, y)
+      return nil unless in_bounds?(x, y)
+
+      @colors[buffer.getbyte(pixel_offset(x, y))]
+    end
+
+    # Fills the entire canvas with +color+.
+    #
+    # @param color [Symbol, Integer, Color] the fill color (default: white)
+    # @return [self]
+    def clear(color = :white)
+      if respond_to?(:_indexed_clear, true)
+        _indexed_clear(buffer, resolve_index(color))
+      else
+        buffer.replace([resolve_index(color)].pack('C') * (width * height))
+      end
+      self
+    end
+
+    # Copies pixels from +source+ onto this canvas.
+    #
+    # IndexedCanvas sources on the same palette are copied row-wise;
+    # other surfaces go through the per-pixel path and are matched to
+    # the palette.
+    #
+    # @param source [Surface] the source surface
+    # @param x [Integer] destination x offset
+    # @param y [Integer] destination y offset
+    # @return [self]
+    def blit(source, x:, y:)
+      source = source.dup if source.equal?(self)
+      if source.is_a?(IndexedCanvas) && source.pixel_format == pixel_format && respond_to?(:_indexed_load, true)
+        _indexed_load(buffer, source.raw_buffer, x, y, source.width, source.height, width, BYTES_PER_PIXEL)
+      else
+        blit_ruby(source, x, y)
+      end
+      self
+    end
+
+    # Bulk-loads raw RGBA bytes into a rectangular region, matching each
+    # pixel to the palette (alpha is ignored).
+    #
+    # Uses a C accelerator when available; it matches by the same redmean
+    # distance as {Palette#nearest_color}.
+    #
+    # @param bytes [String] raw RGBA pixel data
+    # @param width [Integer] source width in pixels
+    # @param height [Integer] source height in pixels
+    # @param x [Integer] destination x offset
+    # @param y [Integer] destination y offset
+    # @return [self]
+    def load_rgba_bytes(bytes, width:, height:, x:, y:)
+      if respond_to?(:_indexed_quantize, true)
+        _indexed_quantize(buffer, bytes, x, y, width, height, self.width, @rgba_lut)
+      else
+        load_rgba_bytes_ruby(bytes, width, height, x, y)
+      end
+      self
+    end
+
+    # Returns a packed copy of the index buffer as a frozen binary string.
+    #
+    # @return [String] palette indices (1 byte per pixel, row-major)
+    def index_bytes
+      buffer.to_s.freeze
+    end
+
+    # Returns the pixels expanded to the palette's RGBA colors.
+    #
+    # @return [String] the pixel data (4 bytes per pixel, row-major)
+    def rgba_bytes
+      return _indexed_to_rgba(buffer, @rgba_lut).freeze if respond_to?(:_indexed_to_rgba, true)
+
+      buffer.to_s.each_byte.map { |i| @rgba_lut.byteslice(i * 4, 4) }.join.freeze
+    end
+
+    # Yields the pixels expanded to the palette's RGBA colors (a copy).
+    #
+    # @yieldparam bytes [String] the pixel data (4 bytes per pixel, row-major)
+    # @return [Object] the block's result
+    def with_rgba_buffer
+      yield rgba_bytes
+    end
+
+    # Writes a glyph bitmap in +color+ wherever its coverage passes the
+    # threshold, via the C accelerator.
+    #
+    # @param bitmap [String] grayscale alpha bitmap (1 byte/pixel)
+    # @param x [Integer] destination x in canvas coordinates
+    # @param y [Integer] destination y in canvas coordinates
+    # @param width [Integer] glyph bitmap width
+    # @param height [Integer] glyph bitmap height
+    # @param color [Symbol, Integer, Color] foreground color for the glyph
+    # @return [Boolean] true if C accelerator was used, false otherwise
+    def blit_glyph(bitmap, x:, y:, width:, height:, color:) # rubocop:disable Naming/PredicateMethod
+      return false unless respond_to?(:_indexed_blit_glyph, true)
+
+      alpha = color.is_a?(Color) ? color.a : 255
+      return true if alpha.zero?
+
+      threshold = ((GLYPH_THRESHOLD * 255) + alpha - 1) / alpha
+      _indexed_blit_glyph(buffer, bitmap, x, y, width, height, self.width, self.height,
+                          resolve_index(color), threshold)
+      true
+    end
+
+    # Packs the indices into a {Framebuffer} of this canvas's format.
+    #
+    # @param into [Framebuffer, nil] optional pre-allocated framebuffer to reuse
+    # @return [Framebuffer]
+    # @raise [ArgumentError] if +into+ does not match the canvas size and format
+    def to_framebuffer(into: nil)
+      fb = into || Framebuffer.new(width, height, pixel_format, clear: false)
+      unless fb.width == width && fb.height == height && fb.pixel_format == pixel_format
+        raise ArgumentError,
+              "framebuffer #{fb.width}x#{fb.height} #{fb.pixel_format.name} " \
+              "does not match canvas #{width}x#{height} #{pixel_format.name}"
+      end
+
+      fb.load_indices(buffer)
+    end
+
+    # Returns true if +other+ is an IndexedCanvas with the same format,
+    # dimensions and pixels.
+    #
+    # @param other [Object] the object to compare
+    # @return [Boolean]
+    def ==(other)
+      super && pixel_format == other.pixel_format
+    end
+
+    alias eql? ==
+
+    # Returns a hash code consistent with {#==} and {#eql?}.
+    #
+    # @return [Integer]
+    def hash
+      [super, pixel_format].hash
+    end
+
+    private
+
+    # @return [Palette] the palette the indices refer to
+    def palette
+      pixel_format.palette
+    end
+
+    # Resolves a color argument into a palette index.
+    #
+    # @param color [Symbol, Integer, Color] palette name, index, or color to match
+    # @return [Integer]
+    # @raise [ArgumentError] if an integer is outside the palette range
+    # @raise [KeyError] if a name is not in the palette
+    def resolve_index(color)
+      case color
+      when Symbol then palette.index_of(color)
+      when Integer
+        return color if color >= 0 && color < palette.size
+
+        raise ArgumentError, "color index #{color} out of range for #{pixel_format.name} palette (0...#{palette.size})"
+      else palette.index_of(palette.nearest_color(color))
+      end
+    end
+
+    # The palette {Color} that +color+ reads back as (see {Drawing::Primitives}).
+    #
+    # @param color [Symbol, Integer, Color] palette name, index, or color
+    # @return [Color]
+    def surface_color(color)
+      @colors[resolve_index(color)]
+    end
+
+    # Byte offset for pixel (x, y) in the index buffer.
+    def pixel_offset(x, y)
+      (y * width) + x
+    end
+
+    # Scanline fill_rect for the Ruby fallback (see {Canvas}).
+    def fill_rect(x, y, w, h, color)
+      return if native_raster(:rect, color, x, y, w, h)
+
+      x0 = [x, 0].max
+      y0 = [y, 0].max
+      x1 = [x + w, width].min
+      y1 = [y + h, height].min
+      return if x0 >= x1 || y0 >= y1
+
+      row = [resolve_index(color)].pack('C') * (x1 - x0)
+      (y0...y1).each { |row_y| buffer[pixel_offset(x0, row_y), row.bytesize] = row }
+    end
+
+    # Ruby fallback for bulk RGBA load: matches each distinct RGB value
+    # once and writes the clipped rows of indices in bulk.
+    def load_rgba_bytes_ruby(bytes, src_w, src_h, ox, oy)
+      x0 = [ox, 0].max
+      x1 = [ox + src_w, width].min
+      return if x0 >= x1
+
+      indices = {}
+      src_h.times do |sy|
+        dy = oy + sy
+        next if dy.negative? || dy >= height
+
+        row = (x0...x1).map do |dx|
+          offset = ((sy * src_w) + dx - ox) * Canvas::BYTES_PER_PIXEL
+          r, g, b = bytes.byteslice(offset, 3).unpack('C3')
+          indices[(r << 16) | (g << 8) | b] ||= resolve_index(Color.new(r: r, g: g, b: b))
+        end
+        buffer[pixel_offset(x0, dy), row.size] = row.pack('C*')
+      end
+    end
+
+    # Rasterizes a shape in the palette index of +color+ (see {Canvas#native_raster_window}).
+    #
+    # @return [Boolean] true if the C path drew the shape
+    def native_raster_window(window, shape, color, *args)
+      return false unless respond_to?(:_indexed_raster, true)
+
+      _indexed_raster(buffer, width, height, window, shape, resolve_index(color), *args)
+    end
+  end
+end
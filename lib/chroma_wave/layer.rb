@@ -7,6 +7,12 @@ module ChromaWave
   # an isolated drawing context that cannot exceed its declared bounds.
   # Layers compose — a Layer of a Layer works via additive offsets.
   #
+  # Rectangle-level operations — {#clear}, {#blit}, {#blit_glyph}, and the
+  # drawing primitives — are translated and clipped once, then handed to
+  # the parent's bulk path (ultimately the root Canvas or Framebuffer C
+  # accelerators), so drawing through nested Layers costs about the same
+  # as drawing on the root surface directly.
+  #
   # @example
   #   canvas = Canvas.new(width: 200, height: 100)
   #   layer = Layer.new(parent: canvas, x: 10, y: 10, width: 50, height: 30)
@@ -39,6 +45,26 @@ module ChromaWave
       "#<#{self.class} #{width}x#{height} at (#{offset_x},#{offset_y})>"
     end
 
+    # Creates a nested {Layer} scoped to a sub-region of this layer.
+    #
+    # If a block is given, yields the layer and returns self for chaining.
+    #
+    # @param x [Integer] sub-region x offset
+    # @param y [Integer] sub-region y offset
+    # @param width [Integer] sub-region width
+    # @param height [Integer] sub-region height
+    # @yield [Layer] the created layer (optional)
+    # @return [Layer, self] the layer, or self if a block was given
+    def layer(x:, y:, width:, height:)
+      l = Layer.new(parent: self, x: x, y: y, width: width, height: height)
+      if block_given?
+        yield l
+        self
+      else
+        l
+      end
+    end
+
     # Sets the pixel at local (x, y) on the parent surface.
     #
     # Out-of-bounds coordinates (relative to the Layer) are silently ignored.
@@ -65,36 +91,171 @@ module ChromaWave
       parent.get_pixel(offset_x + x, offset_y + y)
     end
 
+    # Fills the layer region with +color+.
+    #
+    # @param color [Object] the fill color
+    # @return [self]
+    def clear(color)
+      fill_rect(0, 0, width, height, color)
+      self
+    end
+
+    # Copies pixels from +source+ onto the layer at the given offset.
+    #
+    # Canvas sources are cropped to the layer straight from their borrowed
+    # buffer (see {Canvas#with_rgba_buffer}), so only the visible rows are
+    # copied, then loaded through the parent's {#load_rgba_bytes}; other
+    # sources use the per-pixel {Surface#blit}. Either way pixels are
+    # overwritten, not blended.
+    #
+    # @param source [Surface] the surface to copy from
+    # @param x [Integer] destination x offset
+    # @param y [Integer] destination y offset
+    # @return [self]
+    def blit(source, x:, y:)
+      return super unless source.is_a?(Canvas) && parent.respond_to?(:load_rgba_bytes)
+
+      x0, y0, x1, y1 = clip_rect(x, y, source.width, source.height)
+      return self if x0 >= x1 || y0 >= y1
+
+      # Cropped inside the block but loaded after it, so a source that is
+      # also the destination is no longer borrowed when it is written.
+      visible = source.with_rgba_buffer do |bytes|
+        crop(bytes, source.width, source.height, x0 - x, y0 - y, x1 - x0, y1 - y0, Canvas::BYTES_PER_PIXEL)
+      end
+      load_visible(visible, x0, y0, x1 - x0, y1 - y0)
+    end
+
+    # Bulk-loads raw RGBA bytes into a rectangular region of the layer,
+    # clipped to the layer bounds.
+    #
+    # @param bytes [String] raw RGBA pixel data
+    # @param width [Integer] source width in pixels
+    # @param height [Integer] source height in pixels
+    # @param x [Integer] destination x offset
+    # @param y [Integer] destination y offset
+    # @return [self]
+    def load_rgba_bytes(bytes, width:, height:, x:, y:)
+      x0, y0, x1, y1 = clip_rect(x, y, width, height)
+      return self if x0 >= x1 || y0 >= y1
+
+      load_visible(crop(bytes, width, height, x0 - x, y0 - y, x1 - x0, y1 - y0, Canvas::BYTES_PER_PIXEL),
+                   x0, y0, x1 - x0, y1 - y0)
+    end
+
+    # Composites a glyph bitmap through the parent's C accelerator.
+    #
+    # Clips the bitmap to the layer bounds (cropping it if it is only
+    # partly visible) and forwards it with translated coordinates, so
+    # nested layers reach the root Canvas in one call.
+    #
+    # @param bitmap [String] grayscale alpha bitmap (1 byte/pixel)
+    # @param x [Integer] destination x in layer coordinates
+    # @param y [Integer] destination y in layer coordinates
+    # @param width [Integer] glyph bitmap width
+    # @param height [Integer] glyph bitmap height
+    # @param color [Color] foreground color for the glyph
+    # @return [Boolean] true if the accelerator handled the glyph, false
+    #   if the parent has none
+    def blit_glyph(bitmap, x:, y:, width:, height:, color:) # rubocop:disable Naming/PredicateMethod
+      return false unless parent.respond_to?(:blit_glyph)
+
+      x0, y0, x1, y1 = clip_rect(x, y, width, height)
+      return true if x0 >= x1 || y0 >= y1
+
+      parent.blit_glyph(crop(bitmap, width, height, x0 - x, y0 - y, x1 - x0, y1 - y0, 1),
+                        x: offset_x + x0, y: offset_y + y0,
+                        width: x1 - x0, height: y1 - y0, color: color)
+    end
+
     private
 
     attr_reader :parent, :offset_x, :offset_y
 
-    # Alpha-composites a glyph bitmap via the parent's C accelerator when possible.
-    #
-    # Delegates to +parent.blit_glyph+ with translated coordinates when the
-    # entire glyph fits within Layer bounds. Falls back to the per-pixel Ruby
-    # path for partial-overlap glyphs or when the parent lacks +blit_glyph+.
+    # Alpha-composites a glyph bitmap via {#blit_glyph}, falling back to
+    # the per-pixel Ruby path when the parent lacks +blit_glyph+.
     #
     # @param glyph [Hash] glyph data from Font#each_glyph
     # @param base_x [Integer] line start x in local coordinates
     # @param base_y [Integer] line start y in local coordinates
     # @param color [Color] text foreground color
     def render_glyph(glyph, base_x, base_y, color)
-      return super unless parent.respond_to?(:blit_glyph)
-
-      gx = base_x + glyph[:x]
-      gy = base_y + glyph[:y]
-      gw = glyph[:width]
-      gh = glyph[:height]
-
-      if gx >= 0 && gy >= 0 && (gx + gw) <= width && (gy + gh) <= height &&
-         parent.blit_glyph(glyph[:bitmap],
-                           x: offset_x + gx, y: offset_y + gy,
-                           width: gw, height: gh, color: color)
-        return
-      end
+      return if blit_glyph(glyph[:bitmap],
+                           x: base_x + glyph[:x], y: base_y + glyph[:y],
+                           width: glyph[:width], height: glyph[:height], color: color)
 
       super
     end
+
+    # Colors read back as the parent stores them (see {Drawing::Primitives}).
+    #
+    # @param color [Object] the fill color
+    # @return [Object]
+    def surface_color(color)
+      parent.send(:surface_color, color)
+    end
+
+    # Translates a shape into the parent's coordinates (see
+    # {Drawing::Primitives}), clipped to the layer.
+    #
+    # @return [Boolean] true if the parent's C path drew the shape
+    def native_raster(shape, color, *args)
+      native_raster_window([0, 0, 0, 0, width, height], shape, color, *args)
+    end
+
+    # Composes a child's raster window with this layer's offset and bounds
+    # and passes it up, so nested layers reach the root rasterizer.
+    #
+    # @param window [Array(Integer, Integer, Integer, Integer, Integer, Integer)]
+    #   +[ox, oy, x0, y0, x1, y1]+ in this layer's coordinates
+    # @return [Boolean] true if the root's C path drew the shape
+    def native_raster_window(window, shape, color, *args)
+      return false unless parent.respond_to?(:native_raster_window, true)
+
+      ox, oy, x0, y0, x1, y1 = window
+      parent.send(:native_raster_window,
+                  [ox + offset_x, oy + offset_y,
+                   [x0, -ox].max, [y0, -oy].max, [x1, width - ox].min, [y1, height - oy].min],
+                  shape, color, *args)
+    end
+
+    # Intersects a w x h rectangle at (x, y) with the layer bounds.
+    #
+    # @return [Array(Integer, Integer, Integer, Integer)] x0, y0, x1, y1 (exclusive)
+    def clip_rect(x, y, w, h)
+      [[x, 0].max, [y, 0].max, [x + w, width].min, [y + h, height].min]
+    end
+
+    # Extracts a cw x ch window at (sx, sy) from a row-major pixel string.
+    #
+    # Returns +bytes+ itself when the window is the whole image and +bytes+
+    # is a String; a borrowed {PixelBuffer} is always copied out.
+    def crop(bytes, w, h, sx, sy, cw, ch, bpp) # rubocop:disable Metrics/ParameterLists
+      return bytes if cw == w && ch == h && bytes.is_a?(String)
+
+      row = w * bpp
+      Array.new(ch) { |i| bytes.byteslice(((sy + i) * row) + (sx * bpp), cw * bpp) }.join
+    end
+
+    # Loads RGBA bytes already clipped to the layer into the w x h region
+    # at (x0, y0), through the parent's bulk loader when it has one.
+    def load_visible(bytes, x0, y0, w, h)
+      if parent.respond_to?(:load_rgba_bytes)
+        parent.load_rgba_bytes(bytes, width: w, height: h, x: offset_x + x0, y: offset_y + y0)
+      else
+        load_rgba_pixels(bytes, x0, y0, w, h)
+      end
+      self
+    end
+
+    # Per-pixel fallback for {#load_rgba_bytes} on parents without it.
+    def load_rgba_pixels(bytes, x0, y0, w, h)
+      h.times do |sy|
+        w.times do |sx|
+          offset = ((sy * w) + sx) * Canvas::BYTES_PER_PIXEL
+          set_pixel(x0 + sx, y0 + sy, Color.from_rgba_bytes(bytes.byteslice(offset, Canvas::BYTES_PER_PIXEL)))
+        end
+      end
+    end
   end
 end
@@ -26,9 +26,10 @@ module ChromaWave
       #
       # @param model [Symbol, String] model name (e.g. +:epd_2in13_v4+)
       # @param busy_duration [Numeric] simulated refresh delay in seconds
+      # @param rotation [Integer] drawing orientation (see {Display.new})
       # @return [MockDevice]
       # @raise [ModelNotFoundError] if the model is not in the registry
-      def new(model: nil, busy_duration: 0, **kwargs)
+      def new(model: nil, busy_duration: 0, rotation: 0, **kwargs)
         raise ArgumentError, 'missing keyword: :model' unless model
         raise ArgumentError, "unknown keyword(s): #{kwargs.keys.join(', ')}" unless kwargs.empty?
 
@@ -38,7 +39,8 @@ module ChromaWave
 
         klass = mock_classes[name] ||= build_mock_class(config)
         instance = klass.allocate
-        instance.send(:initialize, model_name: name, config: config, busy_duration: busy_duration)
+        instance.send(:initialize, model_name: name, config: config, busy_duration: busy_duration,
+                                   rotation: rotation)
         instance
       end
 
@@ -46,10 +48,11 @@ module ChromaWave
       #
       # @param model [Symbol, String] model name
       # @param busy_duration [Numeric] simulated refresh delay in seconds
+      # @param rotation [Integer] drawing orientation (see {Display.new})
       # @yield [mock] the opened MockDevice
       # @return [MockDevice, Object] the mock (no block) or the block's return value
-      def open(model:, busy_duration: 0)
-        mock = new(model: model, busy_duration: busy_duration)
+      def open(model:, busy_duration: 0, rotation: 0)
+        mock = new(model: model, busy_duration: busy_duration, rotation: rotation)
         return mock unless block_given?
 
         begin
@@ -137,7 +140,8 @@ module ChromaWave
       self
     end
 
-    # Returns a dup of the last framebuffer sent to the display.
+    # Returns a dup of the last framebuffer sent to the display, in the
+    # panel's orientation.
     #
     # @return [Framebuffer, nil] nil if no show has occurred
     def last_framebuffer
@@ -171,10 +175,10 @@ module ChromaWave
     # @param model_name [Symbol, String] the model identifier
     # @param config [Hash] the model configuration from Native
     # @param busy_duration [Numeric] simulated refresh delay in seconds
-    def initialize(model_name:, config:, busy_duration: 0) # rubocop:disable Lint/MissingSuper -- intentionally avoids Display#initialize which creates a real C Device
+    # @param rotation [Integer] drawing orientation (see {Display.new})
+    def initialize(model_name:, config:, busy_duration: 0, rotation: 0) # rubocop:disable Lint/MissingSuper -- intentionally avoids Display#initialize which creates a real C Device
       @model = model_name.to_sym
-      @width = config[:width]
-      @height = config[:height]
+      configure_geometry(config, rotation)
       @pixel_format = PixelFormat.from_name(config[:pixel_format])
       @busy_duration = busy_duration
       @initialized = false
@@ -182,6 +186,7 @@ module ChromaWave
       @operations_mutex = Mutex.new
       @operations_log = []
       @last_framebuffer = nil
+      @dual_display = config[:dual_display]
       @device = DeviceStub.new(self)
     end
 
@@ -189,6 +194,14 @@ module ChromaWave
 
     attr_reader :busy_duration
 
+    # Whether the model takes a second plane per refresh, like the
+    # native device checks before a dual display.
+    #
+    # @return [Boolean]
+    def dual_display?
+      @dual_display
+    end
+
     # Records an operation to the thread-safe log.
     #
     # @param entry [Hash] the operation fields (op:, plus metadata)
@@ -229,39 +242,15 @@ module ChromaWave
 
     # Writes a framebuffer to a PNG file using palette-accurate colors.
     #
-    # Builds the RGB buffer directly as a binary string, using a pre-built
-    # palette lookup to avoid per-pixel Color.from_name calls.
-    #
     # @param framebuffer [Framebuffer] the framebuffer to export
     # @param path [String] output file path
     # @return [void]
     def write_png(framebuffer, path)
-      w = framebuffer.width
-      h = framebuffer.height
-      rgb_for = build_palette_rgb(framebuffer.pixel_format)
-      buf = String.new(capacity: w * h * 3, encoding: 'BINARY')
-
-      h.times do |y|
-        w.times do |x|
-          buf << rgb_for[framebuffer.get_pixel(x, y)]
-        end
-      end
-
-      image = ::Vips::Image.new_from_memory(buf, w, h, 3, :uchar)
+      rgb = framebuffer.to_rgb_bytes
+      image = ::Vips::Image.new_from_memory(rgb, framebuffer.width, framebuffer.height, 3, :uchar)
       image.write_to_file(path.to_s)
     end
 
-    # Builds a hash mapping palette color names to packed RGB byte strings.
-    #
-    # @param pixel_format [PixelFormat] the framebuffer's pixel format
-    # @return [Hash{Symbol => String}] color name to 3-byte RGB string
-    def build_palette_rgb(pixel_format)
-      pixel_format.palette.each_with_object({}) do |name, map|
-        color = Color.from_name(name)
-        map[name] = [color.r, color.g, color.b].pack('CCC')
-      end
-    end
-
     # Stub device that intercepts hardware calls and delegates to MockDevice.
     #
     # Injected as the +@device+ ivar so capability modules' calls to
@@ -344,9 +333,14 @@ module ChromaWave
       # @param black_fb [Framebuffer] the black plane framebuffer
       # @param red_fb [Framebuffer] the red plane framebuffer
       # @return [void]
-      # @raise [DeviceError] if the device is closed
+      # @raise [DeviceError] if the device is closed, or the model has
+      #   no second display command
       def _epd_display_dual(black_fb, red_fb)
         assert_open!
+        unless @mock_device.send(:dual_display?)
+          raise DeviceError, "#{@mock_device.model} has no second display command"
+        end
+
         @mock_device.send(:store_framebuffer, black_fb)
         @mock_device.send(
           :record_operation,
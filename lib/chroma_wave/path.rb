@@ -0,0 +1,231 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  # A vector path for anti-aliased drawing with {Drawing::Vector#draw_path}.
+  #
+  # Paths are built from one or more contours of straight segments,
+  # quadratic and cubic Béziers, and circular arcs. Curves are flattened
+  # to line segments as they are added, to within {TOLERANCE} pixels.
+  #
+  # Coordinates are Floats in surface space, where pixel (x, y) covers
+  # the square x...x+1, y...y+1 — a 1px horizontal line through the
+  # middle of row 3 runs along y = 3.5. Angles follow {Drawing::Primitives#draw_arc}:
+  # radians, counter-clockwise on screen from the positive x axis.
+  #
+  # Builder methods return +self+ for chaining.
+  #
+  # @example A chart series with a filled area underneath
+  #   line = Path.polyline(points)
+  #   area = Path.polygon([[x0, base], *points, [x1, base]])
+  #   canvas.draw_path(area, pen: Pen.fill(Color.new(r: 0, g: 0, b: 255, a: 64)))
+  #   canvas.draw_path(line, pen: Pen.stroke(Color::BLUE, width: 2))
+  class Path
+    # Maximum distance in pixels between a curve and its flattened segments.
+    TOLERANCE = 0.2
+
+    # Upper bound on segments per flattened curve.
+    MAX_SEGMENTS = 256
+
+    # A flattened subpath: frozen flat +[x0, y0, x1, y1, ...]+ Float array.
+    Contour = Data.define(:points, :closed)
+
+    # Creates a path with a single line segment.
+    #
+    # @return [Path]
+    def self.line(x0, y0, x1, y1)
+      new.move_to(x0, y0).line_to(x1, y1)
+    end
+
+    # Creates an open path through +points+.
+    #
+    # @param points [Array<Array(Numeric, Numeric)>] [x, y] pairs
+    # @return [Path]
+    def self.polyline(points)
+      path = new
+      points.each_with_index { |(x, y), i| i.zero? ? path.move_to(x, y) : path.line_to(x, y) }
+      path
+    end
+
+    # Creates a closed path through +points+.
+    #
+    # @param points [Array<Array(Numeric, Numeric)>] [x, y] pairs
+    # @return [Path]
+    def self.polygon(points)
+      polyline(points).close
+    end
+
+    # Creates a closed rectangle covering +w+ x +h+ pixels from (x, y).
+    #
+    # @return [Path]
+    def self.rect(x, y, w, h)
+      polygon([[x, y], [x + w, y], [x + w, y + h], [x, y + h]])
+    end
+
+    # Creates a closed rectangle with circular corners.
+    #
+    # @param radius [Numeric] corner radius (clamped to half the shorter side)
+    # @return [Path]
+    def self.rounded_rect(x, y, w, h, radius:)
+      r = radius.clamp(0, [w, h].min / 2.0)
+      half_pi = Math::PI / 2
+      new.arc(x + w - r, y + r, r, 0.0, half_pi)
+         .arc(x + r, y + r, r, half_pi, Math::PI)
+         .arc(x + r, y + h - r, r, Math::PI, 3 * half_pi)
+         .arc(x + w - r, y + h - r, r, 3 * half_pi, 2 * Math::PI)
+         .close
+    end
+
+    # Creates a closed circle.
+    #
+    # @return [Path]
+    def self.circle(cx, cy, r)
+      new.arc(cx, cy, r, 0.0, 2 * Math::PI).close
+    end
+
+    def initialize
+      @contours = []
+      @points = nil
+    end
+
+    # Starts a new contour at (x, y).
+    #
+    # @return [self]
+    def move_to(x, y)
+      finish(false)
+      @points = [x.to_f, y.to_f]
+      self
+    end
+
+    # Adds a straight segment to (x, y).
+    #
+    # @return [self]
+    def line_to(x, y)
+      return move_to(x, y) unless @points
+
+      @points << x.to_f << y.to_f
+      self
+    end
+
+    # Adds a quadratic Bézier with control point (cx, cy) ending at (x, y).
+    #
+    # @return [self]
+    def quad_to(cx, cy, x, y)
+      x0, y0 = current_point
+      # Deviation of uniform steps is |p0 - 2p1 + p2| / (4n²)
+      dd = Math.hypot(x0 - (2 * cx) + x, y0 - (2 * cy) + y)
+      flatten(segments_for(dd / 4.0)) do |t|
+        mt = 1 - t
+        [(mt * mt * x0) + (2 * mt * t * cx) + (t * t * x),
+         (mt * mt * y0) + (2 * mt * t * cy) + (t * t * y)]
+      end
+    end
+
+    # Adds a cubic Bézier with control points (c1x, c1y), (c2x, c2y)
+    # ending at (x, y).
+    #
+    # @return [self]
+    def cubic_to(c1x, c1y, c2x, c2y, x, y) # rubocop:disable Metrics/ParameterLists
+      x0, y0 = current_point
+      # Deviation of uniform steps is at most 3 * max|second difference| / (4n²)
+      dd = [Math.hypot(x0 - (2 * c1x) + c2x, y0 - (2 * c1y) + c2y),
+            Math.hypot(c1x - (2 * c2x) + x, c1y - (2 * c2y) + y)].max
+      flatten(segments_for(dd * 0.75)) do |t|
+        mt = 1 - t
+        a = mt * mt * mt
+        b = 3 * mt * mt * t
+        c = 3 * mt * t * t
+        d = t * t * t
+        [(a * x0) + (b * c1x) + (c * c2x) + (d * x), (a * y0) + (b * c1y) + (c * c2y) + (d * y)]
+      end
+    end
+
+    # Adds a circular arc, connected to the current point by a straight
+    # segment (or starting a contour if there is none).
+    #
+    # Sweeps from +start_angle+ to +end_angle+: counter-clockwise when
+    # +end_angle+ is larger, clockwise when smaller, at most one turn.
+    #
+    # @param cx [Numeric] center x
+    # @param cy [Numeric] center y
+    # @param r [Numeric] radius
+    # @param start_angle [Numeric] start angle in radians
+    # @param end_angle [Numeric] end angle in radians
+    # @return [self]
+    def arc(cx, cy, r, start_angle, end_angle)
+      sweep = (end_angle - start_angle).clamp(-2 * Math::PI, 2 * Math::PI)
+      n = arc_segments(r, sweep)
+      (0..n).each do |i|
+        a = start_angle + (sweep * i / n)
+        line_to(cx + (r * Math.cos(a)), cy - (r * Math.sin(a)))
+      end
+      self
+    end
+
+    # Closes the current contour back to its first point.
+    #
+    # @return [self]
+    def close
+      finish(true)
+      self
+    end
+
+    # Returns the flattened contours, including the one in progress.
+    #
+    # @return [Array<Contour>]
+    def contours
+      return @contours.dup unless @points
+
+      @contours + [Contour.new(points: @points.dup.freeze, closed: false)]
+    end
+
+    # Returns true if no points have been added.
+    #
+    # @return [Boolean]
+    def empty?
+      @contours.empty? && @points.nil?
+    end
+
+    # Contours in the shape expected by +Native.rasterize_path+.
+    #
+    # @return [Array<Array(String, Boolean)>]
+    def native_contours
+      contours.map { |c| [c.points.pack('d*'), c.closed] }
+    end
+
+    private
+
+    # Files the contour in progress.
+    def finish(closed)
+      @contours << Contour.new(points: @points.freeze, closed: closed) if @points
+      @points = nil
+    end
+
+    # @return [Array(Float, Float)] the last point of the current contour
+    # @raise [ArgumentError] if no contour has been started
+    def current_point
+      raise ArgumentError, 'curve requires a current point (call move_to first)' unless @points
+
+      @points.last(2)
+    end
+
+    # Appends the curve's points at n uniform parameter steps.
+    def flatten(n)
+      (1..n).each { |i| line_to(*yield(i.fdiv(n))) }
+      self
+    end
+
+    # Number of uniform steps keeping the deviation within {TOLERANCE},
+    # given the deviation of a single step.
+    def segments_for(deviation)
+      Math.sqrt(deviation / TOLERANCE).ceil.clamp(1, MAX_SEGMENTS)
+    end
+
+    # Number of chords keeping an arc of radius r within {TOLERANCE}.
+    def arc_segments(r, sweep)
+      return 1 if r <= TOLERANCE
+
+      step = 2 * Math.acos(1 - (TOLERANCE / r))
+      (sweep.abs / step).ceil.clamp(1, MAX_SEGMENTS)
+    end
+  end
+end
@@ -3,7 +3,7 @@
 module ChromaWave
   # Immutable pixel format descriptor binding a name, bit depth, and palette.
   #
-  # Each constant (MONO, GRAY4, COLOR4, COLOR7) defines one hardware-supported
+  # Each constant (MONO, GRAY4, COLOR4, COLOR7, COLOR4_2BPP) defines one hardware-supported
   # pixel packing scheme. The palette entry ordering exactly matches the
   # hardware's integer-to-color mapping.
   #
@@ -71,12 +71,21 @@ module ChromaWave
                                    palette: Palette[:black, :white, :green, :blue, :red, :yellow, :orange]
                                  ))
 
+  # 2-bit 4-color: black/white/yellow/red packed as the "g" panel
+  # controllers take them, at half the size of COLOR4.
+  PixelFormat.const_set(:COLOR4_2BPP, PixelFormat.new(
+                                        name: :color4_2bpp,
+                                        bits_per_pixel: 2,
+                                        palette: Palette[:black, :white, :yellow, :red]
+                                      ))
+
   # Frozen registry mapping format names to their PixelFormat constants.
   PixelFormat.const_set(:REGISTRY, {
     mono: PixelFormat::MONO,
     gray4: PixelFormat::GRAY4,
     color4: PixelFormat::COLOR4,
-    color7: PixelFormat::COLOR7
+    color7: PixelFormat::COLOR7,
+    color4_2bpp: PixelFormat::COLOR4_2BPP
   }.freeze)
 
   class << PixelFormat
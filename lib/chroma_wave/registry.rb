@@ -23,15 +23,16 @@ module ChromaWave
       # Builds a Display subclass instance for the given model.
       #
       # @param model [Symbol, String] model name (e.g. +:epd_2in13_v4+)
+      # @param rotation [Integer] drawing orientation (see {Display.new})
       # @return [Display]
       # @raise [ModelNotFoundError] if the model is not in the registry
-      def build(model)
+      def build(model, rotation: 0)
         name = model.to_s
         config = Native.model_config(name)
         raise_not_found!(name) unless config
 
         klass = display_classes[name] ||= build_class(name, config)
-        klass.send(:new, model_name: name, config: config)
+        klass.send(:new, model_name: name, config: config, rotation: rotation)
       end
 
       # Returns all registered model names as symbols.
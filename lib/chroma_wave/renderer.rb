@@ -3,8 +3,9 @@
 module ChromaWave
   # Bridges Canvas (RGBA pixels) to Framebuffer (format-specific packed pixels).
   #
-  # Converts full-color RGBA content to the limited palette of an E-Paper
-  # display using configurable dithering strategies. Supports single-buffer
+  # Converts full-color RGBA content (or one-byte {GrayCanvas} content) to
+  # the limited palette of an E-Paper display using configurable
+  # dithering strategies. Supports single-buffer
   # rendering via {#render} and dual-buffer rendering for tri-color displays
   # via {#render_dual}.
   #
@@ -16,21 +17,32 @@ module ChromaWave
   #   renderer = Renderer.new(pixel_format: PixelFormat::COLOR4, dither: :threshold)
   #   black_fb, red_fb = renderer.render_dual(canvas)
   class Renderer
-    attr_reader :pixel_format, :dither
+    # COLOR4 to MONO mappings of the black and red planes of a tri-color
+    # panel (yellow panels take the yellow plane as their red one).
+    BLACK_PLANE = { black: :black, white: :white, yellow: :white, red: :white }.freeze
+    RED_PLANE = { black: :white, white: :white, yellow: :black, red: :black }.freeze
+
+    attr_reader :pixel_format, :dither, :pool
 
     # Creates a new Renderer for the given pixel format and dither strategy.
     #
     # @param pixel_format [PixelFormat, Symbol] target pixel format
     # @param dither [Symbol] dithering strategy (:floyd_steinberg, :ordered, or :threshold)
+    # @param pool [FramebufferPool, nil] pool to rent output framebuffers
+    #   from instead of allocating them; the caller releases them
     # @raise [ArgumentError] if the dither strategy is not recognized
-    def initialize(pixel_format:, dither: :floyd_steinberg)
+    def initialize(pixel_format:, dither: :floyd_steinberg, pool: nil)
       @pixel_format = resolve_pixel_format(pixel_format)
       @strategy = Dither.resolve(dither, pixel_format: @pixel_format)
       @dither = dither
+      @pool = pool
     end
 
     # Renders a Canvas into a Framebuffer.
     #
+    # An {IndexedCanvas} on this renderer's pixel format is already
+    # quantized and is bit-packed directly, without dithering.
+    #
     # @param canvas [Canvas] source RGBA canvas
     # @param into [Framebuffer, nil] optional pre-allocated framebuffer to reuse
     # @return [Framebuffer] the rendered framebuffer
@@ -39,7 +51,11 @@ module ChromaWave
     def render(canvas, into: nil)
       validate_canvas!(canvas)
       framebuffer = prepare_framebuffer(canvas, into)
-      strategy.call(canvas, framebuffer)
+      if canvas.is_a?(IndexedCanvas) && canvas.pixel_format == pixel_format
+        canvas.to_framebuffer(into: framebuffer)
+      else
+        strategy.call(canvas, framebuffer)
+      end
       framebuffer
     end
 
@@ -47,11 +63,15 @@ module ChromaWave
     #
     # Tri-color E-Paper displays use separate black and red planes.
     # The canvas is first quantized to a COLOR4 framebuffer using the
-    # configured dither strategy, then each pixel is split into planes:
+    # configured dither strategy, then split natively into planes (see
+    # {BLACK_PLANE} and {RED_PLANE}):
     # - +:black+ -- black_fb=0, red_fb=1
     # - +:white+ -- black_fb=1, red_fb=1
     # - +:red+ or +:yellow+ -- black_fb=1, red_fb=0
     #
+    # With a {#pool}, the intermediate COLOR4 framebuffer goes back to
+    # it and both planes are rented from it.
+    #
     # @param canvas [Canvas] source RGBA canvas
     # @return [Array(Framebuffer, Framebuffer)] [black_fb, red_fb] both MONO format
     # @raise [ArgumentError] if pixel_format is not COLOR4
@@ -62,9 +82,11 @@ module ChromaWave
 
       # Quantize through the full dither pipeline first, then split
       color_fb = render(canvas)
-      black_fb = Framebuffer.new(canvas.width, canvas.height, PixelFormat::MONO)
-      red_fb   = Framebuffer.new(canvas.width, canvas.height, PixelFormat::MONO)
-      split_channels_from_fb(color_fb, black_fb, red_fb)
+      black_fb = new_framebuffer(canvas.width, canvas.height, PixelFormat::MONO)
+      red_fb   = new_framebuffer(canvas.width, canvas.height, PixelFormat::MONO)
+      color_fb.convert(PixelFormat::MONO, mapping: BLACK_PLANE, into: black_fb)
+      color_fb.convert(PixelFormat::MONO, mapping: RED_PLANE, into: red_fb)
+      pool&.release(color_fb)
       [black_fb, red_fb]
     end
 
@@ -94,6 +116,14 @@ module ChromaWave
       raise TypeError, "expected Canvas, got #{canvas.class}"
     end
 
+    # Rents an output framebuffer from the pool, or allocates one. Every
+    # pixel is written by rendering, so it is not cleared first.
+    #
+    # @return [Framebuffer]
+    def new_framebuffer(width, height, format)
+      pool ? pool.rent(width, height, format) : Framebuffer.new(width, height, format, clear: false)
+    end
+
     # Prepares a Framebuffer for rendering, either reusing +into+ or allocating a new one.
     #
     # @param canvas [Canvas] source canvas for dimensions
@@ -101,7 +131,7 @@ module ChromaWave
     # @return [Framebuffer]
     # @raise [ArgumentError] if +into+ dimensions do not match the canvas
     def prepare_framebuffer(canvas, into)
-      return Framebuffer.new(canvas.width, canvas.height, pixel_format) if into.nil?
+      return new_framebuffer(canvas.width, canvas.height, pixel_format) if into.nil?
 
       unless into.width == canvas.width && into.height == canvas.height
         raise ArgumentError,
@@ -117,47 +147,5 @@ module ChromaWave
 
       into
     end
-
-    # Splits a pre-quantized COLOR4 Framebuffer into two MONO planes.
-    #
-    # Reads each pixel's palette name from the quantized framebuffer
-    # and routes it to the appropriate MONO plane:
-    # - +:black+ -- black plane gets 0 (black), red plane gets 1 (white)
-    # - +:white+ -- black plane gets 1 (white), red plane gets 1 (white)
-    # - +:red+ or +:yellow+ -- black plane gets 1 (white), red plane gets 0 (black)
-    #
-    # @param color_fb [Framebuffer] COLOR4 framebuffer (already quantized)
-    # @param black_fb [Framebuffer] MONO framebuffer for the black plane
-    # @param red_fb [Framebuffer] MONO framebuffer for the red plane
-    def split_channels_from_fb(color_fb, black_fb, red_fb)
-      color_fb.height.times do |y|
-        color_fb.width.times do |x|
-          route_dual_pixel(color_fb.get_pixel(x, y), black_fb, red_fb, x, y)
-        end
-      end
-    end
-
-    # Routes a single quantized pixel to the appropriate dual-buffer planes.
-    #
-    # @param name [Symbol] the quantized palette color name
-    # @param black_fb [Framebuffer] black plane framebuffer
-    # @param red_fb [Framebuffer] red plane framebuffer
-    # @param x [Integer] pixel x coordinate
-    # @param y [Integer] pixel y coordinate
-    def route_dual_pixel(name, black_fb, red_fb, x, y)
-      case name
-      when :black
-        black_fb.set_pixel(x, y, :black)
-        red_fb.set_pixel(x, y, :white)
-      when :white
-        black_fb.set_pixel(x, y, :white)
-        red_fb.set_pixel(x, y, :white)
-      when :red, :yellow
-        black_fb.set_pixel(x, y, :white)
-        red_fb.set_pixel(x, y, :black)
-      else
-        raise ArgumentError, "unexpected COLOR4 palette color: #{name.inspect}"
-      end
-    end
   end
 end
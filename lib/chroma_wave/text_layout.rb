@@ -0,0 +1,137 @@
+# frozen_string_literal: true
+
+module ChromaWave
+  # A laid-out block of text: wrapped lines, their offsets, and the
+  # positioned glyphs of each line, ready to composite.
+  #
+  # Layouts are produced by {Drawing::Text#draw_text} and memoized in a
+  # process-wide bounded cache keyed by font face and size, string,
+  # +max_width+, +align+, and +line_spacing+. Dashboards that redraw the
+  # same labels every refresh skip word wrapping, measurement, and glyph
+  # rasterization on a hit. {Font#measure} shares the same cache.
+  #
+  # @example Inspect cache effectiveness
+  #   ChromaWave::TextLayout.cache_stats
+  #   #=> { hits: 412, misses: 18, size: 18, capacity: 512, hit_rate: 0.958 }
+  class TextLayout
+    # One wrapped line: offset from the draw origin and its glyphs, each
+    # in the shape yielded by {Font#each_glyph} (relative to the line).
+    Line = Data.define(:text, :x, :y, :glyphs)
+
+    # Bounded, thread-safe LRU cache with hit/miss counters.
+    #
+    # Eviction follows {Palette::LruCache}, but values are computed
+    # outside the lock so a computation may itself consult the cache
+    # (layout building calls {Font#measure}).
+    class Cache
+      # Default maximum number of cached entries.
+      DEFAULT_CAPACITY = 512
+
+      attr_reader :capacity
+
+      # @param capacity [Integer] maximum entries before eviction
+      def initialize(capacity: DEFAULT_CAPACITY)
+        @capacity = capacity
+        @store = {}
+        @hits = 0
+        @misses = 0
+        @mutex = Mutex.new
+      end
+
+      # Fetches the value for +key+, or computes and stores it via the block.
+      #
+      # @param key [Object] the cache key
+      # @yield computes the value on cache miss
+      # @return [Object] the cached or computed value
+      def fetch(key)
+        hit = @mutex.synchronize do
+          if @store.key?(key)
+            @hits += 1
+            value = @store.delete(key)
+            @store[key] = value
+            next [value]
+          end
+          @misses += 1
+          nil
+        end
+        return hit.first if hit
+
+        value = yield
+        @mutex.synchronize do
+          @store[key] = value
+          @store.shift while @store.size > capacity
+        end
+        value
+      end
+
+      # Returns the number of cached entries.
+      #
+      # @return [Integer]
+      def size
+        @mutex.synchronize { @store.size }
+      end
+
+      # Empties the cache and resets the counters.
+      #
+      # @return [void]
+      def clear
+        @mutex.synchronize do
+          @store.clear
+          @hits = @misses = 0
+        end
+      end
+
+      # Returns hit/miss counters and the hit rate since the last {#clear}.
+      #
+      # @return [Hash{Symbol => Numeric}]
+      def stats
+        @mutex.synchronize do
+          lookups = @hits + @misses
+          { hits: @hits, misses: @misses, size: @store.size, capacity: capacity,
+            hit_rate: lookups.zero? ? 0.0 : @hits.fdiv(lookups) }
+        end
+      end
+    end
+
+    CACHE = Cache.new
+    private_constant :CACHE
+
+    attr_reader :lines
+
+    # @param lines [Array<Line>] laid-out lines
+    def initialize(lines:)
+      @lines = lines.freeze
+      freeze
+    end
+
+    # Returns the process-wide layout cache.
+    #
+    # @return [Cache]
+    def self.cache
+      CACHE
+    end
+
+    # Returns layout cache counters and hit rate.
+    #
+    # @return [Hash{Symbol => Numeric}]
+    def self.cache_stats
+      CACHE.stats
+    end
+
+    # Empties the layout cache and resets its counters.
+    #
+    # @return [void]
+    def self.clear_cache!
+      CACHE.clear
+    end
+
+    # Returns the cache identity of a font: face and size when the font
+    # exposes them, otherwise the font object itself.
+    #
+    # @param font [#cache_key, Object]
+    # @return [Object]
+    def self.font_key(font)
+      font.respond_to?(:cache_key) ? font.cache_key : font
+    end
+  end
+end
@@ -0,0 +1,108 @@
+# frozen_string_literal: true
+
+require 'tmpdir'
+
+RSpec.describe ChromaWave::BitmapFont do
+  let(:source) { File.join(ChromaWave::Font::DATA_DIR, 'fonts', 'dejavu-sans.ttf') }
+  let(:black) { ChromaWave::Color::BLACK }
+  let(:white) { ChromaWave::Color::WHITE }
+
+  describe '.bake and .load' do
+    let(:path) { File.join(Dir.mktmpdir, 'dejavu.cwbf') }
+
+    before { described_class.bake(source, path: path, sizes: [12, 16]) }
+
+    it 'selects the first strike by default' do
+      expect(described_class.load(path).size).to eq(12)
+    end
+
+    it 'selects a strike by size' do
+      font = described_class.load(path, size: 16)
+      ft = ChromaWave::Font.new(source, size: 16)
+      expect([font.line_height, font.ascent, font.descent]).to eq([ft.line_height, ft.ascent, ft.descent])
+    end
+
+    it 'raises for a missing strike' do
+      expect { described_class.load(path, size: 20) }.to raise_error(ArgumentError, /no 20px strike/)
+    end
+
+    it 'yields the same glyphs as the FreeType font' do
+      font = described_class.load(path, size: 16)
+      ft = ChromaWave::Font.new(source, size: 16)
+      expect(font.each_glyph('Hello').to_a).to eq(ft.each_glyph('Hello').to_a)
+    end
+
+    it 'draws text identically to the FreeType font' do
+      baked = ChromaWave::Canvas.new(width: 80, height: 24, background: white)
+      reference = ChromaWave::Canvas.new(width: 80, height: 24, background: white)
+      baked.draw_text('Hello', x: 2, y: 2, font: described_class.load(path, size: 16), color: black)
+      reference.draw_text('Hello', x: 2, y: 2, font: ChromaWave::Font.new(source, size: 16), color: black)
+      expect(baked.rgba_bytes).to eq(reference.rgba_bytes)
+    end
+
+    it 'applies stored kerning in measure' do
+      font = described_class.load(path, size: 16)
+      plain = font.glyph('A'.ord).advance + font.glyph('V'.ord).advance
+      expect(font.measure('AV').width).to eq(plain + font.kerning('A'.ord, 'V'.ord))
+      expect(font.kerning('A'.ord, 'V'.ord)).to be_negative
+    end
+
+    it 'falls back to .notdef for codepoints outside the baked ranges' do
+      font = described_class.load(path, size: 16)
+      expect(font.include_codepoint?(0x263A)).to be(false)
+      expect(font.glyph(0x263A).codepoint).to eq(described_class::NOTDEF)
+      expect(font.measure("☺").width).to be_positive
+    end
+
+    it 'returns frozen bitmaps sliced from the file' do
+      expect(described_class.load(path).glyph('H'.ord).bitmap).to be_frozen
+    end
+
+    it 'rejects files that are not baked fonts' do
+      File.binwrite(path, 'not a font')
+      expect { described_class.load(path) }.to raise_error(ArgumentError, /not a baked bitmap font/)
+    end
+
+    it 'rejects a truncated strike directory' do
+      File.binwrite(path, File.binread(path)[0, described_class::HEADER_SIZE + 10])
+      expect { described_class.load(path) }.to raise_error(ArgumentError, /strike directory outside the file/)
+    end
+
+    it 'rejects tables outside the file' do
+      data = File.binread(path)
+      data[described_class::HEADER_SIZE + 16, 4] = [data.bytesize].pack('L<')
+      File.binwrite(path, data)
+      expect { described_class.load(path) }.to raise_error(ArgumentError, /glyph table outside the file/)
+    end
+
+    it 'picks up a rebaked file at the same path' do
+      described_class.load(path)
+      described_class.bake(source, path: path, sizes: [20])
+      expect(described_class.load(path).size).to eq(20)
+    end
+  end
+
+  describe '.builtin' do
+    it 'loads each vendored Waveshare font' do
+      described_class::BUILTIN.each do |name|
+        font = described_class.builtin(name)
+        expect(font.glyph('A'.ord).height).to eq(font.size)
+      end
+    end
+
+    it 'is fixed-width' do
+      font = described_class.builtin(:font12)
+      expect(font.measure('iiii').width).to eq(font.measure('WWWW').width)
+    end
+
+    it 'draws onto a canvas' do
+      canvas = ChromaWave::Canvas.new(width: 40, height: 16, background: white)
+      canvas.draw_text('Hi', x: 0, y: 0, font: described_class.builtin(:font16), color: black)
+      expect(canvas.rgba_bytes.unpack('C*').each_slice(4).count { |px| px == [0, 0, 0, 255] }).to be_positive
+    end
+
+    it 'rejects unknown names' do
+      expect { described_class.builtin(:font99) }.to raise_error(ArgumentError, /unknown built-in font/)
+    end
+  end
+end
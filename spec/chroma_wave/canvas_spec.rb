@@ -144,6 +144,47 @@ RSpec.describe ChromaWave::Canvas do
     end
   end
 
+  describe '#with_rgba_buffer' do
+    subject(:canvas) { described_class.new(width: 2, height: 2, background: red) }
+
+    it 'yields the live buffer without copying' do
+      canvas.with_rgba_buffer do |bytes|
+        expect(bytes).to equal(canvas.send(:buffer))
+        expect(bytes.to_s).to eq(canvas.rgba_bytes)
+      end
+    end
+
+    it 'returns the block result' do
+      expect(canvas.with_rgba_buffer(&:bytesize)).to eq(16)
+    end
+
+    it 'rejects writes while borrowed and releases the lock afterwards' do
+      canvas.with_rgba_buffer do |bytes|
+        expect { canvas.set_pixel(0, 0, black) }.to raise_error(RuntimeError)
+        expect { bytes.setbyte(0, 0) }.to raise_error(RuntimeError)
+        canvas.with_rgba_buffer { |inner| expect(inner).to equal(bytes) }
+      end
+      expect { canvas.with_rgba_buffer { raise 'boom' } }.to raise_error('boom')
+
+      expect(canvas.set_pixel(0, 0, black).get_pixel(0, 0)).to eq(black)
+    end
+  end
+
+  describe '.from_rgba_bytes' do
+    it 'loads the bytes as the pixels' do
+      bytes = (red.to_rgba_bytes * 6).freeze
+      canvas = described_class.from_rgba_bytes(bytes, width: 3, height: 2)
+
+      expect(canvas).to eq(described_class.new(width: 3, height: 2, background: red))
+      expect(canvas.set_pixel(0, 0, black).get_pixel(0, 0)).to eq(black)
+    end
+
+    it 'raises ArgumentError for a size mismatch' do
+      expect { described_class.from_rgba_bytes("\x00".b * 15, width: 2, height: 2) }
+        .to raise_error(ArgumentError, /expected 16 bytes/)
+    end
+  end
+
   describe '#blit with alpha compositing' do
     subject(:canvas) { described_class.new(width: 10, height: 10, background: white) }
 
@@ -190,6 +231,61 @@ RSpec.describe ChromaWave::Canvas do
       src = described_class.new(width: 1, height: 1, background: red)
       expect(canvas.blit(src, x: 0, y: 0)).to equal(canvas)
     end
+
+    it 'blits a canvas onto itself' do
+      canvas.set_pixel(0, 0, red)
+      canvas.blit(canvas, x: 1, y: 0)
+      expect(canvas.get_pixel(1, 0)).to eq(red)
+      expect(canvas.get_pixel(2, 0)).to eq(white)
+    end
+  end
+
+  describe 'SIMD blend kernels' do
+    let(:rng) { Random.new(42) }
+
+    # Random RGBA with runs of fully transparent / fully opaque pixels so
+    # every kernel fast path and the scalar tail are exercised.
+    def random_canvas(width, height)
+      bytes = Array.new(width * height) do |i|
+        alpha = case (i / 7) % 3
+                when 0 then rng.rand(256)
+                when 1 then 0
+                else 255
+                end
+        [rng.rand(256), rng.rand(256), rng.rand(256), alpha]
+      end.flatten.pack('C*')
+      described_class.new(width: width, height: height).load_rgba_bytes(bytes, width: width, height: height, x: 0, y: 0)
+    end
+
+    def composite_with(backend, dst, src, mask)
+      ChromaWave::Native.simd_backend = backend
+      out = dst.dup
+      out.blit(src, x: -3, y: 2)
+      out.blit_glyph(mask, x: 5, y: -1, width: 29, height: 11, color: ChromaWave::Color.new(r: 200, g: 30, b: 90))
+      out.rgba_bytes
+    ensure
+      ChromaWave::Native.simd_backend = ChromaWave::Native.simd_backends.first
+    end
+
+    it 'produces identical results on every backend' do
+      dst = random_canvas(33, 17)
+      src = random_canvas(37, 13)
+      mask = Array.new(29 * 11) { |i| i % 5 == 1 ? [0, 255].sample(random: rng) : rng.rand(256) }.pack('C*')
+
+      reference = composite_with(:scalar, dst, src, mask)
+      ChromaWave::Native.simd_backends.each do |backend|
+        expect(composite_with(backend, dst, src, mask)).to eq(reference)
+      end
+    end
+
+    it 'rejects unsupported backends' do
+      expect { ChromaWave::Native.simd_backend = :mmx }.to raise_error(ArgumentError, /unsupported SIMD backend/)
+    end
+
+    it 'always offers the scalar fallback' do
+      expect(ChromaWave::Native.simd_backends.last).to eq(:scalar)
+      expect(ChromaWave::Native.simd_backends).to include(ChromaWave::Native.simd_backend)
+    end
   end
 
   describe '#load_rgba_bytes' do
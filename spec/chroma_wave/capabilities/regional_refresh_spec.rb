@@ -93,6 +93,21 @@ RSpec.describe ChromaWave::Capabilities::RegionalRefresh do
     end
   end
 
+  context 'with a rotated display' do
+    let(:display) { ChromaWave::MockDevice.new(model: :epd_2in7_v2, rotation: 90) }
+    let(:fb) { ChromaWave::Framebuffer.new(display.width, display.height, display.pixel_format) }
+
+    after { display.close }
+
+    it 'maps the region onto the panel before aligning it' do
+      # 176x264 panel drawn as 264x176: rows 10...30 become panel x 146...166
+      display.display_region(fb, x: 40, y: 10, width: 50, height: 20)
+
+      expect(display.last_operation.slice(:x, :y, :width, :height)).to eq(x: 144, y: 40, width: 24, height: 50)
+      expect(display.last_framebuffer.width).to eq(176)
+    end
+  end
+
   describe '#align_x_to_byte_boundary (via display_region)' do
     let(:model) { find_regional_model }
     let(:display) { ChromaWave::MockDevice.new(model: model) }
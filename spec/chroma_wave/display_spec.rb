@@ -36,6 +36,12 @@ RSpec.describe ChromaWave::Display do
       display.close
     end
 
+    it 'swaps width and height for a quarter-turn rotation' do
+      display = described_class.new(model: model, rotation: 90)
+      expect([display.width, display.height, display.rotation]).to eq([config[:height], config[:width], 90])
+      display.close
+    end
+
     it 'accepts a string model name' do
       display = described_class.new(model: 'epd_2in13_v4')
       expect(display.model).to eq(:epd_2in13_v4)
@@ -374,6 +374,57 @@ RSpec.describe ChromaWave::Drawing::Primitives do
     end
   end
 
+  describe '#set_pixels' do
+    it 'sets points from Arrays or packed int16, skipping those outside' do
+      canvas.set_pixels([1, 19, -1, 25], [2, 19, 3, 0], red)
+      canvas.set_pixels([3].pack('s<*'), [4].pack('s<*'), blue)
+
+      expect([canvas.get_pixel(1, 2), canvas.get_pixel(19, 19), canvas.get_pixel(3, 4)]).to eq([red, red, blue])
+    end
+
+    it 'matches the Ruby path, through layers too' do
+      rng = Random.new(3)
+      xs = Array.new(200) { rng.rand(-5..40) }
+      ys = Array.new(200) { rng.rand(-5..25) }
+      fb = ChromaWave::Framebuffer.new(37, 23, :gray4)
+      reference = fb.dup
+      reference.define_singleton_method(:native_raster_window) { |*| false }
+      [fb, reference].each do |surface|
+        ChromaWave::Layer.new(parent: surface, x: 3, y: 2, width: 30, height: 15).set_pixels(xs, ys, :light_gray)
+      end
+
+      expect(fb).to eq(reference)
+    end
+
+    it 'rejects lists of different lengths' do
+      expect { canvas.set_pixels([1, 2], [1], red) }.to raise_error(ArgumentError, /2 x and 1 y/)
+      expect { canvas.set_pixels("\x01", "\x01", red) }.to raise_error(ArgumentError, /2-byte/)
+    end
+  end
+
+  describe '#set_pixel_runs' do
+    it 'sets clipped horizontal runs from triples or packed int16' do
+      canvas.set_pixel_runs([[18, 1, 5], [0, 2, 0]], red)
+      canvas.set_pixel_runs([-2, 3, 4].pack('s<*'), blue)
+
+      expect((17..19).map { |x| canvas.get_pixel(x, 1) }).to eq([white, red, red])
+      expect([canvas.get_pixel(0, 2), canvas.get_pixel(1, 3), canvas.get_pixel(2, 3)]).to eq([white, blue, white])
+    end
+
+    it 'matches the Ruby path on a Framebuffer' do
+      runs = Array.new(50) { |i| [(i * 7 % 50) - 8, i % 25, (i * 3 % 20) - 2] }
+      fb = ChromaWave::Framebuffer.new(37, 23, :mono)
+      reference = fb.dup
+      reference.define_singleton_method(:native_raster) { |*| false }
+
+      expect(fb.set_pixel_runs(runs.flatten.pack('s<*'), :black)).to eq(reference.set_pixel_runs(runs, :black))
+    end
+
+    it 'rejects packed Strings of partial triples' do
+      expect { canvas.set_pixel_runs([1, 2].pack('s<*'), red) }.to raise_error(ArgumentError, /6-byte/)
+    end
+  end
+
   describe 'works on Framebuffer' do
     let(:fb) { ChromaWave::Framebuffer.new(20, 20, :mono) }
 
@@ -411,6 +462,91 @@ RSpec.describe ChromaWave::Drawing::Primitives do
     end
   end
 
+  describe 'native span rasterizer' do
+    # Draws the same pseudo-random scene for a given seed. Shapes sit
+    # partly off-surface so span clipping and packed-byte head/tail masks
+    # are exercised.
+    def draw_scene(surface, colors, seed)
+      rng = Random.new(seed)
+      c = -> { colors.sample(random: rng) }
+      r = ->(range) { rng.rand(range) }
+      12.times do
+        surface.draw_line(r[-10..45], r[-10..30], r[-10..45], r[-10..30], pen: pen_class.stroke(c[], width: r[1..4]))
+        surface.draw_rect(r[-5..35], r[-5..20], r[1..20], r[1..12], pen: pen_class.new(stroke: c[], fill: c[]))
+        surface.draw_rounded_rect(r[-5..30], r[-5..18], r[4..20], r[4..12], radius: r[0..5],
+                                                                            pen: pen_class.new(fill: c[], stroke: c[]))
+        surface.draw_circle(r[-5..40], r[-5..25], r[1..12], pen: pen_class.new(fill: c[], stroke: c[]))
+        surface.draw_circle(r[-5..40], r[-5..25], r[3..12], pen: pen_class.stroke(c[], width: r[2..4]))
+        surface.draw_ellipse(r[-5..40], r[-5..25], r[0..15], r[0..9], pen: pen_class.new(fill: c[], stroke: c[]))
+        surface.draw_ellipse(r[-5..40], r[-5..25], r[2..15], r[2..9], pen: pen_class.stroke(c[], width: r[2..4]))
+        surface.draw_arc(r[0..36], r[0..22], r[2..10], rng.rand(-7.0..7.0), rng.rand(-7.0..7.0),
+                         pen: pen_class.stroke(c[], width: r[1..3]))
+        points = Array.new(r[3..7]) { [r[-8..45], r[-8..30]] }
+        surface.draw_polygon(points, pen: pen_class.new(fill: c[], stroke: c[]))
+      end
+      6.times { surface.flood_fill(r[0..36], r[0..22], color: c[]) }
+      surface
+    end
+
+    # Returns the surface drawn natively and a copy drawn in pure Ruby.
+    def both_paths(surface, colors)
+      reference = surface.dup
+      reference.define_singleton_method(:native_raster) { |*| false }
+      [draw_scene(surface, colors, 7), draw_scene(reference, colors, 7)]
+    end
+
+    it 'matches the Ruby path on Canvas' do
+      native, reference = both_paths(ChromaWave::Canvas.new(width: 37, height: 23), [red, blue, green, black])
+      expect(native.rgba_bytes).to eq(reference.rgba_bytes)
+    end
+
+    %i[mono gray4 color4 color7].each do |format|
+      it "matches the Ruby path on a #{format} Framebuffer" do
+        fb = ChromaWave::Framebuffer.new(37, 23, format)
+        native, reference = both_paths(fb, fb.pixel_format.palette.to_a)
+        expect(native.bytes).to eq(reference.bytes)
+      end
+    end
+
+    it 'clips huge shapes before iterating, on both paths' do
+      draw = lambda do |surface|
+        surface.draw_ellipse(18, -999_990, 30, 1_000_000, pen: pen_class.stroke(green, width: 2))
+        surface.draw_circle(-999_980, 11, 1_000_000, pen: pen_class.stroke(black, width: 3))
+        surface.draw_line(-3_000_000, -1_000_000, 3_000_000, 1_000_000, pen: pen_class.stroke(blue, width: 2))
+        surface.draw_line(-5_000_000, 25, 5_000_000, -15, pen: pen_class.stroke(green))
+        surface.draw_ellipse(18, 11, 1_000_000, 12, pen: pen_class.new(fill: red, stroke: blue))
+      end
+      native = ChromaWave::Canvas.new(width: 37, height: 23)
+      reference = native.dup
+      reference.define_singleton_method(:native_raster) { |*| false }
+
+      elapsed = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+      draw[native]
+      draw[reference]
+      elapsed = Process.clock_gettime(Process::CLOCK_MONOTONIC) - elapsed
+
+      expect(native.rgba_bytes).to eq(reference.rgba_bytes)
+      expect(native.get_pixel(18, 11)).to eq(red)
+      expect(elapsed).to be < 1.0
+    end
+
+    it 'flood-fills a large region natively' do
+      fb = ChromaWave::Framebuffer.new(400, 300, :gray4).clear(:white)
+      fb.draw_circle(200, 150, 100, pen: pen_class.stroke(:black, width: 3))
+      fb.flood_fill(200, 150, color: :dark_gray)
+
+      expect(fb.get_pixel(200, 150)).to eq(:dark_gray)
+      expect(fb.get_pixel(120, 150)).to eq(:dark_gray)
+      expect(fb.get_pixel(5, 5)).to eq(:white)
+      expect(fb.get_pixel(200, 49)).to eq(:black)
+    end
+
+    it 'falls back to Ruby for non-Integer coordinates' do
+      canvas.draw_polygon([[1, 1], [8.0, 1], [4, 6]], pen: pen_class.fill(red))
+      expect(canvas.get_pixel(4, 3)).to eq(red)
+    end
+  end
+
   describe 'chaining multiple primitives' do
     it 'allows method chaining' do
       result = canvas
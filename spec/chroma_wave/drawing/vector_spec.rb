@@ -0,0 +1,139 @@
+# frozen_string_literal: true
+
+RSpec.describe ChromaWave::Drawing::Vector do
+  let(:white) { ChromaWave::Color::WHITE }
+  let(:black) { ChromaWave::Color::BLACK }
+  let(:red)   { ChromaWave::Color::RED }
+  let(:pen_class)  { ChromaWave::Pen }
+  let(:path_class) { ChromaWave::Path }
+  let(:canvas) { ChromaWave::Canvas.new(width: 40, height: 30, background: white) }
+
+  # Sum of coverage (0..1) over a rasterized mask.
+  def coverage_area(path, stroke = nil)
+    mask, = ChromaWave::Native.rasterize_path(path.native_contours, 200, 200, 255, stroke)
+    mask.bytes.sum / 255.0
+  end
+
+  describe '#draw_path fill' do
+    it 'covers pixel-aligned rectangles exactly' do
+      canvas.draw_path(path_class.rect(2, 3, 5, 4), pen: pen_class.fill(red))
+
+      expect(canvas.get_pixel(2, 3)).to eq(red)
+      expect(canvas.get_pixel(6, 6)).to eq(red)
+      expect(canvas.get_pixel(7, 6)).to eq(white)
+      expect(canvas.get_pixel(6, 7)).to eq(white)
+    end
+
+    it 'blends partially covered edge pixels' do
+      canvas.draw_path(path_class.rect(2.5, 3, 4, 4), pen: pen_class.fill(black))
+      expect(canvas.get_pixel(2, 4).r).to be_within(1).of(128)
+    end
+
+    it 'conserves the area of the flattened shape' do
+      circle = path_class.circle(100, 100, 40)
+      pts = circle.contours.first.points.each_slice(2).to_a
+      area = pts.zip(pts.rotate).sum { |(ax, ay), (bx, by)| (ax * by) - (bx * ay) }.abs / 2
+
+      expect(coverage_area(circle)).to be_within(0.5).of(area)
+      expect(area).to be_within(0.5 * Math::PI * 80).of(Math::PI * 1600)
+    end
+
+    it 'cuts holes with contours of opposite direction' do
+      ring = path_class.polygon([[0, 0], [20, 0], [20, 20], [0, 20]])
+      ring.move_to(5, 5).line_to(5, 15).line_to(15, 15).line_to(15, 5).close
+      canvas.draw_path(ring, pen: pen_class.fill(red))
+
+      expect(canvas.get_pixel(2, 10)).to eq(red)
+      expect(canvas.get_pixel(10, 10)).to eq(white)
+    end
+
+    it 'scales coverage by color alpha' do
+      canvas.draw_path(path_class.rect(0, 0, 4, 4), pen: pen_class.fill(ChromaWave::Color.new(r: 0, g: 0, b: 0, a: 51)))
+      expect(canvas.get_pixel(1, 1).r).to eq(204)
+    end
+
+    it 'clips shapes extending past the surface' do
+      canvas.draw_path(path_class.circle(-5, 35, 20), pen: pen_class.fill(red))
+      expect(canvas.get_pixel(0, 29)).to eq(red)
+    end
+
+    it 'skips shapes beyond the range of an int' do
+      [3e9, 2_147_483_700.0, -3e9].each do |at|
+        far = path_class.rect(at, at, 10, 10)
+        expect(ChromaWave::Native.rasterize_path(far.native_contours, 50, 50, 255, nil)).to be_nil
+      end
+    end
+
+    it 'clips shapes reaching in from beyond the range of an int' do
+      canvas.draw_path(path_class.polygon([[-3e9, 0], [20, 0], [20, 3e9]]), pen: pen_class.fill(red))
+      expect(canvas.get_pixel(19, 1)).to eq(red)
+    end
+
+    it 'requires packed coordinate strings' do
+      coords = Object.new
+      def coords.to_str = [0.0, 0.0, 9.0, 0.0, 9.0, 9.0].pack('d*')
+      expect { ChromaWave::Native.rasterize_path([[coords, true]], 50, 50, 255, nil) }.to raise_error(TypeError)
+    end
+  end
+
+  describe '#draw_path stroke' do
+    it 'covers a row with a 1px line along its center' do
+      canvas.draw_path(path_class.line(2, 5.5, 20, 5.5), pen: pen_class.stroke(black))
+
+      expect(canvas.get_pixel(10, 5)).to eq(black)
+      expect(canvas.get_pixel(10, 4)).to eq(white)
+      expect(canvas.get_pixel(10, 6)).to eq(white)
+    end
+
+    it 'has the area of a width x length rectangle with butt caps' do
+      expect(coverage_area(path_class.line(20, 50, 120, 50), [4, 0, 0])).to be_within(0.5).of(400)
+    end
+
+    it 'extends square caps by half the width' do
+      expect(coverage_area(path_class.line(20, 50, 120, 50), [4, 0, 2])).to be_within(0.5).of(416)
+    end
+
+    it 'adds a half disc per end with round caps' do
+      # Discs are flattened too, so allow for the inscribed polygon
+      expect(coverage_area(path_class.line(20, 50, 120, 50), [4, 0, 1])).to be_within(1).of(400 + (Math::PI * 4))
+    end
+
+    it 'fills the outer corner with a miter join but not a bevel join' do
+      corner = path_class.polyline([[5, 20], [20, 20], [20, 5]])
+      miter = ChromaWave::Canvas.new(width: 30, height: 30).draw_path(corner, pen: pen_class.stroke(black, width: 4),
+                                                                             join: :miter)
+      bevel = ChromaWave::Canvas.new(width: 30, height: 30).draw_path(corner, pen: pen_class.stroke(black, width: 4),
+                                                                             join: :bevel)
+
+      expect(miter.get_pixel(21, 21)).to eq(black)
+      expect(bevel.get_pixel(21, 21).r).to be > 100
+    end
+
+    it 'draws fill and stroke together' do
+      canvas.draw_path(path_class.rect(5, 5, 10, 10), pen: pen_class.new(fill: red, stroke: black, stroke_width: 2))
+
+      expect(canvas.get_pixel(10, 10)).to eq(red)
+      expect(canvas.get_pixel(5, 10)).to eq(black)
+    end
+
+    it 'rejects unknown joins and caps' do
+      line = path_class.line(0, 0, 5, 5)
+      expect { canvas.draw_path(line, pen: pen_class.stroke(black), join: :sharp) }.to raise_error(ArgumentError)
+      expect { canvas.draw_path(line, pen: pen_class.stroke(black), cap: :flat) }.to raise_error(ArgumentError)
+    end
+  end
+
+  it 'draws translated and clipped on a Layer' do
+    layer = canvas.layer(x: 10, y: 10, width: 10, height: 10)
+    layer.draw_path(path_class.rect(-5, -5, 30, 30), pen: pen_class.fill(red))
+
+    expect(canvas.get_pixel(10, 10)).to eq(red)
+    expect(canvas.get_pixel(19, 19)).to eq(red)
+    expect(canvas.get_pixel(9, 10)).to eq(white)
+    expect(canvas.get_pixel(20, 19)).to eq(white)
+  end
+
+  it 'returns self for an empty path' do
+    expect(canvas.draw_path(path_class.new, pen: pen_class.fill(red))).to equal(canvas)
+  end
+end
@@ -70,6 +70,14 @@ RSpec.describe ChromaWave::DriverExtraction::SourceParser do
       end
     end
 
+    context 'with EPD_7in3g (4-color gate driver)' do
+      subject(:config) { parse_vendor('EPD_7in3g') }
+
+      it 'detects the packed 2bpp 4-color format from the g suffix' do
+        expect(config.pixel_format).to eq(:color4_2bpp)
+      end
+    end
+
     context 'with EPD_5in65f (color7, tier2 explicit)' do
       subject(:config) { parse_vendor('EPD_5in65f') }
 
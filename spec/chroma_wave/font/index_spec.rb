@@ -0,0 +1,105 @@
+# frozen_string_literal: true
+
+require 'tmpdir'
+
+RSpec.describe ChromaWave::Font::Index do
+  let(:root) { Dir.mktmpdir }
+  let(:index_path) { File.join(Dir.mktmpdir, 'nested', 'font-index.json') }
+
+  def touch_font(relative)
+    path = File.join(root, relative)
+    FileUtils.mkdir_p(File.dirname(path))
+    File.binwrite(path, 'ttf')
+    path
+  end
+
+  def build
+    described_class.build(roots: [root], path: index_path)
+  end
+
+  before do
+    touch_font('TTF/DejaVuSans.ttf')
+    touch_font('TTF/DejaVuSans-Bold.ttf')
+    touch_font('noto/NotoSerif.TTF')
+    touch_font('noto/readme.txt')
+    touch_font('.hidden/Secret.ttf')
+  end
+
+  describe '.build' do
+    it 'indexes TrueType files recursively, skipping hidden entries' do
+      expect(build.candidates.map(&:first)).to contain_exactly('dejavusansbold', 'dejavusans', 'notoserif')
+    end
+
+    it 'persists the index and reuses unchanged directories' do
+      expect(build.rescanned).to contain_exactly(root, File.join(root, 'TTF'), File.join(root, 'noto'))
+      expect(File.exist?(index_path)).to be(true)
+      expect(build.rescanned).to be_empty
+    end
+
+    it 'stores only file names, since invalidation is per directory' do
+      build
+      record = JSON.parse(File.read(index_path)).dig('dirs', File.join(root, 'noto'))
+      expect(record['fonts']).to eq(['NotoSerif.TTF'])
+    end
+
+    it 'rescans only directories whose mtime changed' do
+      build
+      added = touch_font('noto/NotoSans.ttf')
+      File.utime(Time.now + 5, Time.now + 5, File.dirname(added))
+
+      index = build
+      expect(index.rescanned).to eq([File.join(root, 'noto')])
+      expect(index.lookup('Noto Sans')).to eq(added)
+    end
+
+    it 'picks up new subdirectories' do
+      build
+      added = touch_font('extra/Inter.ttf')
+      File.utime(Time.now + 5, Time.now + 5, root)
+
+      expect(build.lookup('inter')).to eq(added)
+    end
+
+    it 'drops removed directories' do
+      build
+      FileUtils.rm_rf(File.join(root, 'noto'))
+      File.utime(Time.now + 5, Time.now + 5, root)
+
+      expect(build.lookup('notoserif')).to be_nil
+    end
+
+    it 'rebuilds from scratch when the index file is corrupt' do
+      build
+      File.write(index_path, '{not json')
+      expect(build.rescanned.size).to eq(3)
+    end
+
+    it 'works without persistence' do
+      expect(described_class.build(roots: [root]).size).to eq(3)
+    end
+
+    it 'ignores missing roots' do
+      expect(described_class.build(roots: [File.join(root, 'missing'), root]).size).to eq(3)
+    end
+  end
+
+  describe '#lookup' do
+    subject(:index) { build }
+
+    it 'prefers an exact normalized match' do
+      expect(index.lookup('DejaVu Sans')).to end_with('TTF/DejaVuSans.ttf')
+    end
+
+    it 'falls back to a partial match' do
+      expect(index.lookup('serif')).to end_with('noto/NotoSerif.TTF')
+    end
+
+    it 'returns nil for unknown names' do
+      expect(index.lookup('Comic Sans')).to be_nil
+    end
+  end
+
+  it 'is frozen' do
+    expect(build).to be_frozen
+  end
+end
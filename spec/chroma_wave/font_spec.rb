@@ -60,16 +60,17 @@ RSpec.describe ChromaWave::Font do
   describe 'font discovery cache immutability' do
     before { described_class.clear_font_cache! }
 
-    it 'freezes the outer candidates array' do
+    it 'freezes the cached index' do
       described_class.new('dejavu-sans', size: 16)
       cache = described_class.instance_variable_get(:@font_cache)
       expect(cache).to be_frozen
     end
 
-    it 'freezes each inner [stem, path] pair' do
+    it 'freezes each [stem, path] candidate pair' do
       described_class.new('dejavu-sans', size: 16)
       cache = described_class.instance_variable_get(:@font_cache)
-      expect(cache).to all be_frozen
+      expect(cache.candidates).to be_frozen
+      expect(cache.candidates).to all be_frozen
     end
   end
 
@@ -84,6 +85,30 @@ RSpec.describe ChromaWave::Font do
     end
   end
 
+  describe '.index_path' do
+    around do |example|
+      saved = ENV.fetch(described_class::INDEX_PATH_ENV, nil)
+      example.run
+    ensure
+      ENV[described_class::INDEX_PATH_ENV] = saved
+    end
+
+    it 'honors the override variable' do
+      ENV[described_class::INDEX_PATH_ENV] = '/tmp/cw-fonts.json'
+      expect(described_class.index_path).to eq('/tmp/cw-fonts.json')
+    end
+
+    it 'disables persistence when the override is empty' do
+      ENV[described_class::INDEX_PATH_ENV] = ''
+      expect(described_class.index_path).to be_nil
+    end
+
+    it 'defaults to the user cache directory' do
+      ENV.delete(described_class::INDEX_PATH_ENV)
+      expect(described_class.index_path).to end_with('chroma_wave/font-index.json')
+    end
+  end
+
   describe '.default' do
     subject(:font) { described_class.default(size: 20) }
 
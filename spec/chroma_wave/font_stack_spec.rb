@@ -0,0 +1,116 @@
+# frozen_string_literal: true
+
+RSpec.describe ChromaWave::FontStack do
+  let(:text_font) { ChromaWave::Font.default(size: 16) }
+  let(:icons) { ChromaWave::IconFont.lucide(size: 16) }
+  let(:house) { icons.glyph_map.fetch(:house) }
+  let(:black) { ChromaWave::Color::BLACK }
+
+  subject(:stack) { described_class.new(text_font, icons) }
+
+  describe '.new' do
+    it 'requires at least one font' do
+      expect { described_class.new }.to raise_error(ArgumentError, /at least one font/)
+    end
+
+    it 'takes the maximum line metrics of its faces' do
+      small = ChromaWave::Font.default(size: 10)
+      combined = described_class.new(small, text_font)
+      expect(combined.line_height).to eq(text_font.line_height)
+      expect(combined.ascent).to eq(text_font.ascent)
+    end
+  end
+
+  describe '#font_for' do
+    it 'resolves each codepoint to the first covering face' do
+      expect(stack.font_for('A'.ord)).to be(text_font)
+      expect(stack.font_for(house)).to be(icons)
+    end
+
+    it 'falls back to the first font when no face covers the codepoint' do
+      expect(stack.font_for(0x10FFFD)).to be(text_font)
+      expect(stack.include_codepoint?(0x10FFFD)).to be(false)
+    end
+  end
+
+  describe '#measure' do
+    it 'sums the widths of each face run' do
+      text = "Home #{house.chr(Encoding::UTF_8)}"
+      expected = text_font.measure('Home ').width + icons.measure(house.chr(Encoding::UTF_8)).width
+      expect(stack.measure(text).width).to eq(expected)
+    end
+
+    it 'reports stacked line heights for multi-line text' do
+      expect(stack.measure("a\nb").height).to eq(stack.line_height * 2)
+    end
+  end
+
+  describe '#line_width' do
+    it 'matches #measure without touching the layout cache' do
+      ChromaWave::TextLayout.clear_cache!
+      text = "Home #{house.chr(Encoding::UTF_8)}"
+      expect(stack.line_width(text)).to eq(text_font.line_width('Home ') + icons.line_width(house.chr(Encoding::UTF_8)))
+      expect(ChromaWave::TextLayout.cache.size).to eq(0)
+      expect(stack.line_width(text)).to eq(stack.measure(text).width)
+    end
+  end
+
+  describe '#each_glyph' do
+    it 'offsets later runs by the width of earlier runs' do
+      glyphs = stack.each_glyph("Hi#{house.chr(Encoding::UTF_8)}").to_a
+      icon_glyph = icons.each_glyph(house.chr(Encoding::UTF_8)).first
+      expect(glyphs.last[:x]).to eq(text_font.measure('Hi').width + icon_glyph[:x])
+    end
+
+    it 'returns the pen advance without caching run widths' do
+      ChromaWave::TextLayout.clear_cache!
+      text = "Hi #{house.chr(Encoding::UTF_8)} there"
+      expect(stack.each_glyph(text) { nil }).to eq(stack.measure(text).width)
+      expect(ChromaWave::TextLayout.cache.size).to eq(1)
+    end
+
+    it 'aligns faces on a shared baseline' do
+      small = ChromaWave::Font.default(size: 10)
+      glyph = described_class.new(text_font, small).each_glyph('x').first
+      expect(glyph[:y]).to eq(text_font.each_glyph('x').first[:y])
+      shifted = described_class.new(small, text_font).each_glyph('x').first
+      expect(shifted[:y]).to eq(small.each_glyph('x').first[:y] + (text_font.ascent - small.ascent))
+    end
+  end
+
+  describe 'draw_text' do
+    it 'renders mixed text like drawing each run with its own font' do
+      mixed = ChromaWave::Canvas.new(width: 120, height: 30)
+      split = ChromaWave::Canvas.new(width: 120, height: 30)
+      mixed.draw_text("Go #{house.chr(Encoding::UTF_8)}", x: 2, y: 2, font: stack, color: black)
+      split.draw_text('Go ', x: 2, y: 2 + stack.ascent - text_font.ascent, font: text_font, color: black)
+      split.draw_text(house.chr(Encoding::UTF_8), x: 2 + text_font.measure('Go ').width,
+                                                  y: 2 + stack.ascent - icons.ascent, font: icons, color: black)
+      expect(mixed.rgba_bytes).to eq(split.rgba_bytes)
+    end
+
+    it 'accepts baked bitmap fonts with a FreeType fallback' do
+      builtin = ChromaWave::BitmapFont.builtin(:font12)
+      chain = described_class.new(builtin, text_font)
+      expect(chain.font_for('A'.ord)).to be(builtin)
+      expect(chain.font_for('é'.ord)).to be(text_font)
+
+      canvas = ChromaWave::Canvas.new(width: 80, height: 20)
+      expect { canvas.draw_text('Café', x: 0, y: 0, font: chain, color: black) }.not_to raise_error
+    end
+  end
+
+  describe 'coverage bitsets' do
+    it 'marks mapped codepoints in Font#coverage' do
+      expect(text_font.include_codepoint?('A'.ord)).to be(true)
+      expect(text_font.include_codepoint?(house)).to be(false)
+    end
+
+    it 'marks stored glyphs in BitmapFont#coverage' do
+      builtin = ChromaWave::BitmapFont.builtin(:font8)
+      expect(builtin.coverage.bytesize).to eq((0x7E >> 3) + 1)
+      expect(builtin.coverage.getbyte('~'.ord >> 3)['~'.ord & 7]).to eq(1)
+      expect(builtin.coverage.getbyte(0)).to eq(0)
+    end
+  end
+end
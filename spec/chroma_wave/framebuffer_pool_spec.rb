@@ -0,0 +1,51 @@
+# frozen_string_literal: true
+
+RSpec.describe ChromaWave::FramebufferPool do
+  let(:pool) { described_class.new(capacity: 2) }
+
+  describe '#rent' do
+    it 'allocates a framebuffer of the requested shape when none is idle' do
+      fb = pool.rent(10, 4, :gray4)
+
+      expect([fb.width, fb.height, fb.pixel_format]).to eq([10, 4, ChromaWave::PixelFormat::GRAY4])
+    end
+
+    it 'hands back a released framebuffer of the same shape' do
+      fb = pool.rent(8, 8, :mono)
+      pool.release(fb)
+
+      expect(pool.rent(8, 8, ChromaWave::PixelFormat::MONO)).to equal(fb)
+      expect(pool.rent(8, 8, :mono)).not_to equal(fb)
+    end
+
+    it 'keeps shapes apart' do
+      pool.release(pool.rent(8, 8, :mono))
+
+      expect(pool.rent(8, 8, :gray4).pixel_format.name).to eq(:gray4)
+      expect(pool.size).to eq(1)
+    end
+  end
+
+  describe '#release' do
+    it 'keeps at most capacity idle framebuffers per shape' do
+      pool.release(*Array.new(3) { pool.rent(4, 4, :mono) })
+
+      expect(pool.size).to eq(2)
+    end
+
+    it 'ignores a framebuffer that is already idle' do
+      fb = pool.rent(4, 4, :mono)
+      pool.release(fb, fb)
+
+      expect(pool.size).to eq(1)
+    end
+
+    it 'rejects non-framebuffers' do
+      expect { pool.release('fb') }.to raise_error(TypeError, /Framebuffer/)
+    end
+  end
+
+  it 'validates the capacity' do
+    expect { described_class.new(capacity: 0) }.to raise_error(ArgumentError, /capacity/)
+  end
+end
@@ -1,15 +1,24 @@
 # frozen_string_literal: true
 
+require 'stringio'
+
 RSpec.describe ChromaWave::Framebuffer do
   describe '#initialize' do
     context 'with valid arguments' do
-      %i[mono gray4 color4 color7].each do |fmt|
+      %i[mono gray4 color4 color7 color4_2bpp].each do |fmt|
         it "creates a framebuffer with format #{fmt}" do
           expect(described_class.new(100, 50, fmt).pixel_format.name).to eq(fmt)
         end
       end
     end
 
+    it 'sets row padding but leaves pixels to the caller with clear: false' do
+      fb = described_class.new(13, 3, :mono, clear: false)
+      13.times { |x| 3.times { |y| fb.set_pixel(x, y, :white) } }
+
+      expect(fb).to eq(described_class.new(13, 3, :mono))
+    end
+
     context 'with invalid format' do
       it 'raises ArgumentError for an unknown symbol' do
         expect { described_class.new(10, 10, :rgb565) }
@@ -272,6 +281,17 @@ RSpec.describe ChromaWave::Framebuffer do
         expect(fb.get_pixel(9, 3)).to eq(:black)
       end
     end
+
+    context 'with COLOR4_2BPP format' do
+      subject(:fb) { described_class.new(10, 4, :color4_2bpp) }
+
+      it 'packs 4 pixels per byte in the controller order' do
+        fb.clear(1).set_pixel(0, 0, :black).set_pixel(1, 0, :yellow).set_pixel(2, 0, :red)
+
+        expect(fb.bytes.getbyte(0)).to eq(0b00_10_11_01)
+        expect((0..3).map { |x| fb.get_pixel(x, 0) }).to eq(%i[black yellow red white])
+      end
+    end
   end
 
   describe 'non-byte-aligned width edge case' do
@@ -378,6 +398,406 @@ RSpec.describe ChromaWave::Framebuffer do
     end
   end
 
+  describe '#fill_rect' do
+    it 'writes masked edge bytes and clips' do
+      fb = described_class.new(20, 2, :mono).clear(:white)
+      fb.fill_rect(3, -1, 14, 2, :black)
+
+      expect(fb.bytes.unpack('C*')).to eq([0xE0, 0x00, 0x7F, 0xFF, 0xFF, 0xFF])
+    end
+
+    it 'combines with the existing pixels by ROP' do
+      fb = described_class.new(4, 1, :gray4).clear(:dark_gray)
+      fb.fill_rect(0, 0, 2, 1, :white, rop: :xor)
+      fb.fill_rect(3, 0, 1, 1, :light_gray, rop: :not)
+
+      expect((0...4).map { |x| fb.get_pixel(x, 0) }).to eq(%i[light_gray light_gray dark_gray dark_gray])
+    end
+
+    it 'allows only :copy where bitwise results could leave the palette' do
+      fb = described_class.new(4, 1, :color7)
+      expect(fb.fill_rect(0, 0, 4, 1, :red).get_pixel(3, 0)).to eq(:red)
+      expect { fb.fill_rect(0, 0, 4, 1, :red, rop: :or) }.to raise_error(ArgumentError, /not supported/)
+      expect { fb.fill_rect(0, 0, 4, 1, :red, rop: :nand) }.to raise_error(ArgumentError, /unknown rop/)
+    end
+  end
+
+  describe '#copy_rect' do
+    def randomize(fb, rng)
+      size = fb.pixel_format.palette.size
+      fb.height.times { |y| fb.width.times { |x| fb.set_pixel(x, y, rng.rand(size)) } }
+      fb
+    end
+
+    %i[mono gray4 color4 color7 color4_2bpp].each do |fmt|
+      it "matches per-pixel copies at any offset for #{fmt}" do
+        rng = Random.new(4)
+        source = randomize(described_class.new(77, 5, fmt), rng)
+        fb = randomize(described_class.new(90, 6, fmt), rng)
+        expected = fb.dup
+        (1...76).each { |x| (0...3).each { |y| expected.set_pixel(x + 4, y + 2, source.get_pixel(x, y + 1)) } }
+
+        expect(fb.copy_rect(source, x: 5, y: 2, rect: [1, 1, 75, 3])).to eq(expected)
+      end
+    end
+
+    it 'clips both rectangles and applies the ROP' do
+      fb = described_class.new(16, 2, :mono).clear(:white)
+      stamp = described_class.new(8, 2, :mono).clear(:white).set_pixel(1, 0, :black)
+      fb.copy_rect(stamp, x: -1, y: 1, rop: :xor)
+
+      expect(fb.bytes.unpack('C*')).to eq([0xFF, 0xFF, 0x81, 0xFF])
+    end
+
+    it 'copies overlapping regions of the same framebuffer' do
+      fb = described_class.new(12, 1, :gray4)
+      (0...12).each { |x| fb.set_pixel(x, 0, x % 4) }
+      fb.copy_rect(fb, x: 1, y: 0, rect: [0, 0, 11, 1])
+
+      shades = %i[black dark_gray light_gray white]
+      expect((0...12).map { |x| fb.get_pixel(x, 0) }).to eq([:black] + (shades * 3).first(11))
+    end
+
+    it 'rejects a source of another format' do
+      expect { described_class.new(4, 4, :mono).copy_rect(described_class.new(4, 4, :gray4), x: 0, y: 0) }
+        .to raise_error(ArgumentError, /does not match/)
+    end
+  end
+
+  describe '#rotate' do
+    def randomize(fb, rng)
+      size = fb.pixel_format.palette.size
+      fb.height.times { |y| fb.width.times { |x| fb.set_pixel(x, y, rng.rand(size)) } }
+      fb
+    end
+
+    def pixels(fb)
+      (0...fb.height).map { |y| (0...fb.width).map { |x| fb.get_pixel(x, y) } }
+    end
+
+    %i[mono gray4 color4 color7 color4_2bpp].each do |fmt|
+      it "matches per-pixel rotations for #{fmt}" do
+        fb = randomize(described_class.new(19, 11, fmt), Random.new(6))
+        rows = pixels(fb)
+
+        expect(pixels(fb.rotate(90))).to eq(rows.transpose.map(&:reverse))
+        expect(pixels(fb.rotate(180))).to eq(rows.reverse.map(&:reverse))
+        expect(pixels(fb.rotate(270))).to eq(rows.transpose.reverse)
+        expect(fb.rotate(0)).to eq(fb)
+      end
+    end
+
+    it 'round-trips and leaves row padding as a fresh framebuffer has it' do
+      fb = randomize(described_class.new(13, 10, :mono), Random.new(7))
+      rotated = fb.rotate(90)
+      expected = described_class.new(10, 13, :mono)
+      13.times { |y| 10.times { |x| expected.set_pixel(x, y, rotated.get_pixel(x, y)) } }
+
+      expect(rotated).to eq(expected)
+      expect(rotated.rotate(270)).to eq(fb)
+    end
+
+    it 'rotates square framebuffers in place' do
+      fb = randomize(described_class.new(8, 8, :gray4), Random.new(8))
+      expected = fb.rotate(90)
+
+      expect(fb.rotate(90, into: fb)).to eq(expected)
+    end
+
+    it 'validates the angle and target' do
+      fb = described_class.new(8, 4, :mono)
+      expect { fb.rotate(45) }.to raise_error(ArgumentError, /rotation must be/)
+      expect { fb.rotate(90, into: fb) }.to raise_error(ArgumentError, /4x8/)
+      expect { fb.rotate(90, into: described_class.new(4, 8, :gray4)) }.to raise_error(ArgumentError)
+    end
+  end
+
+  describe '#flip' do
+    it 'mirrors horizontally and vertically' do
+      fb = described_class.new(5, 2, :color7).set_pixel(0, 0, :red).set_pixel(4, 1, :blue)
+      h = fb.flip(:h)
+      v = fb.flip(:v)
+
+      expect([h.get_pixel(4, 0), h.get_pixel(0, 1)]).to eq(%i[red blue])
+      expect([v.get_pixel(0, 1), v.get_pixel(4, 0)]).to eq(%i[red blue])
+    end
+
+    it 'flips in place and rejects unknown axes' do
+      fb = described_class.new(10, 1, :mono).set_pixel(0, 0, :black)
+      fb.flip(:h, into: fb)
+
+      expect([fb.get_pixel(0, 0), fb.get_pixel(9, 0)]).to eq(%i[white black])
+      expect { fb.flip(:diagonal) }.to raise_error(ArgumentError, /axis/)
+    end
+  end
+
+  describe '#convert' do
+    it 'maps colors by nearest match unless mapped explicitly' do
+      fb = described_class.new(9, 2, :gray4).set_pixel(0, 0, :light_gray).set_pixel(8, 1, :white)
+      mono = fb.convert(:mono)
+      mapped = fb.convert(:mono, mapping: { light_gray: :black, black: :white })
+
+      expect([mono.get_pixel(0, 0), mono.get_pixel(8, 1), mono.get_pixel(1, 0)]).to eq(%i[white white black])
+      expect([mapped.get_pixel(0, 0), mapped.get_pixel(8, 1), mapped.get_pixel(1, 0)]).to eq(%i[black white white])
+    end
+
+    it 'matches per-pixel conversion across formats, padding included' do
+      fb = described_class.new(13, 3, :color7)
+      13.times { |x| 3.times { |y| fb.set_pixel(x, y, (x * 3 + y) % 7) } }
+      expected = described_class.new(13, 3, :gray4)
+      13.times { |x| 3.times { |y| expected.set_pixel(x, y, fb.get_pixel(x, y) == :white ? :white : :black) } }
+
+      table = { green: :black, blue: :black, red: :black, yellow: :black, orange: :black }
+      expect(fb.convert(:gray4, mapping: table)).to eq(expected)
+      expect(expected.convert(:mono).convert(:gray4)).to eq(expected)
+    end
+
+    it 'rejects unknown colors and mismatched targets' do
+      fb = described_class.new(8, 8, :mono)
+      expect { fb.convert(:gray4, mapping: { red: :black }) }.to raise_error(KeyError)
+      expect { fb.convert(:gray4, into: described_class.new(8, 8, :mono)) }.to raise_error(ArgumentError, /gray4/)
+      expect { fb.convert(:gray4, into: described_class.new(4, 8, :gray4)) }.to raise_error(ArgumentError, /8x8/)
+    end
+  end
+
+  describe '#split_planes' do
+    it 'splits pixel indices into MONO bit planes, high bit first' do
+      fb = described_class.new(5, 1, :gray4)
+      4.times { |i| fb.set_pixel(i, 0, i) }
+      high, low = fb.split_planes
+
+      expect(5.times.map { |x| high.get_pixel(x, 0) }).to eq(%i[black black white white black])
+      expect(5.times.map { |x| low.get_pixel(x, 0) }).to eq(%i[black white black white black])
+    end
+
+    it 'fills given targets and checks their count' do
+      fb = described_class.new(4, 4, :color4)
+      planes = Array.new(4) { described_class.new(4, 4, :mono) }
+
+      expect(fb.split_planes(into: planes)).to eq(planes)
+      expect { fb.split_planes(into: planes.take(2)) }.to raise_error(ArgumentError, /4 plane/)
+    end
+  end
+
+  describe '#to_rgb_bytes / #to_canvas' do
+    let(:fb) { described_class.new(13, 3, :color7) }
+
+    before do
+      rng = Random.new(3)
+      fb.load_indices(Array.new(13 * 3) { rng.rand(7) }.pack('C*'))
+    end
+
+    def named_rgb(name)
+      color = ChromaWave::Color.from_name(name)
+      [color.r, color.g, color.b]
+    end
+
+    it 'expands every pixel to its palette color' do
+      %i[mono gray4 color4 color7 color4_2bpp].each do |format|
+        frame = fb.convert(format)
+        expected = (0...3).flat_map { |y| (0...13).flat_map { |x| named_rgb(frame.get_pixel(x, y)) } }
+
+        expect(frame.to_rgb_bytes.unpack('C*')).to eq(expected)
+      end
+    end
+
+    it 'returns a Canvas of the frame, with palette colors overridden' do
+      paper = ChromaWave::Color.new(r: 230, g: 225, b: 210)
+      canvas = fb.to_canvas(palette_rgb: { white: paper })
+
+      expect([canvas.width, canvas.height]).to eq([13, 3])
+      fb.set_pixel(12, 2, :white)
+      expect(fb.to_canvas(palette_rgb: { white: paper }).get_pixel(12, 2)).to eq(paper)
+      expect(canvas.get_pixel(0, 0)).to eq(ChromaWave::Color.from_name(fb.get_pixel(0, 0)))
+      expect { fb.to_rgb_bytes(palette_rgb: { gray: paper }) }.to raise_error(KeyError)
+    end
+  end
+
+  describe '#digest' do
+    let(:fb) { described_class.new(100, 30, :gray4) }
+
+    it 'is equal for equal frames and differs after any write' do
+      digests = [fb.digest]
+      expect(fb.dup.digest).to eq(fb.digest)
+
+      fb.set_pixel(99, 29, :white)
+      digests << fb.digest
+      fb.fill_rect(10, 10, 5, 5, :dark_gray)
+      digests << fb.digest
+      expect(digests.uniq.size).to eq(3)
+
+      fb.clear(0)
+      expect(fb.digest).to eq(digests.first)
+    end
+
+    it 'tells apart frames of another shape with the same bytes' do
+      expect(described_class.new(8, 2, :mono).digest).not_to eq(described_class.new(16, 1, :mono).digest)
+    end
+  end
+
+  describe '#tile_digests' do
+    let(:fb) { described_class.new(100, 30, :mono) }
+
+    it 'cuts the frame into tiles, the last ones short' do
+      tiles = fb.tile_digests(tile_width: 32, tile_height: 16)
+
+      expect([tiles.size, tiles.first.size]).to eq([2, 4])
+      expect(tiles).to be_frozen
+      expect(fb.tile_digests(tile_width: 200, tile_height: 1).map(&:size).uniq).to eq([1])
+    end
+
+    it 'is cached until the next write' do
+      tiles = fb.tile_digests
+      expect(fb.tile_digests).to equal(tiles)
+
+      fb.set_pixel(0, 0, :black)
+      expect(fb.tile_digests).not_to eq(tiles)
+    end
+
+    it 'rejects tile widths that do not start tiles on a byte' do
+      expect { fb.tile_digests(tile_width: 12) }.to raise_error(ArgumentError, /multiple of 8/)
+      expect { fb.tile_digests(tile_height: 0) }.to raise_error(ArgumentError, /positive/)
+    end
+  end
+
+  describe '#changed_region' do
+    let(:fb) { described_class.new(200, 100, :mono) }
+
+    it 'bounds the changed tiles, clipped to the frame' do
+      tiles = fb.tile_digests
+      fb.set_pixel(70, 20, :black).set_pixel(199, 40, :black)
+
+      expect(fb.changed_region(tiles)).to eq(x: 64, y: 16, width: 136, height: 32)
+    end
+
+    it 'compares with an earlier framebuffer, nil when nothing changed' do
+      before = fb.dup
+      expect(fb.changed_region(before)).to be_nil
+
+      fb.set_pixel(5, 99, :black)
+      expect(fb.changed_region(before, tile_width: 8, tile_height: 4)).to eq(x: 0, y: 96, width: 8, height: 4)
+    end
+
+    it 'rejects earlier frames of another shape' do
+      expect { fb.changed_region(described_class.new(100, 100, :mono)) }.to raise_error(ArgumentError)
+      expect { fb.changed_region(fb.tile_digests(tile_width: 8)) }.to raise_error(ArgumentError, /match/)
+      expect { fb.changed_region('tiles') }.to raise_error(TypeError)
+    end
+  end
+
+  describe '.map' do
+    let(:dir) { Dir.mktmpdir('chroma_wave') }
+    let(:path) { File.join(dir, 'frame') }
+    let!(:producer) { described_class.map(path, width: 13, height: 7, format: :gray4) }
+
+    after { FileUtils.rm_rf(dir) }
+
+    it 'creates a cleared framebuffer backed by the file' do
+      expect(producer.mapped?).to be(true)
+      expect(producer).to eq(described_class.new(13, 7, :gray4))
+      expect(File.size(path)).to eq(64 + producer.buffer_size)
+    end
+
+    it 'shares pixels with every mapping of the file' do
+      consumer = described_class.map(path)
+      producer.set_pixel(3, 2, :dark_gray)
+
+      expect([consumer.width, consumer.pixel_format.name]).to eq([13, :gray4])
+      expect(consumer.get_pixel(3, 2)).to eq(:dark_gray)
+      expect(consumer.dup.mapped?).to be(false)
+    end
+
+    it 'hands frames over through the sequence number' do
+      consumer = described_class.map(path)
+      seen = consumer.frame_sequence
+      waiter = Thread.new { consumer.wait_for_frame(after: seen, timeout: 5) }
+      published = producer.publish { |fb| fb.set_pixel(0, 0, :black) }
+
+      expect(waiter.value).to eq(published)
+      expect(consumer.wait_for_frame(after: published, timeout: 0.01)).to be_nil
+    end
+
+    it 'rejects mismatched shapes and non-frame files' do
+      expect { described_class.map(path, width: 12, height: 7, format: :gray4) }
+        .to raise_error(ChromaWave::FormatMismatchError, /another shape/)
+      File.write("#{path}.txt", 'x' * 100)
+      expect { described_class.map("#{path}.txt") }.to raise_error(ArgumentError, /not a frame file/)
+      expect { described_class.map(path, width: 12) }.to raise_error(ArgumentError, /go together/)
+    end
+
+    it 'waits for the file lock without holding up other threads' do
+      File.open(path) do |holder|
+        holder.flock(File::LOCK_EX)
+        mapper = Thread.new { described_class.map(path) }
+        ticker = Thread.new { 20.times.count { sleep 0.005 } }
+
+        expect(ticker.join(5)&.value).to eq(20)
+        expect(mapper.alive?).to be(true)
+        holder.flock(File::LOCK_UN)
+        expect(mapper.value.width).to eq(13)
+      end
+    end
+
+    it 'can interrupt a map waiting for the file lock' do
+      File.open(path) do |holder|
+        holder.flock(File::LOCK_EX)
+        mapper = Thread.new { described_class.map(path) }
+        sleep 0.05
+        mapper.kill
+
+        expect(mapper.join(5)).to equal(mapper)
+      end
+    end
+
+    it 'refuses frame operations on heap framebuffers' do
+      expect(described_class.new(2, 2, :mono).mapped?).to be(false)
+      expect { described_class.new(2, 2, :mono).publish }.to raise_error(ChromaWave::Error, /not mapped/)
+    end
+  end
+
+  describe '#dump / .load' do
+    let(:fb) { described_class.new(203, 41, :mono) }
+
+    it 'round-trips frames of every format, padding included' do
+      %i[mono gray4 color4 color7 color4_2bpp].each do |format|
+        frame = described_class.new(203, 41, format)
+        rng = Random.new(7)
+        frame.load_indices(Array.new(203 * 41) { rng.rand(frame.pixel_format.palette.size) }.pack('C*'))
+        frame.fill_rect(20, 5, 150, 30, 0)
+
+        restored = described_class.load(frame.dump)
+        expect([restored, restored.pixel_format.name]).to eq([frame, format])
+      end
+    end
+
+    it 'packs flat areas and dither patterns into runs' do
+      fb.fill_rect(0, 20, 203, 21, :black)
+      (0...20).each { |y| (0...203).step(2) { |x| fb.set_pixel(x + (y % 2), y, :black) } }
+
+      expect(fb.dump.bytesize).to be < fb.buffer_size / 4
+    end
+
+    it 'writes to and reads from an IO' do
+      fb.set_pixel(17, 3, :black)
+      io = StringIO.new(+'', 'w+b')
+
+      expect(fb.dump(io)).to equal(io)
+      io.rewind
+      expect(described_class.load(io)).to eq(fb)
+    end
+
+    it 'rejects data that is not an intact snapshot' do
+      data = fb.dump
+      damaged = data.dup.tap { |d| d.setbyte(d.bytesize - 1, d.getbyte(d.bytesize - 1) ^ 1) }
+
+      expect { described_class.load('CWFRAME!') }.to raise_error(ArgumentError, /not a framebuffer snapshot/)
+      expect { described_class.load(data[0...-1]) }.to raise_error(ArgumentError, /truncated/)
+      expect { described_class.load("#{data}x") }.to raise_error(ArgumentError, /trailing/)
+      expect { described_class.load(damaged) }.to raise_error(ArgumentError, /digest mismatch/)
+      expect { described_class.load(42) }.to raise_error(TypeError)
+    end
+  end
+
   describe '#bytes' do
     subject(:fb) { described_class.new(8, 2, :mono) }
 
@@ -731,7 +1151,7 @@ RSpec.describe ChromaWave::Framebuffer do
     end
 
     describe 'buffer_size consistency' do
-      %i[mono gray4 color4 color7].each do |fmt|
+      %i[mono gray4 color4 color7 color4_2bpp].each do |fmt|
         it "matches PixelFormat calculation for #{fmt} at 122x250" do
           fb = described_class.new(122, 250, fmt)
           pf = fb.pixel_format
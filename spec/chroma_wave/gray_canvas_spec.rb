@@ -0,0 +1,198 @@
+# frozen_string_literal: true
+
+RSpec.describe ChromaWave::GrayCanvas do
+  let(:white) { ChromaWave::Color::WHITE }
+  let(:black) { ChromaWave::Color::BLACK }
+  let(:red)   { ChromaWave::Color::RED }
+  let(:pen_class) { ChromaWave::Pen }
+
+  def gray(l)
+    ChromaWave::Color.new(r: l, g: l, b: l)
+  end
+
+  # An RGBA canvas reduced pixel by pixel, for comparison.
+  def luma_bytes(canvas)
+    canvas.rgba_bytes.unpack('C*').each_slice(4).map do |r, g, b, _|
+      described_class.luma(ChromaWave::Color.new(r: r, g: g, b: b))
+    end.pack('C*')
+  end
+
+  describe '#initialize' do
+    it 'stores one byte per pixel' do
+      canvas = described_class.new(width: 13, height: 7)
+      expect(canvas.gray_bytes.bytesize).to eq(13 * 7)
+    end
+
+    it 'is a Canvas with the drawing APIs' do
+      canvas = described_class.new(width: 2, height: 2)
+      expect(canvas).to be_a(ChromaWave::Canvas)
+      expect(canvas).to respond_to(:draw_text, :draw_path, :draw_circle)
+    end
+
+    it 'reduces the background to gray' do
+      canvas = described_class.new(width: 2, height: 2, background: red)
+      expect(canvas.get_pixel(1, 1)).to eq(gray(described_class.luma(red)))
+    end
+  end
+
+  describe '.luma' do
+    it 'maps grays to themselves' do
+      expect([0, 1, 127, 128, 254, 255].map { |l| described_class.luma(gray(l)) }).to eq([0, 1, 127, 128, 254, 255])
+    end
+
+    it 'weights green above red above blue' do
+      expect(described_class.luma(ChromaWave::Color.new(r: 0, g: 255, b: 0))).to eq(149)
+      expect(described_class.luma(red)).to eq(77)
+      expect(described_class.luma(ChromaWave::Color.new(r: 0, g: 0, b: 255))).to eq(29)
+    end
+  end
+
+  describe 'pixel access' do
+    let(:canvas) { described_class.new(width: 4, height: 3) }
+
+    it 'round-trips gray values' do
+      canvas.set_pixel(2, 1, gray(90))
+      expect(canvas.get_pixel(2, 1)).to eq(gray(90))
+    end
+
+    it 'ignores and returns nil out of bounds' do
+      canvas.set_pixel(4, 0, black)
+      expect(canvas.get_pixel(4, 0)).to be_nil
+      expect(canvas.gray_bytes).to eq("\xFF".b * 12)
+    end
+  end
+
+  describe '#clear' do
+    it 'fills every pixel with the luma' do
+      canvas = described_class.new(width: 5, height: 2).clear(gray(40))
+      expect(canvas.gray_bytes).to eq([40].pack('C') * 10)
+    end
+  end
+
+  describe '#rgba_bytes' do
+    it 'expands to opaque RGBA' do
+      canvas = described_class.new(width: 2, height: 1).set_pixel(0, 0, gray(7))
+      expect(canvas.rgba_bytes).to eq([7, 7, 7, 255, 255, 255, 255, 255].pack('C*'))
+    end
+  end
+
+  describe 'buffer borrows' do
+    let(:canvas) { described_class.new(width: 2, height: 1).set_pixel(0, 0, gray(7)) }
+
+    it 'lends the live gray buffer' do
+      canvas.with_gray_buffer do |bytes|
+        expect(bytes.to_s).to eq([7, 255].pack('C*'))
+        expect { canvas.clear(black) }.to raise_error(RuntimeError)
+      end
+    end
+
+    it 'lends an RGBA expansion' do
+      canvas.with_rgba_buffer { |bytes| expect(bytes).to eq(canvas.rgba_bytes) }
+    end
+  end
+
+  describe '#blit' do
+    it 'copies a GrayCanvas with clipping' do
+      source = described_class.new(width: 3, height: 2, background: gray(10))
+      canvas = described_class.new(width: 4, height: 3).blit(source, x: 2, y: 2)
+
+      expect(canvas.get_pixel(2, 2)).to eq(gray(10))
+      expect(canvas.get_pixel(3, 2)).to eq(gray(10))
+      expect(canvas.get_pixel(1, 2)).to eq(white)
+    end
+
+    it 'composites an RGBA canvas by its luma and alpha' do
+      source = ChromaWave::Canvas.new(width: 2, height: 1, background: ChromaWave::Color::TRANSPARENT)
+      source.set_pixel(0, 0, ChromaWave::Color.new(r: 0, g: 0, b: 0, a: 128))
+      source.set_pixel(1, 0, red)
+      canvas = described_class.new(width: 3, height: 1).blit(source, x: 1, y: 0)
+
+      expect(canvas.get_pixel(0, 0)).to eq(white)
+      expect(canvas.get_pixel(1, 0)).to eq(gray(((255 * 127) + 127) / 255))
+      expect(canvas.get_pixel(2, 0)).to eq(gray(77))
+    end
+
+    it 'snapshots itself for an overlapping self-blit' do
+      canvas = described_class.new(width: 1, height: 4)
+      canvas.set_pixel(0, 0, gray(10)).set_pixel(0, 1, gray(20))
+      canvas.blit(canvas, x: 0, y: 1)
+
+      expect(canvas.gray_bytes.unpack('C*')).to eq([10, 10, 20, 255])
+    end
+
+    it 'composites an IndexedCanvas through its RGBA colors' do
+      source = ChromaWave::IndexedCanvas.new(width: 2, height: 1, pixel_format: :color4, background: :black)
+      source.set_pixel(1, 0, :red)
+      canvas = described_class.new(width: 3, height: 1).blit(source, x: 1, y: 0)
+
+      expect(canvas.gray_bytes.unpack('C*')).to eq([255, 0, described_class.luma(red)])
+    end
+
+    it 'can be blitted onto an RGBA canvas' do
+      source = described_class.new(width: 1, height: 1, background: black)
+      canvas = ChromaWave::Canvas.new(width: 2, height: 1).blit(source, x: 1, y: 0)
+      expect(canvas.get_pixel(1, 0)).to eq(black)
+    end
+  end
+
+  describe '#load_rgba_bytes' do
+    it 'reduces RGBA rows to luma' do
+      canvas = described_class.new(width: 3, height: 1)
+      canvas.load_rgba_bytes(red.to_rgba_bytes * 2, width: 2, height: 1, x: 2, y: 0)
+      expect(canvas.gray_bytes.unpack('C*')).to eq([255, 255, 77])
+    end
+  end
+
+  describe 'native paths' do
+    let(:font) { ChromaWave::Font.default(size: 14) }
+
+    it 'renders black text like an RGBA canvas reduced to gray' do
+      rgba = ChromaWave::Canvas.new(width: 80, height: 24)
+      gray_canvas = described_class.new(width: 80, height: 24)
+      [rgba, gray_canvas].each { |c| c.draw_text('Gray 8', x: 2, y: 2, font: font, color: black) }
+
+      expect(gray_canvas.gray_bytes).to eq(luma_bytes(rgba))
+      expect(count_non_white(gray_canvas)).to be_positive
+    end
+
+    it 'draws primitives like the Ruby path' do
+      native = described_class.new(width: 37, height: 23)
+      reference = native.dup
+      reference.define_singleton_method(:native_raster) { |*| false }
+      [native, reference].each do |c|
+        rng = Random.new(5)
+        r = ->(range) { rng.rand(range) }
+        6.times do
+          c.draw_circle(r[-5..40], r[-5..25], r[1..12], pen: pen_class.new(fill: gray(60), stroke: black))
+          c.draw_line(r[-5..40], r[-5..25], r[-5..40], r[-5..25], pen: pen_class.stroke(gray(150), width: 3))
+          c.draw_rect(r[-5..30], r[-5..20], r[1..20], r[1..12], pen: pen_class.fill(gray(200)))
+        end
+        c.flood_fill(18, 11, color: gray(30))
+      end
+
+      expect(native).to eq(reference)
+    end
+
+    it 'draws through a Layer' do
+      canvas = described_class.new(width: 10, height: 10)
+      canvas.layer(x: 2, y: 2, width: 4, height: 4).clear(black)
+      expect(canvas.get_pixel(5, 5)).to eq(black)
+      expect(canvas.get_pixel(6, 6)).to eq(white)
+    end
+  end
+
+  describe 'rendering' do
+    %i[threshold ordered floyd_steinberg].each do |dither|
+      it "dithers like the equivalent RGBA canvas with #{dither}" do
+        rgba = ChromaWave::Canvas.new(width: 24, height: 9)
+        gray_canvas = described_class.new(width: 24, height: 9)
+        24.times do |x|
+          [rgba, gray_canvas].each { |c| c.draw_line(x, 0, x, 8, pen: pen_class.stroke(gray(x * 11))) }
+        end
+        renderer = ChromaWave::Renderer.new(pixel_format: :gray4, dither: dither)
+
+        expect(renderer.render(gray_canvas).bytes).to eq(renderer.render(rgba).bytes)
+      end
+    end
+  end
+end
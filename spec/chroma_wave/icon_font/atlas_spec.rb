@@ -0,0 +1,62 @@
+# frozen_string_literal: true
+
+require 'tmpdir'
+
+RSpec.describe ChromaWave::IconFont::Atlas do
+  let(:icons) { ChromaWave::IconFont.lucide(size: 24) }
+  let(:black) { ChromaWave::Color::BLACK }
+
+  describe '#fetch' do
+    subject(:atlas) { described_class.new(size: 24) }
+
+    it 'computes and caches the entry on a miss' do
+      calls = 0
+      2.times do
+        atlas.fetch(:dot) do
+          calls += 1
+          { bitmap: ''.b }
+        end
+      end
+      expect(calls).to eq(1)
+      expect(atlas).to include(:dot)
+    end
+
+    it 'freezes stored entries' do
+      expect(atlas.fetch(:dot) { { bitmap: ''.b } }).to be_frozen
+    end
+  end
+
+  describe '#write and .load' do
+    let(:path) { File.join(Dir.mktmpdir, 'icons.cwia') }
+
+    before { icons.prewarm(:house, :wifi).write(path) }
+
+    it 'round-trips size, names, and metrics' do
+      loaded = described_class.load(path)
+      expect(loaded.size).to eq(24)
+      expect(loaded.names).to contain_exactly(:house, :wifi)
+      expect(loaded[:house]).to eq(icons.atlas[:house])
+    end
+
+    it 'draws identically to the FreeType-backed atlas' do
+      direct = ChromaWave::Canvas.new(width: 40, height: 40)
+      baked = ChromaWave::Canvas.new(width: 40, height: 40)
+      icons.draw(direct, :house, x: 4, y: 4, color: black)
+      described_class.load(path).draw(baked, :house, x: 4, y: 4, color: black)
+      expect(baked).to eq(direct)
+    end
+
+    it 'rejects files that are not atlases' do
+      File.binwrite(path, 'not an atlas')
+      expect { described_class.load(path) }.to raise_error(ArgumentError, /not an icon atlas/)
+    end
+  end
+
+  describe '#draw' do
+    it 'raises KeyError for icons that were never rasterized' do
+      canvas = ChromaWave::Canvas.new(width: 10, height: 10)
+      expect { described_class.new(size: 24).draw(canvas, :house, x: 0, y: 0, color: black) }
+        .to raise_error(KeyError)
+    end
+  end
+end
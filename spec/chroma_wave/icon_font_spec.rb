@@ -59,6 +59,51 @@ RSpec.describe ChromaWave::IconFont do
       expect { icons.draw(canvas, :nonexistent, x: 0, y: 0, color: ChromaWave::Color::BLACK) }
         .to raise_error(KeyError)
     end
+
+    it 'matches the draw_text rendering of the same codepoint' do
+      expected = ChromaWave::Canvas.new(width: 50, height: 50)
+      expected.draw_text(icons.glyph_map[:house].chr(Encoding::UTF_8),
+                         x: 5, y: 5, font: icons, color: ChromaWave::Color::BLACK)
+      icons.draw(canvas, :house, x: 5, y: 5, color: ChromaWave::Color::BLACK)
+      expect(canvas).to eq(expected)
+    end
+
+    it 'caches the rasterized icon in the atlas' do
+      icons.draw(canvas, :house, x: 5, y: 5, color: ChromaWave::Color::BLACK)
+      expect(icons.atlas).to include(:house)
+    end
+
+    it 'draws onto a Layer' do
+      layer = canvas.layer(x: 10, y: 10, width: 30, height: 30)
+      icons.draw(layer, :house, x: 0, y: 0, color: ChromaWave::Color::BLACK)
+      expect(count_non_white(canvas)).to be_positive
+    end
+  end
+
+  describe '#prewarm' do
+    subject(:icons) { described_class.lucide(size: 16) }
+
+    it 'rasterizes the named icons and returns the atlas' do
+      atlas = icons.prewarm(:house, :activity)
+      expect(atlas.names).to contain_exactly(:house, :activity)
+    end
+
+    it 'raises KeyError for an unknown icon name' do
+      expect { icons.prewarm(:nonexistent) }.to raise_error(KeyError)
+    end
+  end
+
+  describe 'atlas: option' do
+    it 'rejects an atlas rasterized at a different size' do
+      atlas = ChromaWave::IconFont::Atlas.new(size: 12)
+      expect { described_class.lucide(size: 24, atlas: atlas) }
+        .to raise_error(ArgumentError, /12px/)
+    end
+
+    it 'seeds the cache from a provided atlas' do
+      atlas = described_class.lucide(size: 16).prewarm(:house)
+      expect(described_class.lucide(size: 16, atlas: atlas).atlas).to include(:house)
+    end
   end
 
   describe 'icons:generate glyph line format' do
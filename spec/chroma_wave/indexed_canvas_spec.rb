@@ -0,0 +1,186 @@
+# frozen_string_literal: true
+
+RSpec.describe ChromaWave::IndexedCanvas do
+  let(:pen_class) { ChromaWave::Pen }
+  let(:canvas) { described_class.new(width: 9, height: 5, pixel_format: :color7) }
+
+  describe '#initialize' do
+    it 'stores one palette index per pixel' do
+      expect(canvas.index_bytes).to eq([1].pack('C') * 45)
+    end
+
+    it 'accepts a PixelFormat and a background' do
+      c = described_class.new(width: 2, height: 1, pixel_format: ChromaWave::PixelFormat::COLOR4, background: :red)
+      expect(c.get_pixel(1, 0)).to eq(ChromaWave::Color::RED)
+    end
+  end
+
+  describe 'pixel access' do
+    it 'accepts palette names, indices, and nearest-matched Colors' do
+      canvas.set_pixel(0, 0, :green)
+      canvas.set_pixel(1, 0, 3)
+      canvas.set_pixel(2, 0, ChromaWave::Color.new(r: 250, g: 10, b: 5))
+
+      expect(canvas.index_bytes.unpack('C3')).to eq([2, 3, 4])
+      expect(canvas.get_pixel(2, 0)).to eq(ChromaWave::Color::RED)
+    end
+
+    it 'rejects out-of-palette indices and names' do
+      expect { canvas.set_pixel(0, 0, 7) }.to raise_error(ArgumentError, /out of range/)
+      expect { canvas.set_pixel(0, 0, :dark_gray) }.to raise_error(KeyError)
+    end
+  end
+
+  describe '#to_framebuffer' do
+    %i[mono gray4 color4 color7].each do |format|
+      it "bit-packs like per-pixel writes for #{format}" do
+        c = described_class.new(width: 13, height: 3, pixel_format: format)
+        expected = ChromaWave::Framebuffer.new(13, 3, format)
+        rng = Random.new(1)
+        size = c.pixel_format.palette.size
+        13.times do |x|
+          3.times do |y|
+            index = rng.rand(size)
+            c.set_pixel(x, y, index)
+            expected.set_pixel(x, y, index)
+          end
+        end
+
+        expect(c.to_framebuffer).to eq(expected)
+      end
+    end
+
+    it 'rejects a framebuffer of another format' do
+      expect { canvas.to_framebuffer(into: ChromaWave::Framebuffer.new(9, 5, :color4)) }
+        .to raise_error(ArgumentError, /does not match/)
+    end
+  end
+
+  describe 'rendering' do
+    it 'packs without dithering on a matching format' do
+      canvas.draw_circle(4, 2, 2, pen: pen_class.fill(:orange))
+      renderer = ChromaWave::Renderer.new(pixel_format: :color7, dither: :floyd_steinberg)
+      expect(renderer.render(canvas)).to eq(canvas.to_framebuffer)
+    end
+
+    it 'dithers the palette colors on another format' do
+      canvas.clear(:black)
+      fb = ChromaWave::Renderer.new(pixel_format: :mono, dither: :threshold).render(canvas)
+      expect(fb.get_pixel(3, 3)).to eq(:black)
+    end
+  end
+
+  describe 'native paths' do
+    it 'draws primitives like the Ruby path' do
+      native = described_class.new(width: 37, height: 23, pixel_format: :color7)
+      reference = native.dup
+      reference.define_singleton_method(:native_raster) { |*| false }
+      [native, reference].each do |c|
+        rng = Random.new(9)
+        r = ->(range) { rng.rand(range) }
+        6.times do
+          c.draw_circle(r[-5..40], r[-5..25], r[1..12], pen: pen_class.new(fill: :green, stroke: :blue))
+          c.draw_line(r[-5..40], r[-5..25], r[-5..40], r[-5..25], pen: pen_class.stroke(:red, width: 3))
+          c.draw_rect(r[-5..30], r[-5..20], r[1..20], r[1..12], pen: pen_class.fill(:yellow))
+        end
+        c.flood_fill(18, 11, color: :orange)
+      end
+
+      expect(native).to eq(reference)
+    end
+
+    it 'flood-fills with palette names through a Layer on the Ruby path' do
+      c = described_class.new(width: 20, height: 20, pixel_format: :color4)
+      c.define_singleton_method(:native_raster_window) { |*| false }
+      layer = c.layer(x: 2, y: 2, width: 10, height: 10)
+      layer.flood_fill(1, 1, color: :red)
+      layer.flood_fill(1, 1, color: :red)
+
+      expect(layer.get_pixel(9, 9)).to eq(ChromaWave::Color::RED)
+      expect(c.get_pixel(0, 0)).to eq(ChromaWave::Color::WHITE)
+    end
+
+    it 'thresholds glyph coverage to palette colors' do
+      c = described_class.new(width: 60, height: 24, pixel_format: :color4)
+      c.draw_text('Sale', x: 2, y: 2, font: ChromaWave::Font.default(size: 16), color: :red)
+
+      expect(c.index_bytes.bytes.uniq.sort).to eq([1, 3])
+    end
+
+    it 'thresholds anti-aliased paths' do
+      c = described_class.new(width: 20, height: 20, pixel_format: :mono)
+      c.draw_path(ChromaWave::Path.circle(10, 10, 6), pen: pen_class.fill(:black))
+
+      expect(c.get_pixel(10, 10)).to eq(ChromaWave::Color::BLACK)
+      expect(c.get_pixel(1, 1)).to eq(ChromaWave::Color::WHITE)
+    end
+
+    it 'skips fully transparent glyph colors' do
+      c = described_class.new(width: 4, height: 1, pixel_format: :mono)
+      c.blit_glyph("\xFF".b * 4, x: 0, y: 0, width: 4, height: 1, color: ChromaWave::Color::TRANSPARENT)
+      expect(c.index_bytes).to eq("\x01".b * 4)
+    end
+
+    it 'blits another IndexedCanvas row-wise with clipping' do
+      source = described_class.new(width: 3, height: 2, pixel_format: :color7, background: :blue)
+      canvas.blit(source, x: 7, y: -1)
+
+      expect(canvas.get_pixel(8, 0)).to eq(ChromaWave::Color::BLUE)
+      expect(canvas.get_pixel(6, 0)).to eq(ChromaWave::Color::WHITE)
+      expect(canvas.get_pixel(8, 1)).to eq(ChromaWave::Color::WHITE)
+    end
+
+    it 'loads RGBA bytes like per-pixel nearest matching, natively and in Ruby' do
+      rng = Random.new(3)
+      bytes = Array.new(15 * 7) { [rng.rand(256), rng.rand(256), rng.rand(256), rng.rand(256)] }
+      bytes.fill([255, 0, 0, 255], 20, 10)
+      bytes = bytes.flatten.pack('C*')
+      native = described_class.new(width: 13, height: 6, pixel_format: :color7)
+      ruby = native.dup
+      ruby.define_singleton_method(:respond_to?) { |name, *all| name != :_indexed_quantize && super(name, *all) }
+      reference = native.dup
+      15.times do |sx|
+        7.times do |sy|
+          r, g, b = bytes.byteslice(((sy * 15) + sx) * 4, 3).unpack('C3')
+          reference.set_pixel(sx - 4, sy + 2, ChromaWave::Color.new(r: r, g: g, b: b))
+        end
+      end
+
+      native.load_rgba_bytes(bytes, width: 15, height: 7, x: -4, y: 2)
+      ruby.load_rgba_bytes(bytes, width: 15, height: 7, x: -4, y: 2)
+      expect(native).to eq(reference)
+      expect(ruby).to eq(reference)
+    end
+
+    it 'snapshots itself for an overlapping self-blit' do
+      c = described_class.new(width: 4, height: 1, pixel_format: :color4)
+      c.set_pixel(0, 0, :red).set_pixel(1, 0, :black).set_pixel(2, 0, :yellow)
+      c.blit(c, x: 1, y: 0)
+
+      expect(Array.new(4) { |x| c.get_pixel(x, 0) })
+        .to eq([ChromaWave::Color::RED, ChromaWave::Color::RED, ChromaWave::Color::BLACK, ChromaWave::Color::YELLOW])
+    end
+
+    it 'draws through a Layer' do
+      canvas.layer(x: 2, y: 1, width: 3, height: 3).clear(:red)
+      expect(canvas.get_pixel(4, 3)).to eq(ChromaWave::Color::RED)
+      expect(canvas.get_pixel(5, 3)).to eq(ChromaWave::Color::WHITE)
+    end
+  end
+
+  describe '#rgba_bytes' do
+    it 'expands indices to palette colors' do
+      c = described_class.new(width: 2, height: 1, pixel_format: :color4).set_pixel(0, 0, :yellow)
+      expect(c.rgba_bytes).to eq(ChromaWave::Color::YELLOW.to_rgba_bytes + ChromaWave::Color::WHITE.to_rgba_bytes)
+    end
+  end
+
+  describe '#==' do
+    it 'compares pixel formats' do
+      a = described_class.new(width: 2, height: 2, pixel_format: :color4)
+      b = described_class.new(width: 2, height: 2, pixel_format: :color7)
+      expect(a).not_to eq(b)
+      expect(a).to eq(a.dup)
+    end
+  end
+end
@@ -43,6 +43,14 @@ RSpec.describe ChromaWave::Layer do
     end
   end
 
+  describe '#layer' do
+    it 'nests with additive offsets' do
+      inner = described_class.new(parent: canvas, x: 2, y: 3, width: 10, height: 8).layer(x: 4, y: 1, width: 3, height: 3)
+      inner.set_pixel(0, 0, red)
+      expect(canvas.get_pixel(6, 4)).to eq(red)
+    end
+  end
+
   describe 'coordinate translation' do
     subject(:layer) { described_class.new(parent: canvas, x: 5, y: 3, width: 8, height: 6) }
 
@@ -201,6 +209,98 @@ RSpec.describe ChromaWave::Layer do
     end
   end
 
+  describe 'pushdown to parent accelerators' do
+    let(:pen_class) { ChromaWave::Pen }
+    let(:font) { ChromaWave::Font.default(size: 14) }
+
+    # An inner layer hanging off the top-left of an outer one, so both
+    # clips matter.
+    def nested(root)
+      described_class.new(parent: root, x: 6, y: 4, width: 40, height: 24)
+                     .layer(x: -5, y: -3, width: 30, height: 30)
+    end
+
+    # The same layer with every fast path disabled (per-pixel Ruby).
+    def ruby_only(layer)
+      layer.define_singleton_method(:native_raster) { |*| false }
+      layer.define_singleton_method(:blit_glyph) { |*, **| false }
+      layer
+    end
+
+    def draw_scene(layer, colors)
+      rng = Random.new(3)
+      c = -> { colors.sample(random: rng) }
+      r = ->(range) { rng.rand(range) }
+      layer.clear(c[])
+      8.times do
+        layer.draw_line(r[-10..40], r[-10..40], r[-10..40], r[-10..40], pen: pen_class.stroke(c[], width: r[1..3]))
+        layer.draw_rect(r[-5..30], r[-5..30], r[1..20], r[1..20], pen: pen_class.new(stroke: c[], fill: c[]))
+        layer.draw_circle(r[-5..35], r[-5..35], r[1..12], pen: pen_class.new(fill: c[], stroke: c[]))
+        layer.draw_ellipse(r[-5..35], r[-5..35], r[1..15], r[1..9], pen: pen_class.stroke(c[], width: 2))
+        layer.draw_polygon(Array.new(4) { [r[-8..38], r[-8..38]] }, pen: pen_class.fill(c[]))
+      end
+      3.times { layer.flood_fill(r[0..29], r[0..29], color: c[]) }
+    end
+
+    it 'draws primitives through nested layers like the Ruby path' do
+      native = ChromaWave::Canvas.new(width: 50, height: 30, background: white)
+      reference = native.dup
+      draw_scene(nested(native), [red, blue, black, white])
+      draw_scene(ruby_only(nested(reference)), [red, blue, black, white])
+
+      expect(native).to eq(reference)
+    end
+
+    it 'draws primitives through nested layers on a Framebuffer' do
+      native = ChromaWave::Framebuffer.new(50, 30, :gray4)
+      reference = native.dup
+      colors = native.pixel_format.palette.to_a
+      draw_scene(nested(native), colors)
+      draw_scene(ruby_only(nested(reference)), colors)
+
+      expect(native.bytes).to eq(reference.bytes)
+    end
+
+    it 'clips glyphs partly outside nested layers like the Ruby path' do
+      native = ChromaWave::Canvas.new(width: 50, height: 30, background: white)
+      reference = native.dup
+      nested(native).draw_text('Wg', x: -4, y: -6, font: font, color: black)
+      ruby_only(nested(reference)).draw_text('Wg', x: -4, y: -6, font: font, color: black)
+
+      expect(count_non_white(native)).to be_positive
+      expect(native).to eq(reference)
+    end
+
+    it 'blits a Canvas partly outside nested layers like the per-pixel copy' do
+      source = ChromaWave::Canvas.new(width: 12, height: 9, background: red)
+      source.set_pixel(0, 8, blue)
+      source.set_pixel(11, 0, ChromaWave::Color.new(r: 0, g: 0, b: 255, a: 128))
+      native = ChromaWave::Canvas.new(width: 50, height: 30, background: white)
+      reference = native.dup
+      nested(native).blit(source, x: -3, y: 25)
+      ChromaWave::Surface.instance_method(:blit).bind_call(nested(reference), source, x: -3, y: 25)
+
+      expect(native).to eq(reference)
+    end
+
+    it 'blits the root Canvas onto a layer of itself without copying it whole' do
+      native = ChromaWave::Canvas.new(width: 50, height: 30, background: white)
+      native.draw_rect(0, 0, 4, 4, pen: ChromaWave::Pen.fill(red))
+      reference = native.dup
+      native.define_singleton_method(:rgba_bytes) { raise 'copied the whole source' }
+      nested(native).blit(native, x: 1, y: 1)
+      ChromaWave::Surface.instance_method(:blit).bind_call(nested(reference), reference.dup, x: 1, y: 1)
+
+      expect(native).to eq(reference)
+    end
+
+    it 'returns true from blit_glyph for a fully clipped glyph' do
+      layer = canvas.layer(x: 2, y: 2, width: 5, height: 5)
+      expect(layer.blit_glyph("\xFF".b, x: 9, y: 0, width: 1, height: 1, color: black)).to be(true)
+      expect(count_non_white(canvas)).to eq(0)
+    end
+  end
+
   describe 'works with Framebuffer parent' do
     let(:fb) { ChromaWave::Framebuffer.new(16, 8, :mono) }
 
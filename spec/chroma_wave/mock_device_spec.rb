@@ -325,6 +325,62 @@ RSpec.describe ChromaWave::MockDevice do
       expect(fb1).to eq(fb2)
       mock.close
     end
+
+    it 'sends 4-color g panels 2bpp frames' do
+      mock = described_class.new(model: :epd_7in3g)
+      mock.show(ChromaWave::Canvas.new(width: mock.width, height: mock.height, background: ChromaWave::Color::RED))
+
+      expect(mock.last_operation[:buffer_bytes]).to eq(800 / 4 * 480)
+      expect(mock.last_framebuffer.get_pixel(5, 5)).to eq(:red)
+      mock.close
+    end
+  end
+
+  describe 'rotation' do
+    it 'swaps the drawing dimensions for quarter turns' do
+      mock = described_class.new(model: model, rotation: 90)
+      config = ChromaWave::Native.model_config(model.to_s)
+      expect([mock.width, mock.height]).to eq([config[:height], config[:width]])
+      expect(mock.inspect).to include('rotated 90')
+      mock.close
+    end
+
+    it 'sends framebuffers in the panel orientation' do
+      mock = described_class.new(model: model, rotation: 270)
+      fb = ChromaWave::Framebuffer.new(mock.width, mock.height, mock.pixel_format).set_pixel(0, 0, :black)
+      mock.show(fb)
+
+      panel = mock.last_framebuffer
+      expect([panel.width, panel.height]).to eq([mock.height, mock.width])
+      expect(panel.get_pixel(0, panel.height - 1)).to eq(:black)
+      mock.close
+    end
+
+    it 'reuses its render and rotation buffers across frames' do
+      mock = described_class.new(model: model, rotation: 90)
+      canvas = ChromaWave::Canvas.new(width: mock.width, height: mock.height)
+      mock.show(canvas)
+      pool = mock.send(:framebuffer_pool)
+      idle = pool.size
+      mock.show(canvas)
+
+      expect([idle, pool.size]).to eq([2, 2])
+      mock.close
+    end
+
+    it 'returns its buffers to the pool when the device raises' do
+      mock = described_class.new(model: model, rotation: 90)
+      canvas = ChromaWave::Canvas.new(width: mock.width, height: mock.height)
+      mock.send(:device).define_singleton_method(:_epd_display) { |*| raise ChromaWave::DeviceError, 'busy timeout' }
+
+      expect { mock.show(canvas) }.to raise_error(ChromaWave::DeviceError, /busy timeout/)
+      expect(mock.send(:framebuffer_pool).size).to eq(2)
+      mock.close
+    end
+
+    it 'rejects unsupported angles' do
+      expect { described_class.new(model: model, rotation: 45) }.to raise_error(ArgumentError, /rotation/)
+    end
   end
 
   describe 'capability dispatch' do
@@ -361,6 +417,36 @@ RSpec.describe ChromaWave::MockDevice do
       mock.close
     end
 
+    it 'sends GRAY4 frames to grayscale models as two bit planes' do
+      mock = described_class.new(model: :epd_2in7_v2)
+      fb = ChromaWave::Framebuffer.new(mock.width, mock.height, :gray4).set_pixel(0, 0, :dark_gray)
+      mock.display_grayscale(fb)
+
+      expect(mock.operations.map { |o| o[:op] }).to eq(%i[init show_dual])
+      expect(mock.last_framebuffer).to eq(fb.split_planes.first)
+      mock.close
+    end
+
+    it 'sends both GRAY4 bit planes to epd_3in7, whose second plane needs its own path' do
+      mock = described_class.new(model: :epd_3in7)
+      fb = ChromaWave::Framebuffer.new(mock.width, mock.height, :gray4).set_pixel(0, 0, :light_gray)
+      mock.display_grayscale(fb)
+
+      plane_bytes = ChromaWave::PixelFormat::MONO.buffer_size(mock.width, mock.height)
+      expect(ChromaWave::Native.model_config('epd_3in7')[:dual_display]).to be(true)
+      expect(mock.last_operation).to include(op: :show_dual, black_bytes: plane_bytes, red_bytes: plane_bytes)
+      expect(mock.last_framebuffer).to eq(fb.split_planes.last)
+      mock.close
+    end
+
+    it 'refuses two planes on models with no second display command' do
+      mock = described_class.new(model: :epd_2in13_v2)
+      fb = ChromaWave::Framebuffer.new(mock.width, mock.height, :mono)
+      expect(ChromaWave::Native.model_config('epd_2in13_v2')[:dual_display]).to be(false)
+      expect { mock.send(:device).send(:_epd_display_dual, fb, fb) }.to raise_error(ChromaWave::DeviceError, /second/)
+      mock.close
+    end
+
     it 'logs DualBuffer show_dual for COLOR4 Canvas' do
       mock = described_class.new(model: :epd_13in3b)
       canvas = ChromaWave::Canvas.new(width: mock.width, height: mock.height)
@@ -120,6 +120,22 @@ RSpec.describe ChromaWave::Native do
       end
     end
 
+    context 'with epd_7in3g' do
+      subject(:config) { described_class.model_config('epd_7in3g') }
+
+      it 'returns pixel_format :color4_2bpp, as the controller packs pixels' do
+        expect(config[:pixel_format]).to eq(:color4_2bpp)
+      end
+    end
+
+    context 'with epd_2in13g' do
+      subject(:config) { described_class.model_config('epd_2in13g') }
+
+      it 'is a tier2 model' do
+        expect(config[:tier2]).to be(true)
+      end
+    end
+
     context 'with unknown model' do
       it 'returns nil' do
         expect(described_class.model_config('nonexistent')).to be_nil
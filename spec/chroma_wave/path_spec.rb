@@ -0,0 +1,81 @@
+# frozen_string_literal: true
+
+RSpec.describe ChromaWave::Path do
+  describe '.polyline / .polygon' do
+    it 'records one open or closed contour' do
+      open = described_class.polyline([[0, 0], [4, 0], [4, 3]])
+      closed = described_class.polygon([[0, 0], [4, 0], [4, 3]])
+
+      expect(open.contours.map(&:closed)).to eq([false])
+      expect(closed.contours.map(&:closed)).to eq([true])
+      expect(closed.contours.first.points).to eq([0.0, 0.0, 4.0, 0.0, 4.0, 3.0])
+    end
+  end
+
+  describe '#move_to' do
+    it 'starts a new contour' do
+      path = described_class.new.move_to(0, 0).line_to(1, 1).move_to(5, 5).line_to(6, 6)
+      expect(path.contours.size).to eq(2)
+    end
+  end
+
+  describe '#quad_to' do
+    it 'flattens to within the tolerance of the curve' do
+      path = described_class.new.move_to(0, 0).quad_to(50, 100, 100, 0)
+      points = path.contours.first.points.each_slice(2).to_a
+
+      expect(points.first).to eq([0.0, 0.0])
+      expect(points.last).to eq([100.0, 0.0])
+      expect(points.size).to be > 10
+      # The curve peaks at t = 0.5, y = 50
+      expect(points.map(&:last).max).to be_within(described_class::TOLERANCE).of(50)
+    end
+
+    it 'requires a current point' do
+      expect { described_class.new.quad_to(1, 1, 2, 2) }.to raise_error(ArgumentError, /move_to/)
+    end
+  end
+
+  describe '#cubic_to' do
+    it 'ends at the final point' do
+      path = described_class.new.move_to(0, 0).cubic_to(0, 40, 40, 40, 40, 0)
+      expect(path.contours.first.points.last(2)).to eq([40.0, 0.0])
+    end
+
+    it 'uses a single segment for a straight cubic' do
+      path = described_class.new.move_to(0, 0).cubic_to(1, 1, 2, 2, 3, 3)
+      expect(path.contours.first.points.size).to eq(4)
+    end
+  end
+
+  describe '#arc' do
+    it 'sweeps counter-clockwise on screen for increasing angles' do
+      points = described_class.new.arc(10, 10, 5, 0, Math::PI / 2).contours.first.points.each_slice(2).to_a
+
+      expect(points.first[0]).to be_within(1e-9).of(15)
+      expect(points.last[1]).to be_within(1e-9).of(5) # above the center
+    end
+
+    it 'keeps every chord within the tolerance' do
+      points = described_class.circle(0, 0, 100).contours.first.points.each_slice(2).to_a
+      mid_distances = points.each_cons(2).map { |(ax, ay), (bx, by)| Math.hypot((ax + bx) / 2, (ay + by) / 2) }
+
+      expect(mid_distances.min).to be >= 100 - described_class::TOLERANCE
+    end
+  end
+
+  describe '#native_contours' do
+    it 'packs points as native doubles' do
+      coords, closed = described_class.polygon([[1, 2], [3, 4], [5, 6]]).native_contours.first
+      expect(coords.unpack('d*')).to eq([1.0, 2.0, 3.0, 4.0, 5.0, 6.0])
+      expect(closed).to be(true)
+    end
+  end
+
+  describe '#empty?' do
+    it 'is true until a point is added' do
+      expect(described_class.new).to be_empty
+      expect(described_class.new.move_to(0, 0)).not_to be_empty
+    end
+  end
+end
@@ -0,0 +1,92 @@
+# frozen_string_literal: true
+
+require 'objspace'
+
+RSpec.describe ChromaWave::PixelBuffer do
+  # 5 RGBA pixels per row: 20 bytes of pixels, padded to a 64-byte stride.
+  let(:buffer) { described_class.new(5, 3, 4, [1, 2, 3, 4].pack('C*')) }
+  let(:packed) { [1, 2, 3, 4].pack('C*') * 15 }
+
+  describe '#initialize' do
+    it 'pads rows to the alignment' do
+      expect(buffer.stride).to eq(described_class::ALIGNMENT)
+      expect(described_class.new(17, 1, 4).stride).to eq(128)
+      expect(buffer.bytesize).to eq(60)
+    end
+
+    it 'fills every pixel' do
+      expect(buffer.to_s).to eq(packed)
+      expect(described_class.new(3, 2, 1).to_s).to eq("\x00".b * 6)
+    end
+
+    it 'reports the native allocation' do
+      big = described_class.new(1000, 100, 4)
+      expect(ObjectSpace.memsize_of(big)).to be >= 1024 * 100
+    end
+
+    it 'validates its arguments' do
+      expect { described_class.new(0, 1, 4) }.to raise_error(ArgumentError, /width/)
+      expect { described_class.new(1, 1, 3) }.to raise_error(ArgumentError, /bytes per pixel/)
+      expect { described_class.new(1, 1, 4, "\x00") }.to raise_error(ArgumentError, /fill/)
+    end
+  end
+
+  describe 'packed byte access' do
+    it 'reads and writes across row padding' do
+      buffer.setbyte(20, 9)
+      buffer[18, 4] = "\xAA\xBB\xCC\xDD".b
+
+      expect(buffer.getbyte(20)).to eq(0xCC)
+      expect(buffer.byteslice(16, 8)).to eq("\x01\x02\xAA\xBB\xCC\xDD\x03\x04".b)
+      expect(buffer.to_s.bytesize).to eq(60)
+    end
+
+    it 'mirrors String bounds behavior' do
+      expect(buffer.getbyte(60)).to be_nil
+      expect(buffer.byteslice(58, 10)).to eq("\x03\x04".b)
+      expect { buffer.setbyte(60, 0) }.to raise_error(IndexError)
+      expect { buffer[58, 4] = 'abcd' }.to raise_error(IndexError)
+      expect { buffer[0, 4] = 'abc' }.to raise_error(ArgumentError)
+    end
+
+    it 'replaces all pixels from packed bytes' do
+      bytes = (0...60).to_a.pack('C*')
+      expect(buffer.replace(bytes).to_s).to eq(bytes)
+      expect { buffer.replace(bytes[0, 59]) }.to raise_error(ArgumentError, /expected 60 bytes/)
+    end
+  end
+
+  describe '#pin' do
+    it 'blocks writes from Ruby and from the kernels until the block returns' do
+      canvas = ChromaWave::Canvas.new(width: 5, height: 3)
+      pixels = canvas.send(:buffer)
+
+      result = pixels.pin do
+        expect(pixels).to be_pinned
+        expect { pixels.setbyte(0, 0) }.to raise_error(RuntimeError, /pinned/)
+        expect { canvas.clear(ChromaWave::Color::BLACK) }.to raise_error(RuntimeError, /pinned/)
+        pixels.pin { :nested }
+      end
+
+      expect(result).to eq(:nested)
+      expect(pixels).not_to be_pinned
+      expect(canvas.clear(ChromaWave::Color::BLACK).get_pixel(4, 2)).to eq(ChromaWave::Color::BLACK)
+    end
+  end
+
+  describe 'copies and equality' do
+    it 'duplicates into independent storage' do
+      copy = buffer.dup
+      copy.setbyte(0, 0)
+      expect(buffer.getbyte(0)).to eq(1)
+      expect(copy).not_to eq(buffer)
+    end
+
+    it 'compares pixels, not padding' do
+      other = described_class.new(5, 3, 4).replace(packed)
+      expect(other).to eq(buffer)
+      expect(other.hash).to eq(buffer.hash)
+      expect(described_class.new(15, 1, 4).replace(packed)).not_to eq(buffer)
+    end
+  end
+end
@@ -29,6 +29,13 @@ RSpec.describe ChromaWave::PixelFormat do
       expect(fmt.bits_per_pixel).to eq(4)
       expect(fmt.palette.to_a).to eq(%i[black white green blue red yellow orange])
     end
+
+    it 'defines COLOR4_2BPP' do
+      fmt = described_class::COLOR4_2BPP
+      expect(fmt.name).to eq(:color4_2bpp)
+      expect(fmt.bits_per_pixel).to eq(2)
+      expect(fmt.palette).to eq(described_class::COLOR4.palette)
+    end
   end
 
   describe '#pixels_per_byte' do
@@ -70,6 +77,12 @@ RSpec.describe ChromaWave::PixelFormat do
       expect(described_class::COLOR7.buffer_size(15, 5)).to eq(fb.buffer_size)
     end
 
+    it 'matches C for COLOR4_2BPP 122x250, half of COLOR4' do
+      fb = ChromaWave::Framebuffer.new(122, 250, :color4_2bpp)
+      expect(described_class::COLOR4_2BPP.buffer_size(122, 250)).to eq(fb.buffer_size)
+      expect(fb.buffer_size).to eq(31 * 250)
+    end
+
     it 'handles width of 1' do
       expect(described_class::MONO.buffer_size(1, 1)).to eq(1)
     end
@@ -106,6 +119,10 @@ RSpec.describe ChromaWave::PixelFormat do
       expect(described_class.from_name(:color7)).to equal(described_class::COLOR7)
     end
 
+    it 'looks up :color4_2bpp' do
+      expect(described_class.from_name(:color4_2bpp)).to equal(described_class::COLOR4_2BPP)
+    end
+
     it 'raises ArgumentError for unknown name' do
       expect { described_class.from_name(:rgb565) }
         .to raise_error(ArgumentError, /unknown pixel format/)
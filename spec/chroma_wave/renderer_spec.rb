@@ -91,6 +91,19 @@ RSpec.describe ChromaWave::Renderer do
       end
     end
 
+    context 'with a pool' do
+      it 'renders into rented framebuffers' do
+        pool = ChromaWave::FramebufferPool.new
+        pooled = described_class.new(pixel_format: mono_format, dither: :threshold, pool: pool)
+        canvas = ChromaWave::Canvas.new(width: 12, height: 3, background: black)
+        first = pooled.render(canvas)
+        pool.release(first)
+
+        expect(pooled.render(canvas)).to equal(first)
+        expect(first).to eq(renderer.render(canvas))
+      end
+    end
+
     context 'with error cases' do
       it 'raises TypeError for nil canvas' do
         expect { renderer.render(nil) }.to raise_error(TypeError, /expected Canvas/)
@@ -0,0 +1,105 @@
+# frozen_string_literal: true
+
+RSpec.describe ChromaWave::Resampling do
+  let(:color) { ChromaWave::Color }
+
+  # 2x1 canvas: black, white
+  let(:pair) { ChromaWave::Canvas.new(width: 2, height: 1).set_pixel(0, 0, color::BLACK) }
+
+  def grays(canvas)
+    canvas.rgba_bytes.unpack('C*').each_slice(4).map(&:first)
+  end
+
+  describe '#resample' do
+    it 'repeats pixels with :nearest' do
+      expect(grays(pair.resample(width: 4, height: 2, filter: :nearest))).to eq([0, 0, 255, 255] * 2)
+    end
+
+    it 'interpolates between pixel centres with :bilinear' do
+      expect(grays(pair.resample(width: 4, height: 1))).to eq([0, 64, 191, 255])
+    end
+
+    it 'weights source pixels by coverage with :box' do
+      wide = ChromaWave::Canvas.new(width: 3, height: 1).set_pixel(1, 0, color::BLACK)
+      expect(grays(wide.resample(width: 2, height: 1, filter: :box))).to eq([170, 170])
+    end
+
+    it 'does not bleed the color of transparent pixels' do
+      source = ChromaWave::Canvas.new(width: 2, height: 1, background: color::RED)
+      source.set_pixel(1, 0, color.new(r: 0, g: 0, b: 255, a: 0))
+
+      expect(source.resample(width: 3, height: 1).get_pixel(1, 0)).to eq(color.new(r: 255, g: 0, b: 0, a: 128))
+    end
+
+    it 'returns an RGBA canvas for byte-per-pixel canvases' do
+      gray = ChromaWave::GrayCanvas.new(width: 4, height: 4, background: color::BLACK)
+      scaled = gray.resample(width: 2, height: 2)
+
+      expect(scaled.class).to eq(ChromaWave::Canvas)
+      expect(scaled.get_pixel(1, 1)).to eq(color::BLACK)
+    end
+
+    it 'matches the Ruby fallback for every filter' do
+      rng = Random.new(5)
+      source = ChromaWave::Canvas.from_rgba_bytes(Array.new(19 * 11 * 4) { rng.rand(256) }.pack('C*'),
+                                                  width: 19, height: 11)
+      [[7, 5], [19, 11], [45, 26]].product(ChromaWave::Canvas::RESAMPLE_FILTERS).each do |(w, h), filter|
+        reference = ChromaWave::Canvas.new(width: w, height: h)
+        reference.send(:resample_ruby, source.rgba_bytes, 19, 11, filter)
+
+        expect(source.resample(width: w, height: h, filter: filter)).to eq(reference)
+      end
+    end
+
+    it 'validates its arguments' do
+      expect { pair.resample(width: 0, height: 1) }.to raise_error(ArgumentError, /width/)
+      expect { pair.resample(width: 1, height: 1, filter: :lanczos) }.to raise_error(ArgumentError, /unknown filter/)
+    end
+  end
+
+  describe '#downsample' do
+    it 'averages factor x factor blocks' do
+      big = ChromaWave::Canvas.new(width: 4, height: 4)
+      big.draw_rect(0, 0, 2, 1, pen: ChromaWave::Pen.fill(color::BLACK))
+      small = big.downsample(2)
+
+      expect([small.width, small.height]).to eq([2, 2])
+      expect(grays(small)).to eq([128, 255, 255, 255])
+    end
+
+    it 'anti-aliases supersampled shapes' do
+      big = ChromaWave::Canvas.new(width: 40, height: 40)
+      big.draw_circle(20, 20, 14, pen: ChromaWave::Pen.fill(color::BLACK))
+
+      expect(grays(big.downsample(4)).uniq.size).to be > 2
+    end
+
+    it 'rounds partial blocks up and rejects bad factors' do
+      expect(ChromaWave::Canvas.new(width: 5, height: 3).downsample(2).width).to eq(3)
+      expect { pair.downsample(0) }.to raise_error(ArgumentError, /factor/)
+    end
+  end
+
+  describe '#blit_scaled' do
+    it 'composites the scaled source with clipping' do
+      canvas = ChromaWave::Canvas.new(width: 6, height: 4)
+      canvas.blit_scaled(pair, x: 3, y: 1, width: 4, height: 2, filter: :nearest)
+
+      expect(canvas.get_pixel(4, 2)).to eq(color::BLACK)
+      expect(canvas.get_pixel(5, 2)).to eq(color::WHITE)
+      expect(canvas.get_pixel(4, 0)).to eq(color::WHITE)
+    end
+
+    it 'scales onto a GrayCanvas through its own blit' do
+      gray = ChromaWave::GrayCanvas.new(width: 8, height: 2)
+      gray.blit_scaled(pair, x: 0, y: 0, width: 8, height: 2, filter: :nearest)
+
+      expect([gray.get_pixel(3, 1), gray.get_pixel(4, 1)]).to eq([color::BLACK, color::WHITE])
+    end
+
+    it 'requires a Canvas source' do
+      expect { pair.blit_scaled(ChromaWave::Framebuffer.new(2, 2, :mono), x: 0, y: 0, width: 4, height: 4) }
+        .to raise_error(ArgumentError, /must be a Canvas/)
+    end
+  end
+end
@@ -0,0 +1,109 @@
+# frozen_string_literal: true
+
+RSpec.describe ChromaWave::TextLayout do
+  let(:font) { ChromaWave::Font.default(size: 14) }
+  let(:black) { ChromaWave::Color::BLACK }
+
+  before { ChromaWave::TextLayout.clear_cache! }
+
+  describe ChromaWave::TextLayout::Cache do
+    subject(:cache) { described_class.new(capacity: 2) }
+
+    it 'computes once per key' do
+      calls = 0
+      3.times do
+        cache.fetch(:a) do
+          calls += 1
+          :value
+        end
+      end
+      expect(calls).to eq(1)
+    end
+
+    it 'evicts the least recently used entry' do
+      cache.fetch(:a) { 1 }
+      cache.fetch(:b) { 2 }
+      cache.fetch(:a) { 1 }
+      cache.fetch(:c) { 3 }
+      expect(cache.fetch(:b) { :recomputed }).to eq(:recomputed)
+      expect(cache.size).to eq(2)
+    end
+
+    it 'allows the block to consult the cache' do
+      expect(cache.fetch(:outer) { cache.fetch(:inner) { 1 } + 1 }).to eq(2)
+    end
+
+    it 'reports hits, misses, and hit rate' do
+      cache.fetch(:a) { 1 }
+      3.times { cache.fetch(:a) { 1 } }
+      expect(cache.stats).to include(hits: 3, misses: 1, size: 1, capacity: 2, hit_rate: 0.75)
+    end
+
+    it 'resets counters on clear' do
+      cache.fetch(:a) { 1 }
+      cache.clear
+      expect(cache.stats).to include(hits: 0, misses: 0, size: 0, hit_rate: 0.0)
+    end
+  end
+
+  describe 'draw_text caching' do
+    it 'reuses the layout for repeated labels' do
+      canvas = ChromaWave::Canvas.new(width: 120, height: 40)
+      canvas.draw_text('Next bus', x: 0, y: 0, font: font, color: black)
+      misses = described_class.cache_stats[:misses]
+
+      canvas.draw_text('Next bus', x: 10, y: 10, font: font, color: black)
+      expect(described_class.cache_stats[:misses]).to eq(misses)
+      expect(described_class.cache_stats[:hits]).to be_positive
+    end
+
+    it 'draws identically on a hit' do
+      first = ChromaWave::Canvas.new(width: 120, height: 60)
+      second = ChromaWave::Canvas.new(width: 120, height: 60)
+      text = 'Temperature reading'
+      first.draw_text(text, x: 3, y: 4, font: font, color: black, max_width: 80, align: :center)
+      second.draw_text(text, x: 3, y: 4, font: font, color: black, max_width: 80, align: :center)
+      expect(second.rgba_bytes).to eq(first.rgba_bytes)
+    end
+
+    it 'keys on layout options' do
+      canvas = ChromaWave::Canvas.new(width: 120, height: 60)
+      canvas.draw_text('Hi there', x: 0, y: 0, font: font, color: black, max_width: 100, align: :left)
+      misses = described_class.cache_stats[:misses]
+      canvas.draw_text('Hi there', x: 0, y: 0, font: font, color: black, max_width: 100, align: :right)
+      expect(described_class.cache_stats[:misses]).to be > misses
+    end
+
+    it 'shares entries between fonts of the same face and size' do
+      canvas = ChromaWave::Canvas.new(width: 120, height: 40)
+      canvas.draw_text('°C', x: 0, y: 0, font: font, color: black)
+      misses = described_class.cache_stats[:misses]
+      canvas.draw_text('°C', x: 0, y: 0, font: ChromaWave::Font.default(size: 14), color: black)
+      expect(described_class.cache_stats[:misses]).to eq(misses)
+    end
+
+    it 'caches a wrapped block as one entry, not its wrap candidates' do
+      canvas = ChromaWave::Canvas.new(width: 120, height: 120)
+      text = 'The quick brown fox jumps over the lazy dog'
+      canvas.draw_text(text, x: 0, y: 0, font: font, color: black, max_width: 60, align: :center)
+      expect(described_class.cache.size).to eq(1)
+    end
+
+    it 'is not affected by mutating the drawn string' do
+      canvas = ChromaWave::Canvas.new(width: 120, height: 40)
+      label = +'Wind'
+      canvas.draw_text(label, x: 0, y: 0, font: font, color: black)
+      label << ' speed'
+      expect(font.measure(label).width).to be > font.measure('Wind').width
+    end
+  end
+
+  describe 'Font#measure caching' do
+    it 'memoizes metrics per face, size, and string' do
+      first = font.measure('Humidity')
+      hits = described_class.cache_stats[:hits]
+      expect(font.measure('Humidity')).to eq(first)
+      expect(described_class.cache_stats[:hits]).to eq(hits + 1)
+    end
+  end
+end
@@ -12,6 +12,10 @@ SimpleCov.start do
 end
 
 require 'chroma_wave'
+require 'tmpdir'
+
+# Keep the persistent font index out of the developer's cache directory.
+ENV[ChromaWave::Font::INDEX_PATH_ENV] ||= File.join(Dir.mktmpdir('chroma_wave'), 'font-index.json')
 
 Dir[File.join(__dir__, 'support', '**', '*.rb')].each { |f| require f }
 